@@ -20,9 +20,13 @@
 #define ALU_4BIT_H
 
 #include <systemc.h>
+#include <cstdint>
+#include "../common/datatypes.h"
 
 // 4位带符号补码ALU模块
-SC_MODULE(alu_4bit) {
+// P是内部运算的数据类型策略（见common/datatypes.h），端口类型与策略无关
+template<typename P>
+struct alu_4bit_t : sc_module {
     // 输入端口
     sc_in<sc_int<4>> A;        // 4位带符号数输入A（补码表示）
     sc_in<sc_int<4>> B;        // 4位带符号数输入B（补码表示）
@@ -34,17 +38,37 @@ SC_MODULE(alu_4bit) {
     sc_out<bool> overflow;     // 溢出标志
     sc_out<bool> carry;        // 进位标志
     
+    SC_HAS_PROCESS(alu_4bit_t);
+
     // ALU运算处理方法
     void alu_process() {
-        // 临时变量用于计算
-        sc_int<4> a_val = A.read();
-        sc_int<4> b_val = B.read();
-        sc_int<4> res = 0;
-        bool carry_flag = false;
-        bool overflow_flag = false;
+        bool zero_flag, overflow_flag, carry_flag;
+        if constexpr (P::native) {
+            int8_t res;
+            evaluate_native(int8_t(A.read().to_int()), int8_t(B.read().to_int()), uint8_t(op.read().to_uint()),
+                            res, zero_flag, overflow_flag, carry_flag);
+            result.write(res);
+        } else {
+            sc_int<4> res;
+            evaluate(A.read(), B.read(), op.read(), res, zero_flag, overflow_flag, carry_flag);
+            result.write(res);
+        }
+        
+        // 设置输出
+        zero.write(zero_flag);
+        overflow.write(overflow_flag);
+        carry.write(carry_flag);
+    }
+    
+    // 运算本身，与端口无关，供流水线版本等其他模型复用
+    static void evaluate(sc_int<4> a_val, sc_int<4> b_val, sc_uint<3> op_val,
+                         sc_int<4>& res, bool& zero_flag, bool& overflow_flag, bool& carry_flag) {
+        res = 0;
+        carry_flag = false;
+        overflow_flag = false;
         
         // 根据操作码执行相应的运算
-        switch(op.read()) {
+        switch(op_val) {
             case 0: // 加法 A+B
                 {
                     // 扩展位宽进行加法，以检测溢出和进位
@@ -128,18 +152,51 @@ SC_MODULE(alu_4bit) {
                 break;
         }
         
-        // 设置输出
-        result.write(res);
-        zero.write(res == 0);
-        overflow.write(overflow_flag);
-        carry.write(carry_flag);
+        zero_flag = (res == 0);
+    }
+    
+    // 与evaluate逐位一致的原生整数实现：int8_t运算，结果显式截断到4位并符号扩展。
+    // 加减法的和差在int中不会回绕，相当于evaluate中的5位扩展
+    static void evaluate_native(int8_t a, int8_t b, uint8_t op_val,
+                                int8_t& res, bool& zero_flag, bool& overflow_flag, bool& carry_flag) {
+        int ext = 0;
+        carry_flag = false;
+        overflow_flag = false;
+        switch (op_val & 7) {
+            case 0:
+                ext = a + b;
+                carry_flag = (a >= 0 && b >= 0 && ext >= 8) || (a < 0 && b < 0 && ext < -8);
+                overflow_flag = (a > 0 && b > 0 && ext < 0) || (a < 0 && b < 0 && ext >= 0);
+                break;
+            case 1:
+                ext = a - b;
+                carry_flag = (a >= 0 && b < 0 && ext >= 8) || (a < 0 && b >= 0 && ext < -8);
+                overflow_flag = (a >= 0 && b < 0 && ext < 0) || (a < 0 && b >= 0 && ext >= 0);
+                break;
+            case 2: ext = ~a; break;
+            case 3: ext = a & b; break;
+            case 4: ext = a | b; break;
+            case 5: ext = a ^ b; break;
+            case 6: ext = (a < b) ? 1 : 0; break;
+            case 7: ext = (a == b) ? 1 : 0; break;
+        }
+        res = int8_t(((ext & 0xF) ^ 0x8) - 8);
+        zero_flag = (res == 0);
     }
     
     // 构造函数
-    SC_CTOR(alu_4bit) {
+    alu_4bit_t(sc_module_name name) : sc_module(name) {
         SC_METHOD(alu_process);
         sensitive << A << B << op;
     }
 };
 
+typedef alu_4bit_t<default_datatypes> alu_4bit;
+
+#ifdef SC_MODELS_LIB
+// 这些实例已在models/libscmodels.a中编译（见build.mk）
+extern template struct alu_4bit_t<sc_datatypes>;
+extern template struct alu_4bit_t<native_datatypes>;
+#endif
+
 #endif // ALU_4BIT_H
@@ -20,7 +20,60 @@
 #include <bitset>
 #include <string>
 #include <iostream>
+#include <cstdlib>
 #include "alu_4bit.h"
+#include "alu_coverage.h"
+#include "alu_activity.h"
+#include "../common/scoreboard.h"
+#include "../common/txn_probe.h"
+
+// ALU的全部输出，作为一个整体与参考模型比较
+struct alu_result {
+    int result;
+    bool zero;
+    bool overflow;
+    bool carry;
+
+    bool operator==(const alu_result& o) const {
+        return result == o.result && zero == o.zero && overflow == o.overflow && carry == o.carry;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const alu_result& r) {
+    return os << "{result=" << r.result << ", zero=" << r.zero
+              << ", overflow=" << r.overflow << ", carry=" << r.carry << "}";
+}
+
+// 整数参考模型，标志位的判断条件与alu_process相同
+// （加减法在5位宽度上计算不会回绕，因此按该条件溢出标志始终为0）
+inline alu_result alu_reference(int a, int b, int op) {
+    int res = 0;
+    bool c = false, v = false;
+    switch (op) {
+    case 0: {
+        int ext = a + b;
+        c = (a >= 0 && b >= 0 && ext >= 8) || (a < 0 && b < 0 && ext < -8);
+        v = (a > 0 && b > 0 && ext < 0) || (a < 0 && b < 0 && ext >= 0);
+        res = ext;
+        break;
+    }
+    case 1: {
+        int ext = a - b;
+        c = (a >= 0 && b < 0 && ext >= 8) || (a < 0 && b >= 0 && ext < -8);
+        v = (a >= 0 && b < 0 && ext < 0) || (a < 0 && b >= 0 && ext >= 0);
+        res = ext;
+        break;
+    }
+    case 2: res = ~a; break;
+    case 3: res = a & b; break;
+    case 4: res = a | b; break;
+    case 5: res = a ^ b; break;
+    case 6: res = a < b ? 1 : 0; break;
+    case 7: res = a == b ? 1 : 0; break;
+    }
+    res = ((res & 0xF) ^ 0x8) - 8;     // 截断为4位带符号数
+    return {res, res == 0, v, c};
+}
 
 SC_MODULE(alu_4bit_tb) {
     // 信号
@@ -38,6 +91,36 @@ SC_MODULE(alu_4bit_tb) {
     // 被测试的ALU实例
     alu_4bit alu_inst;
     
+    // 覆盖率监视器
+    alu_coverage coverage;
+    
+    // 开关活动与能量估算：每1us一个窗口，写入alu_power.csv
+    pwr::power_report power;
+    alu_activity activity;
+    pwr::power_window power_win;
+    
+    // 记分板：参考模型的结果为期望流，ALU输出为实际流
+    scoreboard<alu_result> sb;
+    
+    // 测试结果，仿真结束后由sc_main作为退出码返回
+    bool passed;
+    
+    // 事务日志：设置TXN_LOG时记录每组输入施加后的端口值，用于黄金输出比较
+    txn::probe txn_log;
+    
+    // 施加一组输入，并把参考结果和实际结果交给记分板
+    void apply(int a, int b, int op) {
+        A_sig.write(a);
+        B_sig.write(b);
+        op_sig.write(op);
+        
+        wait(10, SC_NS);
+        
+        sb.expect(alu_reference(a, b, op));
+        sb.actual({result_sig.read().to_int(), zero_sig.read(), overflow_sig.read(), carry_sig.read()});
+        txn_log.sample();
+    }
+    
     // 显示结果的辅助函数
     void display_result(sc_int<4> a, sc_int<4> b, sc_uint<3> op, 
                        sc_int<4> result, bool zero, bool overflow, bool carry) {
@@ -110,11 +193,7 @@ SC_MODULE(alu_4bit_tb) {
         
         // 执行测试用例
         for (auto& tc : test_cases) {
-            A_sig.write(tc.a);
-            B_sig.write(tc.b);
-            op_sig.write(tc.op);
-            
-            wait(10, SC_NS);
+            apply(tc.a, tc.b, tc.op);
             
             display_result(
                 A_sig.read(), B_sig.read(), op_sig.read(),
@@ -122,13 +201,29 @@ SC_MODULE(alu_4bit_tb) {
             );
         }
         
-        cout << "ALU测试完成！波形已保存到 alu_4bit.vcd 文件\n";
+        // 穷举所有操作数和操作码组合，只由记分板检查
+        for (int op = 0; op < 8; op++) {
+            for (int a = -8; a < 8; a++) {
+                for (int b = -8; b < 8; b++) {
+                    apply(a, b, op);
+                }
+            }
+        }
+        
+        sb.report();
+        coverage.group.report();
+        coverage.group.save("alu.cov");
+        passed = sb.passed();
+        cout << (passed ? "ALU测试通过！" : "ALU测试失败！")
+             << "波形已保存到 alu_4bit.vcd 文件\n";
         sc_stop();
     }
     
     // 构造函数
     SC_CTOR(alu_4bit_tb)
-    : alu_inst("alu_instance") {
+    : alu_inst("alu_instance"), coverage("coverage"),
+      activity("alu", power), power_win("power_window", power, sc_time(1, SC_US)), sb("alu", 4),
+      passed(false), txn_log("txn_log") {
         // 连接信号到ALU实例
         alu_inst.A(A_sig);
         alu_inst.B(B_sig);
@@ -138,6 +233,37 @@ SC_MODULE(alu_4bit_tb) {
         alu_inst.overflow(overflow_sig);
         alu_inst.carry(carry_sig);
         
+        // 覆盖率监视器接在相同的信号上
+        coverage.A(A_sig);
+        coverage.B(B_sig);
+        coverage.op(op_sig);
+        coverage.result(result_sig);
+        coverage.zero(zero_sig);
+        coverage.overflow(overflow_sig);
+        coverage.carry(carry_sig);
+        
+        // 开关活动监视器同样接在这些信号上
+        activity.A(A_sig);
+        activity.B(B_sig);
+        activity.op(op_sig);
+        activity.result(result_sig);
+        activity.zero(zero_sig);
+        activity.overflow(overflow_sig);
+        activity.carry(carry_sig);
+        
+        // 监视器已写入默认能量，ENERGY_TABLE指定的能量表文件覆盖其中的条目
+        if (const char* f = std::getenv("ENERGY_TABLE")) power.table().load(f);
+        power.open("alu_power.csv");
+        
+        txn_log.add("A", A_sig);
+        txn_log.add("B", B_sig);
+        txn_log.add("op", op_sig);
+        txn_log.add("result", result_sig);
+        txn_log.add("zero", zero_sig);
+        txn_log.add("overflow", overflow_sig);
+        txn_log.add("carry", carry_sig);
+        txn_log.open_env();
+        
         // 注册测试进程
         SC_THREAD(test_process);
         
@@ -164,5 +290,5 @@ SC_MODULE(alu_4bit_tb) {
 int sc_main(int argc, char* argv[]) {
     alu_4bit_tb tb("alu_testbench");
     sc_start();
-    return 0;
+    return tb.passed ? 0 : 1;
 }
@@ -0,0 +1,73 @@
+// File: alu_activity.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ALU_ACTIVITY_H
+#define ALU_ACTIVITY_H
+
+#include <systemc.h>
+#include "../common/power_window.h"
+
+// ALU开关活动监视器：与alu_4bit接在相同的信号上，任一端口改变时统计各端口的翻转位数
+// 输入和输出分别在各自改变的delta中计入，不需要等结果稳定
+SC_MODULE(alu_activity) {
+    sc_in<sc_int<4>> A;
+    sc_in<sc_int<4>> B;
+    sc_in<sc_uint<3>> op;
+    sc_in<sc_int<4>> result;
+    sc_in<bool> zero;
+    sc_in<bool> overflow;
+    sc_in<bool> carry;
+
+    pwr::activity& act;
+    pwr::port_probe<sc_int<4>> a, b, res;
+    pwr::port_probe<sc_uint<3>> o;
+    pwr::port_probe<bool> z, v, c;
+
+    SC_HAS_PROCESS(alu_activity);
+
+    void sample() {
+        a.sample(act);
+        b.sample(act);
+        o.sample(act);
+        res.sample(act);
+        z.sample(act);
+        v.sample(act);
+        c.sample(act);
+    }
+
+    alu_activity(sc_module_name name, pwr::power_report& report)
+    : sc_module(name), act(report.add_module("alu_4bit", basename())) {
+        a.attach(act, A, "A");
+        b.attach(act, B, "B");
+        o.attach(act, op, "op");
+        res.attach(act, result, "result");
+        z.attach(act, zero, "zero");
+        v.attach(act, overflow, "overflow");
+        c.attach(act, carry, "carry");
+
+        // 每位翻转的默认能量（pJ）：输入翻转会引起加法器内部的翻转，取得比输出大
+        report.table().set("alu_4bit", "*", 0.01);
+        report.table().set("alu_4bit", "A", 0.04);
+        report.table().set("alu_4bit", "B", 0.04);
+        report.table().set("alu_4bit", "op", 0.03);
+        report.table().set("alu_4bit", "result", 0.02);
+
+        SC_METHOD(sample);
+        sensitive << A << B << op << result << zero << overflow << carry;
+    }
+};
+
+#endif // ALU_ACTIVITY_H
@@ -0,0 +1,85 @@
+// File: alu_coverage.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ALU_COVERAGE_H
+#define ALU_COVERAGE_H
+
+#include <systemc.h>
+#include "../common/coverage.h"
+
+// ALU覆盖率监视器：与alu_4bit接在相同的信号上
+// 输入变化后推迟一个delta再采样，此时alu_process写出的结果和标志已经更新
+SC_MODULE(alu_coverage) {
+    sc_in<sc_int<4>> A;
+    sc_in<sc_int<4>> B;
+    sc_in<sc_uint<3>> op;
+    sc_in<sc_int<4>> result;
+    sc_in<bool> zero;
+    sc_in<bool> overflow;
+    sc_in<bool> carry;
+
+    cov::covergroup group;
+    cov::coverpoint& op_cp;
+    cov::coverpoint& a_cp;
+    cov::coverpoint& b_cp;
+    cov::coverpoint& flag_cp;
+    cov::coverpoint& op_x_flag;        // 每种操作下每个标志是否被置位过
+
+    sc_event settle;
+
+    void trigger() {
+        settle.notify(SC_ZERO_TIME);
+    }
+
+    void sample() {
+        unsigned int o = op.read().to_uint();
+        op_cp.sample(o);
+        a_cp.sample(A.read().to_int() + 8);
+        b_cp.sample(B.read().to_int() + 8);
+        if (zero.read())     { flag_cp.sample(0); op_x_flag.sample(o, 0); }
+        if (overflow.read()) { flag_cp.sample(1); op_x_flag.sample(o, 1); }
+        if (carry.read())    { flag_cp.sample(2); op_x_flag.sample(o, 2); }
+    }
+
+    static std::vector<std::string> operand_labels() {
+        std::vector<std::string> l;
+        for (int v = -8; v < 8; v++) l.push_back(std::to_string(v));
+        return l;
+    }
+
+    SC_CTOR(alu_coverage)
+    : group("alu"),
+      op_cp(group.add("op", 8, {"add", "sub", "not", "and", "or", "xor", "less", "equal"})),
+      a_cp(group.add("A", 16, operand_labels())),
+      b_cp(group.add("B", 16, operand_labels())),
+      flag_cp(group.add("flag", 3, {"zero", "overflow", "carry"})),
+      op_x_flag(group.add_cross("op x flag", op_cp, flag_cp)) {
+        // 按规格，逻辑运算和比较不产生溢出和进位
+        for (unsigned int o = 2; o < 8; o++) {
+            op_x_flag.ignore(o, 1);
+            op_x_flag.ignore(o, 2);
+        }
+
+        SC_METHOD(trigger);
+        sensitive << A << B << op;
+
+        SC_METHOD(sample);
+        sensitive << settle;
+        dont_initialize();
+    }
+};
+
+#endif // ALU_COVERAGE_H
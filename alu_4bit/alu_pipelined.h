@@ -0,0 +1,187 @@
+// File: alu_pipelined.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ALU_PIPELINED_H
+#define ALU_PIPELINED_H
+
+#include <systemc.h>
+#include <vector>
+#include "alu_4bit.h"
+
+// 带时钟的流水线ALU
+// 运算与alu_4bit完全相同（调用alu_4bit::evaluate），区别在于结果经过depth级
+// 流水寄存器才出现在输出端。输入和输出都使用valid/ready握手：
+//   - 上升沿时in_valid && in_ready，则接收一个操作
+//   - 上升沿时out_valid && out_ready，则送出一个结果
+// 输出端有结果而下游未就绪时，整条流水线停顿。
+// 初始化间隔ii：两次接收之间至少间隔ii个周期，ii=1为每周期都可以接收。
+//
+// 各级寄存器放在长度为depth的固定环中，前进一级只移动环的起点，不搬移数据。
+SC_MODULE(alu_pipelined) {
+    // 时钟和复位
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+
+    // 输入握手
+    sc_in<bool> in_valid;
+    sc_out<bool> in_ready;
+    sc_in<sc_int<4>> A;
+    sc_in<sc_int<4>> B;
+    sc_in<sc_uint<3>> op;
+
+    // 输出握手
+    sc_out<bool> out_valid;
+    sc_in<bool> out_ready;
+    sc_out<sc_int<4>> result;
+    sc_out<bool> zero;
+    sc_out<bool> overflow;
+    sc_out<bool> carry;
+
+    // 一级流水寄存器
+    struct stage {
+        bool valid;
+        sc_int<4> result;
+        bool zero;
+        bool overflow;
+        bool carry;
+
+        stage() : valid(false), result(0), zero(false), overflow(false), carry(false) {}
+    };
+
+    // 运行统计
+    struct counters {
+        uint64_t cycles;          // 复位释放后的周期数
+        uint64_t issued;          // 接收的操作数
+        uint64_t completed;       // 送出的结果数
+        uint64_t stall_cycles;    // 输出被下游阻塞、流水线停顿的周期
+        uint64_t ii_wait_cycles;  // 有输入但受初始化间隔限制不能接收的周期
+        uint64_t occupied_slots;  // 各周期有效级数之和
+
+        counters() : cycles(0), issued(0), completed(0), stall_cycles(0),
+                     ii_wait_cycles(0), occupied_slots(0) {}
+    };
+
+    const unsigned int depth;
+    const unsigned int ii;
+
+    // 流水线利用率：有效级数占全部级数×周期的比例
+    double utilization() const {
+        return stats.cycles ? double(stats.occupied_slots) / (double(stats.cycles) * depth) : 0.0;
+    }
+
+    // 吞吐率：平均每周期送出的结果数
+    double throughput() const {
+        return stats.cycles ? double(stats.completed) / stats.cycles : 0.0;
+    }
+
+    const counters& statistics() const { return stats; }
+
+    // 时钟进程：接收、前进、送出
+    void clock_process() {
+        if (!rst_n.read()) {
+            for (stage& s : ring) s = stage();
+            head = 0;
+            occupied = 0;
+            ii_wait = 0;
+            ii_open.write(true);
+            write_outputs();
+            return;
+        }
+
+        stats.cycles++;
+        const stage& last = ring[slot(depth - 1)];
+        bool advance = !last.valid || out_ready.read();
+        bool accept = in_valid.read() && in_ready.read();
+
+        if (last.valid && out_ready.read()) stats.completed++;
+        if (!advance) stats.stall_cycles++;
+        if (in_valid.read() && advance && !ii_open.read()) stats.ii_wait_cycles++;
+
+        if (advance) {
+            // 最后一级的槽位已经送出（或为空），转到环首作为新的第0级
+            if (last.valid) occupied--;
+            head = head ? head - 1 : depth - 1;
+            stage& first = ring[head];
+            first.valid = accept;
+            if (accept) {
+                alu_4bit::evaluate(A.read(), B.read(), op.read(),
+                                   first.result, first.zero, first.overflow, first.carry);
+                occupied++;
+                stats.issued++;
+            }
+        }
+        stats.occupied_slots += occupied;
+
+        // 初始化间隔计数与流水线是否前进无关
+        if (accept) {
+            ii_wait = ii - 1;
+        } else if (ii_wait) {
+            ii_wait--;
+        }
+        ii_open.write(ii_wait == 0);
+        write_outputs();
+    }
+
+    // in_ready依赖下游的out_ready，是组合输出
+    void ready_process() {
+        in_ready.write(ii_open.read() && (!out_valid.read() || out_ready.read()));
+    }
+
+    SC_HAS_PROCESS(alu_pipelined);
+
+    // depth至少为1，ii至少为1
+    alu_pipelined(sc_module_name name, unsigned int depth = 3, unsigned int ii = 1)
+    : sc_module(name),
+      depth(depth ? depth : 1),
+      ii(ii ? ii : 1),
+      ii_open("ii_open", true),
+      ring(this->depth),
+      head(0),
+      occupied(0),
+      ii_wait(0) {
+        SC_METHOD(clock_process);
+        sensitive << clk.pos();
+        dont_initialize();
+
+        SC_METHOD(ready_process);
+        sensitive << ii_open << out_valid << out_ready;
+    }
+
+private:
+    sc_signal<bool> ii_open;        // 初始化间隔已满足
+    std::vector<stage> ring;        // 流水寄存器环，构造后不再改变大小
+    unsigned int head;              // 第0级所在的槽位
+    unsigned int occupied;          // 有效级数
+    unsigned int ii_wait;           // 距离下一次可以接收还要等待的周期数
+    counters stats;
+
+    // 第k级所在的槽位
+    unsigned int slot(unsigned int k) const {
+        unsigned int s = head + k;
+        return s >= depth ? s - depth : s;
+    }
+
+    void write_outputs() {
+        const stage& last = ring[slot(depth - 1)];
+        out_valid.write(last.valid);
+        result.write(last.result);
+        zero.write(last.zero);
+        overflow.write(last.overflow);
+        carry.write(last.carry);
+    }
+};
+
+#endif // ALU_PIPELINED_H
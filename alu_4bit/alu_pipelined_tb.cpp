@@ -0,0 +1,211 @@
+// File: alu_pipelined_tb.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <iomanip>
+#include <string>
+#include "alu_4bit.h"
+#include "alu_pipelined.h"
+#include "../common/stimulus.h"
+#include "../common/scoreboard.h"
+
+// 流水线ALU的一个结果
+struct alu_result {
+    int result;
+    bool zero;
+    bool overflow;
+    bool carry;
+
+    bool operator==(const alu_result& o) const {
+        return result == o.result && zero == o.zero && overflow == o.overflow && carry == o.carry;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const alu_result& r) {
+    return os << "{result=" << r.result << ", zero=" << r.zero
+              << ", overflow=" << r.overflow << ", carry=" << r.carry << "}";
+}
+
+// 测试平台：组合ALU alu_4bit接在同一组输入上作为参考模型，
+// 接收操作时取它的输出作为期望值，流水线送出结果时作为实际值，按顺序配对
+SC_MODULE(alu_pipelined_tb) {
+    sc_clock clk;
+    sc_signal<bool> rst_n;
+
+    sc_signal<bool> in_valid;
+    sc_signal<bool> in_ready;
+    sc_signal<sc_int<4>> A_sig;
+    sc_signal<sc_int<4>> B_sig;
+    sc_signal<sc_uint<3>> op_sig;
+
+    sc_signal<bool> out_valid;
+    sc_signal<bool> out_ready;
+    sc_signal<sc_int<4>> result_sig;
+    sc_signal<bool> zero_sig;
+    sc_signal<bool> overflow_sig;
+    sc_signal<bool> carry_sig;
+
+    // 参考模型的输出
+    sc_signal<sc_int<4>> ref_result;
+    sc_signal<bool> ref_zero;
+    sc_signal<bool> ref_overflow;
+    sc_signal<bool> ref_carry;
+
+    alu_pipelined dut;
+    alu_4bit reference;
+    scoreboard<alu_result> sb;
+
+    // 测试参数
+    const uint64_t operations;
+    const double valid_prob;
+    const double ready_prob;
+
+    uint64_t seed;
+    stim::alu_stimulus stimulus;
+    stim::philox_stream handshake;     // 握手信号的随机性使用单独的流
+    bool accepted;                     // 最近一个上升沿接收了当前输入
+    bool passed;
+
+    // 驱动进程：下降沿改变输入；已经发出的操作在被接收之前保持不变
+    void drive_process() {
+        rst_n.write(false);
+        in_valid.write(false);
+        out_ready.write(false);
+        for (int i = 0; i < 3; i++) {
+            wait(clk.negedge_event());
+        }
+        rst_n.write(true);
+
+        uint64_t sent = 0;
+        while (sent < operations) {
+            wait(clk.negedge_event());
+            // 上一个上升沿接收了操作，或者本来就没有发出
+            if (!in_valid.read() || accepted) {
+                accepted = false;
+                if (handshake.bernoulli(valid_prob)) {
+                    stim::alu_op op = stimulus.next();
+                    A_sig.write(op.a);
+                    B_sig.write(op.b);
+                    op_sig.write(op.op);
+                    in_valid.write(true);
+                    sent++;
+                } else {
+                    in_valid.write(false);
+                }
+            }
+            out_ready.write(handshake.bernoulli(ready_prob));
+        }
+
+        // 等待最后一个操作被接收，然后排空流水线
+        while (in_valid.read() && !accepted) {
+            wait(clk.negedge_event());
+        }
+        in_valid.write(false);
+        out_ready.write(true);
+        for (unsigned int i = 0; i < dut.depth + 2; i++) {
+            wait(clk.negedge_event());
+        }
+
+        report();
+        sc_stop();
+    }
+
+    // 监视进程：上升沿时与被测设计看到相同的握手信号
+    void monitor_process() {
+        if (!rst_n.read()) return;
+        if (in_valid.read() && in_ready.read()) {
+            sb.expect({ref_result.read().to_int(), ref_zero.read(), ref_overflow.read(), ref_carry.read()});
+            accepted = true;
+        }
+        if (out_valid.read() && out_ready.read()) {
+            sb.actual({result_sig.read().to_int(), zero_sig.read(), overflow_sig.read(), carry_sig.read()});
+        }
+    }
+
+    void report() {
+        const alu_pipelined::counters& c = dut.statistics();
+        std::cout << "\n===== 流水线ALU (深度 " << dut.depth << ", 初始化间隔 " << dut.ii
+                  << ", 种子 " << seed << ") =====\n"
+                  << "周期 " << c.cycles << ", 接收 " << c.issued << ", 送出 " << c.completed << "\n"
+                  << "停顿周期 " << c.stall_cycles << ", 受初始化间隔限制的周期 " << c.ii_wait_cycles << "\n"
+                  << std::fixed << std::setprecision(3)
+                  << "利用率 " << dut.utilization() << ", 吞吐率 " << dut.throughput() << " 结果/周期\n\n";
+        sb.report();
+        passed = sb.passed() && c.issued == operations && c.completed == operations;
+        if (passed) {
+            std::cout << "\n===== 流水线ALU测试通过 =====\n";
+        } else {
+            std::cout << "\n===== 流水线ALU测试失败 =====\n";
+        }
+    }
+
+    SC_HAS_PROCESS(alu_pipelined_tb);
+
+    alu_pipelined_tb(sc_module_name name, unsigned int depth, unsigned int ii,
+                     uint64_t operations, uint64_t seed)
+    : sc_module(name),
+      clk("clk", 10, SC_NS),
+      dut("dut", depth, ii),
+      reference("reference"),
+      sb("alu.pipelined", 4 * depth + 4),
+      operations(operations),
+      valid_prob(0.8),
+      ready_prob(0.7),
+      seed(seed),
+      stimulus(seed),
+      handshake(seed, stim::STREAM_USER),
+      accepted(false),
+      passed(false) {
+        dut.clk(clk);
+        dut.rst_n(rst_n);
+        dut.in_valid(in_valid);
+        dut.in_ready(in_ready);
+        dut.A(A_sig);
+        dut.B(B_sig);
+        dut.op(op_sig);
+        dut.out_valid(out_valid);
+        dut.out_ready(out_ready);
+        dut.result(result_sig);
+        dut.zero(zero_sig);
+        dut.overflow(overflow_sig);
+        dut.carry(carry_sig);
+
+        reference.A(A_sig);
+        reference.B(B_sig);
+        reference.op(op_sig);
+        reference.result(ref_result);
+        reference.zero(ref_zero);
+        reference.overflow(ref_overflow);
+        reference.carry(ref_carry);
+
+        SC_THREAD(drive_process);
+
+        SC_METHOD(monitor_process);
+        sensitive << clk.posedge_event();
+        dont_initialize();
+    }
+};
+
+// 用法: alu_pipelined_tb [深度] [初始化间隔] [操作数] [随机种子]
+int sc_main(int argc, char* argv[]) {
+    unsigned int depth = argc > 1 ? std::stoul(argv[1]) : 3;
+    unsigned int ii = argc > 2 ? std::stoul(argv[2]) : 1;
+    uint64_t operations = argc > 3 ? std::stoull(argv[3]) : 10000;
+    uint64_t seed = argc > 4 ? std::stoull(argv[4]) : 1;
+    alu_pipelined_tb tb("alu_pipelined_testbench", depth, ii, operations, seed);
+    sc_start();
+    return tb.passed ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+# Shared build configuration
+# Copyright (C) 2025  ZhaoCake
+
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# 各SystemC实验目录共用的编译配置，由各目录的Makefile在开头include。
+# 下面的变量都可以在命令行上设置，顶层make会把它们传给子目录：
+#   MODE=debug|release|pgo-gen|pgo|asan|tsan
+#                        debug不加优化（原先的编译方式）；release为-O3和LTO；
+#                        pgo-gen/pgo是PGO的插桩和优化两步（一般通过顶层的make pgo使用）；
+#                        asan为AddressSanitizer和UBSan；tsan为ThreadSanitizer
+#   NATIVE=1             release之外再加-march=native，生成的程序只能在本机运行
+#   DATATYPES=native     模型内部改用原生整数（-DNATIVE_DATATYPES，见common/datatypes.h），
+#                        产物放在构建目录名加-native的目录中
+#   PCH=0                不使用systemc.h的预编译头
+#   MODELS_LIB=0         不链接模型静态库，各测试平台自己实例化模型模板
+
+ROOT_DIR := $(abspath $(dir $(lastword $(MAKEFILE_LIST))))
+
+MODE ?= debug
+NATIVE ?= 0
+PCH ?= 1
+MODELS_LIB ?= 1
+
+# 不同模式的产物放在不同的构建目录，切换模式不需要make clean。
+# PGO的两步共用build-pgo/：.gcda按目标文件的路径命名，插桩构建生成的剖面要在同一位置被优化构建读到
+RELEASE_CXXFLAGS = -O3 -flto=auto
+RELEASE_BUILD_ROOT = $(ROOT_DIR)/build-release
+PGO_BUILD_ROOT = $(ROOT_DIR)/build-pgo
+ifeq ($(MODE),debug)
+BUILD_ROOT ?= $(ROOT_DIR)/build
+MODE_CXXFLAGS =
+else ifeq ($(MODE),release)
+BUILD_ROOT ?= $(RELEASE_BUILD_ROOT)
+MODE_CXXFLAGS = $(RELEASE_CXXFLAGS)
+else ifeq ($(MODE),pgo-gen)
+# 记录剖面写日志线程和仿真线程会同时更新计数器，用原子更新
+BUILD_ROOT ?= $(PGO_BUILD_ROOT)
+MODE_CXXFLAGS = $(RELEASE_CXXFLAGS) -fprofile-generate -fprofile-update=atomic
+else ifeq ($(MODE),pgo)
+# 没有参与训练的程序没有剖面，按release处理（-fprofile-partial-training）
+BUILD_ROOT ?= $(PGO_BUILD_ROOT)
+MODE_CXXFLAGS = $(RELEASE_CXXFLAGS) -fprofile-use -fprofile-partial-training -Wno-missing-profile
+else ifeq ($(MODE),asan)
+BUILD_ROOT ?= $(ROOT_DIR)/build-asan
+MODE_CXXFLAGS = -O1 -g -fno-omit-frame-pointer -fsanitize=address,undefined -fno-sanitize-recover=undefined
+else ifeq ($(MODE),tsan)
+BUILD_ROOT ?= $(ROOT_DIR)/build-tsan
+MODE_CXXFLAGS = -O1 -g -fsanitize=thread
+else
+$(error 未知的构建模式 MODE=$(MODE)，可选debug、release、pgo-gen、pgo、asan、tsan)
+endif
+
+ifeq ($(NATIVE),1)
+MODE_CXXFLAGS += -march=native
+endif
+
+ifeq ($(DATATYPES),native)
+BUILD_ROOT := $(BUILD_ROOT)-native
+MODE_CXXFLAGS += -DNATIVE_DATATYPES
+endif
+
+# 黄金输出回归：参考日志的保存目录（与构建模式无关，不同模式的构建可以互相比较）和比较工具
+GOLDEN_DIR ?= $(ROOT_DIR)/build/golden
+TXN_DIFF = $(BUILD_ROOT)/common/txn_diff
+
+# 编译器和标志
+CXX = g++
+AR = gcc-ar
+BASE_CXXFLAGS = -std=c++17 -Wall -I/usr/include
+SYSTEMC_LDFLAGS = -L/usr/lib -lsystemc -pthread -Wl,-rpath,/usr/lib
+
+# 模型静态库：register_file_t、ram_t、alu_4bit_t和fifo<int, 8>在库中实例化一次，
+# 定义SC_MODELS_LIB后各头文件用extern template声明这些实例，使用它们的测试平台不再重复编译
+MODELS_LIB_FILE = $(BUILD_ROOT)/models/libscmodels.a
+ifeq ($(MODELS_LIB),1)
+LIB_CXXFLAGS = -DSC_MODELS_LIB
+LIB_LDFLAGS = $(MODELS_LIB_FILE)
+LIB_DEPS = $(MODELS_LIB_FILE)
+endif
+
+# systemc.h的预编译头：common/systemc_pch.h复制到构建目录后编译成.gch，
+# 编译时用-include强制最先包含它，源文件里的#include <systemc.h>因为头文件保护不再展开。
+# .gch与编译选项不匹配时g++退回到直接解析头文件，-Winvalid-pch会给出提示
+PCH_DIR = $(BUILD_ROOT)/pch
+PCH_HEADER = $(PCH_DIR)/systemc_pch.h
+PCH_GCH = $(PCH_HEADER).gch
+ifeq ($(PCH),1)
+PCH_CXXFLAGS = -include $(PCH_HEADER) -Winvalid-pch
+PCH_DEPS = $(PCH_GCH)
+endif
+
+# -MMD -MP生成头文件依赖，修改模型头文件后用到它的目标文件会重新编译
+DEP_CXXFLAGS = -MMD -MP
+
+CXXFLAGS = $(BASE_CXXFLAGS) $(MODE_CXXFLAGS) $(LIB_CXXFLAGS) $(PCH_CXXFLAGS) $(DEP_CXXFLAGS)
+LDFLAGS = $(LIB_LDFLAGS) $(SYSTEMC_LDFLAGS)
+
+# 目标文件编译前需要准备好的预编译头和模型库（作为order-only依赖）
+BUILD_DEPS = $(PCH_DEPS) $(LIB_DEPS)
+
+# include本文件的Makefile仍以all为默认目标
+.DEFAULT_GOAL := all
+
+$(PCH_HEADER): $(ROOT_DIR)/common/systemc_pch.h
+	@mkdir -p $(PCH_DIR)
+	cp $< $@
+
+$(PCH_GCH): $(PCH_HEADER)
+	$(CXX) $(BASE_CXXFLAGS) $(MODE_CXXFLAGS) $(LIB_CXXFLAGS) -x c++-header $< -o $@
+
+# 单独在某个目录make时也会先构建模型库，库本身的依赖由models/Makefile判断。
+# 顶层make已经先构建好了库，并行构建各目录时传入MODELS_LIB_READY=1，避免各目录同时进入models
+ifndef MODELS_LIB_READY
+.PHONY: FORCE
+$(MODELS_LIB_FILE): FORCE | $(PCH_DEPS)
+	@$(MAKE) --no-print-directory -C $(ROOT_DIR)/models BUILD_DIR=$(BUILD_ROOT)/models
+endif
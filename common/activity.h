@@ -0,0 +1,408 @@
+// File: activity.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ACTIVITY_H
+#define ACTIVITY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 开关活动统计与能量估算
+// 每个端口、每组存储单元一个计数项，值改变时累加新旧值异或后的1的个数（翻转位数），
+// 采样只是一次异或、一次popcount和一次加法。能量按"每个事件的能量"表折算，
+// 按时间窗口输出每个模块的能量；窗口记录交给后台线程写文件，仿真线程不等待磁盘。
+namespace pwr {
+
+inline unsigned int toggles(uint64_t old_bits, uint64_t new_bits) {
+    return __builtin_popcountll(old_bits ^ new_bits);
+}
+
+// 一个模块实例的活动计数
+class activity {
+public:
+    activity(const std::string& kind, const std::string& instance)
+    : kind_(kind), instance_(instance) {}
+
+    // 增加一个计数项，返回下标
+    unsigned int add(const std::string& counter) {
+        names_.push_back(counter);
+        counts_.push_back(0);
+        return counts_.size() - 1;
+    }
+
+    // 端口或存储单元从old_bits变为new_bits
+    void toggle(unsigned int c, uint64_t old_bits, uint64_t new_bits) {
+        counts_[c] += toggles(old_bits, new_bits);
+    }
+
+    // 非翻转类事件，例如时钟沿、一次写入
+    void count(unsigned int c, uint64_t n = 1) {
+        counts_[c] += n;
+    }
+
+    const std::string& kind() const { return kind_; }
+    const std::string& instance() const { return instance_; }
+    const std::vector<std::string>& counter_names() const { return names_; }
+    const std::vector<uint64_t>& counts() const { return counts_; }
+
+private:
+    std::string kind_;        // 模块类型，用于查能量表，例如"register_file"
+    std::string instance_;    // 实例名
+    std::vector<std::string> names_;
+    std::vector<uint64_t> counts_;
+};
+
+// 每个事件的能量（pJ），按"模块类型.计数项"配置，同一类型的所有实例共用
+class energy_table {
+public:
+    explicit energy_table(double default_pj = 0.01) : default_pj_(default_pj) {}
+
+    void set(const std::string& kind, const std::string& counter, double pj) {
+        table_[kind + "." + counter] = pj;
+    }
+
+    // 依次查"类型.计数项"、去掉下标的"类型.存储名"（如"ram.mem[3]"查"ram.mem"）、
+    // "类型.*"，都没有时用默认值
+    double get(const std::string& kind, const std::string& counter) const {
+        auto it = table_.find(kind + "." + counter);
+        size_t bracket = counter.find('[');
+        if (it == table_.end() && bracket != std::string::npos) it = table_.find(kind + "." + counter.substr(0, bracket));
+        if (it == table_.end()) it = table_.find(kind + ".*");
+        return it == table_.end() ? default_pj_ : it->second;
+    }
+
+    void set_default(double pj) { default_pj_ = pj; }
+
+    // 每行"模块类型.计数项 能量(pJ)"，"#"之后为注释，"default 能量"设置默认值
+    bool load(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) return false;
+        std::string line;
+        while (std::getline(in, line)) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream ls(line);
+            std::string key;
+            double pj;
+            if (!(ls >> key)) continue;
+            if (!(ls >> pj)) return false;
+            if (key == "default") {
+                default_pj_ = pj;
+            } else {
+                table_[key] = pj;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::map<std::string, double> table_;
+    double default_pj_;
+};
+
+// 一个窗口中一个计数项（或一个模块合计）的记录，二进制文件中按此布局存放
+struct window_record {
+    uint64_t window;       // 窗口编号
+    uint64_t end_ps;       // 窗口结束时刻（ps）
+    uint32_t module;       // 模块编号（注册顺序）
+    uint32_t counter;      // 计数项编号，TOTAL表示模块合计
+    uint64_t events;       // 窗口内的事件数（翻转位数）
+    double energy_pj;      // 窗口内的能量
+
+    static const uint32_t TOTAL = 0xFFFFFFFFu;
+};
+static_assert(sizeof(window_record) == 40, "window_record布局必须固定");
+
+enum class format { csv, binary };
+
+// 后台写文件：仿真线程把记录追加到当前块，块满后在锁内交给写线程，
+// 每块只加锁一次。写得慢时已满的块排队等待，不阻塞仿真线程
+class record_writer {
+public:
+    static const size_t CHUNK = 4096;
+
+    record_writer() : file_(nullptr), fmt_(format::csv), stop_(false), written_(0), chunks_(0) {}
+    ~record_writer() { close(); }
+
+    // names[m]为模块m的"类型 实例名"，counters[m]为其计数项名，用于CSV列和二进制文件头
+    bool open(const std::string& path, format fmt,
+              const std::vector<std::string>& names,
+              const std::vector<std::vector<std::string>>& counters) {
+        close();
+        file_ = std::fopen(path.c_str(), fmt == format::binary ? "wb" : "w");
+        if (!file_) return false;
+        fmt_ = fmt;
+        names_ = names;
+        counters_ = counters;
+        stop_ = false;
+        written_ = 0;
+        chunks_ = 0;
+        write_header();
+        cur_.reserve(CHUNK);
+        thread_ = std::thread([this] { run(); });
+        return true;
+    }
+
+    bool is_open() const { return file_ != nullptr; }
+
+    void push(const window_record& r) {
+        cur_.push_back(r);
+        if (cur_.size() >= CHUNK) flush();
+    }
+
+    // 把当前块交给写线程（不等待写完）
+    void flush() {
+        if (cur_.empty()) return;
+        std::vector<window_record> next;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            full_.push_back(std::move(cur_));
+            if (!spare_.empty()) {
+                next = std::move(spare_.back());
+                spare_.pop_back();
+            }
+            chunks_++;
+        }
+        cv_.notify_one();
+        cur_ = std::move(next);
+        cur_.clear();
+        cur_.reserve(CHUNK);
+    }
+
+    // 写完全部记录后关闭文件
+    void close() {
+        if (!file_) return;
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    uint64_t written() const { return written_; }
+    uint64_t chunks() const { return chunks_; }
+
+private:
+    std::FILE* file_;
+    format fmt_;
+    std::vector<std::string> names_;
+    std::vector<std::vector<std::string>> counters_;
+
+    std::vector<window_record> cur_;                  // 仿真线程正在填充的块
+    std::deque<std::vector<window_record>> full_;     // 等待写出的块
+    std::vector<std::vector<window_record>> spare_;   // 写完回收的块
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    bool stop_;
+    std::atomic<uint64_t> written_;    // 只由写线程修改
+    uint64_t chunks_;
+
+    static void write_u32(std::FILE* f, uint32_t v) {
+        std::fwrite(&v, sizeof(v), 1, f);
+    }
+
+    static void write_string(std::FILE* f, const std::string& s) {
+        write_u32(f, s.size());
+        std::fwrite(s.data(), 1, s.size(), f);
+    }
+
+    // CSV：一行表头；二进制：魔数、模块及计数项名字表，之后是定长记录
+    void write_header() {
+        if (fmt_ == format::csv) {
+            std::fputs("window,end_ps,module,counter,events,energy_pj\n", file_);
+            return;
+        }
+        std::fwrite("SCPWR001", 1, 8, file_);
+        write_u32(file_, names_.size());
+        for (size_t m = 0; m < names_.size(); m++) {
+            write_string(file_, names_[m]);
+            write_u32(file_, counters_[m].size());
+            for (const std::string& c : counters_[m]) write_string(file_, c);
+        }
+    }
+
+    void write_chunk(const std::vector<window_record>& chunk) {
+        if (fmt_ == format::binary) {
+            std::fwrite(chunk.data(), sizeof(window_record), chunk.size(), file_);
+        } else {
+            for (const window_record& r : chunk) {
+                const char* counter = r.counter == window_record::TOTAL ? "total" : counters_[r.module][r.counter].c_str();
+                std::fprintf(file_, "%llu,%llu,%s,%s,%llu,%.6g\n",
+                             (unsigned long long)r.window, (unsigned long long)r.end_ps,
+                             names_[r.module].c_str(), counter,
+                             (unsigned long long)r.events, r.energy_pj);
+            }
+        }
+        written_ += chunk.size();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            cv_.wait(lock, [this] { return stop_ || !full_.empty(); });
+            if (full_.empty()) break;
+            std::vector<window_record> chunk = std::move(full_.front());
+            full_.pop_front();
+            lock.unlock();
+            write_chunk(chunk);
+            chunk.clear();
+            lock.lock();
+            spare_.push_back(std::move(chunk));
+        }
+    }
+};
+
+// 全部模块的活动计数、能量表和窗口输出
+class power_report {
+public:
+    explicit power_report(const energy_table& table = energy_table())
+    : table_(table), window_(0), last_end_ps_(0), per_counter_(false), finished_(false) {}
+
+    // 注册一个模块实例，返回的引用在之后继续注册时仍然有效
+    activity& add_module(const std::string& kind, const std::string& instance) {
+        modules_.emplace_back(kind, instance);
+        return modules_.back();
+    }
+
+    energy_table& table() { return table_; }
+
+    // 打开窗口输出文件，应在全部模块注册之后、仿真开始之前调用。
+    // per_counter为true时每个计数项一行，否则每个模块只输出合计
+    bool open(const std::string& path, format fmt = format::csv, bool per_counter = false) {
+        std::vector<std::string> names;
+        std::vector<std::vector<std::string>> counters;
+        for (const activity& a : modules_) {
+            names.push_back(a.kind() + " " + a.instance());
+            counters.push_back(a.counter_names());
+        }
+        per_counter_ = per_counter;
+        return writer_.open(path, fmt, names, counters);
+    }
+
+    // 结束当前窗口：计算各计数项自上个窗口以来的增量并折算能量
+    void close_window(uint64_t end_ps) {
+        if (finished_) return;
+        resolve();
+        for (uint32_t m = 0; m < modules_.size(); m++) {
+            const std::vector<uint64_t>& counts = modules_[m].counts();
+            std::vector<uint64_t>& last = last_[m];
+            const std::vector<double>& pj = pj_[m];
+            window_record total = {window_, end_ps, m, window_record::TOTAL, 0, 0.0};
+            for (uint32_t c = 0; c < counts.size(); c++) {
+                uint64_t delta = counts[c] - last[c];
+                last[c] = counts[c];
+                double e = delta * pj[c];
+                total.events += delta;
+                total.energy_pj += e;
+                energy_[m][c] += e;
+                if (per_counter_ && writer_.is_open()) {
+                    writer_.push(window_record{window_, end_ps, m, c, delta, e});
+                }
+            }
+            if (writer_.is_open()) writer_.push(total);
+        }
+        window_++;
+        last_end_ps_ = end_ps;
+    }
+
+    // 结束最后一个窗口并关闭输出文件，可以重复调用
+    void finish(uint64_t end_ps) {
+        if (finished_) return;
+        if (end_ps > last_end_ps_ || window_ == 0) close_window(end_ps);
+        writer_.close();
+        finished_ = true;
+    }
+
+    // 各模块的总能量和平均功率，以及能量最大的几个计数项
+    void summary(std::ostream& os = std::cout) const {
+        double seconds = last_end_ps_ * 1e-12;
+        double all = 0.0;
+        os << "[能量估算] " << modules_.size() << " 个模块, " << window_ << " 个窗口";
+        if (writer_.written()) os << ", 写出 " << writer_.written() << " 条记录";
+        os << "\n";
+        for (size_t m = 0; m < modules_.size(); m++) {
+            const activity& a = modules_[m];
+            double e = 0.0;
+            size_t top = 0;
+            for (size_t c = 0; c < a.counts().size(); c++) {
+                if (m < energy_.size()) {
+                    e += energy_[m][c];
+                    if (energy_[m][c] > energy_[m][top]) top = c;
+                }
+            }
+            all += e;
+            os << "    " << std::left << std::setw(16) << a.kind() << std::setw(20) << a.instance() << std::right
+               << std::fixed << std::setprecision(2) << std::setw(12) << e << " pJ";
+            if (seconds > 0) os << std::setw(10) << std::setprecision(3) << e * 1e-12 / seconds * 1e6 << " uW";
+            if (!a.counts().empty() && m < energy_.size()) {
+                os << "  最大: " << a.counter_names()[top] << " (" << a.counts()[top] << " 次)";
+            }
+            os << "\n";
+        }
+        os << "    合计 " << std::fixed << std::setprecision(2) << all << " pJ";
+        if (seconds > 0) os << ", 平均 " << std::setprecision(3) << all * 1e-12 / seconds * 1e6 << " uW";
+        os << "\n";
+    }
+
+    const std::deque<activity>& modules() const { return modules_; }
+    uint64_t windows() const { return window_; }
+
+private:
+    std::deque<activity> modules_;
+    energy_table table_;
+    record_writer writer_;
+
+    // 按模块、计数项展开的能量系数、上个窗口的计数和累计能量
+    std::vector<std::vector<double>> pj_;
+    std::vector<std::vector<uint64_t>> last_;
+    std::vector<std::vector<double>> energy_;
+    uint64_t window_;
+    uint64_t last_end_ps_;
+    bool per_counter_;
+    bool finished_;
+
+    // 第一次结束窗口时查表，之后窗口内只做乘加
+    void resolve() {
+        while (pj_.size() < modules_.size()) {
+            const activity& a = modules_[pj_.size()];
+            std::vector<double> pj;
+            for (const std::string& c : a.counter_names()) pj.push_back(table_.get(a.kind(), c));
+            pj_.push_back(pj);
+            last_.push_back(std::vector<uint64_t>(pj.size(), 0));
+            energy_.push_back(std::vector<double>(pj.size(), 0.0));
+        }
+    }
+};
+
+} // namespace pwr
+
+#endif // ACTIVITY_H
@@ -0,0 +1,223 @@
+// File: activity_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "activity.h"
+#include "stimulus.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    std::cout << "  " << (ok ? "通过: " : "失败: ") << what << std::endl;
+    if (!ok) failures++;
+}
+
+static unsigned int naive_toggles(uint64_t a, uint64_t b) {
+    unsigned int n = 0;
+    for (int i = 0; i < 64; i++) n += ((a >> i) & 1) != ((b >> i) & 1);
+    return n;
+}
+
+static uint32_t read_u32(std::FILE* f) {
+    uint32_t v = 0;
+    if (std::fread(&v, sizeof(v), 1, f) != 1) return 0;
+    return v;
+}
+
+static std::string read_string(std::FILE* f) {
+    std::string s(read_u32(f), '\0');
+    if (!s.empty() && std::fread(&s[0], 1, s.size(), f) != s.size()) return "";
+    return s;
+}
+
+// 翻转计数、能量表、窗口增量以及CSV/二进制输出的自检
+static void self_check() {
+    std::cout << "\n===== 能量估算自检 =====\n";
+
+    stim::philox_stream rng(1, stim::STREAM_USER);
+    bool ok = true;
+    for (int i = 0; i < 100000 && ok; i++) {
+        uint64_t a = rng.next_u64(), b = rng.next_u64();
+        ok = pwr::toggles(a, b) == naive_toggles(a, b);
+    }
+    check(ok, "翻转位数与逐位比较一致");
+
+    const char* cfg = "/tmp/activity_bench.cfg";
+    {
+        std::ofstream out(cfg);
+        out << "# 测试用能量表\n"
+            << "default 0.5\n"
+            << "alu_4bit.result 2.0   # 结果端口\n"
+            << "alu_4bit.* 1.0\n"
+            << "ram.mem 0.25\n";
+    }
+    pwr::energy_table table;
+    check(table.load(cfg), "读入能量表");
+    check(table.get("alu_4bit", "result") == 2.0 && table.get("alu_4bit", "A") == 1.0 &&
+          table.get("ram", "addr") == 0.5 && table.get("ram", "mem[3]") == 0.25,
+          "能量表按计数项、存储名、类型通配、默认值的顺序查找");
+    std::remove(cfg);
+
+    // 两个模块、三个窗口，检查增量、能量和两种文件格式
+    const char* csv = "/tmp/activity_bench.csv";
+    const char* bin = "/tmp/activity_bench.bin";
+    for (int pass = 0; pass < 2; pass++) {
+        pwr::power_report report(table);
+        pwr::activity& alu = report.add_module("alu_4bit", "alu");
+        unsigned int a = alu.add("A");
+        unsigned int r = alu.add("result");
+        pwr::activity& mem = report.add_module("ram", "mem");
+        unsigned int w = mem.add("write");
+        bool opened = pass == 0 ? report.open(csv, pwr::format::csv, true)
+                                : report.open(bin, pwr::format::binary, true);
+        check(opened, pass == 0 ? "打开CSV输出" : "打开二进制输出");
+
+        alu.toggle(a, 0x0, 0xF);       // 4
+        alu.toggle(r, 0x3, 0x1);       // 1
+        report.close_window(1000);
+        mem.count(w, 3);
+        report.close_window(2000);
+        alu.toggle(a, 0xF, 0xE);       // 1
+        report.finish(3000);
+        report.finish(4000);           // 重复调用不再输出
+
+        if (pass == 0) {
+            std::ifstream in(csv);
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(in, line)) lines.push_back(line);
+            // 表头 + 3个窗口 x (ALU 2项+合计, RAM 1项+合计)
+            check(lines.size() == 1 + 3 * 5, "CSV行数");
+            check(lines.size() > 3 && lines[3] == "0,1000,alu_4bit alu,total,5,6", "CSV第一个窗口的ALU合计");
+            check(lines.size() > 10 && lines[10] == "1,2000,ram mem,total,3,1.5", "CSV第二个窗口的RAM合计");
+        } else {
+            std::FILE* f = std::fopen(bin, "rb");
+            char magic[8] = {0};
+            bool header = f && std::fread(magic, 1, 8, f) == 8 && std::string(magic, 8) == "SCPWR001" &&
+                          read_u32(f) == 2 && read_string(f) == "alu_4bit alu" && read_u32(f) == 2 &&
+                          read_string(f) == "A" && read_string(f) == "result" &&
+                          read_string(f) == "ram mem" && read_u32(f) == 1 && read_string(f) == "write";
+            check(header, "二进制文件头（魔数和名字表）");
+            std::vector<pwr::window_record> recs;
+            pwr::window_record rec;
+            while (f && std::fread(&rec, sizeof(rec), 1, f) == 1) recs.push_back(rec);
+            if (f) std::fclose(f);
+            double total = 0.0;
+            for (const pwr::window_record& x : recs) {
+                if (x.counter == pwr::window_record::TOTAL) total += x.energy_pj;
+            }
+            check(recs.size() == 15 && recs[14].window == 2 && recs[14].end_ps == 3000, "二进制记录数和最后一个窗口");
+            check(total == 4 * 1.0 + 1 * 2.0 + 3 * 0.5 + 1 * 1.0, "各窗口合计能量之和");
+        }
+    }
+    std::remove(csv);
+    std::remove(bin);
+}
+
+// 采样代价：随机值序列上的一次翻转计数
+static void measure_sampling(uint64_t n) {
+    std::vector<uint64_t> values(1 << 16);
+    stim::philox_stream rng(2, stim::STREAM_USER);
+    for (uint64_t& v : values) v = rng.next_u32() & 0xFF;
+
+    pwr::activity act("bench", "bench");
+    unsigned int c = act.add("port");
+    uint64_t last = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t v = values[i & 0xFFFF];
+        if (v != last) {
+            act.toggle(c, last, v);
+            last = v;
+        }
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "  每次采样 " << std::fixed << std::setprecision(2) << (s / n * 1e9) << " ns, 平均每次翻转 "
+              << double(act.counts()[c]) / n << " 位\n";
+}
+
+// 窗口输出对仿真线程的代价：后台写出与在仿真线程中直接写CSV对比
+static void measure_windows(unsigned int modules, unsigned int windows) {
+    const char* path = "/tmp/activity_bench_windows.csv";
+    pwr::power_report report;
+    std::vector<pwr::activity*> acts;
+    for (unsigned int m = 0; m < modules; m++) {
+        pwr::activity& a = report.add_module("bench", "m" + std::to_string(m));
+        for (int c = 0; c < 8; c++) a.add("c" + std::to_string(c));
+        acts.push_back(&a);
+    }
+    report.open(path, pwr::format::csv, true);
+
+    double async_s = 0.0;
+    for (unsigned int w = 0; w < windows; w++) {
+        for (pwr::activity* a : acts) {
+            for (unsigned int c = 0; c < 8; c++) a->count(c, w + c);
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        report.close_window((w + 1) * 10000ull);
+        async_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    report.finish(windows * 10000ull);
+    double drain_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+
+    // 同样的记录在仿真线程中直接fprintf
+    std::FILE* f = std::fopen(path, "w");
+    auto t2 = std::chrono::steady_clock::now();
+    for (unsigned int w = 0; w < windows; w++) {
+        for (unsigned int m = 0; m < modules; m++) {
+            for (unsigned int c = 0; c <= 8; c++) {
+                std::fprintf(f, "%u,%llu,bench m%u,c%u,%u,%.6g\n", w, (w + 1) * 10000ull, m, c, w + c, 0.01 * (w + c));
+            }
+        }
+    }
+    double sync_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t2).count();
+    std::fclose(f);
+    std::remove(path);
+
+    uint64_t records = uint64_t(modules) * windows * 9;
+    std::cout << "  " << modules << " 个模块 x 8 项, " << windows << " 个窗口, " << records << " 条记录\n"
+              << std::fixed << std::setprecision(1)
+              << "  后台写出: 仿真线程每个窗口 " << async_s / windows * 1e6 << " us, 结束时等待写完 "
+              << drain_s * 1e3 << " ms\n"
+              << "  同步写出: 仿真线程每个窗口 " << sync_s / windows * 1e6 << " us\n";
+}
+
+// 用法: activity_bench [采样次数]
+int main(int argc, char* argv[]) {
+    uint64_t n = argc > 1 ? std::stoull(argv[1]) : 100000000ull;
+
+    self_check();
+
+    std::cout << "\n===== 采样代价 (" << n << "次) =====\n";
+    measure_sampling(n);
+
+    std::cout << "\n===== 窗口输出代价 =====\n";
+    measure_windows(1000, 200);
+
+    if (failures) {
+        std::cout << "\n===== 能量估算自检失败 (" << failures << "项) =====\n";
+        return 1;
+    }
+    std::cout << "\n===== 能量估算自检通过 =====\n";
+    return 0;
+}
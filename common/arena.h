@@ -0,0 +1,83 @@
+// File: arena.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/mman.h>
+
+// 单调内存区：预留一段连续的虚拟地址，从低到高顺序切分。
+// - 分配只是对齐后移动指针；同一阶段创建的对象在地址上相邻，十万个小对象也只有一段映射
+// - 只有实际写到的页才占用物理内存，所以可以预留得很大（MAP_NORESERVE，不计入提交量）
+// - 单个对象不能释放；reset()把全部页归还给系统并从头开始，析构时解除映射
+// - 自身不使用operator new，可以用来实现全局operator new（见netlist_elab/elab_heap.h）
+// - 不加锁，多个线程共用一个arena时由调用者串行化
+class arena {
+public:
+    static const size_t DEFAULT_RESERVE = size_t(1) << 34;     // 16 GiB地址空间
+
+    explicit arena(size_t reserve = DEFAULT_RESERVE) : base_(0), top_(0), end_(0), allocations_(0) {
+        void* p = mmap(nullptr, reserve, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p != MAP_FAILED) {
+            base_ = top_ = reinterpret_cast<uintptr_t>(p);
+            end_ = base_ + reserve;
+        }
+    }
+
+    ~arena() {
+        if (base_) munmap(reinterpret_cast<void*>(base_), end_ - base_);
+    }
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    // 预留空间用完（或预留失败）时返回nullptr，由调用者退回到普通堆
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        uintptr_t p = (top_ + align - 1) & ~uintptr_t(align - 1);
+        if (!base_ || p > end_ || bytes > end_ - p) return nullptr;
+        top_ = p + bytes;
+        allocations_++;
+        return reinterpret_cast<void*>(p);
+    }
+
+    bool owns(const void* p) const {
+        uintptr_t a = reinterpret_cast<uintptr_t>(p);
+        return a >= base_ && a < end_;
+    }
+
+    // 丢弃全部对象：之前分配的指针全部失效
+    void reset() {
+        if (top_ > base_) madvise(reinterpret_cast<void*>(base_), top_ - base_, MADV_DONTNEED);
+        top_ = base_;
+        allocations_ = 0;
+    }
+
+    bool valid() const { return base_ != 0; }
+    size_t used() const { return top_ - base_; }
+    size_t reserved() const { return end_ - base_; }
+    size_t allocations() const { return allocations_; }
+
+private:
+    uintptr_t base_;
+    uintptr_t top_;
+    uintptr_t end_;
+    size_t allocations_;
+};
+
+#endif // ARENA_H
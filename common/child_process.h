@@ -0,0 +1,156 @@
+// File: child_process.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef CHILD_PROCESS_H
+#define CHILD_PROCESS_H
+
+#include <cerrno>
+#include <iostream>
+#include <map>
+#include <type_traits>
+#include <vector>
+#include <limits.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// 在子进程中运行一段仿真，结果经管道传回父进程。
+//
+// SystemC的仿真内核（sc_simcontext）是进程内全局唯一的：一个进程只能例化一次，
+// sc_start之后不能再创建模块，也不能回到初始状态。需要多次例化（不同的实现、参数、
+// 注入率、随机种子）的基准因此在创建任何SystemC对象之前fork，每次例化在一个子进程中
+// 完成，父进程只收集结果。结果类型必须可以按字节复制，并且不超过PIPE_BUF，
+// 这样子进程一次write就能写完，不会在父进程读取之前阻塞。
+namespace child {
+
+// 一个运行中的子进程
+struct handle {
+    pid_t pid = -1;
+    int fd = -1;        // 读取结果的管道
+};
+
+// fork一个子进程执行fn()并写回它的返回值；pipe或fork失败时返回false，没有子进程
+template<typename Result, typename Fn>
+bool start(Fn&& fn, handle& h) {
+    static_assert(std::is_trivially_copyable<Result>::value, "结果必须可以按字节复制");
+    static_assert(sizeof(Result) <= PIPE_BUF, "结果必须能一次写入管道");
+    int fd[2];
+    if (pipe(fd) != 0) return false;
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fd[0]);
+        close(fd[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fd[0]);
+        Result r = fn();
+        std::cout.flush();
+        ssize_t written = write(fd[1], &r, sizeof(r));
+        _exit(written == ssize_t(sizeof(r)) ? 0 : 1);
+    }
+    close(fd[1]);
+    h.pid = pid;
+    h.fd = fd[0];
+    return true;
+}
+
+// 读取结果并回收子进程；子进程异常退出或没有写回完整的结果时返回false
+template<typename Result>
+bool finish(handle& h, Result& result) {
+    ssize_t got = read(h.fd, &result, sizeof(result));
+    close(h.fd);
+    int status = 0;
+    waitpid(h.pid, &status, 0);
+    h = handle();
+    return got == ssize_t(sizeof(result)) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// 子进程已经被waitpid回收（退出状态为status）后读取结果并关闭管道
+template<typename Result>
+bool collect(handle& h, int status, Result& result) {
+    ssize_t got = read(h.fd, &result, sizeof(result));
+    close(h.fd);
+    h = handle();
+    return got == ssize_t(sizeof(result)) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// 杀死并回收子进程，用于其余子进程无法启动、已启动的也不能正常结束的情形
+inline void stop(handle& h) {
+    kill(h.pid, SIGKILL);
+    close(h.fd);
+    waitpid(h.pid, nullptr, 0);
+    h = handle();
+}
+
+// 在一个子进程中运行fn()，等待它结束并取回结果
+template<typename Result, typename Fn>
+bool run_in_child(Fn&& fn, Result& result) {
+    handle h;
+    return start<Result>(fn, h) && finish(h, result);
+}
+
+// 以最多jobs个子进程并行运行count个任务：fn(i)在子进程中运行第i个任务，
+// done(i, result)在父进程中按完成的顺序调用。无法启动新的子进程时，
+// 先等已经启动的结束并回收再返回false；有任务失败时其余任务照常运行，最后返回false
+template<typename Result, typename Fn, typename Done>
+bool run_parallel(unsigned int count, unsigned int jobs, Fn&& fn, Done&& done) {
+    std::map<pid_t, std::pair<int, unsigned int>> active;    // pid -> (管道, 任务编号)
+    unsigned int launched = 0;
+    bool ok = true;
+
+    while (launched < count || !active.empty()) {
+        while (launched < count && active.size() < jobs) {
+            unsigned int i = launched;
+            handle h;
+            if (!start<Result>([&fn, i]() { return fn(i); }, h)) {
+                for (auto& a : active) {
+                    handle rest{a.first, a.second.first};
+                    Result ignored;
+                    finish(rest, ignored);
+                }
+                return false;
+            }
+            active[h.pid] = std::make_pair(h.fd, i);
+            launched++;
+        }
+
+        // 子进程在退出前已经写完结果，回收后再从管道读取
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0 && errno != EINTR) {
+            for (auto& a : active) close(a.second.first);
+            return false;
+        }
+        auto it = active.find(pid);
+        if (it == active.end()) continue;
+        handle h{pid, it->second.first};
+        unsigned int i = it->second.second;
+        active.erase(it);
+        Result r;
+        if (!collect(h, status, r)) {
+            ok = false;
+            continue;
+        }
+        done(i, r);
+    }
+    return ok;
+}
+
+} // namespace child
+
+#endif // CHILD_PROCESS_H
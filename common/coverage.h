@@ -0,0 +1,293 @@
+// File: coverage.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 功能覆盖率
+// 每个覆盖点的仓（bin）只记录"是否命中过"，存放在紧凑的位图中，采样就是一次按位或，
+// 可以在日常回归中一直开着。交叉覆盖是多个维度的乘积空间，同样是一张位图。
+// 多次并行运行各自保存覆盖率数据库，之后按位或合并成一份报告。
+namespace cov {
+
+class coverpoint {
+public:
+    // 一维覆盖点：bins个仓，labels为各仓的名字（可省略，省略时用编号）
+    coverpoint(const std::string& name, unsigned int bins,
+               const std::vector<std::string>& labels = std::vector<std::string>())
+    : name_(name), dims_{bins}, labels_{labels} {
+        allocate();
+    }
+
+    // 交叉覆盖：a和b的所有仓两两组合
+    coverpoint(const std::string& name, const coverpoint& a, const coverpoint& b)
+    : name_(name) {
+        dims_ = a.dims_;
+        labels_ = a.labels_;
+        dims_.insert(dims_.end(), b.dims_.begin(), b.dims_.end());
+        labels_.insert(labels_.end(), b.labels_.begin(), b.labels_.end());
+        allocate();
+    }
+
+    void sample(unsigned int bin) {
+        hits_[bin >> 6] |= uint64_t(1) << (bin & 63);
+    }
+
+    // 二维交叉覆盖的采样
+    void sample(unsigned int i, unsigned int j) {
+        sample(i * dims_[1] + j);
+    }
+
+    // 不计入覆盖率的仓（按规格不可能出现或不关心的组合）
+    void ignore(unsigned int bin) {
+        ignored_[bin >> 6] |= uint64_t(1) << (bin & 63);
+    }
+
+    void ignore(unsigned int i, unsigned int j) {
+        ignore(i * dims_[1] + j);
+    }
+
+    bool hit(unsigned int bin) const {
+        return (hits_[bin >> 6] >> (bin & 63)) & 1;
+    }
+
+    bool ignored(unsigned int bin) const {
+        return (ignored_[bin >> 6] >> (bin & 63)) & 1;
+    }
+
+    unsigned int bins() const { return size_; }
+
+    // 有效仓数（不含忽略的仓）和其中已命中的仓数
+    unsigned int total() const {
+        unsigned int n = 0;
+        for (uint64_t w : ignored_) n += __builtin_popcountll(w);
+        return size_ - n;
+    }
+
+    unsigned int covered() const {
+        unsigned int n = 0;
+        for (size_t i = 0; i < hits_.size(); i++) n += __builtin_popcountll(hits_[i] & ~ignored_[i]);
+        return n;
+    }
+
+    double percent() const {
+        return total() ? 100.0 * covered() / total() : 100.0;
+    }
+
+    // 仓的名字，交叉覆盖为各维名字用"x"连接
+    std::string label(unsigned int bin) const {
+        std::string s;
+        for (size_t d = dims_.size(); d-- > 0;) {
+            unsigned int k = bin % dims_[d];
+            bin /= dims_[d];
+            std::string part = k < labels_[d].size() ? labels_[d][k] : std::to_string(k);
+            s = s.empty() ? part : part + " x " + s;
+        }
+        return s;
+    }
+
+    const std::string& name() const { return name_; }
+
+    // 名字和各维大小相同才能合并
+    bool compatible(const coverpoint& o) const {
+        return o.name_ == name_ && o.dims_ == dims_;
+    }
+
+    // 与结构相同的覆盖点按位或合并
+    bool merge(const coverpoint& o) {
+        if (!compatible(o)) return false;
+        for (size_t i = 0; i < hits_.size(); i++) {
+            hits_[i] |= o.hits_[i];
+            ignored_[i] |= o.ignored_[i];
+        }
+        return true;
+    }
+
+    void write(std::FILE* f) const {
+        write_string(f, name_);
+        write_u32(f, dims_.size());
+        for (size_t d = 0; d < dims_.size(); d++) {
+            write_u32(f, dims_[d]);
+            write_u32(f, labels_[d].size());
+            for (const std::string& l : labels_[d]) write_string(f, l);
+        }
+        std::fwrite(hits_.data(), sizeof(uint64_t), hits_.size(), f);
+        std::fwrite(ignored_.data(), sizeof(uint64_t), ignored_.size(), f);
+    }
+
+    static bool read(std::FILE* f, coverpoint& p) {
+        uint32_t ndims;
+        if (!read_string(f, p.name_) || !read_u32(f, ndims) || ndims == 0 || ndims > 8) return false;
+        p.dims_.assign(ndims, 0);
+        p.labels_.assign(ndims, std::vector<std::string>());
+        for (uint32_t d = 0; d < ndims; d++) {
+            uint32_t nlabels;
+            if (!read_u32(f, p.dims_[d]) || !read_u32(f, nlabels) || nlabels > p.dims_[d]) return false;
+            p.labels_[d].resize(nlabels);
+            for (std::string& l : p.labels_[d]) {
+                if (!read_string(f, l)) return false;
+            }
+        }
+        p.allocate();
+        return std::fread(p.hits_.data(), sizeof(uint64_t), p.hits_.size(), f) == p.hits_.size() &&
+               std::fread(p.ignored_.data(), sizeof(uint64_t), p.ignored_.size(), f) == p.ignored_.size();
+    }
+
+private:
+    std::string name_;
+    std::vector<uint32_t> dims_;                      // 各维的仓数
+    std::vector<std::vector<std::string>> labels_;    // 各维的仓名
+    unsigned int size_;
+    std::vector<uint64_t> hits_;                      // 命中位图
+    std::vector<uint64_t> ignored_;                   // 忽略位图
+
+    coverpoint() : size_(0) {}
+    friend class covergroup;
+
+    void allocate() {
+        size_ = 1;
+        for (unsigned int d : dims_) size_ *= d;
+        hits_.assign((size_ + 63) / 64, 0);
+        ignored_.assign((size_ + 63) / 64, 0);
+    }
+
+    static void write_u32(std::FILE* f, uint32_t v) {
+        std::fwrite(&v, sizeof(v), 1, f);
+    }
+
+    static void write_string(std::FILE* f, const std::string& s) {
+        write_u32(f, s.size());
+        std::fwrite(s.data(), 1, s.size(), f);
+    }
+
+    static bool read_u32(std::FILE* f, uint32_t& v) {
+        return std::fread(&v, sizeof(v), 1, f) == 1;
+    }
+
+    static bool read_string(std::FILE* f, std::string& s) {
+        uint32_t n;
+        if (!read_u32(f, n) || n > 4096) return false;
+        s.resize(n);
+        return n == 0 || std::fread(&s[0], 1, n, f) == n;
+    }
+};
+
+// 一组覆盖点，对应SystemVerilog的covergroup；负责报告和数据库读写
+class covergroup {
+public:
+    explicit covergroup(const std::string& name) : name_(name) {}
+
+    coverpoint& add(const std::string& name, unsigned int bins,
+                    const std::vector<std::string>& labels = std::vector<std::string>()) {
+        points_.emplace_back(name, bins, labels);
+        return points_.back();
+    }
+
+    coverpoint& add_cross(const std::string& name, const coverpoint& a, const coverpoint& b) {
+        points_.emplace_back(name, a, b);
+        return points_.back();
+    }
+
+    const std::string& name() const { return name_; }
+    const std::deque<coverpoint>& points() const { return points_; }
+
+    double percent() const {
+        unsigned int covered = 0, total = 0;
+        for (const coverpoint& p : points_) {
+            covered += p.covered();
+            total += p.total();
+        }
+        return total ? 100.0 * covered / total : 100.0;
+    }
+
+    // 打印各覆盖点的覆盖率，并列出前max_missing个未命中的仓
+    void report(std::ostream& os = std::cout, unsigned int max_missing = 8) const {
+        os << "[覆盖率 " << name_ << "] " << std::fixed << std::setprecision(1) << percent() << "%\n";
+        for (const coverpoint& p : points_) {
+            os << "    " << std::left << std::setw(24) << p.name() << std::right
+               << std::setw(6) << p.covered() << "/" << std::left << std::setw(6) << p.total()
+               << std::right << std::setw(6) << std::setprecision(1) << p.percent() << "%";
+            unsigned int listed = 0;
+            for (unsigned int b = 0; b < p.bins() && listed < max_missing; b++) {
+                if (!p.hit(b) && !p.ignored(b)) {
+                    os << (listed++ ? ", " : "  未命中: ") << p.label(b);
+                }
+            }
+            if (listed == max_missing && p.total() - p.covered() > max_missing) os << ", ...";
+            os << "\n";
+        }
+    }
+
+    // 覆盖率数据库：文件头 + 组名 + 各覆盖点（结构和位图）
+    bool save(const std::string& path) const {
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        std::fwrite("SCCOV001", 1, 8, f);
+        coverpoint::write_string(f, name_);
+        coverpoint::write_u32(f, points_.size());
+        for (const coverpoint& p : points_) p.write(f);
+        bool ok = !std::ferror(f);
+        std::fclose(f);
+        return ok;
+    }
+
+    // 读入数据库；如果本组已有覆盖点，则与之合并（结构必须一致）
+    // 整个文件先读到临时对象并逐个检查结构，全部通过后才合并，失败时本组保持不变
+    bool load(const std::string& path) {
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        char magic[8];
+        std::string name;
+        uint32_t n;
+        bool ok = std::fread(magic, 1, 8, f) == 8 && std::string(magic, 8) == "SCCOV001" &&
+                  coverpoint::read_string(f, name) && coverpoint::read_u32(f, n);
+        std::deque<coverpoint> loaded;
+        for (uint32_t i = 0; ok && i < n; i++) {
+            loaded.emplace_back(coverpoint());
+            ok = coverpoint::read(f, loaded.back());
+        }
+        std::fclose(f);
+        if (!ok) return false;
+
+        if (points_.empty()) {
+            name_ = name;
+            points_ = loaded;
+            return true;
+        }
+        if (name != name_ || loaded.size() != points_.size()) return false;
+        for (size_t i = 0; i < points_.size(); i++) {
+            if (!points_[i].compatible(loaded[i])) return false;
+        }
+        for (size_t i = 0; i < points_.size(); i++) points_[i].merge(loaded[i]);
+        return true;
+    }
+
+private:
+    std::string name_;
+    std::deque<coverpoint> points_;    // deque保证返回的引用在后续添加时仍然有效
+};
+
+} // namespace cov
+
+#endif // COVERAGE_H
@@ -0,0 +1,121 @@
+// File: coverage_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "coverage.h"
+#include "stimulus.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    std::cout << (ok ? "  通过: " : "  失败: ") << what << std::endl;
+    if (!ok) failures++;
+}
+
+// 覆盖点、交叉覆盖、忽略仓和数据库合并的自检
+static void self_check() {
+    std::cout << "\n===== 覆盖率自检 =====\n";
+
+    cov::covergroup g("demo");
+    cov::coverpoint& op = g.add("op", 4, {"add", "sub", "and", "or"});
+    cov::coverpoint& flag = g.add("flag", 2, {"zero", "carry"});
+    cov::coverpoint& cross = g.add_cross("op x flag", op, flag);
+    for (unsigned int i = 2; i < 4; i++) cross.ignore(i, 1);
+
+    op.sample(0);
+    op.sample(3);
+    cross.sample(1, 1);
+    cross.sample(3, 1);            // 忽略的仓命中不计入覆盖率
+    check(op.covered() == 2 && op.total() == 4, "一维覆盖点计数");
+    check(cross.bins() == 8 && cross.total() == 6 && cross.covered() == 1, "交叉覆盖与忽略仓");
+    check(cross.label(5) == "and x carry", "交叉仓的名字");
+
+    std::ostringstream os;
+    g.report(os);
+    check(os.str().find("未命中: add x zero") != std::string::npos, "报告列出未命中的仓");
+
+    // 两次运行各覆盖一部分，合并后是并集
+    cov::covergroup run2("demo");
+    cov::coverpoint& op2 = run2.add("op", 4, {"add", "sub", "and", "or"});
+    cov::coverpoint& flag2 = run2.add("flag", 2, {"zero", "carry"});
+    cov::coverpoint& cross2 = run2.add_cross("op x flag", op2, flag2);
+    for (unsigned int i = 2; i < 4; i++) cross2.ignore(i, 1);
+    op2.sample(1);
+    cross2.sample(0, 0);
+
+    const char* p1 = "/tmp/coverage_bench_1.cov";
+    const char* p2 = "/tmp/coverage_bench_2.cov";
+    cov::covergroup merged("");
+    bool ok = g.save(p1) && run2.save(p2) && merged.load(p1) && merged.load(p2);
+    check(ok && merged.points()[0].covered() == 3 && merged.points()[2].covered() == 2,
+          "保存并合并两个数据库");
+
+    // 前两个覆盖点结构一致、最后一个不一致：整个文件被拒绝，前面的覆盖点也不能被合并进来
+    cov::covergroup other("demo");
+    other.add("op", 4).sample(2);
+    other.add("flag", 2);
+    other.add("op x flag", 10);
+    check(other.save(p2) && !merged.load(p2) && merged.points()[0].covered() == 3,
+          "结构不一致的数据库拒绝合并，已有数据不变");
+    std::remove(p1);
+    std::remove(p2);
+}
+
+// 采样代价：随机仓号，分别采样一维覆盖点和256x256的交叉覆盖
+static void measure(uint64_t n) {
+    cov::covergroup g("bench");
+    cov::coverpoint& a = g.add("a", 256);
+    cov::coverpoint& b = g.add("b", 256);
+    cov::coverpoint& ab = g.add_cross("a x b", a, b);
+
+    std::vector<uint8_t> values(1 << 16);
+    stim::philox_stream rng(1, stim::STREAM_USER);
+    for (uint8_t& v : values) v = rng.next_u32();
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < n; i++) {
+        unsigned int x = values[i & 0xFFFF];
+        unsigned int y = values[(i + 1) & 0xFFFF];
+        a.sample(x);
+        b.sample(y);
+        ab.sample(x, y);
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "  每次采样（两个覆盖点加一个交叉）" << std::fixed << std::setprecision(2)
+              << (s / n * 1e9) << " ns, 交叉覆盖率 " << std::setprecision(1) << ab.percent() << "%\n";
+}
+
+// 用法: coverage_bench [采样次数]
+int main(int argc, char* argv[]) {
+    uint64_t n = argc > 1 ? std::stoull(argv[1]) : 100000000ull;
+
+    self_check();
+
+    std::cout << "\n===== 采样代价 (" << n << "次) =====\n";
+    measure(n);
+
+    if (failures) {
+        std::cout << "\n===== 覆盖率自检失败 (" << failures << "项) =====\n";
+        return 1;
+    }
+    std::cout << "\n===== 覆盖率自检通过 =====\n";
+    return 0;
+}
@@ -0,0 +1,66 @@
+// File: coverage_merge.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <iostream>
+#include <map>
+#include <string>
+#include "coverage.h"
+
+// 合并多次运行保存的覆盖率数据库，按组名归并后打印报告
+// 用法: coverage_merge [-o 输出文件] 数据库1 数据库2 ...
+int main(int argc, char* argv[]) {
+    std::string output;
+    std::map<std::string, cov::covergroup> groups;
+    unsigned int files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+            continue;
+        }
+        cov::covergroup g("");
+        if (!g.load(arg)) {
+            std::cout << "错误: 无法读取覆盖率数据库 " << arg << std::endl;
+            return 1;
+        }
+        auto it = groups.find(g.name());
+        if (it == groups.end()) {
+            groups.emplace(g.name(), g);
+        } else if (!it->second.load(arg)) {
+            std::cout << "错误: " << arg << " 与之前的 " << g.name() << " 结构不一致" << std::endl;
+            return 1;
+        }
+        files++;
+    }
+
+    if (files == 0) {
+        std::cout << "用法: " << argv[0] << " [-o 输出文件] 数据库1 数据库2 ...\n";
+        return 1;
+    }
+
+    std::cout << "\n===== 合并 " << files << " 个覆盖率数据库 =====\n";
+    for (const auto& g : groups) g.second.report();
+
+    if (!output.empty()) {
+        if (groups.size() != 1 || !groups.begin()->second.save(output)) {
+            std::cout << "错误: 只能把同一组的数据库合并保存到 " << output << std::endl;
+            return 1;
+        }
+        std::cout << "合并结果已保存到 " << output << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+// File: datatypes.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef DATATYPES_H
+#define DATATYPES_H
+
+#include <systemc.h>
+#include <cstdint>
+
+// 模块内部的数据类型策略
+// 端口类型不变，策略只决定register_file_t、ram_t、alu_4bit_t内部的存储数组和运算
+// 使用什么类型，在端口处转换。
+
+// SystemC数据类型：与原先的实现完全相同
+struct sc_datatypes {
+    static constexpr bool native = false;
+    typedef sc_uint<8> byte_type;      // 8位存储单元
+
+    static byte_type to_byte(const sc_uint<8>& v) { return v; }
+    static sc_uint<8> from_byte(const byte_type& v) { return v; }
+};
+
+// 原生整数：存储用uint8_t，ALU用int8_t运算并显式截断到4位
+struct native_datatypes {
+    static constexpr bool native = true;
+    typedef uint8_t byte_type;
+
+    static byte_type to_byte(const sc_uint<8>& v) { return uint8_t(v.to_uint() & 0xFF); }
+    static sc_uint<8> from_byte(byte_type v) { return v; }
+};
+
+// 不带模板参数的register_file、ram、alu_4bit使用的策略，编译时用-DNATIVE_DATATYPES切换
+#ifdef NATIVE_DATATYPES
+typedef native_datatypes default_datatypes;
+#else
+typedef sc_datatypes default_datatypes;
+#endif
+
+#endif // DATATYPES_H
@@ -0,0 +1,112 @@
+// File: power_window.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef POWER_WINDOW_H
+#define POWER_WINDOW_H
+
+#include <systemc.h>
+#include <cstdint>
+#include <type_traits>
+#include "activity.h"
+
+// activity.h的SystemC部分：端口值到位模式的转换、端口翻转探针和时间窗口
+namespace pwr {
+
+// 端口值的位模式，有符号类型只保留其宽度内的位
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value, uint64_t>::type bits(const T& v) {
+    return uint64_t(typename std::make_unsigned<T>::type(v));
+}
+
+inline uint64_t bits(bool v) { return v; }
+
+template<int W>
+inline uint64_t bits(const sc_uint<W>& v) { return v.to_uint64(); }
+
+template<int W>
+inline uint64_t bits(const sc_int<W>& v) {
+    return uint64_t(v.to_int64()) & (W == 64 ? ~uint64_t(0) : (uint64_t(1) << W) - 1);
+}
+
+// 一个端口的翻转计数：记住上次的位模式，值改变时累加翻转位数
+template<typename T>
+struct port_probe {
+    const sc_in<T>* port;
+    unsigned int counter;
+    uint64_t last;
+
+    port_probe() : port(nullptr), counter(0), last(0) {}
+
+    void attach(activity& a, const sc_in<T>& p, const std::string& name) {
+        port = &p;
+        counter = a.add(name);
+    }
+
+    void sample(activity& a) {
+        uint64_t b = bits(port->read());
+        if (b != last) {
+            a.toggle(counter, last, b);
+            last = b;
+        }
+    }
+};
+
+// 每隔period结束一个能量窗口，仿真结束时结束最后一个窗口、关闭输出并打印汇总
+SC_MODULE(power_window) {
+    power_report& report;
+    sc_time period;
+    bool print_summary;
+
+    SC_HAS_PROCESS(power_window);
+
+    power_window(sc_module_name name, power_report& r, const sc_time& p, bool summary = true)
+    : sc_module(name), report(r), period(p), print_summary(summary) {
+        SC_METHOD(tick);
+    }
+
+    ~power_window() {
+        finish();
+    }
+
+private:
+    bool started = false;
+    bool done = false;
+
+    static uint64_t now_ps() {
+        return uint64_t(sc_time_stamp().to_seconds() * 1e12 + 0.5);
+    }
+
+    void tick() {
+        if (started) report.close_window(now_ps());
+        started = true;
+        next_trigger(period);
+    }
+
+    void end_of_simulation() override {
+        finish();
+    }
+
+    void finish() {
+        if (done) return;
+        done = true;
+        report.finish(now_ps());
+        if (print_summary) report.summary();
+    }
+};
+
+} // namespace pwr
+
+#endif // POWER_WINDOW_H
@@ -0,0 +1,208 @@
+// File: scoreboard.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef SCOREBOARD_H
+#define SCOREBOARD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 记分板：收集期望流（参考模型）和实际流（被测设计），按事务编号配对比较
+// 两个流可以乱序到达，先到的一方存入预先分配的开放寻址哈希表，后到的一方
+// 查表配对后立即删除，因此每个事务的代价是O(1)，内存上限在构造时确定。
+// 对于按顺序完成的接口（FIFO、组合逻辑），可以不指定编号，两边各自按到达顺序编号。
+template<typename T>
+class scoreboard {
+public:
+    typedef uint64_t id_type;
+
+    scoreboard(const std::string& name, size_t max_outstanding = 1024, size_t max_reports = 10)
+    : name(name), limit(max_outstanding), max_reports(max_reports),
+      next_expect_id(0), next_actual_id(0),
+      outstanding(0), outstanding_expected(0),
+      matched(0), mismatched(0), duplicates(0), dropped(0) {
+        size_t cap = 16;
+        while (cap < 4 * max_outstanding) cap <<= 1;
+        slots.resize(cap);
+        mask = cap - 1;
+        shift = 64;
+        while (cap > 1) {
+            cap >>= 1;
+            shift--;
+        }
+        log.reserve(max_reports);
+    }
+
+    // 期望值（来自参考模型）
+    void expect(id_type id, const T& value) {
+        arrive(id, value, SIDE_EXPECTED);
+    }
+
+    // 实际值（来自被测设计）
+    void actual(id_type id, const T& value) {
+        arrive(id, value, SIDE_ACTUAL);
+    }
+
+    // 按到达顺序自动编号
+    void expect(const T& value) {
+        expect(next_expect_id++, value);
+    }
+
+    void actual(const T& value) {
+        actual(next_actual_id++, value);
+    }
+
+    // 尚未配对的事务数
+    size_t pending() const { return outstanding; }
+    size_t pending_expected() const { return outstanding_expected; }
+    size_t pending_actual() const { return outstanding - outstanding_expected; }
+
+    // 丢弃所有未配对的事务（例如被测设计复位后），并重新对齐自动编号
+    void clear_pending() {
+        for (slot& s : slots) s.side = SIDE_EMPTY;
+        outstanding = outstanding_expected = 0;
+        next_expect_id = next_actual_id = std::max(next_expect_id, next_actual_id);
+    }
+
+    uint64_t matches() const { return matched; }
+    uint64_t mismatches() const { return mismatched; }
+
+    // 没有不一致、重复编号和溢出，并且所有事务都已配对
+    bool passed() const {
+        return mismatched == 0 && duplicates == 0 && dropped == 0 && outstanding == 0;
+    }
+
+    void report(std::ostream& os = std::cout) const {
+        os << "[记分板 " << name << "] 配对 " << matched
+           << ", 不一致 " << mismatched
+           << ", 缺少实际值 " << pending_expected()
+           << ", 多余实际值 " << pending_actual();
+        if (duplicates) os << ", 重复编号 " << duplicates;
+        if (dropped) os << ", 超出容量丢弃 " << dropped;
+        os << (passed() ? "  通过" : "  失败") << "\n";
+        for (const mismatch_record& m : log) {
+            os << "    事务 " << m.id << ": 期望 " << m.expected << ", 实际 " << m.actual << "\n";
+        }
+        if (mismatched > log.size()) {
+            os << "    ……其余 " << (mismatched - log.size()) << " 处不一致未列出\n";
+        }
+    }
+
+private:
+    enum side_type : uint8_t {
+        SIDE_EMPTY = 0,
+        SIDE_EXPECTED = 1,
+        SIDE_ACTUAL = 2
+    };
+
+    struct slot {
+        id_type id;
+        T value;
+        side_type side;
+
+        slot() : id(0), value(), side(SIDE_EMPTY) {}
+    };
+
+    struct mismatch_record {
+        id_type id;
+        T expected;
+        T actual;
+    };
+
+    std::string name;
+    size_t limit;
+    size_t max_reports;
+    id_type next_expect_id;
+    id_type next_actual_id;
+
+    std::vector<slot> slots;           // 开放寻址哈希表，线性探测，装载率不超过1/4
+    size_t mask;
+    unsigned int shift;
+
+    size_t outstanding;
+    size_t outstanding_expected;
+    uint64_t matched;
+    uint64_t mismatched;
+    uint64_t duplicates;
+    uint64_t dropped;
+    std::vector<mismatch_record> log;  // 只保留前max_reports条不一致
+
+    // 斐波那契散列，连续编号会被打散到整个表中
+    size_t home(id_type id) const {
+        return size_t((id * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    void arrive(id_type id, const T& value, side_type side) {
+        size_t i = home(id);
+        while (slots[i].side != SIDE_EMPTY) {
+            if (slots[i].id == id) {
+                if (slots[i].side == side) {
+                    duplicates++;
+                    return;
+                }
+                const T& expected = side == SIDE_EXPECTED ? value : slots[i].value;
+                const T& actual = side == SIDE_ACTUAL ? value : slots[i].value;
+                compare(id, expected, actual);
+                if (slots[i].side == SIDE_EXPECTED) outstanding_expected--;
+                erase(i);
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+
+        if (outstanding >= limit) {
+            dropped++;
+            return;
+        }
+        slots[i].id = id;
+        slots[i].value = value;
+        slots[i].side = side;
+        outstanding++;
+        if (side == SIDE_EXPECTED) outstanding_expected++;
+    }
+
+    void compare(id_type id, const T& expected, const T& actual) {
+        if (expected == actual) {
+            matched++;
+            return;
+        }
+        mismatched++;
+        if (log.size() < max_reports) log.push_back({id, expected, actual});
+    }
+
+    // 向后移位删除：把后续探测链上的元素前移，表中不留墓碑
+    void erase(size_t hole) {
+        outstanding--;
+        size_t i = hole;
+        for (;;) {
+            i = (i + 1) & mask;
+            if (slots[i].side == SIDE_EMPTY) break;
+            size_t h = home(slots[i].id);
+            // h不在(hole, i]循环区间内时，元素i可以移到hole
+            bool movable = hole <= i ? (h <= hole || h > i) : (h <= hole && h > i);
+            if (movable) {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole].side = SIDE_EMPTY;
+    }
+};
+
+#endif // SCOREBOARD_H
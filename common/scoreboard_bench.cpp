@@ -0,0 +1,138 @@
+// File: scoreboard_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include "scoreboard.h"
+#include "stimulus.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    std::cout << (ok ? "  通过: " : "  失败: ") << what << std::endl;
+    if (!ok) failures++;
+}
+
+// 记分板行为自检
+static void self_check() {
+    std::cout << "\n===== 记分板自检 =====\n";
+
+    // 按顺序自动编号，注入两处错误
+    scoreboard<int> in_order("in_order", 64, 1);
+    for (int i = 0; i < 100; i++) {
+        in_order.expect(i);
+        in_order.actual(i == 10 || i == 20 ? -1 : i);
+    }
+    check(in_order.matches() == 98 && in_order.mismatches() == 2 && !in_order.passed(),
+          "按顺序配对并统计不一致");
+    std::ostringstream os;
+    in_order.report(os);
+    check(os.str().find("事务 10: 期望 10, 实际 -1") != std::string::npos &&
+          os.str().find("其余 1 处") != std::string::npos, "只记录前max_reports条不一致");
+
+    // 缺少和多余的事务
+    scoreboard<int> leftover("leftover");
+    leftover.expect(1, 5);
+    leftover.actual(2, 6);
+    check(leftover.pending_expected() == 1 && leftover.pending_actual() == 1 && !leftover.passed(),
+          "未配对事务计为缺少/多余");
+    leftover.clear_pending();
+    check(leftover.pending() == 0 && leftover.passed(), "clear_pending丢弃未配对事务");
+
+    // 容量上限与重复编号
+    scoreboard<int> bounded("bounded", 8);
+    for (int i = 0; i < 10; i++) bounded.expect(i, i);
+    bounded.expect(3, 3);
+    check(bounded.pending() == 8 && !bounded.passed(), "超出容量的事务被丢弃而不是扩容");
+
+    // 随机乱序、随机先后，与unordered_map参照对比
+    scoreboard<uint32_t> sb("random", 4096);
+    std::unordered_map<uint64_t, uint32_t> ref;
+    stim::philox_stream rng(3, stim::STREAM_USER);
+    uint64_t expected_matches = 0;
+    for (int i = 0; i < 200000; i++) {
+        uint64_t id = rng.uniform(0, 3000);
+        uint32_t v = rng.next_u32() & 0xFF;
+        if (ref.count(id)) {
+            sb.actual(id, ref[id]);
+            ref.erase(id);
+            expected_matches++;
+        } else {
+            sb.expect(id, v);
+            ref[id] = v;
+        }
+    }
+    check(sb.matches() == expected_matches && sb.mismatches() == 0 && sb.pending() == ref.size(),
+          "随机插入删除与参照哈希表一致");
+}
+
+// 10M事务的平均代价：expect和actual各一次
+static void measure(const char* name, uint64_t n, unsigned int window) {
+    scoreboard<uint32_t> sb(name, window ? window : 1);
+    stim::philox_stream rng(1, stim::STREAM_USER);
+    std::vector<uint64_t> inflight(window);
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (window == 0) {
+        for (uint64_t i = 0; i < n; i++) {
+            sb.expect(uint32_t(i));
+            sb.actual(uint32_t(i));
+        }
+    } else {
+        // 期望值按顺序产生，实际值在window个在途事务中随机完成一个
+        for (unsigned int i = 0; i < window; i++) {
+            inflight[i] = i;
+            sb.expect(i, uint32_t(i));
+        }
+        for (uint64_t i = window; i < n; i++) {
+            unsigned int k = rng.next_u32() & (window - 1);
+            sb.actual(inflight[k], uint32_t(inflight[k]));
+            inflight[k] = i;
+            sb.expect(i, uint32_t(i));
+        }
+        for (unsigned int k = 0; k < window; k++) {
+            sb.actual(inflight[k], uint32_t(inflight[k]));
+        }
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(8) << (s / n * 1e9) << " ns/事务"
+              << std::setw(10) << std::setprecision(2) << s << " s"
+              << "   配对 " << sb.matches() << (sb.passed() ? "" : "  (未全部配对)") << "\n";
+}
+
+// 用法: scoreboard_bench [事务数]
+int main(int argc, char* argv[]) {
+    uint64_t n = argc > 1 ? std::stoull(argv[1]) : 10000000ull;
+
+    self_check();
+
+    std::cout << "\n===== 配对代价 (" << n << "个事务) =====\n";
+    measure("按顺序", n, 0);
+    measure("乱序(窗口64)", n, 64);
+    measure("乱序(窗口4096)", n, 4096);
+
+    if (failures) {
+        std::cout << "\n===== 记分板自检失败 (" << failures << "项) =====\n";
+        return 1;
+    }
+    std::cout << "\n===== 记分板自检通过 =====\n";
+    return 0;
+}
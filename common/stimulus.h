@@ -0,0 +1,443 @@
+// File: stimulus.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STIMULUS_H
+#define STIMULUS_H
+
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+// 可复现的随机激励库
+// 核心是基于计数器的Philox4x32-10生成器：第n个随机数只由(种子, 流编号, n)决定，
+// 与其他流的消耗情况和求值顺序无关。每个激励生成器各自占用一个流，
+// 因此增删一个生成器或改变调用顺序不会影响其他生成器产生的序列。
+namespace stim {
+
+// 各个现成生成器默认使用的流编号
+enum stream_id : uint64_t {
+    STREAM_FIFO   = 1,
+    STREAM_ALU    = 2,
+    STREAM_MUX    = 3,
+    STREAM_REG    = 4,
+    STREAM_RAM    = 5,
+    STREAM_USER   = 0x100      // 用户自定义流从这里开始编号
+};
+
+// Philox4x32-10（Salmon等, SC'11），每个计数器块产生4个32位随机数。
+// 一次连续生成BLOCKS个块：各块的10轮运算互不依赖，交错执行时乘法的延迟可以互相掩盖，
+// 序列与逐块生成完全相同
+class philox_stream {
+public:
+    static const unsigned int BLOCKS = 4;
+    static const unsigned int BUFFER = 4 * BLOCKS;
+
+    philox_stream(uint64_t seed, uint64_t stream)
+    : key0(uint32_t(seed)), key1(uint32_t(seed >> 32)),
+      stream_lo(uint32_t(stream)), stream_hi(uint32_t(stream >> 32)),
+      block(0), index(BUFFER) {}
+
+    uint32_t next_u32() {
+        if (index == BUFFER) refill();
+        return buffer[index++];
+    }
+
+    uint64_t next_u64() {
+        uint64_t lo = next_u32();
+        return lo | (uint64_t(next_u32()) << 32);
+    }
+
+    // [0, 1)区间的双精度浮点数
+    double next_double() {
+        return (next_u64() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // [lo, hi]闭区间内的均匀整数（Lemire乘法映射，拒绝采样保证无偏）
+    // 区间不超过2^32个值时用一个32位随机数，更宽的区间用64位随机数和128位乘积
+    int64_t uniform(int64_t lo, int64_t hi) {
+        uint64_t span = uint64_t(hi) - uint64_t(lo) + 1;
+        if (span == 0) return int64_t(uint64_t(lo) + next_u64());     // 整个int64范围
+        if (span > 0xFFFFFFFFull) return int64_t(uint64_t(lo) + uniform_wide(span));
+        uint64_t m = uint64_t(next_u32()) * span;
+        uint32_t l = uint32_t(m);
+        if (l < span) {
+            uint32_t t = uint32_t(-span) % uint32_t(span);
+            while (l < t) {
+                m = uint64_t(next_u32()) * span;
+                l = uint32_t(m);
+            }
+        }
+        return int64_t(uint64_t(lo) + (m >> 32));
+    }
+
+    // 以概率p返回true
+    bool bernoulli(double p) {
+        return next_u32() < threshold(p);
+    }
+
+    // 直接比较预先计算的门限，避免每次浮点运算
+    bool bernoulli_threshold(uint64_t thr) {
+        return next_u32() < thr;
+    }
+
+    static uint64_t threshold(double p) {
+        if (p <= 0.0) return 0;
+        if (p >= 1.0) return 0x100000000ull;
+        return uint64_t(p * 4294967296.0);
+    }
+
+    // 已经产生的随机数个数，以及跳转到第n个随机数
+    uint64_t position() const {
+        return block * 4 - (BUFFER - index);
+    }
+
+    void seek(uint64_t n) {
+        block = n / 4;
+        index = BUFFER;
+        if (n % 4) {
+            refill();
+            index = n % 4;
+        }
+    }
+
+    // 随机访问：不改变当前位置，直接计算第n个随机数
+    uint32_t at(uint64_t n) const {
+        uint32_t out[4];
+        generate<1>(n / 4, out);
+        return out[n % 4];
+    }
+
+private:
+    uint32_t key0, key1;
+    uint32_t stream_lo, stream_hi;
+    uint64_t block;                // buffer之后的下一个计数器块
+    unsigned int index;            // buffer中下一个可用位置
+    uint32_t buffer[BUFFER];
+
+    void refill() {
+        generate<BLOCKS>(block, buffer);
+        block += BLOCKS;
+        index = 0;
+    }
+
+    // span > 2^32时的Lemire映射：64位随机数乘以span，高64位是结果，低64位用于拒绝
+    uint64_t uniform_wide(uint64_t span) {
+        unsigned __int128 m = (unsigned __int128)next_u64() * span;
+        uint64_t l = uint64_t(m);
+        if (l < span) {
+            uint64_t t = (0 - span) % span;
+            while (l < t) {
+                m = (unsigned __int128)next_u64() * span;
+                l = uint64_t(m);
+            }
+        }
+        return uint64_t(m >> 64);
+    }
+
+    // 从块ctr开始连续生成N个块，out依次存放每块的4个随机数
+    // 计数器 = (块号低32位, 块号高32位, 流编号低32位, 流编号高32位)
+    template<unsigned int N>
+    void generate(uint64_t ctr, uint32_t* out) const {
+        uint32_t c0[N], c1[N], c2[N], c3[N];
+        for (unsigned int j = 0; j < N; j++) {
+            c0[j] = uint32_t(ctr + j);
+            c1[j] = uint32_t((ctr + j) >> 32);
+            c2[j] = stream_lo;
+            c3[j] = stream_hi;
+        }
+        uint32_t k0 = key0, k1 = key1;
+        for (int round = 0; round < 10; round++) {
+            for (unsigned int j = 0; j < N; j++) {
+                uint64_t p0 = uint64_t(0xD2511F53u) * c0[j];
+                uint64_t p1 = uint64_t(0xCD9E8D57u) * c2[j];
+                uint32_t n0 = uint32_t(p1 >> 32) ^ c1[j] ^ k0;
+                uint32_t n2 = uint32_t(p0 >> 32) ^ c3[j] ^ k1;
+                c0[j] = n0;
+                c1[j] = uint32_t(p1);
+                c2[j] = n2;
+                c3[j] = uint32_t(p0);
+            }
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        for (unsigned int j = 0; j < N; j++) {
+            out[4 * j] = c0[j];
+            out[4 * j + 1] = c1[j];
+            out[4 * j + 2] = c2[j];
+            out[4 * j + 3] = c3[j];
+        }
+    }
+};
+
+// 加权选择（Vose别名法），每次选择O(1)
+class weighted_choice {
+public:
+    weighted_choice() {}
+
+    weighted_choice(std::initializer_list<double> weights) {
+        set_weights(std::vector<double>(weights));
+    }
+
+    explicit weighted_choice(const std::vector<double>& weights) {
+        set_weights(weights);
+    }
+
+    void set_weights(const std::vector<double>& weights) {
+        const unsigned int n = weights.size();
+        prob.assign(n, 0);
+        alias.assign(n, 0);
+        if (n == 0) return;
+
+        double total = 0;
+        for (double w : weights) total += w;
+
+        std::vector<double> scaled(n);
+        std::vector<unsigned int> small, large;
+        for (unsigned int i = 0; i < n; i++) {
+            scaled[i] = weights[i] * n / total;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty()) {
+            unsigned int s = small.back(); small.pop_back();
+            unsigned int l = large.back(); large.pop_back();
+            prob[s] = philox_stream::threshold(scaled[s]);
+            alias[s] = l;
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+            (scaled[l] < 1.0 ? small : large).push_back(l);
+        }
+        for (unsigned int i : large) prob[i] = 0x100000000ull;
+        for (unsigned int i : small) prob[i] = 0x100000000ull;
+    }
+
+    unsigned int size() const { return prob.size(); }
+
+    // 至少要有一个权重
+    unsigned int pick(philox_stream& rng) const {
+        assert(!prob.empty() && "weighted_choice::pick: 没有设置权重");
+        uint64_t r = rng.next_u64();
+        unsigned int column = unsigned((uint64_t(uint32_t(r >> 32)) * prob.size()) >> 32);
+        return uint32_t(r) < prob[column] ? column : alias[column];
+    }
+
+private:
+    std::vector<uint64_t> prob;        // 本列被选中的门限（32位定点）
+    std::vector<unsigned int> alias;   // 未选中时的替代项
+};
+
+// 带约束的取值分布：若干个加权的闭区间，先按权重选区间，再在区间内均匀取值
+// 例如 add_range(-8, -8, 1); add_range(7, 7, 1); add_range(-7, 6, 2);
+// 表示有一半的概率取到边界值-8或7
+class value_dist {
+public:
+    value_dist() {}
+
+    value_dist(int64_t lo, int64_t hi) {
+        add_range(lo, hi, 1.0);
+    }
+
+    value_dist& add_range(int64_t lo, int64_t hi, double weight) {
+        ranges.push_back({lo, hi});
+        weights.push_back(weight);
+        choice.set_weights(weights);
+        return *this;
+    }
+
+    value_dist& add_value(int64_t v, double weight) {
+        return add_range(v, v, weight);
+    }
+
+    int64_t sample(philox_stream& rng) const {
+        const range& r = ranges.size() == 1 ? ranges[0] : ranges[choice.pick(rng)];
+        return r.lo == r.hi ? r.lo : rng.uniform(r.lo, r.hi);
+    }
+
+private:
+    struct range {
+        int64_t lo, hi;
+    };
+    std::vector<range> ranges;
+    std::vector<double> weights;
+    weighted_choice choice;
+};
+
+// ===== 现成的接口激励生成器 =====
+
+// FIFO：写使能、写数据、读使能
+struct fifo_op {
+    bool write_en;
+    int data;
+    bool read_en;
+};
+
+class fifo_stimulus {
+public:
+    explicit fifo_stimulus(uint64_t seed, double write_prob = 0.6, double read_prob = 0.4,
+                           uint64_t stream = STREAM_FIFO)
+    : rng(seed, stream),
+      write_thr(philox_stream::threshold(write_prob)),
+      read_thr(philox_stream::threshold(read_prob)),
+      data(0, 100) {}
+
+    fifo_stimulus& set_data(const value_dist& d) {
+        data = d;
+        return *this;
+    }
+
+    fifo_op next() {
+        fifo_op op;
+        op.write_en = rng.bernoulli_threshold(write_thr);
+        op.read_en = rng.bernoulli_threshold(read_thr);
+        op.data = int(data.sample(rng));
+        return op;
+    }
+
+    philox_stream& stream() { return rng; }
+
+private:
+    philox_stream rng;
+    uint64_t write_thr;
+    uint64_t read_thr;
+    value_dist data;
+};
+
+// ALU：操作数A、B（-8~7）和操作码（0~7）
+struct alu_op {
+    int a;
+    int b;
+    int op;
+};
+
+class alu_stimulus {
+public:
+    explicit alu_stimulus(uint64_t seed, uint64_t stream = STREAM_ALU)
+    : rng(seed, stream),
+      operand(-8, 7),
+      ops({1, 1, 1, 1, 1, 1, 1, 1}) {}
+
+    // 操作码权重，依次对应加、减、取反、与、或、异或、比较、判等
+    alu_stimulus& set_op_weights(const std::vector<double>& w) {
+        ops.set_weights(w);
+        return *this;
+    }
+
+    alu_stimulus& set_operands(const value_dist& d) {
+        operand = d;
+        return *this;
+    }
+
+    // 常用约束：一半概率取边界值（-8、-1、0、1、7），便于触发进位和溢出
+    alu_stimulus& bias_corners() {
+        operand = value_dist();
+        operand.add_range(-8, 7, 5);
+        for (int v : {-8, -1, 0, 1, 7}) operand.add_value(v, 1);
+        return *this;
+    }
+
+    alu_op next() {
+        alu_op op;
+        op.a = int(operand.sample(rng));
+        op.b = int(operand.sample(rng));
+        op.op = int(ops.pick(rng));
+        return op;
+    }
+
+    philox_stream& stream() { return rng; }
+
+private:
+    philox_stream rng;
+    value_dist operand;
+    weighted_choice ops;
+};
+
+// 2位4选1选择器：四个2位输入和选择信号
+struct mux_op {
+    int x[4];
+    int y;
+};
+
+class mux_stimulus {
+public:
+    explicit mux_stimulus(uint64_t seed, uint64_t stream = STREAM_MUX)
+    : rng(seed, stream), select({1, 1, 1, 1}) {}
+
+    mux_stimulus& set_select_weights(const std::vector<double>& w) {
+        select.set_weights(w);
+        return *this;
+    }
+
+    mux_op next() {
+        mux_op op;
+        uint32_t r = rng.next_u32();
+        for (int i = 0; i < 4; i++) op.x[i] = (r >> (2 * i)) & 3;
+        op.y = int(select.pick(rng));
+        return op;
+    }
+
+    philox_stream& stream() { return rng; }
+
+private:
+    philox_stream rng;
+    weighted_choice select;
+};
+
+// 寄存器堆/RAM：地址、数据、写使能
+struct memory_op {
+    unsigned int addr;
+    unsigned int data;
+    bool write;
+};
+
+class memory_stimulus {
+public:
+    explicit memory_stimulus(uint64_t seed, double write_prob = 0.5,
+                             uint64_t stream = STREAM_RAM)
+    : rng(seed, stream),
+      write_thr(philox_stream::threshold(write_prob)),
+      addr(0, 15),
+      data(0, 255) {}
+
+    // 约束地址范围，例如只访问某个窗口或偏向某些热点地址
+    memory_stimulus& set_addr(const value_dist& d) {
+        addr = d;
+        return *this;
+    }
+
+    memory_stimulus& set_data(const value_dist& d) {
+        data = d;
+        return *this;
+    }
+
+    memory_op next() {
+        memory_op op;
+        op.write = rng.bernoulli_threshold(write_thr);
+        op.addr = unsigned(addr.sample(rng));
+        op.data = unsigned(data.sample(rng));
+        return op;
+    }
+
+    philox_stream& stream() { return rng; }
+
+private:
+    philox_stream rng;
+    uint64_t write_thr;
+    value_dist addr;
+    value_dist data;
+};
+
+} // namespace stim
+
+#endif // STIMULUS_H
@@ -0,0 +1,153 @@
+// File: stimulus_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "stimulus.h"
+
+using namespace stim;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    std::cout << (ok ? "  通过: " : "  失败: ") << what << std::endl;
+    if (!ok) failures++;
+}
+
+// 可复现性和分布的自检
+static void self_check() {
+    std::cout << "\n===== 激励库自检 =====\n";
+
+    // Random123发布的Philox4x32-10已知答案（计数器和密钥全0）
+    philox_stream zero(0, 0);
+    check(zero.next_u32() == 0x6627e8d5u && zero.next_u32() == 0xe169c58du &&
+          zero.next_u32() == 0xbc57ac4cu && zero.next_u32() == 0x9b00dbd8u,
+          "Philox4x32-10已知答案");
+
+    // 相同(种子, 流)产生相同序列，交错消耗两个流不影响各自的序列
+    philox_stream a(42, STREAM_FIFO), b(42, STREAM_ALU);
+    philox_stream a_ref(42, STREAM_FIFO), b_ref(42, STREAM_ALU);
+    bool same = true;
+    for (int i = 0; i < 1000; i++) {
+        if (i % 3 == 0) same &= b.next_u32() == b_ref.next_u32();
+        same &= a.next_u32() == a_ref.next_u32();
+    }
+    check(same, "各流的序列与求值顺序无关");
+
+    // 不同流、不同种子的序列不同
+    philox_stream c(42, STREAM_MUX), d(43, STREAM_MUX), e(42, STREAM_MUX);
+    unsigned int diff_stream = 0, diff_seed = 0;
+    for (int i = 0; i < 64; i++) {
+        uint32_t x = e.next_u32();
+        diff_stream += x != a_ref.next_u32();
+        diff_seed += x != d.next_u32();
+        c.next_u32();
+    }
+    check(diff_stream > 60 && diff_seed > 60, "不同流和不同种子相互独立");
+
+    // seek和at与顺序生成一致
+    philox_stream seq(7, STREAM_RAM), jump(7, STREAM_RAM);
+    for (int i = 0; i < 1001; i++) seq.next_u32();
+    jump.seek(1001);
+    check(seq.position() == 1001 && jump.next_u32() == seq.next_u32() &&
+          jump.at(5) == philox_stream(7, STREAM_RAM).at(5), "seek/at与顺序生成一致");
+    philox_stream batch(7, STREAM_RAM);
+    bool same_at = true;
+    for (uint64_t i = 0; i < 100; i++) same_at &= batch.position() == i && batch.next_u32() == batch.at(i);
+    check(same_at, "成批生成的序列与逐块计算的at一致");
+
+    // 约束区间不越界，权重比例正确
+    philox_stream r(1, STREAM_USER);
+    value_dist v;
+    v.add_range(-8, -8, 1).add_range(7, 7, 1).add_range(-7, 6, 2);
+    int corner = 0;
+    bool in_range = true;
+    const int N = 200000;
+    for (int i = 0; i < N; i++) {
+        int64_t x = v.sample(r);
+        in_range &= x >= -8 && x <= 7;
+        corner += x == -8 || x == 7;
+    }
+    check(in_range, "约束区间不越界");
+    check(std::fabs(corner / double(N) - 0.5) < 0.01, "区间权重比例约为1:1:2");
+
+    // 超过2^32个值的区间同样无偏：区间长3×2^61时，取模映射会让前2/3的值多一次机会，
+    // 下半区间约占56%
+    const uint64_t wide = 0x6000000000000000ull;
+    unsigned int lower = 0;
+    bool wide_in_range = true;
+    for (int i = 0; i < N; i++) {
+        int64_t x = r.uniform(-1, int64_t(wide - 2));
+        wide_in_range &= x >= -1 && x <= int64_t(wide - 2);
+        lower += uint64_t(x + 1) < wide / 2;
+    }
+    check(wide_in_range && std::fabs(lower / double(N) - 0.5) < 0.01, "宽区间(>2^32)不越界且无偏");
+
+    weighted_choice w({1, 2, 5});
+    unsigned int hist[3] = {0, 0, 0};
+    for (int i = 0; i < N; i++) hist[w.pick(r)]++;
+    check(std::fabs(hist[2] / double(N) - 0.625) < 0.01 &&
+          std::fabs(hist[0] / double(N) - 0.125) < 0.01, "加权选择比例约为1:2:5");
+
+    unsigned int ones = 0;
+    for (int i = 0; i < N; i++) ones += r.bernoulli(0.6);
+    check(std::fabs(ones / double(N) - 0.6) < 0.01, "伯努利概率约为0.6");
+}
+
+template<typename F>
+static void measure(const char* name, uint64_t n, F f) {
+    uint64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < n; i++) sink += f();
+    auto t1 = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "  " << std::left << std::setw(24) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << (n / s / 1e6) << " M/s"
+              << "   (校验和 " << std::hex << (sink & 0xFFFF) << std::dec << ")\n";
+}
+
+// 用法: stimulus_bench [每项生成数量]
+int main(int argc, char* argv[]) {
+    uint64_t n = argc > 1 ? std::stoull(argv[1]) : 100000000ull;
+
+    self_check();
+
+    std::cout << "\n===== 生成速率 (" << n << "个) =====\n";
+    philox_stream rng(1, STREAM_USER);
+    measure("next_u32", n, [&] { return rng.next_u32(); });
+    measure("uniform(-8, 7)", n / 4, [&] { return uint64_t(rng.uniform(-8, 7)); });
+    measure("bernoulli(0.6)", n / 4, [&] { return uint64_t(rng.bernoulli(0.6)); });
+
+    fifo_stimulus fifo_gen(1);
+    alu_stimulus alu_gen(1);
+    alu_gen.bias_corners();
+    mux_stimulus mux_gen(1);
+    memory_stimulus mem_gen(1);
+    measure("fifo_stimulus", n / 10, [&] { fifo_op o = fifo_gen.next(); return uint64_t(o.data + o.write_en); });
+    measure("alu_stimulus", n / 10, [&] { alu_op o = alu_gen.next(); return uint64_t(o.a + o.b + o.op); });
+    measure("mux_stimulus", n / 10, [&] { mux_op o = mux_gen.next(); return uint64_t(o.x[0] + o.y); });
+    measure("memory_stimulus", n / 10, [&] { memory_op o = mem_gen.next(); return uint64_t(o.addr + o.data); });
+
+    if (failures) {
+        std::cout << "\n===== 激励库自检失败 (" << failures << "项) =====\n";
+        return 1;
+    }
+    std::cout << "\n===== 激励库自检通过 =====\n";
+    return 0;
+}
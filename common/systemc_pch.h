@@ -0,0 +1,31 @@
+// File: systemc_pch.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef SYSTEMC_PCH_H
+#define SYSTEMC_PCH_H
+
+// 预编译头：各实验的源文件都要解析的头文件，主要是systemc.h。
+// 不需要在源文件里包含它，构建时由build.mk编译成.gch并用-include强制最先包含
+#include <systemc.h>
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#endif // SYSTEMC_PCH_H
@@ -0,0 +1,291 @@
+// File: telemetry.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 运行中仿真的遥测：仿真进程定期把一组计数值的快照发布到POSIX共享内存，
+// 另一个进程（telemetry_top）随时映射同一段内存读取，两边没有锁也没有系统调用往来。
+//
+// 共享内存的内容：
+//   头部   布局写完后最后写入magic；pid、状态、时间分辨率、标签和字段表
+//   环     RING_SLOTS个快照槽，第n个快照写在n % RING_SLOTS，published为已发布的快照数
+// 每个槽是一个顺序锁：写者先把seq置为2n+1，写完值再置为2n+2；读者前后两次读到相同的
+// 偶数seq才接受这次读取，否则重读。写者从不等待读者，读者慢了只会跳过中间的快照。
+// 槽中的值都是std::atomic<uint64_t>，写用release、读用acquire（保证第二次读seq不会提前），
+// 在x86-64上都是普通的mov，也不需要ThreadSanitizer不支持的内存栅栏
+namespace tele {
+
+static const uint32_t MAGIC = 0x454C4554;      // "TELE"
+static const uint32_t VERSION = 1;
+static const unsigned int MAX_FIELDS = 64;
+static const unsigned int MAX_VALUES = 256;
+static const unsigned int NAME_BYTES = 32;
+static const unsigned int LABEL_BYTES = 64;
+static const unsigned int RING_SLOTS = 16;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "共享内存中的原子量必须免锁");
+
+// 字段种类：counter为累计值，读者按两次快照之差计算速率；gauge为当前值；
+// histogram占bins个连续的值，每个是落在该仓的累计采样次数，最后一仓包含更大的值
+enum class kind : uint32_t { counter = 0, gauge = 1, histogram = 2 };
+
+enum class run_state : uint32_t { running = 0, finished = 1 };
+
+struct field_desc {
+    char name[NAME_BYTES];
+    uint32_t kind;
+    uint32_t offset;        // 在values中的下标
+    uint32_t bins;          // counter和gauge为1
+    uint32_t reserved;
+};
+
+struct slot {
+    std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> wall_ns;
+    std::atomic<uint64_t> sim_time;
+    std::atomic<uint64_t> cycles;
+    std::atomic<uint64_t> values[MAX_VALUES];
+};
+
+struct region {
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t pid;
+    std::atomic<uint32_t> state;
+    uint64_t resolution_fs;             // sim_time的单位（飞秒）
+    uint32_t field_count;
+    uint32_t value_count;
+    char label[LABEL_BYTES];
+    field_desc fields[MAX_FIELDS];
+    std::atomic<uint64_t> published;
+    slot ring[RING_SLOTS];
+};
+
+// 读者得到的一个快照副本
+struct snapshot {
+    uint64_t index;         // 第几个快照（从0开始）
+    uint64_t wall_ns;       // 从写者打开到发布时的墙钟时间
+    uint64_t sim_time;      // 仿真时间，以region::resolution_fs为单位
+    uint64_t cycles;
+    uint64_t values[MAX_VALUES];
+};
+
+// 共享内存的名字以'/'开头
+inline std::string shm_path(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+inline void copy_name(char* dst, const std::string& src, unsigned int bytes) {
+    std::memset(dst, 0, bytes);
+    std::memcpy(dst, src.data(), std::min<size_t>(src.size(), bytes - 1));
+}
+
+// 发布端：先用add_*定义字段，open创建共享内存，之后修改values()并publish
+class writer {
+public:
+    writer() : region_(nullptr), value_count_(0) {}
+    ~writer() { close(); }
+
+    writer(const writer&) = delete;
+    writer& operator=(const writer&) = delete;
+
+    unsigned int add_counter(const std::string& name) { return add(name, kind::counter, 1); }
+    unsigned int add_gauge(const std::string& name) { return add(name, kind::gauge, 1); }
+    unsigned int add_histogram(const std::string& name, unsigned int bins) {
+        return add(name, kind::histogram, std::max(1u, bins));
+    }
+
+    // 创建共享内存name（已存在的同名内存先删除，映射着它的读者看到的仍是旧内容）
+    bool open(const std::string& name, const std::string& label, uint64_t resolution_fs, std::string& error) {
+        close();
+        if (fields_.size() > MAX_FIELDS || value_count_ > MAX_VALUES) {
+            error = "遥测字段超过上限（" + std::to_string(MAX_FIELDS) + "个字段、" +
+                    std::to_string(MAX_VALUES) + "个值）";
+            return false;
+        }
+        path_ = shm_path(name);
+        shm_unlink(path_.c_str());
+        int fd = shm_open(path_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            error = "无法创建共享内存 " + path_;
+            return false;
+        }
+        void* p = MAP_FAILED;
+        if (ftruncate(fd, sizeof(region)) == 0) {
+            p = mmap(nullptr, sizeof(region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            shm_unlink(path_.c_str());
+            error = "无法映射共享内存 " + path_;
+            return false;
+        }
+
+        // ftruncate得到的内存全为0，原子量的初值即为0
+        region_ = static_cast<region*>(p);
+        region_->version = VERSION;
+        region_->pid = uint32_t(getpid());
+        region_->resolution_fs = resolution_fs;
+        region_->field_count = uint32_t(fields_.size());
+        region_->value_count = value_count_;
+        copy_name(region_->label, label, LABEL_BYTES);
+        for (size_t i = 0; i < fields_.size(); i++) region_->fields[i] = fields_[i];
+        values_.assign(value_count_, 0);
+        start_ = std::chrono::steady_clock::now();
+        region_->magic.store(MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    bool is_open() const { return region_ != nullptr; }
+    uint64_t published() const { return region_ ? region_->published.load(std::memory_order_relaxed) : 0; }
+
+    // 下一个快照的值，按add_*返回的下标修改
+    uint64_t* values() { return values_.data(); }
+
+    // 发布一个快照：只写共享内存，不做系统调用，也不等待读者
+    void publish(uint64_t sim_time, uint64_t cycles) {
+        if (!region_) return;
+        uint64_t n = region_->published.load(std::memory_order_relaxed);
+        slot& s = region_->ring[n % RING_SLOTS];
+        s.seq.store(2 * n + 1, std::memory_order_relaxed);
+        uint64_t wall = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - start_).count());
+        s.wall_ns.store(wall, std::memory_order_release);
+        s.sim_time.store(sim_time, std::memory_order_release);
+        s.cycles.store(cycles, std::memory_order_release);
+        for (unsigned int i = 0; i < value_count_; i++) s.values[i].store(values_[i], std::memory_order_release);
+        s.seq.store(2 * n + 2, std::memory_order_release);
+        region_->published.store(n + 1, std::memory_order_release);
+    }
+
+    // 标记运行结束并删除名字；已经映射的读者还能读到最后的快照
+    void close() {
+        if (!region_) return;
+        region_->state.store(uint32_t(run_state::finished), std::memory_order_release);
+        munmap(region_, sizeof(region));
+        shm_unlink(path_.c_str());
+        region_ = nullptr;
+    }
+
+private:
+    region* region_;
+    std::string path_;
+    std::vector<field_desc> fields_;
+    unsigned int value_count_;
+    std::vector<uint64_t> values_;
+    std::chrono::steady_clock::time_point start_;
+
+    unsigned int add(const std::string& name, kind k, unsigned int bins) {
+        field_desc f;
+        copy_name(f.name, name, NAME_BYTES);
+        f.kind = uint32_t(k);
+        f.offset = value_count_;
+        f.bins = bins;
+        f.reserved = 0;
+        fields_.push_back(f);
+        value_count_ += bins;
+        return f.offset;
+    }
+};
+
+// 读取端：attach映射写者创建的共享内存，latest取最新的完整快照
+class reader {
+public:
+    reader() : region_(nullptr) {}
+    ~reader() { detach(); }
+
+    reader(const reader&) = delete;
+    reader& operator=(const reader&) = delete;
+
+    bool attach(const std::string& name, std::string& error) {
+        detach();
+        std::string path = shm_path(name);
+        int fd = shm_open(path.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            error = "共享内存 " + path + " 不存在";
+            return false;
+        }
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(region)) {
+            p = mmap(nullptr, sizeof(region), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            error = "共享内存 " + path + " 尚未就绪";
+            return false;
+        }
+        region_ = static_cast<const region*>(p);
+        if (region_->magic.load(std::memory_order_acquire) != MAGIC || region_->version != VERSION) {
+            detach();
+            error = "共享内存 " + path + " 尚未就绪或版本不符";
+            return false;
+        }
+        return true;
+    }
+
+    void detach() {
+        if (region_) munmap(const_cast<region*>(region_), sizeof(region));
+        region_ = nullptr;
+    }
+
+    bool is_attached() const { return region_ != nullptr; }
+    const region& info() const { return *region_; }
+    bool finished() const {
+        return region_->state.load(std::memory_order_acquire) == uint32_t(run_state::finished);
+    }
+
+    // 取最新的完整快照；还没有快照，或写者停在写一个快照的中途（进程被杀死）时返回false
+    bool latest(snapshot& out) const {
+        for (unsigned int attempt = 0; attempt < MAX_RETRIES; attempt++) {
+            uint64_t n = region_->published.load(std::memory_order_acquire);
+            if (n == 0) return false;
+            const slot& s = region_->ring[(n - 1) % RING_SLOTS];
+            uint64_t seq = s.seq.load(std::memory_order_acquire);
+            if (seq != 2 * (n - 1) + 2) continue;       // 写者已经开始覆盖这个槽
+            out.index = n - 1;
+            out.wall_ns = s.wall_ns.load(std::memory_order_acquire);
+            out.sim_time = s.sim_time.load(std::memory_order_acquire);
+            out.cycles = s.cycles.load(std::memory_order_acquire);
+            for (unsigned int i = 0; i < region_->value_count; i++) {
+                out.values[i] = s.values[i].load(std::memory_order_acquire);
+            }
+            if (s.seq.load(std::memory_order_relaxed) == seq) return true;
+        }
+        return false;
+    }
+
+private:
+    static const unsigned int MAX_RETRIES = 1000;
+    const region* region_;
+};
+
+} // namespace tele
+
+#endif // TELEMETRY_H
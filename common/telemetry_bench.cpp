@@ -0,0 +1,183 @@
+// File: telemetry_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "telemetry.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    std::cout << "  " << (ok ? "通过: " : "失败: ") << what << std::endl;
+    if (!ok) failures++;
+}
+
+static std::string bench_name(const char* what) {
+    return "/telemetry_bench." + std::to_string(getpid()) + "." + what;
+}
+
+// 字段布局、快照内容、结束标志和名字的删除
+static void self_check() {
+    std::cout << "\n===== 遥测自检 =====\n";
+    std::string name = bench_name("check"), error;
+
+    tele::writer w;
+    unsigned int cyc = w.add_counter("flits");
+    unsigned int occ = w.add_gauge("backlog");
+    unsigned int hist = w.add_histogram("occupancy", 5);
+    check(cyc == 0 && occ == 1 && hist == 2, "字段按登记顺序占用连续的值");
+
+    tele::reader r;
+    check(!r.attach(name, error), "打开之前读者无法映射");
+    check(w.open(name, "自检", 1000, error), "创建共享内存");
+    check(r.attach(name, error), "读者映射共享内存");
+
+    const tele::region& info = r.info();
+    check(info.field_count == 3 && info.value_count == 7 && info.resolution_fs == 1000 &&
+          std::string(info.label) == "自检" && std::string(info.fields[2].name) == "occupancy" &&
+          info.fields[2].kind == uint32_t(tele::kind::histogram) && info.fields[2].bins == 5 &&
+          info.pid == uint32_t(getpid()),
+          "头部的字段表、标签和pid");
+
+    std::unique_ptr<tele::snapshot> s(new tele::snapshot);
+    check(!r.latest(*s), "发布之前没有快照");
+
+    // 发布比环更多的快照，读者只看到最新的一个
+    for (uint64_t n = 0; n < 3 * tele::RING_SLOTS + 1; n++) {
+        w.values()[cyc] = 10 * n;
+        w.values()[occ] = n % 3;
+        w.values()[hist + n % 5]++;
+        w.publish(100 * n, n);
+    }
+    uint64_t last = 3 * tele::RING_SLOTS;
+    check(r.latest(*s) && s->index == last && s->cycles == last && s->sim_time == 100 * last &&
+          s->values[cyc] == 10 * last && s->values[occ] == last % 3,
+          "最新快照的时间和计数");
+    uint64_t total = 0;
+    for (unsigned int b = 0; b < 5; b++) total += s->values[hist + b];
+    check(total == last + 1 && s->values[hist] == (last / 5) + 1, "直方图的累计采样");
+    check(!r.finished(), "运行中");
+
+    w.close();
+    check(r.finished(), "关闭后读者看到结束标志");
+    check(r.latest(*s) && s->index == last, "结束后仍能读到最后的快照");
+    tele::reader r2;
+    check(!r2.attach(name, error), "关闭后名字已删除");
+
+    // 同名的下一次运行创建新的共享内存，旧读者不受影响
+    tele::writer w2;
+    w2.add_counter("flits");
+    check(w2.open(name, "第二次", 1000, error) && r2.attach(name, error) && !r2.finished() &&
+          std::string(r2.info().label) == "第二次" && r.finished(),
+          "同名的新运行与旧的映射互不影响");
+
+    tele::writer big;
+    for (unsigned int i = 0; i <= tele::MAX_VALUES; i++) big.add_counter("c" + std::to_string(i));
+    check(!big.open(bench_name("big"), "", 1000, error), "超过值的上限时打开失败");
+}
+
+// 一个线程全速发布、另一个线程反复读取：读到的每个快照的值必须属于同一次发布
+static void stress(uint64_t publishes) {
+    std::cout << "\n===== 并发读写 =====\n";
+    std::string name = bench_name("stress"), error;
+    tele::writer w;
+    for (unsigned int i = 0; i < 32; i++) w.add_counter("c" + std::to_string(i));
+    w.add_histogram("h", tele::MAX_VALUES - 32);
+    if (!w.open(name, "并发", 1000, error)) {
+        check(false, error.c_str());
+        return;
+    }
+    tele::reader r;
+    check(r.attach(name, error), "读者映射共享内存");
+
+    std::atomic<bool> done(false);
+    uint64_t reads = 0, torn = 0, backwards = 0;
+    std::thread reader_thread([&]() {
+        std::unique_ptr<tele::snapshot> s(new tele::snapshot);
+        uint64_t prev = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            if (!r.latest(*s)) continue;
+            reads++;
+            if (s->index < prev) backwards++;
+            prev = s->index;
+            if (s->cycles != s->index) torn++;
+            for (unsigned int i = 0; i < tele::MAX_VALUES; i++) {
+                if (s->values[i] != s->index * (i + 1)) {
+                    torn++;
+                    break;
+                }
+            }
+        }
+    });
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; n < publishes; n++) {
+        for (unsigned int i = 0; i < tele::MAX_VALUES; i++) w.values()[i] = n * (i + 1);
+        w.publish(n, n);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    done.store(true, std::memory_order_release);
+    reader_thread.join();
+
+    std::cout << "发布 " << publishes << " 个快照（每个 " << tele::MAX_VALUES << " 个值），读取 " << reads << " 次\n";
+    check(reads > 0 && torn == 0, "读到的快照没有混合两次发布的值");
+    check(backwards == 0, "读到的快照序号不回退");
+    std::cout << "发布: " << std::fixed << std::setprecision(0) << seconds * 1e9 / publishes
+              << " ns/快照（有读者并发读取）\n";
+}
+
+// 仿真中的实际用法：每200 ms发布一次，测量一次发布本身的代价
+static void bench() {
+    std::cout << "\n===== 发布代价 =====\n";
+    std::string name = bench_name("bench"), error;
+    tele::writer w;
+    for (unsigned int i = 0; i < 8; i++) w.add_counter("c" + std::to_string(i));
+    w.add_histogram("h", 9);
+    w.open(name, "代价", 1000, error);
+
+    const uint64_t n = 1000000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < n; i++) {
+        w.values()[i & 15]++;
+        w.publish(i, i);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "17个值的快照: " << std::fixed << std::setprecision(1) << seconds * 1e9 / n
+              << " ns/快照；每秒发布5次时占仿真线程的 " << std::setprecision(6)
+              << seconds / n * 5 * 100 << "%\n";
+}
+
+// 用法: telemetry_bench [并发测试的发布次数]
+int main(int argc, char* argv[]) {
+    uint64_t publishes = argc > 1 ? std::stoull(argv[1]) : 500000;
+
+    self_check();
+    stress(publishes);
+    bench();
+
+    if (failures) {
+        std::cout << "\n===== 遥测测试失败 (" << failures << "处错误) =====" << std::endl;
+        return 1;
+    }
+    std::cout << "\n===== 遥测测试通过 =====" << std::endl;
+    return 0;
+}
@@ -0,0 +1,147 @@
+// File: telemetry_publisher.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TELEMETRY_PUBLISHER_H
+#define TELEMETRY_PUBLISHER_H
+
+#include <systemc.h>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+#include "telemetry.h"
+
+// telemetry.h的SystemC部分：在仿真中定期发布快照
+namespace tele {
+
+// 每隔sample_cycles个时钟周期（仿真时间）醒来一次：对登记的信号做直方图采样，
+// 距上次发布超过interval（墙钟时间）时读取全部计数并发布一个快照。
+// 没有打开共享内存时进程在第一次运行后就不再触发，不影响仿真的速度和结束条件
+class publisher : public sc_module {
+public:
+    std::chrono::milliseconds interval;
+
+    SC_HAS_PROCESS(publisher);
+
+    publisher(sc_module_name name, const sc_time& clock_period, uint64_t sample_cycles = 1000)
+    : sc_module(name), interval(200), period_(clock_period), sample_(clock_period * double(sample_cycles)) {
+        SC_METHOD(tick);
+    }
+
+    ~publisher() {
+        finish();
+    }
+
+    // 累计值，telemetry_top显示数值和每秒的增量；read在发布时调用
+    void add_counter(const std::string& field, std::function<uint64_t()> read) {
+        reads_.push_back({log_.add_counter(field), std::move(read)});
+    }
+
+    // 当前值，例如队列长度
+    void add_gauge(const std::string& field, std::function<uint64_t()> read) {
+        reads_.push_back({log_.add_gauge(field), std::move(read)});
+    }
+
+    // 直方图，返回值用于add_sample；0 ~ bins-2各占一仓，最后一仓为bins-1及以上
+    unsigned int add_histogram(const std::string& field, unsigned int bins) {
+        histograms_.push_back({log_.add_histogram(field, bins), bins, {}});
+        return unsigned(histograms_.size() - 1);
+    }
+
+    // 每次采样时把sig的值计入直方图h，例如一组FIFO的size
+    void add_sample(unsigned int h, const sc_signal_in_if<unsigned int>& sig) {
+        histograms_[h].sources.push_back(&sig);
+    }
+
+    bool open(const std::string& shm_name, const std::string& label, std::string& error) {
+        uint64_t fs = uint64_t(sc_get_time_resolution().to_seconds() * 1e15 + 0.5);
+        if (!log_.open(shm_name, label, fs, error)) return false;
+        last_ = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    // 环境变量var给出共享内存名字时打开；未设置时不发布
+    bool open_env(const std::string& label, const char* var = "TELEMETRY") {
+        const char* shm_name = std::getenv(var);
+        if (!shm_name) return true;
+        std::string error;
+        if (!open(shm_name, label, error)) {
+            std::cout << "错误: " << error << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool is_open() const { return log_.is_open(); }
+
+    // 立即读取全部计数并发布
+    void publish() {
+        if (!log_.is_open()) return;
+        uint64_t* v = log_.values();
+        for (const counter_read& r : reads_) v[r.offset] = r.read();
+        log_.publish(sc_time_stamp().value(), uint64_t(sc_time_stamp() / period_));
+        last_ = std::chrono::steady_clock::now();
+    }
+
+private:
+    struct counter_read {
+        unsigned int offset;
+        std::function<uint64_t()> read;
+    };
+
+    struct histogram {
+        unsigned int offset;
+        unsigned int bins;
+        std::vector<const sc_signal_in_if<unsigned int>*> sources;
+    };
+
+    writer log_;
+    sc_time period_;
+    sc_time sample_;
+    std::vector<counter_read> reads_;
+    std::vector<histogram> histograms_;
+    std::chrono::steady_clock::time_point last_;
+    bool done_ = false;
+
+    void tick() {
+        if (!log_.is_open() || done_) return;
+        uint64_t* v = log_.values();
+        for (const histogram& h : histograms_) {
+            for (const sc_signal_in_if<unsigned int>* s : h.sources) {
+                v[h.offset + std::min(s->read(), h.bins - 1)]++;
+            }
+        }
+        if (std::chrono::steady_clock::now() - last_ >= interval) publish();
+        next_trigger(sample_);
+    }
+
+    void end_of_simulation() override {
+        finish();
+    }
+
+    // 发布最后的快照并标记结束
+    void finish() {
+        if (done_ || !log_.is_open()) return;
+        done_ = true;
+        publish();
+        log_.close();
+    }
+};
+
+} // namespace tele
+
+#endif // TELEMETRY_PUBLISHER_H
@@ -0,0 +1,174 @@
+// File: telemetry_top.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cerrno>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <signal.h>
+#include <unistd.h>
+#include "telemetry.h"
+
+// 显示中的两个快照：最新的一个，以及它之前读到的一个（用于计算速率）
+struct view {
+    tele::snapshot last;
+    tele::snapshot base;
+    bool has_last = false;
+    bool has_base = false;
+
+    // 读到新的快照时更新，返回是否是新的
+    bool update(const tele::snapshot& s) {
+        if (has_last && s.index == last.index) return false;
+        if (has_last) {
+            base = last;
+            has_base = true;
+        }
+        last = s;
+        has_last = true;
+        return true;
+    }
+};
+
+static double per_second(uint64_t delta, uint64_t wall_ns) {
+    return wall_ns ? double(delta) * 1e9 / double(wall_ns) : 0.0;
+}
+
+// 直方图一行：每仓的比例，后面是平均值
+static void print_histogram(const tele::field_desc& f, const uint64_t* v) {
+    uint64_t total = 0;
+    double sum = 0;
+    for (unsigned int b = 0; b < f.bins; b++) {
+        total += v[b];
+        sum += double(b) * double(v[b]);
+    }
+    std::cout << "  " << std::left << std::setw(20) << f.name << std::right
+              << "采样 " << total << ", 平均 " << std::fixed << std::setprecision(2)
+              << (total ? sum / double(total) : 0.0) << "\n";
+    for (unsigned int b = 0; b < f.bins; b++) {
+        double p = total ? double(v[b]) / double(total) : 0.0;
+        std::cout << "  " << std::setw(22) << (b + 1 == f.bins ? std::to_string(b) + "+" : std::to_string(b))
+                  << std::setprecision(1) << std::setw(7) << p * 100 << "% "
+                  << std::string(size_t(p * 40 + 0.5), '#') << "\n";
+    }
+}
+
+static void print_view(const tele::reader& r, const view& w, bool finished) {
+    const tele::region& info = r.info();
+    const tele::snapshot& s = w.last;
+    double sim_us = double(s.sim_time) * double(info.resolution_fs) * 1e-9;
+    std::cout << info.label << "  (pid " << info.pid << ", " << (finished ? "已结束" : "运行中")
+              << ", 快照 " << s.index + 1 << ")\n";
+    std::cout << std::fixed << std::setprecision(3)
+              << "仿真时间 " << sim_us << " us, 周期 " << s.cycles
+              << ", 墙钟 " << double(s.wall_ns) * 1e-9 << " s\n"
+              << std::setprecision(0) << "每秒仿真周期数 平均 " << per_second(s.cycles, s.wall_ns);
+    if (w.has_base) {
+        std::cout << ", 最近 " << per_second(s.cycles - w.base.cycles, s.wall_ns - w.base.wall_ns);
+    }
+    std::cout << "\n\n";
+
+    for (unsigned int i = 0; i < info.field_count; i++) {
+        const tele::field_desc& f = info.fields[i];
+        const uint64_t* v = s.values + f.offset;
+        if (f.kind == uint32_t(tele::kind::histogram)) {
+            print_histogram(f, v);
+            continue;
+        }
+        std::cout << "  " << std::left << std::setw(20) << f.name << std::right << std::setw(16) << v[0];
+        if (f.kind == uint32_t(tele::kind::counter) && w.has_base) {
+            std::cout << std::setw(16) << std::setprecision(0)
+                      << per_second(v[0] - w.base.values[f.offset], s.wall_ns - w.base.wall_ns) << "/s";
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::flush;
+}
+
+// 用法: telemetry_top [-f] [-n 次数] [-i 毫秒] <名字>
+//   名字与仿真进程的TELEMETRY环境变量相同；-f在一次运行结束后继续等待同名的下一次运行
+//   （例如noc_bench每个注入率一个子进程）；-n显示若干次后退出；-i为刷新间隔，默认1000毫秒
+int main(int argc, char* argv[]) {
+    bool follow = false;
+    uint64_t count = 0;
+    unsigned int interval_ms = 1000;
+    std::string name;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-f") {
+            follow = true;
+        } else if (arg == "-n" && i + 1 < argc) {
+            count = std::stoull(argv[++i]);
+        } else if (arg == "-i" && i + 1 < argc) {
+            interval_ms = std::stoul(argv[++i]);
+        } else {
+            name = arg;
+        }
+    }
+    if (name.empty()) {
+        std::cout << "用法: " << argv[0] << " [-f] [-n 次数] [-i 毫秒] <名字>\n";
+        return 2;
+    }
+
+    bool tty = isatty(STDOUT_FILENO);
+    std::unique_ptr<view> w;
+    tele::reader r;
+    std::unique_ptr<tele::snapshot> s(new tele::snapshot);
+    bool waiting = false;
+    uint64_t shown = 0;
+    uint32_t done_pid = 0;      // 已经显示过结束的运行，写者删除名字之前可能再次映射到它
+
+    for (;;) {
+        if (!r.is_attached()) {
+            std::string error;
+            if (r.attach(name, error)) {
+                if (r.finished() && r.info().pid == done_pid) {
+                    r.detach();
+                } else {
+                    w.reset(new view);
+                    waiting = false;
+                }
+            } else if (!waiting) {
+                std::cout << "等待仿真: " << error << std::endl;
+                waiting = true;
+            }
+        }
+
+        if (r.is_attached()) {
+            // 先取结束标志再取快照，结束时一定显示的是最后一个快照
+            bool finished = r.finished();
+            if (r.latest(*s)) {
+                w->update(*s);
+                if (tty) std::cout << "\033[H\033[2J";
+                else if (shown) std::cout << "\n";
+                print_view(r, *w, finished);
+                shown++;
+            }
+            bool gone = !finished && kill(pid_t(r.info().pid), 0) != 0 && errno == ESRCH;
+            if (gone) std::cout << "仿真进程已退出，没有正常结束" << std::endl;
+            if (finished || gone) {
+                done_pid = r.info().pid;
+                r.detach();
+                if (!follow) return 0;
+            }
+        }
+
+        if (count && shown >= count) return 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    }
+}
@@ -0,0 +1,171 @@
+// File: txn_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "txn_log.h"
+#include "stimulus.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    std::cout << (ok ? "  通过: " : "  失败: ") << what << std::endl;
+    if (!ok) failures++;
+}
+
+// 与fifo_tb相同的一组字段
+static void define_fields(txn::writer& w) {
+    w.add_field("rst_n", 1);
+    w.add_field("write_en", 1);
+    w.add_field("data_in", 32);
+    w.add_field("read_en", 1);
+    w.add_field("data_out", 32);
+    w.add_field("full", 1);
+    w.add_field("empty", 1);
+    w.add_field("size", 32);
+}
+
+// 写n条由(种子)决定的记录；alter_record处把alter_field改成另一个值（-1改时间戳）
+static bool write_log(const std::string& path, uint64_t n, uint64_t alter_record = ~uint64_t(0),
+                      int alter_field = 0) {
+    txn::writer w;
+    define_fields(w);
+    std::string error;
+    if (!w.open(path, error)) {
+        std::cout << "错误: " << error << std::endl;
+        return false;
+    }
+    stim::philox_stream rng(1, stim::STREAM_USER);
+    unsigned int fields = unsigned(w.format().fields.size());
+    for (uint64_t k = 0; k < n; k++) {
+        uint64_t time = 10000 * k + 5000;
+        for (unsigned int f = 0; f < fields; f++) {
+            uint64_t v = rng.next_u32();
+            if (k == alter_record && int(f) == alter_field) v ^= 1;
+            w.set(f, v);
+        }
+        if (k == alter_record && alter_field < 0) time++;
+        w.record(time);
+    }
+    return w.close(error);
+}
+
+static void self_check(const std::string& dir) {
+    std::cout << "\n===== 事务日志自检 =====\n";
+    const uint64_t N = 100000;
+    std::string a = dir + "/txn_check_a.txn", b = dir + "/txn_check_b.txn";
+    std::string error;
+    txn::divergence d;
+
+    write_log(a, N);
+    write_log(b, N);
+    check(txn::compare(a, b, d, error) && d.kind == txn::divergence::none && d.records == N, "相同的日志逐位一致");
+
+    write_log(b, N, N - 7, 4);
+    check(txn::compare(a, b, d, error) && d.kind == txn::divergence::value && d.record == N - 7 && d.field == 4 &&
+          (d.a ^ d.b) == 1, "定位到第一处不同的记录和字段");
+
+    write_log(b, N, 5, -1);
+    check(txn::compare(a, b, d, error) && d.kind == txn::divergence::value && d.record == 5 && d.field == -1,
+          "时间戳不同");
+
+    write_log(b, N - 1);
+    check(txn::compare(a, b, d, error) && d.kind == txn::divergence::length && d.records == N - 1,
+          "一个日志提前结束");
+
+    {
+        txn::writer w;
+        w.add_field("x", 4);
+        w.add_field("y", 12);
+        w.open(b, error);
+        w.set(0, uint64_t(-3));
+        w.set(1, 0x1234);
+        w.record(7);
+        w.close(error);
+    }
+    check(txn::compare(a, b, d, error) && d.kind == txn::divergence::format, "字段不同");
+    txn::reader r;
+    const uint8_t* rec;
+    check(r.open(b, error) && r.read(16, rec) == 1 && r.format().value(rec, 0) == 0xD &&
+          r.format().value(rec, 1) == 0x234 && r.format().time(rec) == 7, "按位宽截断，有符号数取补码");
+
+    {
+        FILE* f = std::fopen(b.c_str(), "ab");
+        std::fputc(0, f);
+        std::fclose(f);
+    }
+    txn::reader r2;
+    check(r2.open(b, error) && r2.read(16, rec) == 1 && r2.truncated(), "末尾不足一条记录时报告截断");
+
+    check(!txn::compare(a, dir + "/txn_missing.txn", d, error), "文件不存在时报错");
+
+    std::remove(a.c_str());
+    std::remove(b.c_str());
+}
+
+// 写出和比较两个records条记录的日志的速度
+static void bench(const std::string& dir, uint64_t records) {
+    std::cout << "\n===== 事务日志速度 (" << records << " 条记录) =====\n";
+    std::string a = dir + "/txn_bench_a.txn", b = dir + "/txn_bench_b.txn";
+
+    auto t0 = std::chrono::steady_clock::now();
+    bool ok = write_log(a, records);
+    auto t1 = std::chrono::steady_clock::now();
+    ok = write_log(b, records, records - 1, 7) && ok;
+    if (!ok) {
+        failures++;
+        return;
+    }
+
+    txn::divergence d;
+    std::string error;
+    auto t2 = std::chrono::steady_clock::now();
+    ok = txn::compare(a, b, d, error);
+    auto t3 = std::chrono::steady_clock::now();
+
+    txn::reader r;
+    r.open(a, error);
+    double mb = double(records) * r.format().record_bytes / 1e6;
+    double w = std::chrono::duration<double>(t1 - t0).count();
+    double c = std::chrono::duration<double>(t3 - t2).count();
+    std::cout << "每条记录 " << r.format().record_bytes << " 字节，日志 " << std::fixed << std::setprecision(1)
+              << mb << " MB\n";
+    std::cout << "写入: " << std::setprecision(0) << records / w << " 条/s, " << mb / w << " MB/s\n";
+    std::cout << "比较: " << records / c << " 条/s, " << 2 * mb / c << " MB/s（两个日志合计）\n";
+    check(ok && d.kind == txn::divergence::value && d.record == records - 1, "在最后一条记录发现不同");
+
+    std::remove(a.c_str());
+    std::remove(b.c_str());
+}
+
+// 用法: txn_bench [记录数] [临时文件目录]
+int main(int argc, char* argv[]) {
+    uint64_t records = argc > 1 ? std::stoull(argv[1]) : 4000000;
+    std::string dir = argc > 2 ? argv[2] : ".";
+
+    self_check(dir);
+    bench(dir, records);
+
+    if (failures) {
+        std::cout << "\n===== 事务日志测试失败 (" << failures << "处错误) =====" << std::endl;
+        return 1;
+    }
+    std::cout << "\n===== 事务日志测试通过 =====" << std::endl;
+    return 0;
+}
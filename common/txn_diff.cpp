@@ -0,0 +1,115 @@
+// File: txn_diff.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "txn_log.h"
+
+static std::string hex(uint64_t v) {
+    std::ostringstream os;
+    os << "0x" << std::hex << v;
+    return os.str();
+}
+
+// 并排打印两条记录，不同的字段用*标出
+static void print_records(const txn::layout& l, const uint8_t* a, const uint8_t* b) {
+    std::cout << std::left << std::setw(16) << "  字段" << std::setw(20) << "参考" << "待比较\n";
+    for (int f = -1; f < int(l.fields.size()); f++) {
+        uint64_t x = f < 0 ? l.time(a) : l.value(a, f);
+        uint64_t y = f < 0 ? l.time(b) : l.value(b, f);
+        std::string name = f < 0 ? "时间" : l.fields[f].name;
+        std::cout << (x != y ? "* " : "  ") << std::left << std::setw(14) << name
+                  << std::setw(20) << hex(x) << hex(y) << "\n";
+    }
+}
+
+// 打印日志的字段和从first开始的count条记录
+static int dump(const std::string& path, uint64_t first, uint64_t count) {
+    txn::reader r;
+    std::string error;
+    if (!r.open(path, error)) {
+        std::cout << "错误: " << error << std::endl;
+        return 2;
+    }
+    const txn::layout& l = r.format();
+    std::cout << path << ": " << l.fields.size() << "个字段, 每条记录" << l.record_bytes << "字节\n";
+    std::cout << std::right << std::setw(10) << "记录" << std::setw(16) << "时间";
+    for (const txn::field& f : l.fields) std::cout << std::setw(12) << f.name;
+    std::cout << "\n";
+
+    uint64_t index = 0;
+    const uint8_t* data;
+    while (size_t n = r.read(4096, data)) {
+        for (size_t i = 0; i < n; i++, index++) {
+            if (index < first) continue;
+            if (index >= first + count) return 0;
+            const uint8_t* rec = data + i * l.record_bytes;
+            std::cout << std::setw(10) << index << std::setw(16) << l.time(rec) << std::hex;
+            for (unsigned int f = 0; f < l.fields.size(); f++) std::cout << std::setw(12) << l.value(rec, f);
+            std::cout << std::dec << "\n";
+        }
+    }
+    if (r.truncated()) std::cout << "（日志末尾不完整）\n";
+    return 0;
+}
+
+// 用法: txn_diff <参考日志> <待比较日志>
+//       txn_diff -p <日志> [起始记录] [条数]
+// 比较时两者逐位相同返回0，有不同返回1，无法读取返回2
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && std::string(argv[1]) == "-p") {
+        uint64_t first = argc > 3 ? std::stoull(argv[3]) : 0;
+        uint64_t count = argc > 4 ? std::stoull(argv[4]) : 20;
+        return dump(argv[2], first, count);
+    }
+    if (argc != 3) {
+        std::cout << "用法: " << argv[0] << " <参考日志> <待比较日志>\n"
+                  << "      " << argv[0] << " -p <日志> [起始记录] [条数]\n";
+        return 2;
+    }
+
+    txn::divergence d;
+    std::string error;
+    if (!txn::compare(argv[1], argv[2], d, error)) {
+        std::cout << "错误: " << error << std::endl;
+        return 2;
+    }
+
+    switch (d.kind) {
+    case txn::divergence::none:
+        std::cout << "一致: " << d.records << " 条记录逐位相同\n";
+        return 0;
+    case txn::divergence::format:
+        std::cout << "不同: 两个日志的字段不同\n";
+        break;
+    case txn::divergence::length:
+        std::cout << "不同: 前 " << d.records << " 条记录相同，之后一个日志先结束\n";
+        break;
+    case txn::divergence::value: {
+        txn::reader r;
+        r.open(argv[1], error);
+        const txn::layout& l = r.format();
+        std::cout << "不同: 第一处不同在记录 " << d.record << "，"
+                  << (d.field < 0 ? std::string("时间") : "字段 " + l.fields[d.field].name)
+                  << " 参考=" << hex(d.a) << " 待比较=" << hex(d.b) << "\n";
+        print_records(l, d.rec_a.data(), d.rec_b.data());
+        break;
+    }
+    }
+    return 1;
+}
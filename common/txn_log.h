@@ -0,0 +1,307 @@
+// File: txn_log.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TXN_LOG_H
+#define TXN_LOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 二进制事务日志：每条记录是一个采样时刻的全部端口值。测试平台用它保存黄金输出，
+// 优化过的实现（原生数据类型、周期引擎、release/PGO构建等）的日志再与之逐位比较。
+//
+// 文件格式（小端）：
+//   头部   "TXNL" | 版本 u32 | 字段数 u32 | 记录字节数 u32
+//          每个字段：位宽 u8 | 名字长度 u8 | 名字
+//   记录   时间戳 u64 | 各字段的值，按位宽占1、2、4或8字节
+// 记录定长，比较时整块memcmp，发现不同后再定位到记录和字段
+namespace txn {
+
+static const char MAGIC[4] = {'T', 'X', 'N', 'L'};
+static const uint32_t VERSION = 1;
+static const unsigned int TIME_BYTES = 8;
+
+inline unsigned int field_bytes(unsigned int bits) {
+    return bits <= 8 ? 1 : bits <= 16 ? 2 : bits <= 32 ? 4 : 8;
+}
+
+inline void put(uint8_t* p, uint64_t v, unsigned int n) {
+    for (unsigned int i = 0; i < n; i++) p[i] = uint8_t(v >> (8 * i));
+}
+
+inline uint64_t get(const uint8_t* p, unsigned int n) {
+    uint64_t v = 0;
+    for (unsigned int i = 0; i < n; i++) v |= uint64_t(p[i]) << (8 * i);
+    return v;
+}
+
+struct field {
+    std::string name;
+    unsigned int bits;
+    unsigned int bytes;
+    unsigned int offset;        // 在记录中的偏移（含开头的时间戳）
+};
+
+// 记录布局：字段表和每条记录的字节数
+struct layout {
+    std::vector<field> fields;
+    unsigned int record_bytes;
+
+    layout() : record_bytes(TIME_BYTES) {}
+
+    unsigned int add(const std::string& name, unsigned int bits) {
+        bits = bits == 0 ? 1 : bits > 64 ? 64 : bits;
+        field f = {name.substr(0, 255), bits, field_bytes(bits), record_bytes};
+        fields.push_back(f);
+        record_bytes += f.bytes;
+        return unsigned(fields.size() - 1);
+    }
+
+    bool operator==(const layout& o) const {
+        if (fields.size() != o.fields.size()) return false;
+        for (size_t i = 0; i < fields.size(); i++) {
+            if (fields[i].name != o.fields[i].name || fields[i].bits != o.fields[i].bits) return false;
+        }
+        return true;
+    }
+
+    uint64_t time(const uint8_t* rec) const { return get(rec, TIME_BYTES); }
+    uint64_t value(const uint8_t* rec, unsigned int i) const {
+        return get(rec + fields[i].offset, fields[i].bytes);
+    }
+};
+
+// 写日志：先add_field定义字段，open写出头部，之后每次采样set各字段再record
+class writer {
+public:
+    writer() : file_(nullptr), used_(0), records_(0), failed_(false) {}
+    ~writer() {
+        std::string error;
+        close(error);
+    }
+
+    unsigned int add_field(const std::string& name, unsigned int bits) { return layout_.add(name, bits); }
+    const layout& format() const { return layout_; }
+
+    bool open(const std::string& path, std::string& error) {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            error = "无法创建 " + path;
+            return false;
+        }
+        std::vector<uint8_t> h(16);
+        std::memcpy(h.data(), MAGIC, 4);
+        put(&h[4], VERSION, 4);
+        put(&h[8], layout_.fields.size(), 4);
+        put(&h[12], layout_.record_bytes, 4);
+        for (const field& f : layout_.fields) {
+            h.push_back(uint8_t(f.bits));
+            h.push_back(uint8_t(f.name.size()));
+            h.insert(h.end(), f.name.begin(), f.name.end());
+        }
+        rec_.assign(layout_.record_bytes, 0);
+        buf_.resize(BUFFER_RECORDS * layout_.record_bytes);
+        used_ = 0;
+        records_ = 0;
+        failed_ = std::fwrite(h.data(), 1, h.size(), file_) != h.size();
+        return !failed_;
+    }
+
+    bool is_open() const { return file_ != nullptr; }
+
+    // 只保留低bits位，有符号数按补码截断
+    void set(unsigned int i, uint64_t v) {
+        if (!file_) return;
+        const field& f = layout_.fields[i];
+        if (f.bits < 64) v &= (uint64_t(1) << f.bits) - 1;
+        put(&rec_[f.offset], v, f.bytes);
+    }
+
+    // 以time为时间戳追加一条记录，字段取最近一次set的值
+    void record(uint64_t time) {
+        if (!file_) return;
+        put(rec_.data(), time, TIME_BYTES);
+        std::memcpy(&buf_[used_], rec_.data(), rec_.size());
+        used_ += rec_.size();
+        records_++;
+        if (used_ == buf_.size()) flush();
+    }
+
+    uint64_t records() const { return records_; }
+
+    bool close(std::string& error) {
+        if (!file_) return true;
+        flush();
+        bool ok = !failed_ && std::fclose(file_) == 0;
+        file_ = nullptr;
+        if (!ok) error = "写日志失败";
+        return ok;
+    }
+
+private:
+    static const size_t BUFFER_RECORDS = 4096;
+
+    layout layout_;
+    FILE* file_;
+    std::vector<uint8_t> rec_;      // 正在填写的记录
+    std::vector<uint8_t> buf_;
+    size_t used_;
+    uint64_t records_;
+    bool failed_;
+
+    void flush() {
+        if (used_ && std::fwrite(buf_.data(), 1, used_, file_) != used_) failed_ = true;
+        used_ = 0;
+    }
+};
+
+// 顺序读日志，每次读出一块整条的记录
+class reader {
+public:
+    reader() : file_(nullptr) {}
+    ~reader() {
+        if (file_) std::fclose(file_);
+    }
+    reader(const reader&) = delete;
+    reader& operator=(const reader&) = delete;
+
+    bool open(const std::string& path, std::string& error) {
+        file_ = std::fopen(path.c_str(), "rb");
+        if (!file_) {
+            error = "无法打开 " + path;
+            return false;
+        }
+        uint8_t h[16];
+        if (std::fread(h, 1, 16, file_) != 16 || std::memcmp(h, MAGIC, 4) != 0) {
+            error = path + " 不是事务日志";
+            return false;
+        }
+        if (get(&h[4], 4) != VERSION) {
+            error = path + " 的版本不支持";
+            return false;
+        }
+        uint32_t n = uint32_t(get(&h[8], 4));
+        for (uint32_t i = 0; i < n; i++) {
+            uint8_t fh[2];
+            char name[256];
+            if (std::fread(fh, 1, 2, file_) != 2 || std::fread(name, 1, fh[1], file_) != fh[1]) {
+                error = path + " 的头部不完整";
+                return false;
+            }
+            layout_.add(std::string(name, fh[1]), fh[0]);
+        }
+        if (layout_.record_bytes != get(&h[12], 4)) {
+            error = path + " 的记录长度与字段不符";
+            return false;
+        }
+        return true;
+    }
+
+    const layout& format() const { return layout_; }
+
+    // 读出最多max条记录，data指向内部缓冲；返回条数，0表示已到末尾。
+    // 文件末尾不足一条的残余字节记为截断
+    size_t read(size_t max, const uint8_t*& data) {
+        size_t rb = layout_.record_bytes;
+        buf_.resize(max * rb);
+        size_t got = std::fread(buf_.data(), 1, buf_.size(), file_);
+        if (got % rb) truncated_ = true;
+        data = buf_.data();
+        return got / rb;
+    }
+
+    bool truncated() const { return truncated_; }
+
+private:
+    FILE* file_;
+    layout layout_;
+    std::vector<uint8_t> buf_;
+    bool truncated_ = false;
+};
+
+// 两个日志的第一处不同
+struct divergence {
+    enum kind_t { none, format, value, length };
+    kind_t kind;
+    uint64_t record;            // 第一条不同的记录（从0开始），length时为较短日志的记录数
+    int field;                  // 不同的字段，-1为时间戳
+    uint64_t a, b;              // 两个日志中该字段的值
+    uint64_t records;           // 不同之前相同的记录数
+    std::vector<uint8_t> rec_a, rec_b;      // 两条不同的记录（value时）
+
+    divergence() : kind(none), record(0), field(0), a(0), b(0), records(0) {}
+};
+
+// 流式比较两个日志，内存占用与日志长度无关。返回false表示无法读取；
+// 能读取时d.kind为none表示两者逐位相同
+inline bool compare(const std::string& path_a, const std::string& path_b, divergence& d, std::string& error) {
+    d = divergence();
+    reader ra, rb;
+    if (!ra.open(path_a, error) || !rb.open(path_b, error)) return false;
+    const layout& l = ra.format();
+    if (!(l == rb.format())) {
+        d.kind = divergence::format;
+        return true;
+    }
+
+    const size_t BLOCK = (size_t(1) << 20) / l.record_bytes + 1;
+    const size_t rbytes = l.record_bytes;
+    uint64_t base = 0;
+    for (;;) {
+        const uint8_t* pa;
+        const uint8_t* pb;
+        size_t na = ra.read(BLOCK, pa);
+        size_t nb = rb.read(BLOCK, pb);
+        size_t n = na < nb ? na : nb;
+        if (std::memcmp(pa, pb, n * rbytes) != 0) {
+            size_t i = 0;
+            while (std::memcmp(pa + i * rbytes, pb + i * rbytes, rbytes) == 0) i++;
+            const uint8_t* x = pa + i * rbytes;
+            const uint8_t* y = pb + i * rbytes;
+            d.kind = divergence::value;
+            d.record = base + i;
+            d.records = base + i;
+            d.field = -1;
+            d.a = l.time(x);
+            d.b = l.time(y);
+            for (unsigned int f = 0; d.a == d.b && f < l.fields.size(); f++) {
+                d.field = int(f);
+                d.a = l.value(x, f);
+                d.b = l.value(y, f);
+            }
+            d.rec_a.assign(x, x + rbytes);
+            d.rec_b.assign(y, y + rbytes);
+            return true;
+        }
+        base += n;
+        if (na != nb || ra.truncated() != rb.truncated()) {
+            d.kind = divergence::length;
+            d.record = base;
+            d.records = base;
+            return true;
+        }
+        if (na == 0) break;
+    }
+    d.records = base;
+    return true;
+}
+
+} // namespace txn
+
+#endif // TXN_LOG_H
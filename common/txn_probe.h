@@ -0,0 +1,103 @@
+// File: txn_probe.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TXN_PROBE_H
+#define TXN_PROBE_H
+
+#include <systemc.h>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "txn_log.h"
+#include "power_window.h"
+
+// txn_log.h的SystemC部分：采样一组信号写入事务日志
+namespace txn {
+
+// 信号类型的位宽，决定日志中字段的宽度
+template<typename T>
+struct width { static const unsigned int value = sizeof(T) * 8; };
+
+template<>
+struct width<bool> { static const unsigned int value = 1; };
+
+template<int W>
+struct width<sc_int<W>> { static const unsigned int value = W; };
+
+template<int W>
+struct width<sc_uint<W>> { static const unsigned int value = W; };
+
+// 日志探针：测试平台用add登记要记录的信号，open_env在设置了TXN_LOG时打开日志。
+// 带trigger构造时在每次trigger发生时采样（例如时钟下降沿），否则由测试平台调用sample()。
+// 没有打开日志时sample()直接返回，不影响测试平台原来的运行
+class probe : public sc_module {
+public:
+    SC_HAS_PROCESS(probe);
+
+    explicit probe(sc_module_name name) : sc_module(name) {}
+
+    probe(sc_module_name name, const sc_event& trigger) : sc_module(name) {
+        SC_METHOD(sample);
+        sensitive << trigger;
+        dont_initialize();
+    }
+
+    ~probe() {
+        std::string error;
+        if (!log_.close(error)) std::cout << "错误: " << name() << ": " << error << std::endl;
+    }
+
+    // 登记一个信号，字段按登记的顺序排列；应在open之前调用
+    template<typename T>
+    void add(const std::string& field, const sc_signal_in_if<T>& sig) {
+        log_.add_field(field, width<T>::value);
+        reads_.push_back([&sig]() { return pwr::bits(sig.read()); });
+    }
+
+    bool open(const std::string& path, std::string& error) { return log_.open(path, error); }
+
+    // 环境变量var给出日志路径时打开日志；未设置时不记录
+    bool open_env(const char* var = "TXN_LOG") {
+        const char* path = std::getenv(var);
+        if (!path) return true;
+        std::string error;
+        if (!log_.open(path, error)) {
+            std::cout << "错误: " << error << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool is_open() const { return log_.is_open(); }
+    uint64_t records() const { return log_.records(); }
+
+    // 记录所有登记的信号的当前值，时间戳为当前仿真时间（以时间分辨率为单位）
+    void sample() {
+        if (!log_.is_open()) return;
+        for (unsigned int i = 0; i < reads_.size(); i++) log_.set(i, reads_[i]());
+        log_.record(sc_time_stamp().value());
+    }
+
+private:
+    writer log_;
+    std::vector<std::function<uint64_t()>> reads_;
+};
+
+} // namespace txn
+
+#endif // TXN_PROBE_H
@@ -0,0 +1,406 @@
+// File: cycle_engine.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef CYCLE_ENGINE_H
+#define CYCLE_ENGINE_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 基于周期的（levelized）快速仿真引擎
+// 适用于全同步设计：不使用事件队列、delta周期和sc_signal的request_update，
+// 组合节点在elaborate()时一次性按拓扑层次排序，之后每个时钟周期按固定顺序
+// 直线执行；时序元件采用两阶段更新（先采样全部输入，再统一提交状态）。
+// 所有线网的值保存在一个扁平数组中，用net_id索引。
+//
+// 行为与事件驱动模型逐位一致，包括以下细节：
+// - register_file/ram的读输出只在地址变化时刷新（与SC_METHOD敏感列表相同），
+//   写入当前地址后输出保持旧值，直到地址变化
+// - ram在时钟上升沿先输出写入前的值再写入
+// - fifo的状态输出只在发生读或写时更新，读操作先于写操作，满时同周期读写不写入
+class cycle_engine {
+public:
+    typedef uint32_t net_id;
+
+    // 添加一个线网，返回其编号
+    net_id add_net(const std::string& name, int64_t init = 0) {
+        nets_.push_back(init);
+        names_.push_back(name);
+        driver_.push_back(NO_DRIVER);
+        return nets_.size() - 1;
+    }
+
+    // 2位4选1选择器：F = X[Y]
+    void add_mux4(net_id x0, net_id x1, net_id x2, net_id x3, net_id y, net_id f) {
+        add_comb(COMB_MUX4, {x0, x1, x2, x3, y}, {f}, 0);
+    }
+
+    // 4位带符号补码ALU，操作数和结果以-8~7的整数保存
+    void add_alu4(net_id a, net_id b, net_id op,
+                  net_id result, net_id zero, net_id overflow, net_id carry) {
+        add_comb(COMB_ALU4, {a, b, op}, {result, zero, overflow, carry}, 0);
+    }
+
+    // 16x8位寄存器堆，返回存储编号（用于后门访问）
+    unsigned int add_register_file(net_id rd_addr, net_id wr_addr, net_id wr_data,
+                                   net_id wr_en, net_id rd_data) {
+        unsigned int base = alloc_storage();
+        add_comb(COMB_MEM_READ, {rd_addr}, {rd_data}, base);
+        add_seq(SEQ_REG_WRITE, {wr_addr, wr_data, wr_en}, {}, base);
+        return base / MEM_WORDS;
+    }
+
+    // 16x8位RAM，返回存储编号（用于后门访问）
+    unsigned int add_ram(net_id addr, net_id wr_data, net_id wr_en, net_id rd_data) {
+        unsigned int base = alloc_storage();
+        add_comb(COMB_MEM_READ, {addr}, {rd_data}, base);
+        // 上升沿时ram也会刷新rd_data，但它与读节点属于同一个元件，不计为第二个驱动
+        add_seq(SEQ_RAM, {addr, wr_data, wr_en}, {}, base);
+        pins_.push_back(rd_data);
+        return base / MEM_WORDS;
+    }
+
+    // 深度为depth的FIFO，状态以结构数组形式保存
+    void add_fifo(unsigned int depth, net_id rst_n, net_id write_en, net_id data_in,
+                  net_id read_en, net_id data_out, net_id full, net_id empty, net_id size) {
+        unsigned int index = fifo_depth_.size();
+        fifo_base_.push_back(fifo_data_.size());
+        fifo_depth_.push_back(depth);
+        fifo_head_.push_back(0);
+        fifo_count_.push_back(0);
+        fifo_data_.resize(fifo_data_.size() + depth, 0);
+
+        add_seq(SEQ_FIFO, {rst_n, write_en, data_in, read_en},
+                {data_out, full, empty, size}, index);
+        nets_[data_out] = 0;
+        nets_[full] = 0;
+        nets_[empty] = 1;
+        nets_[size] = 0;
+    }
+
+    // 层次化排序：每个组合节点的层次 = 驱动其输入的组合节点的最大层次 + 1
+    // 存在组合环路时返回false
+    bool elaborate() {
+        std::vector<unsigned int> pending(comb_.size(), 0);
+        std::vector<std::vector<unsigned int>> fanout(comb_.size());
+        for (unsigned int i = 0; i < comb_.size(); i++) {
+            for (unsigned int k = 0; k < comb_[i].num_in; k++) {
+                int32_t d = driver_[pins_[comb_[i].pin + k]];
+                if (d >= 0) {
+                    fanout[d].push_back(i);
+                    pending[i]++;
+                }
+            }
+        }
+
+        schedule_.clear();
+        levels_ = 0;
+        std::vector<unsigned int> ready;
+        for (unsigned int i = 0; i < comb_.size(); i++) {
+            if (pending[i] == 0) ready.push_back(i);
+        }
+        while (!ready.empty()) {
+            std::vector<unsigned int> next;
+            for (unsigned int i : ready) {
+                schedule_.push_back(comb_[i]);
+                for (unsigned int j : fanout[i]) {
+                    if (--pending[j] == 0) next.push_back(j);
+                }
+            }
+            levels_++;
+            ready.swap(next);
+        }
+
+        if (schedule_.size() != comb_.size()) {
+            std::cerr << "Error: 组合逻辑存在环路，无法分层" << std::endl;
+            return false;
+        }
+        if (conflict_) {
+            return false;
+        }
+
+        // 第一次求值时所有读节点无条件刷新（对应SystemC初始化阶段每个进程执行一次）
+        for (auto& a : last_addr_) a = INVALID_ADDR;
+        eval();
+        return true;
+    }
+
+    void set(net_id n, int64_t v) {
+        nets_[n] = v;
+        dirty_ = true;
+    }
+
+    int64_t get(net_id n) const {
+        return nets_[n];
+    }
+
+    // 按层次顺序求值所有组合节点
+    void eval() {
+        for (const node& n : schedule_) {
+            const net_id* p = &pins_[n.pin];
+            switch (n.kind) {
+            case COMB_MUX4:
+                nets_[p[5]] = nets_[p[nets_[p[4]] & 3]];
+                break;
+            case COMB_ALU4:
+                alu4(nets_[p[0]], nets_[p[1]], nets_[p[2]],
+                     nets_[p[3]], nets_[p[4]], nets_[p[5]], nets_[p[6]]);
+                break;
+            case COMB_MEM_READ: {
+                uint32_t addr = nets_[p[0]] & 0xF;
+                if (addr != last_addr_[n.state]) {
+                    last_addr_[n.state] = addr;
+                    nets_[p[1]] = storage_[n.aux + addr];
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        dirty_ = false;
+    }
+
+    // 一个时钟上升沿：采样全部时序输入，统一提交，再重新求值组合逻辑
+    void step() {
+        if (dirty_) eval();
+
+        const unsigned int n = sample_pins_.size();
+        for (unsigned int i = 0; i < n; i++) {
+            sampled_[i] = nets_[sample_pins_[i]];
+        }
+        for (const node& s : seq_) {
+            commit(s);
+        }
+
+        eval();
+        cycles_++;
+    }
+
+    // 后门访问寄存器堆/RAM存储
+    uint8_t& mem(unsigned int storage, unsigned int addr) {
+        return storage_[storage * MEM_WORDS + (addr & 0xF)];
+    }
+
+    const std::string& net_name(net_id n) const { return names_[n]; }
+    unsigned int num_nets() const { return nets_.size(); }
+    unsigned int num_levels() const { return levels_; }
+    uint64_t cycles() const { return cycles_; }
+
+    // 与alu_4bit::alu_process逐位一致的整数实现
+    static void alu4(int64_t a, int64_t b, int64_t op,
+                     int64_t& result, int64_t& zero, int64_t& overflow, int64_t& carry) {
+        int res = 0;
+        bool c = false, v = false;
+        switch (op & 7) {
+        case 0: {
+            int ext = a + b;   // 5位足以容纳，不会回绕
+            c = (a >= 0 && b >= 0 && ext >= 8) || (a < 0 && b < 0 && ext < -8);
+            v = (a > 0 && b > 0 && ext < 0) || (a < 0 && b < 0 && ext >= 0);
+            res = sext4(ext);
+            break;
+        }
+        case 1: {
+            int ext = a - b;
+            c = (a >= 0 && b < 0 && ext >= 8) || (a < 0 && b >= 0 && ext < -8);
+            v = (a >= 0 && b < 0 && ext < 0) || (a < 0 && b >= 0 && ext >= 0);
+            res = sext4(ext);
+            break;
+        }
+        case 2: res = sext4(~a); break;
+        case 3: res = sext4(a & b); break;
+        case 4: res = sext4(a | b); break;
+        case 5: res = sext4(a ^ b); break;
+        case 6: res = (a < b) ? 1 : 0; break;
+        case 7: res = (a == b) ? 1 : 0; break;
+        }
+        result = res;
+        zero = (res == 0);
+        overflow = v;
+        carry = c;
+    }
+
+    // 取低4位并符号扩展（等价于sc_int<4>的赋值截断）
+    static int sext4(int64_t v) {
+        return int((v & 0xF) ^ 0x8) - 8;
+    }
+
+private:
+    enum node_kind : uint8_t {
+        COMB_MUX4, COMB_ALU4, COMB_MEM_READ,
+        SEQ_REG_WRITE, SEQ_RAM, SEQ_FIFO
+    };
+
+    static constexpr int32_t NO_DRIVER = -1;
+    static constexpr int32_t SEQ_DRIVER = -2;
+    static constexpr unsigned int MEM_WORDS = 16;
+    static constexpr uint32_t INVALID_ADDR = 0xFFFFFFFFu;
+
+    // 组合节点和时序节点共用的描述
+    // 组合节点：pin指向pins_中连续的输入和输出
+    // 时序节点：sample指向sampled_中连续的采样输入，out_pin指向pins_中的输出
+    struct node {
+        node_kind kind;
+        uint8_t  num_in;
+        uint32_t pin;
+        uint32_t sample;
+        uint32_t out_pin;
+        uint32_t aux;      // 存储基址或fifo编号
+        uint32_t state;    // 读节点的last_addr_槽位
+    };
+
+    void add_comb(node_kind k, std::initializer_list<net_id> in,
+                  std::initializer_list<net_id> out, uint32_t aux) {
+        node n = {k, uint8_t(in.size()), uint32_t(pins_.size()), 0, 0, aux, 0};
+        for (net_id i : in) pins_.push_back(i);
+        for (net_id o : out) {
+            set_driver(o, comb_.size());
+            pins_.push_back(o);
+        }
+        if (k == COMB_MEM_READ) {
+            n.state = last_addr_.size();
+            last_addr_.push_back(INVALID_ADDR);
+        }
+        comb_.push_back(n);
+    }
+
+    void add_seq(node_kind k, std::initializer_list<net_id> in,
+                 std::initializer_list<net_id> out, uint32_t aux) {
+        node n = {k, uint8_t(in.size()), 0, uint32_t(sample_pins_.size()),
+                  uint32_t(pins_.size()), aux, 0};
+        for (net_id i : in) {
+            sample_pins_.push_back(i);
+            sampled_.push_back(0);
+        }
+        for (net_id o : out) {
+            set_driver(o, SEQ_DRIVER);
+            pins_.push_back(o);
+        }
+        seq_.push_back(n);
+    }
+
+    void set_driver(net_id n, int32_t d) {
+        if (driver_[n] != NO_DRIVER) {
+            std::cerr << "Error: 线网 " << names_[n] << " 存在多个驱动" << std::endl;
+            conflict_ = true;
+        }
+        driver_[n] = d;
+    }
+
+    unsigned int alloc_storage() {
+        unsigned int base = storage_.size();
+        storage_.resize(base + MEM_WORDS, 0);
+        return base;
+    }
+
+    // 第二阶段：只读取sampled_，写入状态和输出线网
+    void commit(const node& s) {
+        const int64_t* in = &sampled_[s.sample];
+        const net_id* out = &pins_[s.out_pin];
+        switch (s.kind) {
+        case SEQ_REG_WRITE:
+            // in: wr_addr, wr_data, wr_en
+            if (in[2]) storage_[s.aux + (in[0] & 0xF)] = uint8_t(in[1]);
+            break;
+        case SEQ_RAM: {
+            // in: addr, wr_data, wr_en；先输出写入前的值
+            uint8_t& cell = storage_[s.aux + (in[0] & 0xF)];
+            nets_[out[0]] = cell;
+            if (in[2]) cell = uint8_t(in[1]);
+            break;
+        }
+        case SEQ_FIFO:
+            commit_fifo(s.aux, in, out);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // in: rst_n, write_en, data_in, read_en
+    // out: data_out, full, empty, size
+    void commit_fifo(unsigned int f, const int64_t* in, const net_id* out) {
+        const uint32_t depth = fifo_depth_[f];
+        uint32_t& head = fifo_head_[f];
+        uint32_t& count = fifo_count_[f];
+        int64_t* data = &fifo_data_[fifo_base_[f]];
+
+        if (!in[0]) {
+            head = 0;
+            count = 0;
+            nets_[out[0]] = 0;
+            nets_[out[1]] = 0;
+            nets_[out[2]] = 1;
+            nets_[out[3]] = 0;
+            return;
+        }
+
+        const bool was_full = count >= depth;
+        bool changed = false;
+        if (in[3] && count != 0) {
+            nets_[out[0]] = data[head];
+            head = (head + 1 == depth) ? 0 : head + 1;
+            count--;
+            changed = true;
+        }
+        if (in[1] && !was_full) {
+            uint32_t tail = head + count;
+            if (tail >= depth) tail -= depth;
+            data[tail] = in[2];
+            count++;
+            changed = true;
+        }
+        if (changed) {
+            nets_[out[1]] = count >= depth;
+            nets_[out[2]] = count == 0;
+            nets_[out[3]] = count;
+        }
+    }
+
+    // 线网
+    std::vector<int64_t> nets_;
+    std::vector<std::string> names_;
+    std::vector<int32_t> driver_;
+
+    // 节点
+    std::vector<node> comb_;
+    std::vector<node> schedule_;
+    std::vector<node> seq_;
+    std::vector<net_id> pins_;
+    std::vector<net_id> sample_pins_;
+    std::vector<int64_t> sampled_;
+
+    // 寄存器堆/RAM存储与读节点状态
+    std::vector<uint8_t> storage_;
+    std::vector<uint32_t> last_addr_;
+
+    // FIFO状态（结构数组）
+    std::vector<int64_t> fifo_data_;
+    std::vector<uint32_t> fifo_base_;
+    std::vector<uint32_t> fifo_depth_;
+    std::vector<uint32_t> fifo_head_;
+    std::vector<uint32_t> fifo_count_;
+
+    unsigned int levels_ = 0;
+    uint64_t cycles_ = 0;
+    bool dirty_ = false;
+    bool conflict_ = false;
+};
+
+#endif // CYCLE_ENGINE_H
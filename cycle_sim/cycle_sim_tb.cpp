@@ -0,0 +1,482 @@
+// File: cycle_sim_tb.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+#include "cycle_engine.h"
+#include "../mux_4to1/mux_4to1.h"
+#include "../alu_4bit/alu_4bit.h"
+#include "../register_ram/register_file.h"
+#include "../register_ram/ram.h"
+#include "../fifo_design/fifo.h"
+#include "../common/txn_probe.h"
+
+// 每个周期施加给所有模块的激励
+struct stimulus {
+    int x[4], y;                               // 选择器
+    int a, b, op;                              // ALU
+    int chain_op[3];                           // ALU链
+    int rd_addr, wr_addr, reg_data, reg_wr_en; // 寄存器堆
+    int ram_addr, ram_data, ram_wr_en;         // RAM
+    int rst_n, write_en, data_in, read_en;     // FIFO
+};
+
+// 确定性激励生成器：前1024个周期穷举选择器，前2048个周期穷举ALU，之后随机
+struct stimulus_gen {
+    uint64_t state;
+    int ram_addr;
+
+    explicit stimulus_gen(uint64_t seed) : state(seed), ram_addr(0) {}
+
+    uint32_t next() {
+        // xorshift64*
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return uint32_t((state * 2685821657736338717ULL) >> 32);
+    }
+
+    stimulus make(uint64_t k) {
+        stimulus s;
+        uint32_t r = next();
+        if (k < 1024) {
+            for (int i = 0; i < 4; i++) s.x[i] = (k >> (2 * i)) & 3;
+            s.y = (k >> 8) & 3;
+        } else {
+            for (int i = 0; i < 4; i++) s.x[i] = (r >> (2 * i)) & 3;
+            s.y = (r >> 8) & 3;
+        }
+
+        r = next();
+        uint32_t alu_bits = k < 2048 ? uint32_t(k) : r;
+        s.a = cycle_engine::sext4(alu_bits & 0xF);
+        s.b = cycle_engine::sext4((alu_bits >> 4) & 0xF);
+        s.op = (alu_bits >> 8) & 7;
+
+        r = next();
+        s.rd_addr = r & 0xF;
+        s.wr_addr = (r >> 4) & 0xF;
+        s.reg_data = (r >> 8) & 0xFF;
+        s.reg_wr_en = (r >> 16) & 1;
+
+        // RAM地址一半时间保持不变，以覆盖"写入当前地址后读输出保持旧值"的情形
+        r = next();
+        if ((r & 1) == 0) ram_addr = (r >> 1) & 0xF;
+        s.ram_addr = ram_addr;
+        s.ram_data = (r >> 8) & 0xFF;
+        s.ram_wr_en = ((r >> 16) & 3) == 0;
+
+        r = next();
+        s.rst_n = k >= 3 && (r % 500) != 0;
+        s.write_en = ((r >> 9) % 10) < 6;
+        s.read_en = ((r >> 13) % 10) < 4;
+        s.data_in = (r >> 17) & 0x7FFF;
+
+        r = next();
+        for (int i = 0; i < 3; i++) s.chain_op[i] = (r >> (3 * i)) & 7;
+        return s;
+    }
+};
+
+// ALU链的级数：第i级的A接上一级的结果，B接再上一级的结果，构成多层组合逻辑
+static const int CHAIN = 3;
+
+// 引擎中与各模块端口对应的线网
+struct engine_nets {
+    cycle_engine::net_id x[4], y, f;
+    cycle_engine::net_id a, b, op, result, zero, overflow, carry;
+    cycle_engine::net_id chain_op[CHAIN], chain_result[CHAIN], chain_zero[CHAIN];
+    cycle_engine::net_id chain_overflow[CHAIN], chain_carry[CHAIN];
+    cycle_engine::net_id rd_addr, wr_addr, reg_data, reg_wr_en, reg_rd_data;
+    cycle_engine::net_id ram_addr, ram_data, ram_wr_en, ram_rd_data;
+    cycle_engine::net_id rst_n, write_en, data_in, read_en, data_out, full, empty, size;
+};
+
+// 在引擎中建立与testbench相同的网表
+bool build_engine(cycle_engine& e, engine_nets& n) {
+    for (int i = 0; i < 4; i++) n.x[i] = e.add_net("X" + std::to_string(i));
+    n.y = e.add_net("Y");
+    n.f = e.add_net("F");
+    e.add_mux4(n.x[0], n.x[1], n.x[2], n.x[3], n.y, n.f);
+
+    n.a = e.add_net("A");
+    n.b = e.add_net("B");
+    n.op = e.add_net("op");
+    n.result = e.add_net("result");
+    n.zero = e.add_net("zero");
+    n.overflow = e.add_net("overflow");
+    n.carry = e.add_net("carry");
+    e.add_alu4(n.a, n.b, n.op, n.result, n.zero, n.overflow, n.carry);
+
+    // ALU链按从后到前的顺序加入，求值顺序只能来自elaborate()的分层排序
+    for (int i = 0; i < CHAIN; i++) {
+        std::string k = std::to_string(i);
+        n.chain_op[i] = e.add_net("chain_op" + k);
+        n.chain_result[i] = e.add_net("chain_result" + k);
+        n.chain_zero[i] = e.add_net("chain_zero" + k);
+        n.chain_overflow[i] = e.add_net("chain_overflow" + k);
+        n.chain_carry[i] = e.add_net("chain_carry" + k);
+    }
+    for (int i = CHAIN - 1; i >= 0; i--) {
+        cycle_engine::net_id a = i == 0 ? n.result : n.chain_result[i - 1];
+        cycle_engine::net_id b = i == 0 ? n.b : i == 1 ? n.result : n.chain_result[i - 2];
+        e.add_alu4(a, b, n.chain_op[i], n.chain_result[i], n.chain_zero[i],
+                   n.chain_overflow[i], n.chain_carry[i]);
+    }
+
+    n.rd_addr = e.add_net("reg_rd_addr");
+    n.wr_addr = e.add_net("reg_wr_addr");
+    n.reg_data = e.add_net("reg_wr_data");
+    n.reg_wr_en = e.add_net("reg_wr_en");
+    n.reg_rd_data = e.add_net("reg_rd_data");
+    e.add_register_file(n.rd_addr, n.wr_addr, n.reg_data, n.reg_wr_en, n.reg_rd_data);
+
+    n.ram_addr = e.add_net("ram_addr");
+    n.ram_data = e.add_net("ram_wr_data");
+    n.ram_wr_en = e.add_net("ram_wr_en");
+    n.ram_rd_data = e.add_net("ram_rd_data");
+    e.add_ram(n.ram_addr, n.ram_data, n.ram_wr_en, n.ram_rd_data);
+
+    n.rst_n = e.add_net("rst_n");
+    n.write_en = e.add_net("write_en");
+    n.data_in = e.add_net("data_in");
+    n.read_en = e.add_net("read_en");
+    n.data_out = e.add_net("data_out");
+    n.full = e.add_net("full");
+    n.empty = e.add_net("empty");
+    n.size = e.add_net("size");
+    e.add_fifo(8, n.rst_n, n.write_en, n.data_in, n.read_en,
+               n.data_out, n.full, n.empty, n.size);
+
+    return e.elaborate();
+}
+
+void apply(cycle_engine& e, const engine_nets& n, const stimulus& s) {
+    for (int i = 0; i < 4; i++) e.set(n.x[i], s.x[i]);
+    e.set(n.y, s.y);
+    e.set(n.a, s.a);
+    e.set(n.b, s.b);
+    e.set(n.op, s.op);
+    for (int i = 0; i < CHAIN; i++) e.set(n.chain_op[i], s.chain_op[i]);
+    e.set(n.rd_addr, s.rd_addr);
+    e.set(n.wr_addr, s.wr_addr);
+    e.set(n.reg_data, s.reg_data);
+    e.set(n.reg_wr_en, s.reg_wr_en);
+    e.set(n.ram_addr, s.ram_addr);
+    e.set(n.ram_data, s.ram_data);
+    e.set(n.ram_wr_en, s.ram_wr_en);
+    e.set(n.rst_n, s.rst_n);
+    e.set(n.write_en, s.write_en);
+    e.set(n.data_in, s.data_in);
+    e.set(n.read_en, s.read_en);
+}
+
+SC_MODULE(cycle_sim_tb) {
+    sc_clock clk;
+
+    sc_signal<sc_uint<2>> X_sig[4];
+    sc_signal<sc_uint<2>> Y_sig;
+    sc_signal<sc_uint<2>> F_sig;
+
+    sc_signal<sc_int<4>> A_sig;
+    sc_signal<sc_int<4>> B_sig;
+    sc_signal<sc_uint<3>> op_sig;
+    sc_signal<sc_int<4>> result_sig;
+    sc_signal<bool> zero_sig;
+    sc_signal<bool> overflow_sig;
+    sc_signal<bool> carry_sig;
+
+    sc_signal<sc_uint<3>> chain_op[CHAIN];
+    sc_signal<sc_int<4>> chain_result[CHAIN];
+    sc_signal<bool> chain_zero[CHAIN];
+    sc_signal<bool> chain_overflow[CHAIN];
+    sc_signal<bool> chain_carry[CHAIN];
+
+    sc_signal<sc_uint<4>> reg_rd_addr;
+    sc_signal<sc_uint<4>> reg_wr_addr;
+    sc_signal<sc_uint<8>> reg_wr_data;
+    sc_signal<bool> reg_wr_en;
+    sc_signal<sc_uint<8>> reg_rd_data;
+
+    sc_signal<sc_uint<4>> ram_addr;
+    sc_signal<sc_uint<8>> ram_wr_data;
+    sc_signal<bool> ram_wr_en;
+    sc_signal<sc_uint<8>> ram_rd_data;
+
+    sc_signal<bool> rst_n;
+    sc_signal<bool> write_en;
+    sc_signal<int> data_in;
+    sc_signal<bool> read_en;
+    sc_signal<int> data_out;
+    sc_signal<bool> full;
+    sc_signal<bool> empty;
+    sc_signal<unsigned int> size;
+
+    // 事件驱动模型
+    mux_4to1 mux_inst;
+    alu_4bit alu_inst;
+    sc_vector<alu_4bit> chain_inst;
+    register_file reg_file;
+    ram memory;
+    fifo<int, 8> fifo_inst;
+
+    // 周期引擎模型
+    cycle_engine engine;
+    engine_nets nets;
+
+    uint64_t num_cycles;
+    uint64_t mismatches;
+    double seconds;
+    bool engine_ok;
+
+    // 事务日志：TXN_LOG记录事件驱动模型的输出，TXN_ENGINE_LOG记录周期引擎的同一组输出，
+    // 字段和时间戳相同，两者以及与保存的黄金输出都可以直接用txn_diff比较
+    txn::probe txn_log;
+    txn::writer engine_log;
+
+    template<typename T>
+    void add_log_field(const std::string& name, const sc_signal<T>& sig) {
+        txn_log.add(name, sig);
+        engine_log.add_field(name, txn::width<T>::value);
+    }
+
+    void log_outputs() {
+        txn_log.sample();
+        if (!engine_log.is_open()) return;
+        const cycle_engine::net_id outputs[] = {
+            nets.f, nets.result, nets.zero, nets.overflow, nets.carry, nets.reg_rd_data,
+            nets.ram_rd_data, nets.data_out, nets.full, nets.empty, nets.size
+        };
+        for (unsigned int i = 0; i < sizeof(outputs) / sizeof(outputs[0]); i++) {
+            engine_log.set(i, uint64_t(engine.get(outputs[i])));
+        }
+        engine_log.record(sc_time_stamp().value());
+    }
+
+    // 比较一个输出，不一致时打印前若干条
+    void check(uint64_t cycle, cycle_engine::net_id n, int64_t expected) {
+        int64_t actual = engine.get(n);
+        if (actual != expected) {
+            if (mismatches < 10) {
+                std::cout << "错误: 周期 " << cycle << " 线网 " << engine.net_name(n)
+                          << " 事件驱动=" << expected << " 周期引擎=" << actual << std::endl;
+            }
+            mismatches++;
+        }
+    }
+
+    void compare(uint64_t cycle) {
+        check(cycle, nets.f, F_sig.read().to_int());
+        check(cycle, nets.result, result_sig.read().to_int());
+        check(cycle, nets.zero, zero_sig.read());
+        check(cycle, nets.overflow, overflow_sig.read());
+        check(cycle, nets.carry, carry_sig.read());
+        for (int i = 0; i < CHAIN; i++) {
+            check(cycle, nets.chain_result[i], chain_result[i].read().to_int());
+            check(cycle, nets.chain_zero[i], chain_zero[i].read());
+            check(cycle, nets.chain_overflow[i], chain_overflow[i].read());
+            check(cycle, nets.chain_carry[i], chain_carry[i].read());
+        }
+        check(cycle, nets.reg_rd_data, reg_rd_data.read().to_int());
+        check(cycle, nets.ram_rd_data, ram_rd_data.read().to_int());
+        check(cycle, nets.data_out, data_out.read());
+        check(cycle, nets.full, full.read());
+        check(cycle, nets.empty, empty.read());
+        check(cycle, nets.size, size.read());
+        log_outputs();
+    }
+
+    // 在时钟下降沿比较上一周期的结果，并同时向两个模型施加新激励
+    void test_process() {
+        stimulus_gen gen(0x5eed);
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint64_t k = 0; k < num_cycles; k++) {
+            wait(clk.negedge_event());
+            compare(k);
+
+            stimulus s = gen.make(k);
+            for (int i = 0; i < 4; i++) X_sig[i].write(s.x[i]);
+            Y_sig.write(s.y);
+            A_sig.write(s.a);
+            B_sig.write(s.b);
+            op_sig.write(s.op);
+            for (int i = 0; i < CHAIN; i++) chain_op[i].write(s.chain_op[i]);
+            reg_rd_addr.write(s.rd_addr);
+            reg_wr_addr.write(s.wr_addr);
+            reg_wr_data.write(s.reg_data);
+            reg_wr_en.write(s.reg_wr_en);
+            ram_addr.write(s.ram_addr);
+            ram_wr_data.write(s.ram_data);
+            ram_wr_en.write(s.ram_wr_en);
+            rst_n.write(s.rst_n);
+            write_en.write(s.write_en);
+            data_in.write(s.data_in);
+            read_en.write(s.read_en);
+
+            // 引擎一步对应下一个上升沿
+            apply(engine, nets, s);
+            engine.step();
+        }
+
+        wait(clk.negedge_event());
+        compare(num_cycles);
+
+        auto end = std::chrono::steady_clock::now();
+        seconds = std::chrono::duration<double>(end - start).count();
+        sc_stop();
+    }
+
+    SC_CTOR(cycle_sim_tb)
+    : clk("clk", 10, SC_NS),
+      mux_inst("mux_instance"),
+      alu_inst("alu_instance"),
+      chain_inst("chain_alu", CHAIN),
+      reg_file("register_file_inst"),
+      memory("ram_inst"),
+      fifo_inst("fifo_instance"),
+      num_cycles(20000),
+      mismatches(0),
+      seconds(0),
+      engine_ok(false),
+      txn_log("txn_log") {
+
+        mux_inst.X0(X_sig[0]);
+        mux_inst.X1(X_sig[1]);
+        mux_inst.X2(X_sig[2]);
+        mux_inst.X3(X_sig[3]);
+        mux_inst.Y(Y_sig);
+        mux_inst.F(F_sig);
+
+        alu_inst.A(A_sig);
+        alu_inst.B(B_sig);
+        alu_inst.op(op_sig);
+        alu_inst.result(result_sig);
+        alu_inst.zero(zero_sig);
+        alu_inst.overflow(overflow_sig);
+        alu_inst.carry(carry_sig);
+
+        for (int i = 0; i < CHAIN; i++) {
+            chain_inst[i].A(i == 0 ? result_sig : chain_result[i - 1]);
+            chain_inst[i].B(i == 0 ? B_sig : i == 1 ? result_sig : chain_result[i - 2]);
+            chain_inst[i].op(chain_op[i]);
+            chain_inst[i].result(chain_result[i]);
+            chain_inst[i].zero(chain_zero[i]);
+            chain_inst[i].overflow(chain_overflow[i]);
+            chain_inst[i].carry(chain_carry[i]);
+        }
+
+        reg_file.clk(clk);
+        reg_file.rd_addr(reg_rd_addr);
+        reg_file.wr_addr(reg_wr_addr);
+        reg_file.wr_data(reg_wr_data);
+        reg_file.wr_en(reg_wr_en);
+        reg_file.rd_data(reg_rd_data);
+
+        memory.clk(clk);
+        memory.addr(ram_addr);
+        memory.wr_data(ram_wr_data);
+        memory.wr_en(ram_wr_en);
+        memory.rd_data(ram_rd_data);
+
+        fifo_inst.debug_print = false;
+        fifo_inst.clk(clk);
+        fifo_inst.rst_n(rst_n);
+        fifo_inst.write_en(write_en);
+        fifo_inst.data_in(data_in);
+        fifo_inst.read_en(read_en);
+        fifo_inst.data_out(data_out);
+        fifo_inst.full(full);
+        fifo_inst.empty(empty);
+        fifo_inst.size(size);
+
+        engine_ok = build_engine(engine, nets);
+
+        // 字段顺序与log_outputs中的线网顺序一致
+        add_log_field("F", F_sig);
+        add_log_field("result", result_sig);
+        add_log_field("zero", zero_sig);
+        add_log_field("overflow", overflow_sig);
+        add_log_field("carry", carry_sig);
+        add_log_field("reg_rd_data", reg_rd_data);
+        add_log_field("ram_rd_data", ram_rd_data);
+        add_log_field("data_out", data_out);
+        add_log_field("full", full);
+        add_log_field("empty", empty);
+        add_log_field("size", size);
+        txn_log.open_env();
+        if (const char* path = std::getenv("TXN_ENGINE_LOG")) {
+            std::string error;
+            if (!engine_log.open(path, error)) std::cout << "错误: " << error << std::endl;
+        }
+
+        SC_THREAD(test_process);
+    }
+};
+
+// 只运行周期引擎，测量吞吐量
+double bench_engine(uint64_t cycles) {
+    cycle_engine e;
+    engine_nets n;
+    if (!build_engine(e, n)) return 0;
+    stimulus_gen gen(0x5eed);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t k = 0; k < cycles; k++) {
+        apply(e, n, gen.make(k));
+        e.step();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// 用法: cycle_sim_tb [对比周期数] [引擎基准周期数]
+int sc_main(int argc, char* argv[]) {
+    uint64_t validate_cycles = argc > 1 ? std::stoull(argv[1]) : 20000;
+    uint64_t bench_cycles = argc > 2 ? std::stoull(argv[2]) : 1000000;
+
+    cycle_sim_tb tb("cycle_sim_testbench");
+    tb.num_cycles = validate_cycles;
+
+    std::cout << "\n===== 周期引擎与事件驱动模型对比 =====\n";
+    if (!tb.engine_ok) {
+        std::cout << "错误: 周期引擎网表建立失败（组合环路或多驱动）\n";
+        std::cout << "\n===== 周期引擎验证失败 =====\n";
+        return 1;
+    }
+    std::cout << "线网数: " << tb.engine.num_nets()
+              << ", 组合层次: " << tb.engine.num_levels() << "\n";
+
+    sc_start();
+
+    std::cout << "对比周期数: " << validate_cycles
+              << ", 不一致次数: " << tb.mismatches << "\n";
+    std::cout << "事件驱动+引擎 并行运行: " << std::fixed << std::setprecision(0)
+              << (validate_cycles / tb.seconds) << " 周期/s\n";
+
+    double engine_seconds = bench_engine(bench_cycles);
+    std::cout << "仅周期引擎: " << (bench_cycles / engine_seconds) << " 周期/s\n";
+
+    if (tb.mismatches != 0) {
+        std::cout << "\n===== 周期引擎验证失败 =====\n";
+        return 1;
+    }
+    std::cout << "\n===== 周期引擎验证通过 =====\n";
+    return 0;
+}
@@ -0,0 +1,261 @@
+// File: comb_net.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef COMB_NET_H
+#define COMB_NET_H
+
+#include <systemc.h>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// 零delta组合网络
+// 由sc_signal连接的组合模块链，每一级都要经过一次request_update和一个delta周期。
+// comb_net是用于组合模块之间连线的通道：写入立即生效，不经过内核的更新阶段；
+// 各组合模块登记到comb_network中，由它在elaborate结束时按拓扑层次静态排序，
+// 输入变化后在同一个求值阶段内按层次顺序直接调用各模块的求值函数，每个模块至多一次。
+//
+// 网络的边界仍然是普通sc_signal：输入由时序逻辑驱动，经input()登记；输出（例如ALU的
+// 结果和标志）直接接sc_signal。因此时钟沿上任何进程看到的值都与全部使用sc_signal时相同，
+// 整个网络只占一个delta周期。
+//
+// 限制：
+// - 网络内部只能是组合逻辑，comb_net只能由网络中的节点写入
+// - comb_net写入后立即可见，不要在网络之外读取
+// - 不支持bool（bool通道还需要posedge/negedge）
+class comb_network;
+
+// 线网的公共部分：驱动节点和扇出节点
+class comb_net_base {
+public:
+    comb_net_base() : network(nullptr), driver(-1) {}
+    virtual ~comb_net_base() {}
+
+protected:
+    friend class comb_network;
+    comb_network* network;
+    int driver;                         // 驱动该线网的节点，-1表示网络的输入
+    std::vector<unsigned int> fanout;   // 读该线网的节点
+
+    inline void changed();
+};
+
+// 网络的边界输入：包装一个由网络外部驱动的sc_signal
+class comb_boundary : public comb_net_base {
+public:
+    virtual bool event() const = 0;
+};
+
+template<typename T>
+class comb_input : public comb_boundary {
+public:
+    explicit comb_input(const sc_signal_in_if<T>& sig) : sig(sig) {}
+    bool event() const override { return sig.event(); }
+
+private:
+    const sc_signal_in_if<T>& sig;
+};
+
+// 组合网络：节点登记、静态分层和求值
+SC_MODULE(comb_network) {
+    // 登记一个组合节点：eval是模块的求值函数（通常就是它的SC_METHOD），
+    // inputs和outputs是它读写的comb_net
+    void add(const std::function<void()>& eval,
+             std::initializer_list<comb_net_base*> inputs,
+             std::initializer_list<comb_net_base*> outputs) {
+        unsigned int id = nodes.size();
+        nodes.push_back(eval);
+        node_inputs.push_back(std::vector<comb_net_base*>(inputs));
+        for (comb_net_base* n : inputs) {
+            n->network = this;
+            n->fanout.push_back(id);
+        }
+        for (comb_net_base* n : outputs) {
+            n->network = this;
+            if (n->driver >= 0) {
+                SC_REPORT_ERROR("comb_network", "comb_net有多个驱动节点");
+            }
+            n->driver = id;
+        }
+    }
+
+    // 登记一个边界输入，返回值用作add()的输入；同一个信号只登记一次
+    template<typename T>
+    comb_net_base* input(const sc_signal_in_if<T>& sig) {
+        auto it = boundary_map.find(&sig);
+        if (it != boundary_map.end()) return it->second;
+        comb_boundary* b = new comb_input<T>(sig);
+        boundaries.push_back(std::unique_ptr<comb_boundary>(b));
+        boundary_map[&sig] = b;
+        // 模块构造结束后sensitive不再关联任何进程，需要重新指定为求值进程
+        sensitive << settle_handle << sig.value_changed_event();
+        return b;
+    }
+
+    unsigned int num_nodes() const { return nodes.size(); }
+    unsigned int num_levels() const { return buckets.size(); }
+
+    // 累计的节点求值次数
+    uint64_t evaluations() const { return evaluated; }
+
+    // 某个线网的值改变：把它的扇出节点放入各自层次的待求值列表
+    void mark(const std::vector<unsigned int>& fanout) {
+        if (dirty.empty()) return;      // 还在elaborate阶段，初始化时会全部求值一次
+        for (unsigned int id : fanout) {
+            if (!dirty[id]) {
+                dirty[id] = 1;
+                buckets[level[id]].push_back(id);
+            }
+        }
+        // 在网络之外写入comb_net时（不推荐）立即通知，在当前求值阶段内补做求值
+        if (!settling && !requested) {
+            requested = true;
+            settle_event.notify();
+        }
+    }
+
+    // 找出本delta中改变的边界输入，再按层次顺序求值所有待求值节点；
+    // 节点的输出只会让更高层次的节点变脏
+    void settle_process() {
+        settling = true;
+        requested = false;
+        for (const std::unique_ptr<comb_boundary>& b : boundaries) {
+            if (b->event()) mark(b->fanout);
+        }
+        for (std::vector<unsigned int>& bucket : buckets) {
+            for (size_t i = 0; i < bucket.size(); i++) {
+                unsigned int id = bucket[i];
+                dirty[id] = 0;
+                nodes[id]();
+                evaluated++;
+            }
+            bucket.clear();
+        }
+        settling = false;
+    }
+
+    // 静态分层：节点层次 = 驱动其输入的节点的最大层次 + 1
+    void end_of_elaboration() override {
+        const unsigned int UNKNOWN = ~0u;
+        level.assign(nodes.size(), UNKNOWN);
+        unsigned int levels = 0;
+        bool progress = true;
+        unsigned int done = 0;
+        while (progress && done < nodes.size()) {
+            progress = false;
+            for (unsigned int id = 0; id < nodes.size(); id++) {
+                if (level[id] != UNKNOWN) continue;
+                unsigned int l = 0;
+                bool ready = true;
+                for (comb_net_base* n : node_inputs[id]) {
+                    if (n->driver < 0) continue;
+                    if (level[n->driver] == UNKNOWN) {
+                        ready = false;
+                        break;
+                    }
+                    l = std::max(l, level[n->driver] + 1);
+                }
+                if (ready) {
+                    level[id] = l;
+                    levels = std::max(levels, l + 1);
+                    done++;
+                    progress = true;
+                }
+            }
+        }
+        if (done != nodes.size()) {
+            SC_REPORT_ERROR("comb_network", "组合逻辑存在环路，无法分层");
+            return;
+        }
+
+        buckets.assign(levels, std::vector<unsigned int>());
+        dirty.assign(nodes.size(), 0);
+        // 初始化阶段所有节点各求值一次（对应SystemC初始化时每个SC_METHOD执行一次）
+        for (unsigned int id = 0; id < nodes.size(); id++) {
+            dirty[id] = 1;
+            buckets[level[id]].push_back(id);
+        }
+    }
+
+    SC_CTOR(comb_network)
+    : settling(false), requested(false), evaluated(0) {
+        SC_METHOD(settle_process);
+        sensitive << settle_event;
+        settle_handle = sc_get_current_process_handle();
+    }
+
+private:
+    std::vector<std::function<void()>> nodes;
+    std::vector<std::vector<comb_net_base*>> node_inputs;
+    std::vector<unsigned int> level;
+    std::vector<std::vector<unsigned int>> buckets;   // 每个层次的待求值节点
+    std::vector<char> dirty;
+    std::vector<std::unique_ptr<comb_boundary>> boundaries;
+    std::map<const sc_interface*, comb_net_base*> boundary_map;
+    sc_event settle_event;
+    sc_process_handle settle_handle;
+    bool settling;
+    bool requested;
+    uint64_t evaluated;
+};
+
+inline void comb_net_base::changed() {
+    if (network && !fanout.empty()) network->mark(fanout);
+}
+
+// 组合网络中的线网，可以直接绑定到sc_in<T>/sc_out<T>端口
+template<typename T>
+class comb_net : public comb_net_base, public sc_signal_inout_if<T>, public sc_prim_channel {
+    static_assert(!std::is_same<T, bool>::value, "comb_net不支持bool，网络的bool输出请使用sc_signal");
+
+public:
+    comb_net() : sc_prim_channel(sc_gen_unique_name("comb_net")), value() {}
+    explicit comb_net(const char* name, const T& init = T()) : sc_prim_channel(name), value(init) {}
+
+    // 写入立即生效；值改变时通知网络重新求值扇出节点
+    void write(const T& v) override {
+        if (v == value) return;
+        value = v;
+        changed();
+    }
+
+    const T& read() const override { return value; }
+    const T& get_data_ref() const { return value; }
+
+    // 网络内的模块由comb_network直接调用，不需要内核事件；
+    // 这个事件只用于满足端口敏感列表的绑定，从不通知
+    const sc_event& value_changed_event() const override { return never; }
+    const sc_event& default_event() const override { return never; }
+    bool event() const override { return false; }
+
+    operator const T&() const { return value; }
+
+    comb_net& operator=(const T& v) {
+        write(v);
+        return *this;
+    }
+
+    const char* kind() const override { return "comb_net"; }
+
+private:
+    T value;
+    sc_event never;
+};
+
+#endif // COMB_NET_H
@@ -0,0 +1,311 @@
+// File: comb_net_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "comb_net.h"
+#include "../mux_4to1/mux_4to1.h"
+#include "../alu_4bit/alu_4bit.h"
+#include "../common/stimulus.h"
+
+// 组合链基准：每个单元4条8级mux_4to1链，两条拼成ALU的A，两条拼成B。
+// 第0级的4个输入都是叶子，之后每级的X0接上一级的输出，X1~X3是叶子。
+// 每个时钟沿随机改写全部叶子、选择信号和操作码。
+static const unsigned int CHAINS = 4;
+static const unsigned int LEVELS = 8;
+
+// 一个单元的边界输入，由时序逻辑驱动，两种实现共用
+struct unit_inputs {
+    sc_signal<sc_uint<2>> leaf[CHAINS][LEVELS][4];    // 第0级用X0~X3，之后各级用X1~X3
+    sc_signal<sc_uint<2>> sel[CHAINS][LEVELS];
+    sc_signal<sc_uint<3>> op;
+};
+
+// 两个2位切片拼成4位带符号操作数
+SC_MODULE(pack_4bit) {
+    sc_in<sc_uint<2>> lo;
+    sc_in<sc_uint<2>> hi;
+    sc_out<sc_int<4>> F;
+
+    void pack_process() {
+        int v = int((hi.read().to_uint() << 2) | lo.read().to_uint());
+        F.write((v ^ 8) - 8);
+    }
+
+    SC_CTOR(pack_4bit) {
+        SC_METHOD(pack_process);
+        sensitive << lo << hi;
+    }
+};
+
+// COMB为false时单元内部全部用sc_signal连接，为true时用comb_net连接并登记到网络
+template<bool COMB>
+struct mux_alu_unit : sc_module {
+    template<typename T>
+    using wire = typename std::conditional<COMB, comb_net<T>, sc_signal<T>>::type;
+
+    wire<sc_uint<2>> out[CHAINS][LEVELS];
+    wire<sc_int<4>> a;
+    wire<sc_int<4>> b;
+
+    // 网络的输出仍是sc_signal。comb版本中ALU自己的SC_METHOD在初始化时写一次，
+    // 之后由网络的求值进程写，所以需要允许多个写入进程
+    template<typename T>
+    using output = sc_signal<T, COMB ? SC_MANY_WRITERS : SC_ONE_WRITER>;
+
+    output<sc_int<4>> result;
+    output<bool> zero;
+    output<bool> overflow;
+    output<bool> carry;
+
+    mux_4to1* mux[CHAINS][LEVELS];
+    pack_4bit* pack_a;
+    pack_4bit* pack_b;
+    alu_4bit* alu;
+
+    mux_alu_unit(sc_module_name name, unit_inputs& in, comb_network* net) : sc_module(name) {
+        for (unsigned int c = 0; c < CHAINS; c++) {
+            for (unsigned int l = 0; l < LEVELS; l++) {
+                std::string n = "mux_" + std::to_string(c) + "_" + std::to_string(l);
+                mux_4to1* m = new mux_4to1(n.c_str());
+                mux[c][l] = m;
+                if (l == 0) {
+                    m->X0(in.leaf[c][0][0]);
+                } else {
+                    m->X0(out[c][l - 1]);
+                }
+                m->X1(in.leaf[c][l][1]);
+                m->X2(in.leaf[c][l][2]);
+                m->X3(in.leaf[c][l][3]);
+                m->Y(in.sel[c][l]);
+                m->F(out[c][l]);
+
+                if constexpr (COMB) {
+                    comb_net_base* x0 = l == 0 ? net->input(in.leaf[c][0][0]) : &out[c][l - 1];
+                    net->add([m] { m->mux_process(); },
+                             {x0, net->input(in.leaf[c][l][1]), net->input(in.leaf[c][l][2]),
+                              net->input(in.leaf[c][l][3]), net->input(in.sel[c][l])},
+                             {&out[c][l]});
+                }
+            }
+        }
+
+        pack_a = new pack_4bit("pack_a");
+        pack_a->lo(out[0][LEVELS - 1]);
+        pack_a->hi(out[1][LEVELS - 1]);
+        pack_a->F(a);
+        pack_b = new pack_4bit("pack_b");
+        pack_b->lo(out[2][LEVELS - 1]);
+        pack_b->hi(out[3][LEVELS - 1]);
+        pack_b->F(b);
+
+        alu = new alu_4bit("alu");
+        alu->A(a);
+        alu->B(b);
+        alu->op(in.op);
+        alu->result(result);
+        alu->zero(zero);
+        alu->overflow(overflow);
+        alu->carry(carry);
+
+        if constexpr (COMB) {
+            pack_4bit* pa = pack_a;
+            pack_4bit* pb = pack_b;
+            alu_4bit* u = alu;
+            net->add([pa] { pa->pack_process(); }, {&out[0][LEVELS - 1], &out[1][LEVELS - 1]}, {&a});
+            net->add([pb] { pb->pack_process(); }, {&out[2][LEVELS - 1], &out[3][LEVELS - 1]}, {&b});
+            net->add([u] { u->alu_process(); }, {&a, &b, net->input(in.op)}, {});
+        }
+    }
+
+    // 结果和三个标志打包，用于比较和校验和
+    unsigned int outputs() const {
+        return (result.read().to_uint() & 0xF) | (zero.read() << 4) | (overflow.read() << 5) | (carry.read() << 6);
+    }
+};
+
+// 在每个时钟上升沿随机改写全部边界输入
+SC_MODULE(leaf_driver) {
+    sc_in<bool> clk;
+
+    std::vector<unit_inputs*> units;
+    stim::philox_stream rng;
+    uint32_t bits;
+    unsigned int left;
+
+    SC_HAS_PROCESS(leaf_driver);
+
+    // 每个32位随机数切成16个2位值
+    unsigned int next2() {
+        if (left == 0) {
+            bits = rng.next_u32();
+            left = 16;
+        }
+        unsigned int v = bits & 3;
+        bits >>= 2;
+        left--;
+        return v;
+    }
+
+    void drive_process() {
+        for (unit_inputs* u : units) {
+            for (unsigned int c = 0; c < CHAINS; c++) {
+                for (unsigned int l = 0; l < LEVELS; l++) {
+                    for (unsigned int x = (l == 0 ? 0 : 1); x < 4; x++) {
+                        u->leaf[c][l][x].write(next2());
+                    }
+                    u->sel[c][l].write(next2());
+                }
+            }
+            u->op.write(rng.next_u32() & 7);
+        }
+    }
+
+    leaf_driver(sc_module_name name, uint64_t seed)
+    : sc_module(name), rng(seed, stim::STREAM_USER), bits(0), left(0) {
+        SC_METHOD(drive_process);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+};
+
+// 在时钟上升沿读取各单元的输出：此时看到的是上一周期的输入稳定后的结果。
+// reference为true时还用软件模型逐个单元检查，并比较两种实现的输出。
+SC_MODULE(result_checker) {
+    sc_in<bool> clk;
+
+    std::vector<unit_inputs*> inputs;
+    std::vector<mux_alu_unit<false>*> signal_units;
+    std::vector<mux_alu_unit<true>*> comb_units;
+    bool reference;
+    uint64_t checksum;
+    uint64_t cycles;
+    int errors;
+
+    static unsigned int chain_value(const unit_inputs& u, unsigned int c) {
+        unsigned int v = u.leaf[c][0][u.sel[c][0].read().to_uint()].read().to_uint();
+        for (unsigned int l = 1; l < LEVELS; l++) {
+            unsigned int s = u.sel[c][l].read().to_uint();
+            if (s != 0) v = u.leaf[c][l][s].read().to_uint();
+        }
+        return v;
+    }
+
+    static unsigned int expected(const unit_inputs& u) {
+        int a = int((chain_value(u, 1) << 2) | chain_value(u, 0));
+        int b = int((chain_value(u, 3) << 2) | chain_value(u, 2));
+        sc_int<4> res;
+        bool z, v, c;
+        alu_4bit::evaluate((a ^ 8) - 8, (b ^ 8) - 8, u.op.read(), res, z, v, c);
+        return (res.to_uint() & 0xF) | (z << 4) | (v << 5) | (c << 6);
+    }
+
+    void report(const char* variant, size_t i, unsigned int got, unsigned int want) {
+        if (errors < 10) {
+            std::cout << "错误: 周期 " << cycles << " 单元 " << i << " (" << variant << ") 输出 0x"
+                      << std::hex << got << ", 期望 0x" << want << std::dec << std::endl;
+        }
+        errors++;
+    }
+
+    void check_process() {
+        // 第一个上升沿在时刻0，组合逻辑可能还没有从初值稳定下来
+        if (cycles++ == 0) return;
+        for (size_t i = 0; i < inputs.size(); i++) {
+            unsigned int s = signal_units.empty() ? 0 : signal_units[i]->outputs();
+            unsigned int c = comb_units.empty() ? 0 : comb_units[i]->outputs();
+            checksum = checksum * 131 + (signal_units.empty() ? c : s);
+            if (!reference) continue;
+            unsigned int want = expected(*inputs[i]);
+            if (!signal_units.empty() && s != want) report("sc_signal", i, s, want);
+            if (!comb_units.empty() && c != want) report("comb_net", i, c, want);
+        }
+    }
+
+    SC_CTOR(result_checker) : reference(false), checksum(0), cycles(0), errors(0) {
+        SC_METHOD(check_process);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+};
+
+// 用法: comb_net_bench [signal|comb|both] [单元数] [周期数] [种子]
+//   signal  单元内部全部用sc_signal连接
+//   comb    单元内部用comb_net连接，由comb_network按层次直接调用
+//   both    两种实现同时运行，每个周期与软件模型逐个比较
+int sc_main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "both";
+    unsigned int num_units = argc > 2 ? std::stoul(argv[2]) : 64;
+    uint64_t num_cycles = argc > 3 ? std::stoull(argv[3]) : 10000;
+    uint64_t seed = argc > 4 ? std::stoull(argv[4]) : 1;
+    if (mode != "signal" && mode != "comb" && mode != "both") {
+        std::cout << "未知模式: " << mode << std::endl;
+        return 1;
+    }
+    bool use_signal = mode != "comb";
+    bool use_comb = mode != "signal";
+
+    sc_clock clk("clk", 10, SC_NS);
+    leaf_driver driver("driver", seed);
+    result_checker checker("checker");
+    comb_network net("net");
+    driver.clk(clk);
+    checker.clk(clk);
+    checker.reference = mode == "both";
+
+    for (unsigned int i = 0; i < num_units; i++) {
+        unit_inputs* in = new unit_inputs;
+        driver.units.push_back(in);
+        checker.inputs.push_back(in);
+        if (use_signal) {
+            std::string n = "signal_unit_" + std::to_string(i);
+            checker.signal_units.push_back(new mux_alu_unit<false>(n.c_str(), *in, nullptr));
+        }
+        if (use_comb) {
+            std::string n = "comb_unit_" + std::to_string(i);
+            checker.comb_units.push_back(new mux_alu_unit<true>(n.c_str(), *in, &net));
+        }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    sc_start(clk.period() * double(num_cycles));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    uint64_t cycles = checker.cycles;
+    std::cout << "模式 " << mode << ", 单元 " << num_units << ", mux " << num_units * CHAINS * LEVELS
+              << ", 周期 " << cycles << "\n"
+              << std::fixed << std::setprecision(3) << "用时 " << seconds << " s, "
+              << std::setprecision(0) << "每秒仿真周期数 " << (cycles / seconds) << "\n"
+              << std::setprecision(2) << "每周期delta数 " << double(sc_delta_count()) / cycles << "\n";
+    if (use_comb) {
+        std::cout << "网络节点 " << net.num_nodes() << ", 层次 " << net.num_levels()
+                  << ", 每周期节点求值 " << double(net.evaluations()) / cycles << "\n";
+    }
+    std::cout << "输出校验和 0x" << std::hex << checker.checksum << std::dec << std::endl;
+
+    if (checker.reference) {
+        if (checker.errors) {
+            std::cout << "===== 组合网络测试失败 (" << checker.errors << "处错误) =====" << std::endl;
+        } else {
+            std::cout << "===== 组合网络测试通过 =====" << std::endl;
+        }
+    }
+    return checker.errors ? 1 : 0;
+}
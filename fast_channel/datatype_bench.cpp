@@ -0,0 +1,260 @@
+// File: datatype_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "../register_ram/register_file.h"
+#include "../register_ram/ram.h"
+#include "../alu_4bit/alu_4bit.h"
+#include "../common/datatypes.h"
+#include "../common/stimulus.h"
+
+// 数据类型策略基准：每个单元一个寄存器堆、一个RAM和一个ALU，
+// 连线全部是sc_signal，只有模块内部的存储和运算类型随策略P改变
+template<typename P>
+struct datapath_unit : sc_module {
+    sc_signal<sc_uint<4>> reg_rd_addr;
+    sc_signal<sc_uint<4>> reg_wr_addr;
+    sc_signal<sc_uint<8>> reg_wr_data;
+    sc_signal<bool> reg_wr_en;
+    sc_signal<sc_uint<8>> reg_rd_data;
+
+    sc_signal<sc_uint<4>> ram_addr;
+    sc_signal<sc_uint<8>> ram_wr_data;
+    sc_signal<bool> ram_wr_en;
+    sc_signal<sc_uint<8>> ram_rd_data;
+
+    sc_signal<sc_int<4>> a;
+    sc_signal<sc_int<4>> b;
+    sc_signal<sc_uint<3>> op;
+    sc_signal<sc_int<4>> result;
+    sc_signal<bool> zero;
+    sc_signal<bool> overflow;
+    sc_signal<bool> carry;
+
+    register_file_t<P> reg_file;
+    ram_t<P> memory;
+    alu_4bit_t<P> alu;
+
+    datapath_unit(sc_module_name name, sc_clock& clk)
+    : sc_module(name), reg_file("reg_file"), memory("memory"), alu("alu") {
+        reg_file.clk(clk);
+        reg_file.rd_addr(reg_rd_addr);
+        reg_file.wr_addr(reg_wr_addr);
+        reg_file.wr_data(reg_wr_data);
+        reg_file.wr_en(reg_wr_en);
+        reg_file.rd_data(reg_rd_data);
+
+        memory.clk(clk);
+        memory.addr(ram_addr);
+        memory.wr_data(ram_wr_data);
+        memory.wr_en(ram_wr_en);
+        memory.rd_data(ram_rd_data);
+
+        alu.A(a);
+        alu.B(b);
+        alu.op(op);
+        alu.result(result);
+        alu.zero(zero);
+        alu.overflow(overflow);
+        alu.carry(carry);
+    }
+
+    // 全部输出打包，用于比较和校验和
+    uint64_t outputs() const {
+        return reg_rd_data.read().to_uint64()
+             | (ram_rd_data.read().to_uint64() << 8)
+             | (uint64_t(result.read().to_uint() & 0xF) << 16)
+             | (uint64_t(zero.read()) << 20)
+             | (uint64_t(overflow.read()) << 21)
+             | (uint64_t(carry.read()) << 22);
+    }
+};
+
+// 一个单元一个周期的激励
+struct unit_inputs {
+    unsigned int reg_rd_addr;
+    stim::memory_op reg;
+    stim::memory_op ram;
+    stim::alu_op alu;
+};
+
+template<typename P>
+static void drive(datapath_unit<P>& u, const unit_inputs& in) {
+    u.reg_rd_addr.write(in.reg_rd_addr);
+    u.reg_wr_addr.write(in.reg.addr);
+    u.reg_wr_data.write(in.reg.data);
+    u.reg_wr_en.write(in.reg.write);
+    u.ram_addr.write(in.ram.addr);
+    u.ram_wr_data.write(in.ram.data);
+    u.ram_wr_en.write(in.ram.write);
+    u.a.write(in.alu.a);
+    u.b.write(in.alu.b);
+    u.op.write(in.alu.op);
+}
+
+// 在时钟上升沿读取上一周期的输出，并给每个单元一组新的随机激励
+SC_MODULE(unit_driver) {
+    sc_in<bool> clk;
+
+    std::vector<datapath_unit<sc_datatypes>*> sc_units;
+    std::vector<datapath_unit<native_datatypes>*> native_units;
+    unsigned int num_units;
+
+    stim::memory_stimulus reg_stim;
+    stim::memory_stimulus ram_stim;
+    stim::alu_stimulus alu_stim;
+    stim::philox_stream rng;
+
+    uint64_t cycles;
+    uint64_t checksum;
+    int errors;
+
+    SC_HAS_PROCESS(unit_driver);
+
+    void mix(uint64_t v) {
+        checksum = (checksum ^ v) * 1099511628211ULL;
+    }
+
+    void drive_process() {
+        for (unsigned int i = 0; i < num_units; i++) {
+            uint64_t s = sc_units.empty() ? 0 : sc_units[i]->outputs();
+            uint64_t n = native_units.empty() ? 0 : native_units[i]->outputs();
+            if (!sc_units.empty() && !native_units.empty() && s != n) {
+                if (errors < 10) {
+                    std::cout << "错误: 周期 " << cycles << " 单元 " << i << " sc_datatypes输出 0x" << std::hex << s
+                              << ", native_datatypes输出 0x" << n << std::dec << std::endl;
+                }
+                errors++;
+            }
+            mix(sc_units.empty() ? n : s);
+        }
+
+        for (unsigned int i = 0; i < num_units; i++) {
+            unit_inputs in;
+            in.reg_rd_addr = rng.next_u32() & 0xF;
+            in.reg = reg_stim.next();
+            in.ram = ram_stim.next();
+            in.alu = alu_stim.next();
+            if (!sc_units.empty()) drive(*sc_units[i], in);
+            if (!native_units.empty()) drive(*native_units[i], in);
+        }
+        cycles++;
+    }
+
+    unit_driver(sc_module_name name, uint64_t seed)
+    : sc_module(name), num_units(0),
+      reg_stim(seed, 0.5, stim::STREAM_REG),
+      ram_stim(seed, 0.5, stim::STREAM_RAM),
+      alu_stim(seed),
+      rng(seed, stim::STREAM_USER),
+      cycles(0), checksum(14695981039346656037ULL), errors(0) {
+        SC_METHOD(drive_process);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+};
+
+// evaluate_native必须与evaluate在全部8×16×16种输入上逐位一致
+static int check_alu_exhaustive() {
+    int errors = 0;
+    for (unsigned int op = 0; op < 8; op++) {
+        for (int a = -8; a < 8; a++) {
+            for (int b = -8; b < 8; b++) {
+                sc_int<4> r1;
+                int8_t r2;
+                bool z1, v1, c1, z2, v2, c2;
+                alu_4bit_t<sc_datatypes>::evaluate(a, b, op, r1, z1, v1, c1);
+                alu_4bit_t<native_datatypes>::evaluate_native(a, b, op, r2, z2, v2, c2);
+                if (r1.to_int() != r2 || z1 != z2 || v1 != v2 || c1 != c2) {
+                    if (errors < 10) {
+                        std::cout << "错误: op=" << op << " a=" << a << " b=" << b
+                                  << " evaluate结果 " << r1.to_int() << ", evaluate_native结果 " << int(r2) << std::endl;
+                    }
+                    errors++;
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+template<typename P>
+static void print_footprint(const char* name) {
+    std::cout << std::left << std::setw(18) << name << std::right
+              << "register_file " << std::setw(5) << sizeof(register_file_t<P>) << " 字节（存储 "
+              << std::setw(3) << sizeof(register_file_t<P>::registers) << "）, "
+              << "ram " << std::setw(5) << sizeof(ram_t<P>) << " 字节（存储 "
+              << std::setw(3) << sizeof(ram_t<P>::memory) << "）, "
+              << "alu_4bit " << std::setw(5) << sizeof(alu_4bit_t<P>) << " 字节\n";
+}
+
+// 用法: datatype_bench [sc|native|both] [单元数] [周期数] [种子]
+//   sc      模块内部使用sc_uint/sc_int（原先的实现）
+//   native  模块内部使用uint8_t/int8_t
+//   both    两种策略接同一组激励同时运行，逐周期比较全部输出
+int sc_main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "both";
+    unsigned int num_units = argc > 2 ? std::stoul(argv[2]) : 256;
+    uint64_t num_cycles = argc > 3 ? std::stoull(argv[3]) : 10000;
+    uint64_t seed = argc > 4 ? std::stoull(argv[4]) : 1;
+    if (mode != "sc" && mode != "native" && mode != "both") {
+        std::cout << "未知模式: " << mode << std::endl;
+        return 1;
+    }
+
+    int alu_errors = check_alu_exhaustive();
+    print_footprint<sc_datatypes>("sc_datatypes");
+    print_footprint<native_datatypes>("native_datatypes");
+
+    sc_clock clk("clk", 10, SC_NS);
+    unit_driver driver("driver", seed);
+    driver.clk(clk);
+    driver.num_units = num_units;
+    for (unsigned int i = 0; i < num_units; i++) {
+        if (mode != "native") {
+            std::string n = "sc_unit_" + std::to_string(i);
+            driver.sc_units.push_back(new datapath_unit<sc_datatypes>(n.c_str(), clk));
+        }
+        if (mode != "sc") {
+            std::string n = "native_unit_" + std::to_string(i);
+            driver.native_units.push_back(new datapath_unit<native_datatypes>(n.c_str(), clk));
+        }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    sc_start(clk.period() * double(num_cycles));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    uint64_t cycles = driver.cycles;
+    std::cout << "模式 " << mode << ", 单元 " << num_units << ", 周期 " << cycles << "\n"
+              << std::fixed << std::setprecision(3) << "用时 " << seconds << " s, "
+              << std::setprecision(0) << "每秒仿真周期数 " << (cycles / seconds) << "\n"
+              << "输出校验和 0x" << std::hex << driver.checksum << std::dec << std::endl;
+
+    int errors = alu_errors + driver.errors;
+    if (mode == "both") {
+        if (errors) {
+            std::cout << "===== 数据类型策略测试失败 (" << errors << "处错误) =====" << std::endl;
+        } else {
+            std::cout << "===== 数据类型策略测试通过 =====" << std::endl;
+        }
+    }
+    return errors ? 1 : 0;
+}
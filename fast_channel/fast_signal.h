@@ -0,0 +1,148 @@
+// File: fast_signal.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FAST_SIGNAL_H
+#define FAST_SIGNAL_H
+
+#include <systemc.h>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// 64位以内整数类型的信号通道
+// 语义与sc_signal相同（写入在更新阶段生效，值改变时通知value_changed_event），
+// 可以直接绑定已有模块的sc_in<T>/sc_out<T>端口。区别在于：
+// - 另存一份原生整数，写入时用整数比较，不经过sc_uint/sc_int的运算符
+// - 写入的值与当前值相同、且本delta没有待更新的写入时，不调用request_update
+// - 同一delta内多次写入只登记一次更新
+// - 不做写入进程检查，相当于SC_MANY_WRITERS
+template<typename T, typename Enable = void>
+struct native_traits;
+
+// 内建整数类型（含bool）本身就是原生表示
+template<typename T>
+struct native_traits<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+    typedef T type;
+    static type to_native(const T& v) { return v; }
+    static T from_native(type n) { return n; }
+};
+
+template<int W>
+struct native_traits<sc_uint<W>> {
+    static_assert(W <= 64, "fast_signal只支持64位以内的类型");
+    typedef uint64_t type;
+    static type to_native(const sc_uint<W>& v) { return v.to_uint64(); }
+    static sc_uint<W> from_native(type n) { return sc_uint<W>(n); }
+};
+
+template<int W>
+struct native_traits<sc_int<W>> {
+    static_assert(W <= 64, "fast_signal只支持64位以内的类型");
+    typedef int64_t type;
+    static type to_native(const sc_int<W>& v) { return v.to_int64(); }
+    static sc_int<W> from_native(type n) { return sc_int<W>(n); }
+};
+
+template<typename T>
+class fast_signal : public sc_signal_inout_if<T>, public sc_prim_channel {
+    typedef native_traits<T> traits;
+    typedef typename traits::type native_t;
+
+    // 只有bool信号需要上升沿、下降沿事件
+    struct no_edges {};
+    struct edges {
+        sc_event pos;
+        sc_event neg;
+    };
+    static const bool IS_BOOL = std::is_same<T, bool>::value;
+
+public:
+    fast_signal()
+    : sc_prim_channel(sc_gen_unique_name("fast_signal")),
+      cur_val(), cur(traits::to_native(cur_val)), next(cur), pending(false) {}
+
+    explicit fast_signal(const char* name, const T& init = T())
+    : sc_prim_channel(name), cur_val(init), cur(traits::to_native(init)), next(cur), pending(false) {}
+
+    void write(const T& v) override {
+        next = traits::to_native(v);
+        if (!pending && next != cur) {
+            pending = true;
+            request_update();
+        }
+    }
+
+    const T& read() const override { return cur_val; }
+    const T& get_data_ref() const override { return cur_val; }
+
+    const sc_event& value_changed_event() const override { return changed; }
+    const sc_event& default_event() const override { return changed; }
+    bool event() const override { return changed.triggered(); }
+
+    // bool信号的边沿，供sc_in<bool>的pos()/neg()使用
+    const sc_event& posedge_event() const {
+        if constexpr (IS_BOOL) return edge.pos; else return changed;
+    }
+    const sc_event& negedge_event() const {
+        if constexpr (IS_BOOL) return edge.neg; else return changed;
+    }
+    bool posedge() const {
+        if constexpr (IS_BOOL) return edge.pos.triggered(); else return false;
+    }
+    bool negedge() const {
+        if constexpr (IS_BOOL) return edge.neg.triggered(); else return false;
+    }
+
+    operator const T&() const { return cur_val; }
+
+    fast_signal& operator=(const T& v) {
+        write(v);
+        return *this;
+    }
+
+    const char* kind() const override { return "fast_signal"; }
+
+protected:
+    void update() override {
+        pending = false;
+        if (next == cur) return;    // 同一delta内又写回了原值
+        cur = next;
+        cur_val = traits::from_native(next);
+        changed.notify(SC_ZERO_TIME);
+        if constexpr (IS_BOOL) {
+            if (cur) {
+                edge.pos.notify(SC_ZERO_TIME);
+            } else {
+                edge.neg.notify(SC_ZERO_TIME);
+            }
+        }
+    }
+
+private:
+    T cur_val;          // read()返回引用，需要保留一份T
+    native_t cur;
+    native_t next;
+    bool pending;       // 本delta已经登记了更新
+    sc_event changed;
+    typename std::conditional<IS_BOOL, edges, no_edges>::type edge;
+};
+
+template<typename T>
+inline void sc_trace(sc_trace_file* tf, const fast_signal<T>& s, const std::string& name) {
+    sc_trace(tf, s.read(), name);
+}
+
+#endif // FAST_SIGNAL_H
@@ -0,0 +1,244 @@
+// File: fast_signal_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "fast_signal.h"
+#include "../register_ram/register_file.h"
+#include "../register_ram/ram.h"
+#include "../fifo_design/fifo.h"
+#include "../common/stimulus.h"
+
+// 一个单元一个周期的激励：寄存器堆读写、RAM访问和FIFO读写
+struct unit_inputs {
+    unsigned int reg_rd_addr;
+    stim::memory_op reg;
+    stim::memory_op ram;
+    stim::fifo_op fifo;
+    bool rst_n;
+};
+
+// 寄存器堆、RAM和FIFO测试平台的负载：每个单元各一个register_file、ram和fifo<int, 8>，
+// 模块本身不改动，只把连线换成fast_signal。
+// FAST为false时连线是sc_signal，为true时是fast_signal
+template<bool FAST>
+struct memory_fifo_unit : sc_module {
+    template<typename T>
+    using wire = typename std::conditional<FAST, fast_signal<T>, sc_signal<T>>::type;
+
+    wire<sc_uint<4>> reg_rd_addr;
+    wire<sc_uint<4>> reg_wr_addr;
+    wire<sc_uint<8>> reg_wr_data;
+    wire<bool> reg_wr_en;
+    wire<sc_uint<8>> reg_rd_data;
+
+    wire<sc_uint<4>> ram_addr;
+    wire<sc_uint<8>> ram_wr_data;
+    wire<bool> ram_wr_en;
+    wire<sc_uint<8>> ram_rd_data;
+
+    wire<bool> rst_n;
+    wire<bool> write_en;
+    wire<int> data_in;
+    wire<bool> read_en;
+    wire<int> data_out;
+    wire<bool> full;
+    wire<bool> empty;
+    wire<unsigned int> size;
+
+    register_file reg_file;
+    ram memory;
+    fifo<int, 8> queue;
+
+    memory_fifo_unit(sc_module_name name, sc_clock& clk)
+    : sc_module(name), reg_file("reg_file"), memory("memory"), queue("queue") {
+        reg_file.clk(clk);
+        reg_file.rd_addr(reg_rd_addr);
+        reg_file.wr_addr(reg_wr_addr);
+        reg_file.wr_data(reg_wr_data);
+        reg_file.wr_en(reg_wr_en);
+        reg_file.rd_data(reg_rd_data);
+
+        memory.clk(clk);
+        memory.addr(ram_addr);
+        memory.wr_data(ram_wr_data);
+        memory.wr_en(ram_wr_en);
+        memory.rd_data(ram_rd_data);
+
+        queue.debug_print = false;
+        queue.clk(clk);
+        queue.rst_n(rst_n);
+        queue.write_en(write_en);
+        queue.data_in(data_in);
+        queue.read_en(read_en);
+        queue.data_out(data_out);
+        queue.full(full);
+        queue.empty(empty);
+        queue.size(size);
+    }
+
+    void drive(const unit_inputs& in) {
+        reg_rd_addr.write(in.reg_rd_addr);
+        reg_wr_addr.write(in.reg.addr);
+        reg_wr_data.write(in.reg.data);
+        reg_wr_en.write(in.reg.write);
+        ram_addr.write(in.ram.addr);
+        ram_wr_data.write(in.ram.data);
+        ram_wr_en.write(in.ram.write);
+        rst_n.write(in.rst_n);
+        write_en.write(in.fifo.write_en);
+        data_in.write(in.fifo.data);
+        read_en.write(in.fifo.read_en);
+    }
+
+    // 全部输出打包成一个64位值，用于比较和校验和
+    uint64_t outputs() const {
+        return reg_rd_data.read().to_uint64()
+             | (ram_rd_data.read().to_uint64() << 8)
+             | (uint64_t(uint32_t(data_out.read())) << 16)
+             | (uint64_t(size.read()) << 48)
+             | (uint64_t(full.read()) << 56)
+             | (uint64_t(empty.read()) << 57);
+    }
+};
+
+// 在时钟上升沿驱动各单元的输入，并读取上一周期的输出。
+// 真实的时序驱动器每个周期都会重写全部输出，多数周期其实没有变化：
+// 每个单元每周期以activity的概率换一组新激励，否则重写原值。
+SC_MODULE(unit_driver) {
+    sc_in<bool> clk;
+
+    std::vector<memory_fifo_unit<false>*> signal_units;
+    std::vector<memory_fifo_unit<true>*> fast_units;
+    std::vector<unit_inputs> current;
+
+    stim::memory_stimulus reg_stim;
+    stim::memory_stimulus ram_stim;
+    stim::fifo_stimulus fifo_stim;
+    stim::philox_stream rng;
+    uint64_t activity_thr;
+
+    uint64_t cycles;
+    uint64_t checksum;
+    int errors;
+
+    SC_HAS_PROCESS(unit_driver);
+
+    void mix(uint64_t v) {
+        checksum = (checksum ^ v) * 1099511628211ULL;
+    }
+
+    void drive_process() {
+        // 两种实现同时运行时，输出必须逐周期相同
+        for (size_t i = 0; i < current.size(); i++) {
+            uint64_t s = signal_units.empty() ? 0 : signal_units[i]->outputs();
+            uint64_t f = fast_units.empty() ? 0 : fast_units[i]->outputs();
+            if (!signal_units.empty() && !fast_units.empty() && s != f) {
+                if (errors < 10) {
+                    std::cout << "错误: 周期 " << cycles << " 单元 " << i << " sc_signal输出 0x" << std::hex << s
+                              << ", fast_signal输出 0x" << f << std::dec << std::endl;
+                }
+                errors++;
+            }
+            mix(signal_units.empty() ? f : s);
+        }
+
+        for (size_t i = 0; i < current.size(); i++) {
+            unit_inputs& in = current[i];
+            in.rst_n = cycles > 0;
+            if (cycles == 0 || rng.bernoulli_threshold(activity_thr)) {
+                in.reg_rd_addr = rng.next_u32() & 0xF;
+                in.reg = reg_stim.next();
+                in.ram = ram_stim.next();
+                in.fifo = fifo_stim.next();
+            }
+            if (!signal_units.empty()) signal_units[i]->drive(in);
+            if (!fast_units.empty()) fast_units[i]->drive(in);
+        }
+        cycles++;
+    }
+
+    unit_driver(sc_module_name name, uint64_t seed, double activity)
+    : sc_module(name),
+      reg_stim(seed, 0.5, stim::STREAM_REG),
+      ram_stim(seed, 0.5, stim::STREAM_RAM),
+      fifo_stim(seed),
+      rng(seed, stim::STREAM_USER),
+      activity_thr(stim::philox_stream::threshold(activity)),
+      cycles(0), checksum(14695981039346656037ULL), errors(0) {
+        SC_METHOD(drive_process);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+};
+
+// 用法: fast_signal_bench [signal|fast|both] [单元数] [周期数] [激励变化概率] [种子]
+//   signal  连线全部是sc_signal
+//   fast    连线全部是fast_signal
+//   both    两种实现接同一组激励同时运行，逐周期比较输出
+int sc_main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "both";
+    unsigned int num_units = argc > 2 ? std::stoul(argv[2]) : 256;
+    uint64_t num_cycles = argc > 3 ? std::stoull(argv[3]) : 10000;
+    double activity = argc > 4 ? std::stod(argv[4]) : 0.25;
+    uint64_t seed = argc > 5 ? std::stoull(argv[5]) : 1;
+    if (mode != "signal" && mode != "fast" && mode != "both") {
+        std::cout << "未知模式: " << mode << std::endl;
+        return 1;
+    }
+
+    sc_clock clk("clk", 10, SC_NS);
+    unit_driver driver("driver", seed, activity);
+    driver.clk(clk);
+    driver.current.resize(num_units);
+    for (unsigned int i = 0; i < num_units; i++) {
+        if (mode != "fast") {
+            std::string n = "signal_unit_" + std::to_string(i);
+            driver.signal_units.push_back(new memory_fifo_unit<false>(n.c_str(), clk));
+        }
+        if (mode != "signal") {
+            std::string n = "fast_unit_" + std::to_string(i);
+            driver.fast_units.push_back(new memory_fifo_unit<true>(n.c_str(), clk));
+        }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    sc_start(clk.period() * double(num_cycles));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    uint64_t cycles = driver.cycles;
+    std::cout << "模式 " << mode << ", 单元 " << num_units << ", 周期 " << cycles
+              << ", 激励变化概率 " << activity << "\n"
+              << std::fixed << std::setprecision(3) << "用时 " << seconds << " s, "
+              << std::setprecision(0) << "每秒仿真周期数 " << (cycles / seconds) << "\n"
+              << std::setprecision(2) << "每周期delta数 " << double(sc_delta_count()) / cycles << "\n"
+              << "每个单元（连线和模块实例） " << (mode == "fast" ? sizeof(memory_fifo_unit<true>) : sizeof(memory_fifo_unit<false>))
+              << " 字节\n"
+              << "输出校验和 0x" << std::hex << driver.checksum << std::dec << std::endl;
+
+    if (mode == "both") {
+        if (driver.errors) {
+            std::cout << "===== fast_signal测试失败 (" << driver.errors << "处错误) =====" << std::endl;
+        } else {
+            std::cout << "===== fast_signal测试通过 =====" << std::endl;
+        }
+    }
+    return driver.errors ? 1 : 0;
+}
@@ -18,9 +18,42 @@
 #define FIFO_H
 
 #include <systemc.h>
-#include <deque>
 #include <iostream>
 
+// 固定容量的环形缓冲，接口与fifo用到的std::deque成员函数相同。
+// 存储是对象内的定长数组，入队出队只移动下标，不做堆分配
+template<typename T, unsigned int DEPTH>
+class fifo_ring {
+public:
+    fifo_ring() : head_(0), count_(0) {}
+
+    bool empty() const { return count_ == 0; }
+    unsigned int size() const { return count_; }
+    const T& front() const { return slots_[head_]; }
+
+    // 调用方保证未满（fifo在full为true时不写）
+    void push_back(const T& v) {
+        unsigned int tail = head_ + count_;
+        slots_[tail >= DEPTH ? tail - DEPTH : tail] = v;
+        count_++;
+    }
+
+    void pop_front() {
+        head_ = head_ + 1 == DEPTH ? 0 : head_ + 1;
+        count_--;
+    }
+
+    void clear() {
+        head_ = 0;
+        count_ = 0;
+    }
+
+private:
+    T slots_[DEPTH];
+    unsigned int head_;
+    unsigned int count_;
+};
+
 // 参数化FIFO模板类，使用SC_THREAD实现
 template<typename T, unsigned int DEPTH = 8>
 SC_MODULE(fifo) {
@@ -35,8 +68,11 @@ SC_MODULE(fifo) {
     sc_out<bool> empty;        // FIFO空信号
     sc_out<unsigned int> size; // 当前FIFO中元素数量
 
-    // FIFO的内部存储
-    std::deque<T> buffer;
+    // FIFO的内部存储：DEPTH个槽的环形缓冲
+    fifo_ring<T, DEPTH> buffer;
+
+    // 是否打印每次读写的调试信息（大规模实例化时应关闭）
+    bool debug_print;
     
     // 主进程 - 合并读写操作到一个进程，避免多驱动问题
     void fifo_process() {
@@ -73,8 +109,10 @@ SC_MODULE(fifo) {
                 did_read = true;
                 
                 // 打印调试信息
-                std::cout << sc_time_stamp() << ": 读取数据 " << value 
-                          << ", FIFO大小: " << buffer.size() << std::endl;
+                if (debug_print) {
+                    std::cout << sc_time_stamp() << ": 读取数据 " << value 
+                              << ", FIFO大小: " << buffer.size() << std::endl;
+                }
             }
             
             // 再处理写入操作（可以在同一周期既读又写）
@@ -83,8 +121,10 @@ SC_MODULE(fifo) {
                 did_write = true;
                 
                 // 打印调试信息
-                std::cout << sc_time_stamp() << ": 写入数据 " << data_in.read() 
-                          << ", FIFO大小: " << buffer.size() << std::endl;
+                if (debug_print) {
+                    std::cout << sc_time_stamp() << ": 写入数据 " << data_in.read() 
+                              << ", FIFO大小: " << buffer.size() << std::endl;
+                }
             }
             
             // 在所有操作完成后更新状态，保证状态一致性
@@ -102,7 +142,7 @@ SC_MODULE(fifo) {
     }
 
     // 构造函数
-    SC_CTOR(fifo) {
+    SC_CTOR(fifo) : debug_print(true) {
         // 使用单一SC_THREAD进程处理所有逻辑，避免多驱动错误
         SC_THREAD(fifo_process);
         sensitive << clk.pos();
@@ -114,4 +154,10 @@ SC_MODULE(fifo) {
     }
 };
 
+#ifdef SC_MODELS_LIB
+// 这些实例已在models/libscmodels.a中编译（见build.mk）
+extern template class fifo_ring<int, 8>;
+extern template struct fifo<int, 8>;
+#endif
+
 #endif // FIFO_H
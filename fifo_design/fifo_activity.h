@@ -0,0 +1,114 @@
+// File: fifo_activity.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FIFO_ACTIVITY_H
+#define FIFO_ACTIVITY_H
+
+#include <systemc.h>
+#include <string>
+#include "../common/power_window.h"
+
+// FIFO开关活动监视器：端口翻转、每个存储槽的翻转、入队/出队次数和时钟周期
+// fifo内部是DEPTH个槽的环形缓冲，监视器另存一份影子槽和写指针。上升沿读到的是
+// 本次时钟沿之前的值，与fifo_process做判断时看到的相同，所以按同样的条件重放写入即可
+template<typename T, unsigned int DEPTH = 8>
+SC_MODULE(fifo_activity) {
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+    sc_in<bool> write_en;
+    sc_in<T> data_in;
+    sc_in<bool> read_en;
+    sc_in<T> data_out;
+    sc_in<bool> full;
+    sc_in<bool> empty;
+    sc_in<unsigned int> size;
+
+    pwr::activity& act;
+    pwr::port_probe<bool> rst_n_p, write_en_p, read_en_p, full_p, empty_p;
+    pwr::port_probe<T> data_in_p, data_out_p;
+    pwr::port_probe<unsigned int> size_p;
+    unsigned int slot_counter[DEPTH];
+    uint64_t slot[DEPTH];
+    unsigned int wr_ptr;
+    unsigned int cycles;
+    unsigned int pushes;
+    unsigned int pops;
+
+    SC_HAS_PROCESS(fifo_activity);
+
+    void sample_ports() {
+        rst_n_p.sample(act);
+        write_en_p.sample(act);
+        data_in_p.sample(act);
+        read_en_p.sample(act);
+        data_out_p.sample(act);
+        full_p.sample(act);
+        empty_p.sample(act);
+        size_p.sample(act);
+    }
+
+    void sample_clock() {
+        act.count(cycles);
+        if (!rst_n.read()) {
+            wr_ptr = 0;
+            return;
+        }
+        if (read_en.read() && !empty.read()) act.count(pops);
+        if (write_en.read() && !full.read()) {
+            uint64_t d = pwr::bits(data_in.read());
+            act.toggle(slot_counter[wr_ptr], slot[wr_ptr], d);
+            slot[wr_ptr] = d;
+            wr_ptr = (wr_ptr + 1) % DEPTH;
+            act.count(pushes);
+        }
+    }
+
+    fifo_activity(sc_module_name name, pwr::power_report& report)
+    : sc_module(name), act(report.add_module("fifo", basename())), wr_ptr(0) {
+        rst_n_p.attach(act, rst_n, "rst_n");
+        write_en_p.attach(act, write_en, "write_en");
+        data_in_p.attach(act, data_in, "data_in");
+        read_en_p.attach(act, read_en, "read_en");
+        data_out_p.attach(act, data_out, "data_out");
+        full_p.attach(act, full, "full");
+        empty_p.attach(act, empty, "empty");
+        size_p.attach(act, size, "size");
+        for (unsigned int i = 0; i < DEPTH; i++) {
+            slot_counter[i] = act.add("slot[" + std::to_string(i) + "]");
+            slot[i] = 0;
+        }
+        cycles = act.add("clk");
+        pushes = act.add("push");
+        pops = act.add("pop");
+
+        // 默认能量（pJ）：端口和存储按每位翻转，clk按每个周期，push/pop按每次操作
+        pwr::energy_table& t = report.table();
+        t.set("fifo", "*", 0.01);
+        t.set("fifo", "slot", 0.05);
+        t.set("fifo", "clk", 0.25);
+        t.set("fifo", "push", 0.3);
+        t.set("fifo", "pop", 0.2);
+
+        SC_METHOD(sample_ports);
+        sensitive << rst_n << write_en << data_in << read_en << data_out << full << empty << size;
+
+        SC_METHOD(sample_clock);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+};
+
+#endif // FIFO_ACTIVITY_H
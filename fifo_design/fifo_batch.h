@@ -0,0 +1,166 @@
+// File: fifo_batch.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FIFO_BATCH_H
+#define FIFO_BATCH_H
+
+#include <systemc.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// 批量FIFO的逐通道访问接口
+// 驱动方在时钟沿之外（例如下降沿）写入下一个上升沿要采样的输入，
+// 上升沿之后读取各通道的输出，行为与N个独立的fifo<T, DEPTH>相同
+template<typename T>
+class fifo_batch_if : virtual public sc_interface {
+public:
+    virtual unsigned int lanes() const = 0;
+
+    // 设置某个通道下一个时钟沿的输入（对应write_en/data_in/read_en端口）
+    virtual void set_inputs(unsigned int lane, bool write_en, const T& data, bool read_en) = 0;
+
+    // 读取某个通道的输出（对应data_out/full/empty/size端口）
+    virtual const T& data_out(unsigned int lane) const = 0;
+    virtual bool full(unsigned int lane) const = 0;
+    virtual bool empty(unsigned int lane) const = 0;
+    virtual unsigned int size(unsigned int lane) const = 0;
+
+    // 每个时钟沿处理完所有通道后触发
+    virtual const sc_event& updated_event() const = 0;
+};
+
+// 结构数组形式的批量FIFO：一个模块模拟N个类型和深度相同的逻辑FIFO
+// 存储、头指针、计数等按字段存放在连续数组中，所有通道在同一个进程里
+// 一次步进；控制计算与数据搬运分两遍完成，控制部分没有分支，便于编译器向量化
+template<typename T, unsigned int DEPTH = 8>
+SC_MODULE(fifo_batch), public fifo_batch_if<T> {
+    sc_in<bool>  clk;          // 时钟
+    sc_in<bool>  rst_n;        // 低电平有效复位（所有通道共用）
+    sc_export<fifo_batch_if<T>> lane_export;   // 逐通道访问接口
+
+    SC_HAS_PROCESS(fifo_batch);
+
+    // 所有通道在一个进程中步进，与fifo::fifo_process的读写顺序一致：
+    // 先读后写，写入判断使用读之前的满状态
+    void step_process() {
+        const unsigned int n = num_lanes;
+        if (!rst_n.read()) {
+            std::fill(head.begin(), head.end(), 0);
+            std::fill(count.begin(), count.end(), 0);
+            std::fill(out.begin(), out.end(), T());
+            updated.notify(SC_ZERO_TIME);
+            return;
+        }
+
+        uint32_t* __restrict h_arr = head.data();
+        uint32_t* __restrict c_arr = count.data();
+        const uint8_t* __restrict we = write_en.data();
+        const uint8_t* __restrict re = read_en.data();
+        uint32_t* __restrict rd_idx = rd_index.data();
+        uint32_t* __restrict wr_idx = wr_index.data();
+        uint8_t* __restrict ops = op.data();
+
+        // 第一遍：只做控制计算（读写判定、索引、指针和计数更新），
+        // 全部是等长数组上的逐元素运算，可以被向量化
+        for (unsigned int i = 0; i < n; i++) {
+            const uint32_t c = c_arr[i];
+            const uint32_t h = h_arr[i];
+            const uint32_t r = re[i] & (c != 0);
+            const uint32_t w = we[i] & (c < DEPTH);
+
+            uint32_t t = h + c;
+            t = t >= DEPTH ? t - DEPTH : t;
+            rd_idx[i] = i * DEPTH + h;
+            wr_idx[i] = i * DEPTH + t;
+            ops[i] = r | (w << 1);
+
+            uint32_t nh = h + r;
+            h_arr[i] = nh == DEPTH ? 0 : nh;
+            c_arr[i] = c + w - r;
+        }
+
+        // 第二遍：按索引搬运数据。同一通道读写同时发生时，读位置和写位置
+        // 一定不同（空时不读、满时不写），因此两者顺序无关
+        const T* __restrict din = data_in.data();
+        T* __restrict dout = out.data();
+        T* __restrict mem = storage.data();
+        for (unsigned int i = 0; i < n; i++) {
+            if (ops[i] & 1) dout[i] = mem[rd_idx[i]];
+            if (ops[i] & 2) mem[wr_idx[i]] = din[i];
+        }
+        updated.notify(SC_ZERO_TIME);
+    }
+
+    // fifo_batch_if实现
+    unsigned int lanes() const override { return num_lanes; }
+
+    void set_inputs(unsigned int lane, bool we, const T& data, bool re) override {
+        write_en[lane] = we;
+        data_in[lane] = data;
+        read_en[lane] = re;
+    }
+
+    const T& data_out(unsigned int lane) const override { return out[lane]; }
+    bool full(unsigned int lane) const override { return count[lane] >= DEPTH; }
+    bool empty(unsigned int lane) const override { return count[lane] == 0; }
+    unsigned int size(unsigned int lane) const override { return count[lane]; }
+    const sc_event& updated_event() const override { return updated; }
+
+    fifo_batch(sc_module_name name, unsigned int lanes)
+    : sc_module(name),
+      lane_export("lane_export"),
+      num_lanes(lanes),
+      storage(size_t(lanes) * DEPTH),
+      head(lanes, 0),
+      count(lanes, 0),
+      out(lanes),
+      write_en(lanes, 0),
+      read_en(lanes, 0),
+      data_in(lanes),
+      rd_index(lanes),
+      wr_index(lanes),
+      op(lanes) {
+        lane_export(*this);
+
+        SC_METHOD(step_process);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+
+private:
+    unsigned int num_lanes;
+
+    // 状态（结构数组）
+    std::vector<T> storage;            // 通道i的存储位于[i*DEPTH, (i+1)*DEPTH)
+    std::vector<uint32_t> head;        // 各通道队首位置
+    std::vector<uint32_t> count;       // 各通道元素数量
+    std::vector<T> out;                // 各通道data_out
+
+    // 下一个时钟沿要采样的输入
+    std::vector<uint8_t> write_en;
+    std::vector<uint8_t> read_en;
+    std::vector<T> data_in;
+
+    // 步进时的临时数组：读写位置与操作标志（bit0读，bit1写）
+    std::vector<uint32_t> rd_index;
+    std::vector<uint32_t> wr_index;
+    std::vector<uint8_t> op;
+
+    sc_event updated;
+};
+
+#endif // FIFO_BATCH_H
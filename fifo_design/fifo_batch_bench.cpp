@@ -0,0 +1,194 @@
+// File: fifo_batch_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <sys/resource.h>
+#include "fifo.h"
+#include "fifo_batch.h"
+#include "../common/child_process.h"
+
+// 两种实现使用完全相同的激励：每个通道每周期一个xorshift随机数
+// 写概率60%，读概率40%，与fifo_tb一致
+struct lane_stimulus {
+    static uint32_t next(uint32_t& s) {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return s;
+    }
+};
+
+// N个独立fifo<int, 8>实例
+SC_MODULE(separate_top) {
+    sc_clock clk;
+    sc_signal<bool> rst_n;
+    sc_vector<sc_signal<bool>> write_en;
+    sc_vector<sc_signal<int>> data_in;
+    sc_vector<sc_signal<bool>> read_en;
+    sc_vector<sc_signal<int>> data_out;
+    sc_vector<sc_signal<bool>> full;
+    sc_vector<sc_signal<bool>> empty;
+    sc_vector<sc_signal<unsigned int>> size;
+    sc_vector<fifo<int, 8>> fifos;
+
+    std::vector<uint32_t> seeds;
+    uint64_t checksum;
+    unsigned int cycle;
+
+    SC_HAS_PROCESS(separate_top);
+
+    // 下降沿：累计各通道输出，并给出下一个上升沿的输入
+    void drive_process() {
+        if (cycle++ == 2) rst_n.write(true);
+        for (unsigned int i = 0; i < fifos.size(); i++) {
+            checksum = checksum * 31 + data_out[i].read() + (uint64_t(size[i].read()) << 32);
+            uint32_t r = lane_stimulus::next(seeds[i]);
+            write_en[i].write((r & 0xFF) < 154);
+            data_in[i].write(r >> 16);
+            read_en[i].write(((r >> 8) & 0xFF) < 102);
+        }
+    }
+
+    separate_top(sc_module_name name, unsigned int lanes)
+    : sc_module(name), clk("clk", 10, SC_NS),
+      write_en("write_en", lanes), data_in("data_in", lanes), read_en("read_en", lanes),
+      data_out("data_out", lanes), full("full", lanes), empty("empty", lanes),
+      size("size", lanes), fifos("fifo", lanes),
+      seeds(lanes), checksum(0), cycle(0) {
+        for (unsigned int i = 0; i < lanes; i++) {
+            seeds[i] = 0x9E3779B9u * (i + 1);
+            fifos[i].debug_print = false;
+            fifos[i].clk(clk);
+            fifos[i].rst_n(rst_n);
+            fifos[i].write_en(write_en[i]);
+            fifos[i].data_in(data_in[i]);
+            fifos[i].read_en(read_en[i]);
+            fifos[i].data_out(data_out[i]);
+            fifos[i].full(full[i]);
+            fifos[i].empty(empty[i]);
+            fifos[i].size(size[i]);
+        }
+        SC_METHOD(drive_process);
+        sensitive << clk.negedge_event();
+        dont_initialize();
+    }
+};
+
+// 一个fifo_batch模块模拟N个通道
+SC_MODULE(batched_top) {
+    sc_clock clk;
+    sc_signal<bool> rst_n;
+    fifo_batch<int, 8> fifos;
+    sc_port<fifo_batch_if<int>> lanes;
+
+    std::vector<uint32_t> seeds;
+    uint64_t checksum;
+    unsigned int cycle;
+
+    SC_HAS_PROCESS(batched_top);
+
+    void drive_process() {
+        if (cycle++ == 2) rst_n.write(true);
+        for (unsigned int i = 0; i < seeds.size(); i++) {
+            checksum = checksum * 31 + lanes->data_out(i) + (uint64_t(lanes->size(i)) << 32);
+            uint32_t r = lane_stimulus::next(seeds[i]);
+            lanes->set_inputs(i, (r & 0xFF) < 154, int(r >> 16), ((r >> 8) & 0xFF) < 102);
+        }
+    }
+
+    batched_top(sc_module_name name, unsigned int n)
+    : sc_module(name), clk("clk", 10, SC_NS), fifos("fifos", n), lanes("lanes"),
+      seeds(n), checksum(0), cycle(0) {
+        for (unsigned int i = 0; i < n; i++) {
+            seeds[i] = 0x9E3779B9u * (i + 1);
+        }
+        fifos.clk(clk);
+        fifos.rst_n(rst_n);
+        lanes(fifos.lane_export);
+        SC_METHOD(drive_process);
+        sensitive << clk.negedge_event();
+        dont_initialize();
+    }
+};
+
+struct bench_result {
+    double elab_seconds;
+    double sim_seconds;
+    long max_rss_kb;
+    uint64_t checksum;
+};
+
+// 例化并运行一种实现，在子进程中调用（见common/child_process.h）
+template<typename TOP>
+bench_result run_top(unsigned int lanes, unsigned int cycles) {
+    bench_result r;
+    auto t0 = std::chrono::steady_clock::now();
+    TOP top("top", lanes);
+    sc_start(SC_ZERO_TIME);
+    auto t1 = std::chrono::steady_clock::now();
+    sc_start(10.0 * cycles, SC_NS);
+    auto t2 = std::chrono::steady_clock::now();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    r.elab_seconds = std::chrono::duration<double>(t1 - t0).count();
+    r.sim_seconds = std::chrono::duration<double>(t2 - t1).count();
+    r.max_rss_kb = usage.ru_maxrss;
+    r.checksum = top.checksum;
+    return r;
+}
+
+void print_result(const char* name, const bench_result& r, unsigned int cycles) {
+    std::cout << std::left << std::setw(14) << name << std::right << std::fixed
+              << std::setw(12) << std::setprecision(3) << r.elab_seconds
+              << std::setw(12) << r.sim_seconds
+              << std::setw(14) << std::setprecision(0) << (cycles / r.sim_seconds)
+              << std::setw(12) << (r.max_rss_kb / 1024.0)
+              << "  0x" << std::hex << r.checksum << std::dec << std::endl;
+}
+
+// 用法: fifo_batch_bench [通道数] [周期数]
+int sc_main(int argc, char* argv[]) {
+    unsigned int lanes = argc > 1 ? std::stoul(argv[1]) : 10000;
+    unsigned int cycles = argc > 2 ? std::stoul(argv[2]) : 1000;
+
+    std::cout << "\n===== 批量FIFO与独立实例对比 =====\n";
+    std::cout << "通道数: " << lanes << ", 周期数: " << cycles << "\n\n";
+    std::cout << std::left << std::setw(14) << "实现" << std::right
+              << std::setw(12) << "例化(s)" << std::setw(12) << "仿真(s)"
+              << std::setw(14) << "周期/s" << std::setw(12) << "峰值RSS(MB)" << "  摘要\n";
+
+    bench_result separate, batched;
+    if (!child::run_in_child([&]() { return run_top<separate_top>(lanes, cycles); }, separate) ||
+        !child::run_in_child([&]() { return run_top<batched_top>(lanes, cycles); }, batched)) {
+        std::cout << "错误: 子进程运行失败\n";
+        return 1;
+    }
+    print_result("独立实例", separate, cycles);
+    print_result("fifo_batch", batched, cycles);
+    std::cout << "仿真加速比: " << std::setprecision(1)
+              << (separate.sim_seconds / batched.sim_seconds) << "x\n";
+
+    if (separate.checksum != batched.checksum) {
+        std::cout << "\n===== 错误: 两种实现的输出不一致 =====\n";
+        return 1;
+    }
+    std::cout << "\n===== 两种实现的输出一致 =====\n";
+    return 0;
+}
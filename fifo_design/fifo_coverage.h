@@ -0,0 +1,66 @@
+// File: fifo_coverage.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FIFO_COVERAGE_H
+#define FIFO_COVERAGE_H
+
+#include <systemc.h>
+#include <algorithm>
+#include "../common/coverage.h"
+
+// FIFO覆盖率监视器：与fifo接在相同的信号上，每个时钟上升沿采样
+// 上升沿时读到的是本次时钟沿之前的状态，正好是fifo_process做判断时看到的状态
+SC_MODULE(fifo_coverage) {
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+    sc_in<bool> write_en;
+    sc_in<bool> read_en;
+    sc_in<bool> full;
+    sc_in<bool> empty;
+    sc_in<unsigned int> size;
+
+    unsigned int depth;
+    cov::covergroup group;
+    cov::coverpoint& size_cp;          // 深度0~depth
+    cov::coverpoint& op_cp;            // 本周期的读写操作
+    cov::coverpoint& state_cp;         // 空/部分/满
+    cov::coverpoint& op_x_state;       // 操作与状态的交叉，包括满时同时读写、空时同时读写
+
+    SC_HAS_PROCESS(fifo_coverage);
+
+    void sample() {
+        if (!rst_n.read()) return;
+        unsigned int op = unsigned(read_en.read()) | (unsigned(write_en.read()) << 1);
+        unsigned int state = empty.read() ? 0 : (full.read() ? 2 : 1);
+        size_cp.sample(std::min(size.read(), depth));
+        op_cp.sample(op);
+        state_cp.sample(state);
+        op_x_state.sample(op, state);
+    }
+
+    fifo_coverage(sc_module_name name, unsigned int depth)
+    : sc_module(name), depth(depth), group("fifo"),
+      size_cp(group.add("size", depth + 1)),
+      op_cp(group.add("op", 4, {"idle", "read", "write", "read+write"})),
+      state_cp(group.add("state", 3, {"empty", "partial", "full"})),
+      op_x_state(group.add_cross("op x state", op_cp, state_cp)) {
+        SC_METHOD(sample);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+};
+
+#endif // FIFO_COVERAGE_H
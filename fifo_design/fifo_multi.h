@@ -0,0 +1,234 @@
+// File: fifo_multi.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FIFO_MULTI_H
+#define FIFO_MULTI_H
+
+#include <systemc.h>
+#include <cstdint>
+
+// 调度方式
+enum class class_schedule {
+    strict,         // 严格优先级：类0最高
+    weighted        // 加权轮询：每轮类k最多被选中weight[k]次
+};
+
+// 多类别的出队选择器。输入是非空类别的位图，用find-first-set选出一个类别，
+// 与类别数无关：严格优先级直接取最低的置位；加权轮询再与本轮还有额度的类别位图相与，
+// 都用完时开始新的一轮。额度按轮次惰性重置，换轮不需要逐个类别清零
+template<unsigned int K>
+class class_scheduler {
+    static_assert(K >= 1 && K <= 32, "类别数应在1~32之间");
+
+public:
+    static const uint32_t ALL = K == 32 ? 0xFFFFFFFFu : (1u << K) - 1;
+
+    class_scheduler() : mode(class_schedule::strict) {
+        for (unsigned int k = 0; k < K; k++) weight_[k] = 1;
+        reset();
+    }
+
+    class_schedule mode;
+
+    // 权重至少为1
+    void set_weight(unsigned int k, unsigned int w) { weight_[k] = w ? w : 1; }
+    unsigned int weight(unsigned int k) const { return weight_[k]; }
+
+    void reset() {
+        eligible_ = ALL;
+        round_ = 1;
+        for (unsigned int k = 0; k < K; k++) {
+            credit_[k] = 0;
+            epoch_[k] = 0;
+        }
+    }
+
+    // 从非空类别中选出一个出队；nonempty为0时返回K
+    unsigned int select(uint32_t nonempty) {
+        if (!nonempty) return K;
+        if (mode == class_schedule::strict) return __builtin_ctz(nonempty);
+
+        uint32_t m = nonempty & eligible_;
+        if (!m) {
+            eligible_ = ALL;
+            round_++;
+            m = nonempty;
+        }
+        unsigned int k = __builtin_ctz(m);
+        if (epoch_[k] != round_) {
+            epoch_[k] = round_;
+            credit_[k] = weight_[k];
+        }
+        if (--credit_[k] == 0) eligible_ &= ~(1u << k);
+        return k;
+    }
+
+private:
+    unsigned int weight_[K];
+    unsigned int credit_[K];        // 本轮剩余额度，epoch_[k]不是当前轮次时视为weight_[k]
+    uint64_t epoch_[K];
+    uint64_t round_;
+    uint32_t eligible_;             // 本轮还有额度的类别
+};
+
+// K个类别共用DEPTH个槽的缓冲池。槽、各类别队列的链接和空闲链表都在对象内的定长数组中：
+// 每个类别是一条经next_串起来的单链表（head_/tail_），空闲槽也串成一条链表，
+// 入队从空闲链表取一个槽挂到类别队尾，出队把队首槽还给空闲链表，都是O(1)、没有堆分配。
+// nonempty_位图记录非空的类别，供class_scheduler选择
+template<typename T, unsigned int K, unsigned int DEPTH>
+class multi_queue {
+    static_assert(K >= 1 && K <= 32, "类别数应在1~32之间");
+    static_assert(DEPTH >= 1 && DEPTH < 0xFFFF, "缓冲池深度应在1~65534之间");
+
+public:
+    multi_queue() {
+        for (unsigned int k = 0; k < K; k++) limit_[k] = DEPTH;
+        clear();
+    }
+
+    bool empty() const { return used_ == 0; }
+    bool full() const { return used_ >= DEPTH; }
+    unsigned int size() const { return used_; }
+    unsigned int size(unsigned int k) const { return count_[k]; }
+    uint32_t nonempty() const { return nonempty_; }
+
+    // 单个类别最多占用的槽数，默认DEPTH（不限制，全部类别共享缓冲池）
+    void set_limit(unsigned int k, unsigned int n) { limit_[k] = n < DEPTH ? n : DEPTH; }
+    unsigned int limit(unsigned int k) const { return limit_[k]; }
+
+    bool can_push(unsigned int k) const { return used_ < DEPTH && count_[k] < limit_[k]; }
+
+    // 调用方保证can_push(k)
+    void push_back(unsigned int k, const T& v) {
+        uint16_t s = free_;
+        free_ = next_[s];
+        slots_[s] = v;
+        next_[s] = NIL;
+        if (count_[k] == 0) head_[k] = s;
+        else next_[tail_[k]] = s;
+        tail_[k] = s;
+        count_[k]++;
+        used_++;
+        nonempty_ |= 1u << k;
+    }
+
+    const T& front(unsigned int k) const { return slots_[head_[k]]; }
+
+    // 调用方保证size(k) > 0
+    void pop_front(unsigned int k) {
+        uint16_t s = head_[k];
+        head_[k] = next_[s];
+        next_[s] = free_;
+        free_ = s;
+        if (--count_[k] == 0) nonempty_ &= ~(1u << k);
+        used_--;
+    }
+
+    void clear() {
+        for (unsigned int s = 0; s < DEPTH; s++) next_[s] = uint16_t(s + 1 < DEPTH ? s + 1 : NIL);
+        free_ = 0;
+        for (unsigned int k = 0; k < K; k++) {
+            head_[k] = NIL;
+            tail_[k] = NIL;
+            count_[k] = 0;
+        }
+        used_ = 0;
+        nonempty_ = 0;
+    }
+
+private:
+    static const uint16_t NIL = 0xFFFF;
+
+    T slots_[DEPTH];
+    uint16_t next_[DEPTH];          // 同一链表中的下一个槽
+    uint16_t head_[K];
+    uint16_t tail_[K];
+    unsigned int count_[K];
+    unsigned int limit_[K];
+    uint16_t free_;                 // 空闲链表的第一个槽
+    unsigned int used_;
+    uint32_t nonempty_;
+};
+
+// 多类别FIFO：K个优先级类别共用DEPTH个槽的缓冲池，出队时按严格优先级或加权轮询
+// 选择类别。读写时序与fifo<T, DEPTH>相同：上升沿先读后写，写入判断使用读之前的状态；
+// full/empty/size描述整个缓冲池，rd_class给出最近一次读出的数据所属的类别
+template<typename T, unsigned int K = 8, unsigned int DEPTH = 32>
+SC_MODULE(fifo_multi) {
+    sc_in<bool>  clk;
+    sc_in<bool>  rst_n;
+    sc_in<bool>  write_en;
+    sc_in<T>     data_in;
+    sc_in<unsigned int> wr_class;  // 写入数据的类别
+    sc_in<bool>  read_en;          // 读使能：从选出的类别读一个
+    sc_out<T>    data_out;
+    sc_out<unsigned int> rd_class;
+    sc_out<bool> full;
+    sc_out<bool> empty;
+    sc_out<unsigned int> size;
+
+    multi_queue<T, K, DEPTH> queues;
+    class_scheduler<K> scheduler;
+    uint64_t dropped;               // 因类别已满或缓冲池已满而丢弃的写入
+
+    void fifo_process() {
+        if (!rst_n.read()) {
+            queues.clear();
+            scheduler.reset();
+            full.write(false);
+            empty.write(true);
+            size.write(0);
+            data_out.write(T());
+            rd_class.write(0);
+            return;
+        }
+
+        unsigned int k = wr_class.read();
+        bool do_write = write_en.read() && k < K && queues.can_push(k);
+        if (write_en.read() && !do_write) dropped++;
+
+        bool did_read = false;
+        if (read_en.read()) {
+            unsigned int c = scheduler.select(queues.nonempty());
+            if (c < K) {
+                data_out.write(queues.front(c));
+                rd_class.write(c);
+                queues.pop_front(c);
+                did_read = true;
+            }
+        }
+        if (do_write) queues.push_back(k, data_in.read());
+
+        if (did_read || do_write) {
+            empty.write(queues.empty());
+            full.write(queues.full());
+            size.write(queues.size());
+        }
+    }
+
+    SC_CTOR(fifo_multi) : dropped(0) {
+        SC_METHOD(fifo_process);
+        sensitive << clk.pos();
+        dont_initialize();
+
+        full.initialize(false);
+        empty.initialize(true);
+        size.initialize(0);
+        rd_class.initialize(0);
+    }
+};
+
+#endif // FIFO_MULTI_H
@@ -0,0 +1,282 @@
+// File: fifo_multi_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <sys/resource.h>
+#include "fifo.h"
+#include "fifo_multi.h"
+#include "../common/child_process.h"
+
+// 每组K个类别，每个类别最多CLASS_DEPTH个元素
+static const unsigned int K = 8;
+static const unsigned int CLASS_DEPTH = 4;
+static const unsigned int POOL = K * CLASS_DEPTH;
+
+struct multi_stimulus {
+    static uint32_t next(uint32_t& s) {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return s;
+    }
+
+    // 每组每周期：60%写入，50%读出；写入的类别按几何分布偏斜（类0占一半，类1占四分之一……）
+    static bool write(uint32_t r) { return (r & 0xFF) < 154; }
+    static bool read(uint32_t r) { return ((r >> 8) & 0xFF) < 128; }
+    static unsigned int cls(uint32_t r) {
+        unsigned int c = __builtin_ctz((r >> 16) | 0x80000000u);
+        return c < K ? c : K - 1;
+    }
+    static int data(uint32_t r) { return int(r >> 12); }
+};
+
+static void configure(class_scheduler<K>& s, class_schedule mode) {
+    s.mode = mode;
+    for (unsigned int k = 0; k < K; k++) s.set_weight(k, K - k);
+}
+
+// 每组K个独立的fifo<int, CLASS_DEPTH>，由驱动方查看各fifo的empty选出要读的类别
+SC_MODULE(separate_top) {
+    sc_clock clk;
+    sc_signal<bool> rst_n;
+    sc_vector<sc_signal<bool>> write_en;
+    sc_vector<sc_signal<int>> data_in;
+    sc_vector<sc_signal<bool>> read_en;
+    sc_vector<sc_signal<int>> data_out;
+    sc_vector<sc_signal<bool>> full;
+    sc_vector<sc_signal<bool>> empty;
+    sc_vector<sc_signal<unsigned int>> size;
+    sc_vector<fifo<int, CLASS_DEPTH>> fifos;
+
+    std::vector<class_scheduler<K>> schedulers;
+    std::vector<uint32_t> seeds;
+    std::vector<unsigned int> last_class;
+    uint64_t checksum;
+    uint64_t dropped;
+    unsigned int cycle;
+
+    SC_HAS_PROCESS(separate_top);
+
+    void drive_process() {
+        if (cycle++ == 2) rst_n.write(true);
+        for (unsigned int g = 0; g < seeds.size(); g++) {
+            unsigned int base = g * K;
+            unsigned int total = 0;
+            uint32_t nonempty = 0;
+            for (unsigned int k = 0; k < K; k++) {
+                total += size[base + k].read();
+                if (!empty[base + k].read()) nonempty |= 1u << k;
+            }
+            unsigned int lc = last_class[g];
+            checksum = checksum * 31 + uint32_t(data_out[base + lc].read()) + (uint64_t(lc) << 32) +
+                       (uint64_t(total) << 40);
+
+            uint32_t r = multi_stimulus::next(seeds[g]);
+            unsigned int c = multi_stimulus::cls(r);
+            bool w = multi_stimulus::write(r);
+            if (w && full[base + c].read()) dropped++;
+            unsigned int sel = multi_stimulus::read(r) ? schedulers[g].select(nonempty) : K;
+            if (sel < K) last_class[g] = sel;
+            for (unsigned int k = 0; k < K; k++) {
+                write_en[base + k].write(w && k == c);
+                read_en[base + k].write(k == sel);
+            }
+            data_in[base + c].write(multi_stimulus::data(r));
+        }
+    }
+
+    uint64_t total_dropped() const { return dropped; }
+
+    separate_top(sc_module_name name, unsigned int groups, class_schedule mode, bool)
+    : sc_module(name), clk("clk", 10, SC_NS),
+      write_en("write_en", groups * K), data_in("data_in", groups * K), read_en("read_en", groups * K),
+      data_out("data_out", groups * K), full("full", groups * K), empty("empty", groups * K),
+      size("size", groups * K), fifos("fifo", groups * K),
+      schedulers(groups), seeds(groups), last_class(groups, 0), checksum(0), dropped(0), cycle(0) {
+        for (unsigned int g = 0; g < groups; g++) {
+            seeds[g] = 0x9E3779B9u * (g + 1);
+            configure(schedulers[g], mode);
+        }
+        for (unsigned int i = 0; i < groups * K; i++) {
+            fifos[i].debug_print = false;
+            fifos[i].clk(clk);
+            fifos[i].rst_n(rst_n);
+            fifos[i].write_en(write_en[i]);
+            fifos[i].data_in(data_in[i]);
+            fifos[i].read_en(read_en[i]);
+            fifos[i].data_out(data_out[i]);
+            fifos[i].full(full[i]);
+            fifos[i].empty(empty[i]);
+            fifos[i].size(size[i]);
+        }
+        SC_METHOD(drive_process);
+        sensitive << clk.negedge_event();
+        dont_initialize();
+    }
+};
+
+// 每组一个fifo_multi<int, K, POOL>；shared为false时每个类别限制为CLASS_DEPTH个，
+// 行为与separate_top相同；为true时全部类别共享缓冲池
+SC_MODULE(multi_top) {
+    sc_clock clk;
+    sc_signal<bool> rst_n;
+    sc_vector<sc_signal<bool>> write_en;
+    sc_vector<sc_signal<int>> data_in;
+    sc_vector<sc_signal<unsigned int>> wr_class;
+    sc_vector<sc_signal<bool>> read_en;
+    sc_vector<sc_signal<int>> data_out;
+    sc_vector<sc_signal<unsigned int>> rd_class;
+    sc_vector<sc_signal<bool>> full;
+    sc_vector<sc_signal<bool>> empty;
+    sc_vector<sc_signal<unsigned int>> size;
+    sc_vector<fifo_multi<int, K, POOL>> fifos;
+
+    std::vector<uint32_t> seeds;
+    uint64_t checksum;
+    unsigned int cycle;
+
+    SC_HAS_PROCESS(multi_top);
+
+    void drive_process() {
+        if (cycle++ == 2) rst_n.write(true);
+        for (unsigned int g = 0; g < seeds.size(); g++) {
+            checksum = checksum * 31 + uint32_t(data_out[g].read()) + (uint64_t(rd_class[g].read()) << 32) +
+                       (uint64_t(size[g].read()) << 40);
+            uint32_t r = multi_stimulus::next(seeds[g]);
+            write_en[g].write(multi_stimulus::write(r));
+            wr_class[g].write(multi_stimulus::cls(r));
+            data_in[g].write(multi_stimulus::data(r));
+            read_en[g].write(multi_stimulus::read(r));
+        }
+    }
+
+    uint64_t total_dropped() const {
+        uint64_t d = 0;
+        for (unsigned int g = 0; g < fifos.size(); g++) d += fifos[g].dropped;
+        return d;
+    }
+
+    multi_top(sc_module_name name, unsigned int groups, class_schedule mode, bool shared)
+    : sc_module(name), clk("clk", 10, SC_NS),
+      write_en("write_en", groups), data_in("data_in", groups), wr_class("wr_class", groups),
+      read_en("read_en", groups), data_out("data_out", groups), rd_class("rd_class", groups),
+      full("full", groups), empty("empty", groups), size("size", groups), fifos("fifo", groups),
+      seeds(groups), checksum(0), cycle(0) {
+        for (unsigned int g = 0; g < groups; g++) {
+            seeds[g] = 0x9E3779B9u * (g + 1);
+            fifo_multi<int, K, POOL>& f = fifos[g];
+            configure(f.scheduler, mode);
+            if (!shared) {
+                for (unsigned int k = 0; k < K; k++) f.queues.set_limit(k, CLASS_DEPTH);
+            }
+            f.clk(clk);
+            f.rst_n(rst_n);
+            f.write_en(write_en[g]);
+            f.data_in(data_in[g]);
+            f.wr_class(wr_class[g]);
+            f.read_en(read_en[g]);
+            f.data_out(data_out[g]);
+            f.rd_class(rd_class[g]);
+            f.full(full[g]);
+            f.empty(empty[g]);
+            f.size(size[g]);
+        }
+        SC_METHOD(drive_process);
+        sensitive << clk.negedge_event();
+        dont_initialize();
+    }
+};
+
+struct bench_result {
+    double elab_seconds;
+    double sim_seconds;
+    long max_rss_kb;
+    uint64_t checksum;
+    uint64_t dropped;
+};
+
+// 例化并运行一种实现，在子进程中调用（见common/child_process.h）
+template<typename TOP>
+bench_result run_top(unsigned int groups, unsigned int cycles, class_schedule mode, bool shared) {
+    bench_result r;
+    auto t0 = std::chrono::steady_clock::now();
+    TOP top("top", groups, mode, shared);
+    sc_start(SC_ZERO_TIME);
+    auto t1 = std::chrono::steady_clock::now();
+    sc_start(10.0 * cycles, SC_NS);
+    auto t2 = std::chrono::steady_clock::now();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    r.elab_seconds = std::chrono::duration<double>(t1 - t0).count();
+    r.sim_seconds = std::chrono::duration<double>(t2 - t1).count();
+    r.max_rss_kb = usage.ru_maxrss;
+    r.checksum = top.checksum;
+    r.dropped = top.total_dropped();
+    return r;
+}
+
+void print_result(const char* name, const bench_result& r, unsigned int cycles) {
+    std::cout << std::left << std::setw(18) << name << std::right << std::fixed
+              << std::setw(12) << std::setprecision(3) << r.elab_seconds
+              << std::setw(12) << r.sim_seconds
+              << std::setw(14) << std::setprecision(0) << (cycles / r.sim_seconds)
+              << std::setw(12) << (r.max_rss_kb / 1024.0)
+              << std::setw(12) << r.dropped
+              << "  0x" << std::hex << r.checksum << std::dec << std::endl;
+}
+
+// 用法: fifo_multi_bench [组数] [周期数] [strict|weighted]
+int sc_main(int argc, char* argv[]) {
+    unsigned int groups = argc > 1 ? std::stoul(argv[1]) : 1000;
+    unsigned int cycles = argc > 2 ? std::stoul(argv[2]) : 2000;
+    std::string sched = argc > 3 ? argv[3] : "strict";
+    if (sched != "strict" && sched != "weighted") {
+        std::cout << "未知的调度方式: " << sched << std::endl;
+        return 1;
+    }
+    class_schedule mode = sched == "strict" ? class_schedule::strict : class_schedule::weighted;
+
+    std::cout << "\n===== 多类别FIFO与K个独立FIFO对比 =====\n";
+    std::cout << "组数: " << groups << ", 每组" << K << "个类别 x " << CLASS_DEPTH << "个元素, 周期数: " << cycles
+              << ", 调度: " << (mode == class_schedule::strict ? "严格优先级" : "加权轮询(权重8..1)") << "\n\n";
+    std::cout << std::left << std::setw(18) << "实现" << std::right
+              << std::setw(12) << "例化(s)" << std::setw(12) << "仿真(s)"
+              << std::setw(14) << "周期/s" << std::setw(12) << "峰值RSS(MB)" << std::setw(12) << "丢弃" << "  摘要\n";
+
+    bench_result separate, multi, shared;
+    if (!child::run_in_child([&]() { return run_top<separate_top>(groups, cycles, mode, false); }, separate) ||
+        !child::run_in_child([&]() { return run_top<multi_top>(groups, cycles, mode, false); }, multi) ||
+        !child::run_in_child([&]() { return run_top<multi_top>(groups, cycles, mode, true); }, shared)) {
+        std::cout << "错误: 子进程运行失败\n";
+        return 1;
+    }
+    print_result("K个独立fifo", separate, cycles);
+    print_result("fifo_multi", multi, cycles);
+    print_result("fifo_multi(共享)", shared, cycles);
+    std::cout << "仿真加速比: " << std::setprecision(1) << (separate.sim_seconds / multi.sim_seconds) << "x\n";
+    std::cout << "共享缓冲池的丢弃: " << shared.dropped << " / 按类别划分: " << multi.dropped << "\n";
+
+    if (separate.checksum != multi.checksum || separate.dropped != multi.dropped) {
+        std::cout << "\n===== 错误: fifo_multi与K个独立fifo的输出不一致 =====\n";
+        return 1;
+    }
+    std::cout << "\n===== fifo_multi与K个独立fifo的输出一致 =====\n";
+    return 0;
+}
@@ -16,9 +16,28 @@
 
 #include <systemc.h>
 #include <iomanip>
-#include <queue>
-#include <random>
+#include <cstdlib>
 #include "fifo.h"
+#include "fifo_coverage.h"
+#include "fifo_activity.h"
+#include "../common/stimulus.h"
+#include "../common/scoreboard.h"
+#include "../common/txn_probe.h"
+
+// FIFO状态输出，作为一个整体与参考模型比较
+struct fifo_status {
+    bool empty;
+    bool full;
+    unsigned int size;
+
+    bool operator==(const fifo_status& o) const {
+        return empty == o.empty && full == o.full && size == o.size;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const fifo_status& s) {
+    return os << "{empty=" << s.empty << ", full=" << s.full << ", size=" << s.size << "}";
+}
 
 // 测试平台模块
 SC_MODULE(fifo_tb) {
@@ -36,21 +55,36 @@ SC_MODULE(fifo_tb) {
     // 波形跟踪文件
     sc_trace_file *tf;
     
-    // 参考模型
-    std::queue<int> reference_fifo;
+    // 记分板：写入的数据作为期望流，读出的数据作为实际流，按顺序配对；
+    // 尚未读出的期望数据个数就是参考模型中FIFO的深度
+    scoreboard<int> data_sb;
+    scoreboard<fifo_status> status_sb;
     
     // 被测FIFO实例
     fifo<int, 8> fifo_inst;
     
+    // 覆盖率监视器
+    fifo_coverage coverage;
+    
+    // 开关活动与能量估算：每1us一个窗口，写入fifo_<种子>_power.csv
+    pwr::power_report power;
+    fifo_activity<int, 8> activity;
+    pwr::power_window power_win;
+    
+    // 事务日志：设置TXN_LOG时在每个时钟下降沿记录全部端口值，用于黄金输出比较
+    txn::probe txn_log;
+    
     // 测试参数
     const int MAX_TESTS = 1000;  // 最大测试次数
     const double WRITE_PROB = 0.6;  // 写入概率
     const double READ_PROB = 0.4;   // 读取概率
     
-    // 随机数生成器
-    std::mt19937 rng;
-    std::uniform_real_distribution<double> dist;
-    std::uniform_int_distribution<int> data_dist;
+    // 可复现的随机激励（相同种子得到相同的测试序列）
+    uint64_t seed;
+    stim::fifo_stimulus stimulus;
+    
+    // 测试结果，仿真结束后由sc_main作为退出码返回
+    bool passed;
     
     // 测试进程
     void test_process() {
@@ -67,28 +101,29 @@ SC_MODULE(fifo_tb) {
         rst_n.write(true);   // 释放复位
         
         wait(clk.posedge_event());
-        std::cout << "\n===== FIFO测试开始 =====\n\n";
+        std::cout << "\n===== FIFO测试开始 (种子 " << seed << ") =====\n\n";
         
-        // 运行随机测试
+        // 运行随机测试，出错时不停止，所有不一致由记分板汇总
         int test_count = 0;
         bool error_detected = false;
         
-        while (test_count < MAX_TESTS && !error_detected) {
-            // 决定本周期是否写入
-            bool do_write = dist(rng) < WRITE_PROB && !full.read();
+        while (test_count < MAX_TESTS) {
+            stim::fifo_op op = stimulus.next();
             
-            // 决定本周期是否读取
-            bool do_read = dist(rng) < READ_PROB && !empty.read();
+            // 读写使能不按full/empty屏蔽，满时写、空时读也驱动到端口上，
+            // 由参考模型判断本周期哪些操作会被接受（先读后写，都按时钟沿之前的深度判断）
+            unsigned int depth_before = data_sb.pending_expected();
+            bool do_write = op.write_en && depth_before < 8;
+            bool do_read = op.read_en && depth_before > 0;
             
             // 设置控制信号
-            write_en.write(do_write);
-            read_en.write(do_read);
+            write_en.write(op.write_en);
+            read_en.write(op.read_en);
             
-            // 如果写入，生成随机数据
-            if (do_write) {
-                int data = data_dist(rng);
-                data_in.write(data);
-                reference_fifo.push(data);
+            // 写使能有效时驱动随机数据，只有被接受的写入进入记分板
+            if (op.write_en) {
+                data_in.write(op.data);
+                if (do_write) data_sb.expect(op.data);
             }
             
             // 等待下一个时钟上升沿
@@ -97,41 +132,18 @@ SC_MODULE(fifo_tb) {
             // 让信号稳定
             wait(1, SC_NS);
             
-            // 如果读取，验证数据
-            if (do_read && !reference_fifo.empty()) {
-                int expected = reference_fifo.front();
-                reference_fifo.pop();
-                
-                int actual = data_out.read();
-                
-                // 验证读取的数据
-                if (actual != expected) {
-                    std::cout << "错误: 预期读取 " << expected 
-                              << ", 实际读取 " << actual << std::endl;
-                    error_detected = true;
-                }
+            // 如果读取，把读出的数据交给记分板
+            if (do_read) {
+                data_sb.actual(data_out.read());
             }
             
             // 让状态信号稳定后再验证
             wait(1, SC_NS);
             
             // 验证full/empty/size信号
-            bool expected_empty = reference_fifo.empty();
-            bool expected_full = reference_fifo.size() >= 8;
-            unsigned int expected_size = reference_fifo.size();
-            
-            if (empty.read() != expected_empty || 
-                full.read() != expected_full ||
-                size.read() != expected_size) {
-                std::cout << "错误: 状态信号不匹配\n"
-                          << "预期: empty=" << expected_empty 
-                          << ", full=" << expected_full 
-                          << ", size=" << expected_size << "\n"
-                          << "实际: empty=" << empty.read() 
-                          << ", full=" << full.read() 
-                          << ", size=" << size.read() << std::endl;
-                error_detected = true;
-            }
+            unsigned int expected_size = data_sb.pending_expected();
+            status_sb.expect({expected_size == 0, expected_size >= 8, expected_size});
+            status_sb.actual({empty.read(), full.read(), size.read()});
             
             test_count++;
         }
@@ -139,13 +151,15 @@ SC_MODULE(fifo_tb) {
         // 特殊案例测试：满和溢出
         std::cout << "\n===== 测试FIFO满条件 =====\n";
         
-        // 先清空FIFO和参考模型
+        // 先清空FIFO和记分板中未读出的数据
+        write_en.write(false);
+        read_en.write(false);
         rst_n.write(false);
         wait(clk.posedge_event());
         wait(1, SC_NS);
         rst_n.write(true);
         wait(clk.posedge_event());
-        reference_fifo = std::queue<int>();  // 清空参考模型
+        data_sb.clear_pending();
         
         // 写入直到满
         write_en.write(true);
@@ -154,7 +168,7 @@ SC_MODULE(fifo_tb) {
         for (int i = 0; i < 10; i++) {  // 尝试写入10个，但FIFO容量为8
             data_in.write(100 + i);
             if (i < 8) {
-                reference_fifo.push(100 + i);
+                data_sb.expect(100 + i);
             }
             wait(clk.posedge_event());
             wait(1, SC_NS);  // 等待状态稳定
@@ -183,6 +197,9 @@ SC_MODULE(fifo_tb) {
             
             std::cout << "读取循环 " << i << ", FIFO空状态: " 
                       << empty.read() << ", FIFO大小: " << size.read() << std::endl;
+            if (i < 8) {
+                data_sb.actual(data_out.read());
+            }
             
             // 验证8个数据后FIFO应该空了
             if (i >= 7 && !empty.read()) {
@@ -193,7 +210,13 @@ SC_MODULE(fifo_tb) {
         }
         
         // 测试结果
-        if (error_detected) {
+        std::cout << "\n";
+        data_sb.report();
+        status_sb.report();
+        coverage.group.report();
+        coverage.group.save("fifo_" + std::to_string(seed) + ".cov");
+        passed = !error_detected && data_sb.passed() && status_sb.passed();
+        if (!passed) {
             std::cout << "\n===== FIFO测试失败 =====\n";
         } else {
             std::cout << "\n===== FIFO测试通过 (" << test_count << "个测试用例) =====\n";
@@ -203,13 +226,22 @@ SC_MODULE(fifo_tb) {
         sc_stop();
     }
 
+    SC_HAS_PROCESS(fifo_tb);
+    
     // 构造函数
-    SC_CTOR(fifo_tb)
-    : clk("clk", 10, SC_NS),
+    fifo_tb(sc_module_name name, uint64_t seed)
+    : sc_module(name),
+      clk("clk", 10, SC_NS),
+      data_sb("fifo.data", 64),
+      status_sb("fifo.status", 4),
       fifo_inst("fifo_instance"),
-      rng(std::random_device()()),
-      dist(0.0, 1.0),
-      data_dist(0, 100) {
+      coverage("coverage", 8),
+      activity("fifo", power),
+      power_win("power_window", power, sc_time(1, SC_US)),
+      txn_log("txn_log", clk.negedge_event()),
+      seed(seed),
+      stimulus(seed, WRITE_PROB, READ_PROB),
+      passed(false) {
         
         // 连接FIFO端口
         fifo_inst.clk(clk);
@@ -222,6 +254,39 @@ SC_MODULE(fifo_tb) {
         fifo_inst.empty(empty);
         fifo_inst.size(size);
         
+        // 覆盖率监视器接在相同的信号上
+        coverage.clk(clk);
+        coverage.rst_n(rst_n);
+        coverage.write_en(write_en);
+        coverage.read_en(read_en);
+        coverage.full(full);
+        coverage.empty(empty);
+        coverage.size(size);
+        
+        activity.clk(clk);
+        activity.rst_n(rst_n);
+        activity.write_en(write_en);
+        activity.data_in(data_in);
+        activity.read_en(read_en);
+        activity.data_out(data_out);
+        activity.full(full);
+        activity.empty(empty);
+        activity.size(size);
+        
+        // 监视器已写入默认能量，ENERGY_TABLE指定的能量表文件覆盖其中的条目
+        if (const char* f = std::getenv("ENERGY_TABLE")) power.table().load(f);
+        power.open("fifo_" + std::to_string(seed) + "_power.csv");
+        
+        txn_log.add("rst_n", rst_n);
+        txn_log.add("write_en", write_en);
+        txn_log.add("data_in", data_in);
+        txn_log.add("read_en", read_en);
+        txn_log.add("data_out", data_out);
+        txn_log.add("full", full);
+        txn_log.add("empty", empty);
+        txn_log.add("size", size);
+        txn_log.open_env();
+        
         // 注册测试进程
         SC_THREAD(test_process);
         
@@ -247,8 +312,10 @@ SC_MODULE(fifo_tb) {
 };
 
 // 主函数
+// 用法: fifo_tb [随机种子]，复现失败用例时传入失败时打印的种子
 int sc_main(int argc, char* argv[]) {
-    fifo_tb tb("fifo_testbench");
+    uint64_t seed = argc > 1 ? std::stoull(argv[1]) : 1;
+    fifo_tb tb("fifo_testbench", seed);
     sc_start();
-    return 0;
+    return tb.passed ? 0 : 1;
 }
@@ -0,0 +1,159 @@
+// File: isa.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ISA_H
+#define ISA_H
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 迷你CPU的指令集
+// 指令16位：[15:12]操作码 [11:8]rd [7:4]rs1 [3:0]rs2/立即数/跳转目标
+// 16个8位寄存器，ALU只使用寄存器的低4位（-8~7），结果符号扩展后写回。
+// 指令存储和数据存储各16个单元，地址为4位。
+namespace isa {
+
+enum opcode : unsigned int {
+    OP_ADD  = 0,    // rd = rs1 + rs2    （操作码0~7与ALU的op相同）
+    OP_SUB  = 1,    // rd = rs1 - rs2
+    OP_NOT  = 2,    // rd = ~rs1
+    OP_AND  = 3,    // rd = rs1 & rs2
+    OP_OR   = 4,    // rd = rs1 | rs2
+    OP_XOR  = 5,    // rd = rs1 ^ rs2
+    OP_LESS = 6,    // rd = rs1 < rs2
+    OP_EQ   = 7,    // rd = rs1 == rs2
+    OP_ADDI = 8,    // rd = rs1 + imm
+    OP_LD   = 9,    // rd = mem[rs1 + imm]
+    OP_ST   = 10,   // mem[rs1 + imm] = rd
+    OP_BZ   = 11,   // if (rs1 == 0) pc = target
+    OP_BNZ  = 12,   // if (rs1 != 0) pc = target
+    OP_JMP  = 13,   // pc = target
+    OP_NOP  = 14,
+    OP_HALT = 15
+};
+
+// 译码后的指令
+struct instruction {
+    opcode op;
+    unsigned int rd;
+    unsigned int rs1;
+    unsigned int rs2;
+    int imm;                // 低4位的符号扩展
+    unsigned int target;    // 低4位作为跳转目标
+
+    // 是否写回寄存器
+    bool writes_register() const {
+        return op <= OP_LD;
+    }
+};
+
+inline instruction decode(uint16_t word) {
+    instruction i;
+    i.op = opcode(word >> 12);
+    i.rd = (word >> 8) & 0xF;
+    i.rs1 = (word >> 4) & 0xF;
+    i.rs2 = word & 0xF;
+    i.imm = int((word & 0xF) ^ 0x8) - 8;
+    i.target = word & 0xF;
+    return i;
+}
+
+// 编码
+inline uint16_t encode(opcode op, unsigned int rd, unsigned int rs1, unsigned int low) {
+    return uint16_t((op << 12) | ((rd & 0xF) << 8) | ((rs1 & 0xF) << 4) | (low & 0xF));
+}
+
+inline uint16_t alu(opcode op, unsigned int rd, unsigned int rs1, unsigned int rs2) {
+    return encode(op, rd, rs1, rs2);
+}
+inline uint16_t addi(unsigned int rd, unsigned int rs1, int imm) { return encode(OP_ADDI, rd, rs1, imm); }
+inline uint16_t ld(unsigned int rd, unsigned int rs1, int imm)   { return encode(OP_LD, rd, rs1, imm); }
+inline uint16_t st(unsigned int rs, unsigned int rs1, int imm)   { return encode(OP_ST, rs, rs1, imm); }
+inline uint16_t bz(unsigned int rs1, unsigned int target)        { return encode(OP_BZ, 0, rs1, target); }
+inline uint16_t bnz(unsigned int rs1, unsigned int target)       { return encode(OP_BNZ, 0, rs1, target); }
+inline uint16_t jmp(unsigned int target)                         { return encode(OP_JMP, 0, 0, target); }
+inline uint16_t nop()                                            { return encode(OP_NOP, 0, 0, 0); }
+inline uint16_t halt()                                           { return encode(OP_HALT, 0, 0, 0); }
+
+// 反汇编，用于打印程序和定位错误
+inline std::string disassemble(uint16_t word) {
+    static const char* names[16] = {
+        "add", "sub", "not", "and", "or", "xor", "less", "eq",
+        "addi", "ld", "st", "bz", "bnz", "jmp", "nop", "halt"
+    };
+    instruction i = decode(word);
+    std::ostringstream os;
+    os << names[i.op];
+    switch (i.op) {
+    case OP_NOT:  os << " r" << i.rd << ", r" << i.rs1; break;
+    case OP_ADDI: os << " r" << i.rd << ", r" << i.rs1 << ", " << i.imm; break;
+    case OP_LD:
+    case OP_ST:   os << " r" << i.rd << ", " << i.imm << "(r" << i.rs1 << ")"; break;
+    case OP_BZ:
+    case OP_BNZ:  os << " r" << i.rs1 << ", " << i.target; break;
+    case OP_JMP:  os << " " << i.target; break;
+    case OP_NOP:
+    case OP_HALT: break;
+    default:      os << " r" << i.rd << ", r" << i.rs1 << ", r" << i.rs2; break;
+    }
+    return os.str();
+}
+
+// 程序：按顺序存放的指令字
+// 指令存储由高、低两个8位ram拼成，write()生成两个ram::initialize格式的文件
+class program {
+public:
+    explicit program(const std::string& name) : name_(name) {}
+
+    program& operator<<(uint16_t word) {
+        words_.push_back(word);
+        return *this;
+    }
+
+    const std::string& name() const { return name_; }
+    const std::vector<uint16_t>& words() const { return words_; }
+
+    std::string hi_path(const std::string& dir = ".") const { return dir + "/" + name_ + "_hi.txt"; }
+    std::string lo_path(const std::string& dir = ".") const { return dir + "/" + name_ + "_lo.txt"; }
+
+    // 格式：@地址 数据（十六进制），每行一个存储单元
+    // 超过16条指令时不创建也不改动已有的文件
+    bool write(const std::string& dir = ".") const {
+        if (words_.size() > 16) return false;
+        std::ofstream hi(hi_path(dir)), lo(lo_path(dir));
+        if (!hi || !lo) return false;
+        hi << "# " << name_ << " 指令高8位\n";
+        lo << "# " << name_ << " 指令低8位\n";
+        for (size_t a = 0; a < words_.size(); a++) {
+            hi << "@" << std::hex << a << " " << std::setw(2) << std::setfill('0') << (words_[a] >> 8) << "\n";
+            lo << "@" << std::hex << a << " " << std::setw(2) << std::setfill('0') << (words_[a] & 0xFF)
+               << "    # " << disassemble(words_[a]) << "\n";
+        }
+        return bool(hi) && bool(lo);
+    }
+
+private:
+    std::string name_;
+    std::vector<uint16_t> words_;
+};
+
+} // namespace isa
+
+#endif // ISA_H
@@ -0,0 +1,180 @@
+// File: iss.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ISS_H
+#define ISS_H
+
+#include <systemc.h>
+#include <cstdint>
+#include "isa.h"
+#include "../register_ram/register_file.h"
+#include "../register_ram/ram.h"
+#include "../alu_4bit/alu_4bit.h"
+
+// 指令集模拟器（快速模式）
+// 不经过端口和仿真内核，经后门peek/poke读写各模块的存储，一条指令就是一次
+// switch分派。只保证功能结果（寄存器、数据存储、pc、指令数）与周期精确模式一致，
+// 不模拟周期。
+//
+// 存储访问与TLM适配器（register_ram/tlm_target.h）一样经过ECC校验、观察点和ram的访问计数，
+// 读端口的对应关系与周期精确模式相同：rf_a读rs1，rf_b读rs2（st读rd），每条指令读一次指令存储。
+// 观察点在快速模式中照常命中，then_stop要等这一段快速执行结束后才生效
+//
+// 运算查表完成：构造时用alu_4bit::evaluate算出全部8×16×16种组合，
+// 结果与组合ALU逐位一致。
+class iss {
+public:
+    iss(register_file& rf_a, register_file& rf_b, ram& imem_hi, ram& imem_lo, ram& dmem)
+    : rf_a(rf_a), rf_b(rf_b), imem_hi(imem_hi), imem_lo(imem_lo), dmem(dmem) {
+        for (unsigned int op = 0; op < 8; op++) {
+            for (int a = -8; a < 8; a++) {
+                for (int b = -8; b < 8; b++) {
+                    sc_int<4> res;
+                    bool z, v, c;
+                    alu_4bit::evaluate(a, b, op, res, z, v, c);
+                    alu_table[index(op, a, b)] = int8_t(res.to_int());
+                }
+            }
+        }
+    }
+
+    // 从pc开始执行最多n条指令，返回实际执行的条数；执行到halt时halted为true
+    // pc在返回时指向下一条要执行的指令
+    uint64_t run(unsigned int& pc, uint64_t n, bool& halted) {
+        predecode();
+        halted = false;
+        uint64_t done = 0;
+        while (done < n) {
+            const isa::instruction& in = fetch(pc);
+            unsigned int next = (pc + 1) & 0xF;
+            done++;
+            switch (in.op) {
+            case isa::OP_ADDI:
+                write_reg(in.rd, alu(isa::OP_ADD, reg(rf_a, in.rs1), in.imm));
+                break;
+            case isa::OP_LD:
+                write_reg(in.rd, load(dmem, alu(isa::OP_ADD, reg(rf_a, in.rs1), in.imm) & 0xF));
+                break;
+            case isa::OP_ST: {
+                unsigned int a = alu(isa::OP_ADD, reg(rf_a, in.rs1), in.imm) & 0xF;
+                store(dmem, a, load(rf_b, in.rd));
+                break;
+            }
+            case isa::OP_BZ:
+                if (alu(isa::OP_OR, reg(rf_a, in.rs1), 0) == 0) next = in.target;
+                break;
+            case isa::OP_BNZ:
+                if (alu(isa::OP_OR, reg(rf_a, in.rs1), 0) != 0) next = in.target;
+                break;
+            case isa::OP_JMP:
+                next = in.target;
+                break;
+            case isa::OP_NOP:
+                break;
+            case isa::OP_HALT:
+                pc = next;
+                halted = true;
+                return done;
+            default:
+                // 操作码0~7与ALU相同
+                write_reg(in.rd, alu(in.op, reg(rf_a, in.rs1), reg(rf_b, in.rs2)));
+                break;
+            }
+            pc = next;
+        }
+        return done;
+    }
+
+private:
+    register_file& rf_a;
+    register_file& rf_b;
+    ram& imem_hi;
+    ram& imem_lo;
+    ram& dmem;
+
+    int8_t alu_table[8 * 16 * 16];
+    isa::instruction code[16];      // 预译码的程序
+
+    static unsigned int index(unsigned int op, int a, int b) {
+        return (op << 8) | ((a & 0xF) << 4) | (b & 0xF);
+    }
+
+    int alu(unsigned int op, int a, int b) const {
+        return alu_table[index(op, a, b)];
+    }
+
+    // 一次读访问：ECC纠错、读出、观察点（register_file和ram共用）
+    template<typename MODEL>
+    static unsigned int peek_checked(MODEL& m, unsigned int a) {
+        if (m.ecc.enabled) m.ecc_read(a);
+        unsigned int v = m.peek(a).to_uint();
+        if (m.watch.armed(a, WATCH_READ)) m.watch.check(m.name(), a, WATCH_READ, v, v);
+        return v;
+    }
+
+    // 一次写访问：观察点、写入（poke同时更新ECC校验位）
+    template<typename MODEL>
+    static void poke_checked(MODEL& m, unsigned int a, unsigned int v) {
+        if (m.watch.armed(a, WATCH_WRITE)) m.watch.check(m.name(), a, WATCH_WRITE, m.peek(a).to_uint(), v);
+        m.poke(a, v);
+    }
+
+    static unsigned int load(register_file& rf, unsigned int r) { return peek_checked(rf, r); }
+
+    static unsigned int load(ram& m, unsigned int a) {
+        m.reads++;
+        return peek_checked(m, a);
+    }
+
+    static void store(ram& m, unsigned int a, unsigned int v) {
+        poke_checked(m, a, v);
+        m.writes++;
+    }
+
+    // 寄存器的低4位作为ALU操作数
+    static int reg(register_file& rf, unsigned int r) {
+        return int((load(rf, r) & 0xF) ^ 0x8) - 8;
+    }
+
+    // 写回：结果符号扩展为8位，两份寄存器堆同时写
+    void write_reg(unsigned int r, int v) {
+        poke_checked(rf_a, r, v & 0xFF);
+        poke_checked(rf_b, r, v & 0xFF);
+    }
+
+    // 取指：译码结果来自predecode，访问计数和读观察点按每条指令一次读指令存储处理
+    const isa::instruction& fetch(unsigned int pc) {
+        imem_hi.reads++;
+        imem_lo.reads++;
+        if (imem_hi.watch.armed(pc, WATCH_READ) || imem_lo.watch.armed(pc, WATCH_READ)) {
+            unsigned int hi = imem_hi.peek(pc).to_uint(), lo = imem_lo.peek(pc).to_uint();
+            if (imem_hi.watch.armed(pc, WATCH_READ)) imem_hi.watch.check(imem_hi.name(), pc, WATCH_READ, hi, hi);
+            if (imem_lo.watch.armed(pc, WATCH_READ)) imem_lo.watch.check(imem_lo.name(), pc, WATCH_READ, lo, lo);
+        }
+        return code[pc];
+    }
+
+    // 指令存储在运行中不会改变，每次进入快速模式时译码一遍即可（打开ECC时先纠错）
+    void predecode() {
+        for (unsigned int a = 0; a < 16; a++) {
+            if (imem_hi.ecc.enabled) imem_hi.ecc_read(a);
+            if (imem_lo.ecc.enabled) imem_lo.ecc_read(a);
+            code[a] = isa::decode((imem_hi.peek(a).to_uint() << 8) | imem_lo.peek(a).to_uint());
+        }
+    }
+};
+
+#endif // ISS_H
@@ -0,0 +1,412 @@
+// File: mini_cpu.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef MINI_CPU_H
+#define MINI_CPU_H
+
+#include <systemc.h>
+#include <algorithm>
+#include <string>
+#include "isa.h"
+#include "iss.h"
+#include "../register_ram/register_file.h"
+#include "../register_ram/ram.h"
+#include "../alu_4bit/alu_4bit.h"
+#include "../mux_4to1/mux_4to1.h"
+
+// 由前面几个实验的模块搭成的迷你load/store CPU（多周期，每条指令4个周期）
+//
+//   指令存储  imem_hi/imem_lo：两个ram拼成16位指令
+//   寄存器堆  rf_a/rf_b：两份内容相同的register_file，提供两个读端口，写端口并联
+//   操作数B   mux_lo/mux_hi：两个2位mux_4to1按位切片，在rs2、立即数和0之间选择
+//   运算      alu：alu_4bit，操作数A直接来自rf_a
+//   数据存储  dmem：ram
+//
+// 控制器在每个时钟上升沿完成当前阶段并为下一阶段驱动控制信号：
+//   FETCH   送出取指地址
+//   DECODE  读入指令并译码，驱动寄存器读地址、ALU操作码和操作数选择
+//   EXECUTE 读取ALU结果和零标志，决定下一条指令地址；访存指令送出数据存储地址
+//   MEMORY  store在此沿写入数据存储；load读出数据；驱动寄存器写回
+// 写回在下一个上升沿（下一条指令的FETCH）发生。
+//
+// 除周期精确模式外还有快速模式：fast_forward(n)之后，控制器在下一个FETCH沿把
+// 状态交给指令集模拟器iss，在零仿真时间内执行n条指令，再从新的pc继续周期精确执行。
+// 两种模式共用同一组寄存器堆和存储数组，交接时不需要拷贝状态。
+SC_MODULE(mini_cpu) {
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+    sc_out<bool> halted;
+
+    // 操作数B的来源，即mux_4to1的选择信号
+    enum operand_source {
+        SRC_REG = 0,    // rs2（store时为rd）
+        SRC_IMM = 1,    // 立即数
+        SRC_ZERO = 2    // 常数0，分支用 rs1 | 0 得到零标志
+    };
+
+    enum stage {
+        STAGE_FETCH,
+        STAGE_DECODE,
+        STAGE_EXECUTE,
+        STAGE_MEMORY,
+        STAGE_HALTED
+    };
+
+    // 子模块
+    ram imem_hi;
+    ram imem_lo;
+    register_file rf_a;
+    register_file rf_b;
+    mux_4to1 mux_lo;
+    mux_4to1 mux_hi;
+    alu_4bit alu;
+    ram dmem;
+
+    // 快速模式
+    iss fast;
+
+    // 执行的指令数达到该值时停机，0表示只在halt指令停机
+    uint64_t max_instructions;
+
+    uint64_t instructions() const { return retired; }
+    uint64_t fast_instructions() const { return fast_retired; }
+    uint64_t cycles() const { return cycle_count; }
+    unsigned int pc() const { return pc_reg; }
+
+    // 请求在下一条指令开始时切换到快速模式，执行n条指令（或到halt）后切回周期精确模式
+    // 可以在复位期间调用，也可以在运行中随时调用
+    void fast_forward(uint64_t n) {
+        fast_remaining = n;
+    }
+
+    // 体系结构状态，用于比较两种模式的结果
+    struct architectural_state {
+        unsigned int pc;
+        uint64_t instructions;
+        uint8_t regs[16];
+        uint8_t mem[16];
+
+        bool operator==(const architectural_state& o) const {
+            if (pc != o.pc || instructions != o.instructions) return false;
+            for (unsigned int i = 0; i < 16; i++) {
+                if (regs[i] != o.regs[i] || mem[i] != o.mem[i]) return false;
+            }
+            return true;
+        }
+    };
+
+    architectural_state snapshot() const {
+        architectural_state s;
+        s.pc = pc_reg;
+        s.instructions = retired;
+        for (unsigned int i = 0; i < 16; i++) {
+            s.regs[i] = rf_a.peek(i).to_uint();
+            s.mem[i] = dmem.peek(i).to_uint();
+        }
+        return s;
+    }
+
+    // 从ram::initialize格式的文件装入程序和数据
+    void load_program(const std::string& hi_file, const std::string& lo_file) {
+        imem_hi.initialize(hi_file);
+        imem_lo.initialize(lo_file);
+    }
+
+    void load_data(const std::string& file) {
+        dmem.initialize(file);
+    }
+
+    // 寄存器的后门访问，两份寄存器堆同时修改
+    sc_uint<8> peek_register(unsigned int r) const {
+        return rf_a.peek(r);
+    }
+
+    void poke_register(unsigned int r, sc_uint<8> v) {
+        rf_a.poke(r, v);
+        rf_b.poke(r, v);
+    }
+
+    // 控制器
+    void control_process() {
+        if (!rst_n.read()) {
+            state = STAGE_FETCH;
+            pc_reg = 0;
+            retired = 0;
+            fast_retired = 0;
+            cycle_count = 0;
+            rf_wr_en.write(false);
+            dmem_wr_en.write(false);
+            halted.write(false);
+            return;
+        }
+
+        cycle_count++;
+        switch (state) {
+        case STAGE_FETCH:
+            // 本沿没有寄存器写入时才能交接，否则write_process可能在快速模式之后
+            // 执行，覆盖快速模式写的寄存器；有快速模式请求时，MEMORY阶段改用后门写回
+            if (fast_remaining && !rf_wr_en.read() && run_fast()) {
+                halted.write(true);
+                rf_wr_en.write(false);
+                state = STAGE_HALTED;
+                break;
+            }
+            imem_addr.write(pc_reg);
+            rf_wr_en.write(false);
+            // register_file的读进程只对rd_addr敏感，寄存器被改写后rd_data保持旧值，
+            // 直到读地址变化。上一条指令的写回正好在本沿发生，快速模式和poke也会改写
+            // 寄存器，所以取指时总是改变读地址；译码时读任何寄存器都能读到新值
+            rf_rd_addr_a.write(rf_rd_addr_a.read() ^ 1);
+            rf_rd_addr_b.write(rf_rd_addr_b.read() ^ 1);
+            state = STAGE_DECODE;
+            break;
+
+        case STAGE_DECODE:
+            current = isa::decode((imem_hi_data.read().to_uint() << 8) | imem_lo_data.read().to_uint());
+            rf_rd_addr_a.write(current.rs1);
+            rf_rd_addr_b.write(current.op == isa::OP_ST ? current.rd : current.rs2);
+            imm.write(current.imm);
+            if (current.op <= isa::OP_EQ) {
+                alu_op.write(current.op);
+                operand_select.write(SRC_REG);
+            } else if (current.op == isa::OP_BZ || current.op == isa::OP_BNZ) {
+                alu_op.write(isa::OP_OR);
+                operand_select.write(SRC_ZERO);
+            } else {
+                // addi和访存地址计算都是加法
+                alu_op.write(isa::OP_ADD);
+                operand_select.write(SRC_IMM);
+            }
+            state = STAGE_EXECUTE;
+            break;
+
+        case STAGE_EXECUTE:
+            next_pc = (pc_reg + 1) & 0xF;
+            writeback = sc_uint<8>(alu_result.read().to_int() & 0xFF);
+            switch (current.op) {
+            case isa::OP_BZ:
+                if (alu_zero.read()) next_pc = current.target;
+                break;
+            case isa::OP_BNZ:
+                if (!alu_zero.read()) next_pc = current.target;
+                break;
+            case isa::OP_JMP:
+                next_pc = current.target;
+                break;
+            case isa::OP_LD:
+                dmem_addr.write(alu_result.read().to_int() & 0xF);
+                break;
+            case isa::OP_ST:
+                dmem_addr.write(alu_result.read().to_int() & 0xF);
+                dmem_wr_data.write(rf_b_data.read());
+                dmem_wr_en.write(true);
+                break;
+            default:
+                break;
+            }
+            state = STAGE_MEMORY;
+            break;
+
+        case STAGE_MEMORY:
+            dmem_wr_en.write(false);
+            if (current.op == isa::OP_LD) writeback = dmem_rd_data.read();
+            if (current.writes_register()) {
+                if (fast_remaining) {
+                    poke_register(current.rd, writeback);
+                } else {
+                    rf_wr_addr.write(current.rd);
+                    rf_wr_data.write(writeback);
+                    rf_wr_en.write(true);
+                }
+            }
+            pc_reg = next_pc;
+            retired++;
+            if (current.op == isa::OP_HALT || (max_instructions && retired >= max_instructions)) {
+                halted.write(true);
+                state = STAGE_HALTED;
+            } else {
+                state = STAGE_FETCH;
+            }
+            break;
+
+        case STAGE_HALTED:
+            // 最后一条指令的写回在本沿完成
+            rf_wr_en.write(false);
+            break;
+        }
+    }
+
+    // 寄存器读数据到ALU操作数A和mux各输入的连线（位切片）
+    void operand_process() {
+        unsigned int a = rf_a_data.read().to_uint();
+        unsigned int b = rf_b_data.read().to_uint();
+        unsigned int i = imm.read().to_int() & 0xF;
+        alu_a.write(sc_int<4>(int(a & 0xF)));
+        x_lo[SRC_REG].write(b & 3);
+        x_hi[SRC_REG].write((b >> 2) & 3);
+        x_lo[SRC_IMM].write(i & 3);
+        x_hi[SRC_IMM].write((i >> 2) & 3);
+    }
+
+    // 两个mux的输出拼成操作数B
+    void operand_b_process() {
+        alu_b.write(sc_int<4>((f_hi.read().to_int() << 2) | f_lo.read().to_int()));
+    }
+
+    SC_CTOR(mini_cpu)
+    : imem_hi("imem_hi"), imem_lo("imem_lo"),
+      rf_a("rf_a"), rf_b("rf_b"),
+      mux_lo("mux_lo"), mux_hi("mux_hi"),
+      alu("alu"),
+      dmem("dmem"),
+      fast(rf_a, rf_b, imem_hi, imem_lo, dmem),
+      max_instructions(0),
+      state(STAGE_FETCH), pc_reg(0), next_pc(0),
+      retired(0), fast_retired(0), fast_remaining(0), cycle_count(0), writeback(0) {
+        current = isa::decode(isa::nop());
+
+        // 指令存储只读
+        imem_hi.clk(clk);
+        imem_hi.addr(imem_addr);
+        imem_hi.wr_data(const_byte);
+        imem_hi.wr_en(const_false);
+        imem_hi.rd_data(imem_hi_data);
+        imem_lo.clk(clk);
+        imem_lo.addr(imem_addr);
+        imem_lo.wr_data(const_byte);
+        imem_lo.wr_en(const_false);
+        imem_lo.rd_data(imem_lo_data);
+
+        // 两份寄存器堆共用写端口
+        rf_a.clk(clk);
+        rf_a.rd_addr(rf_rd_addr_a);
+        rf_a.wr_addr(rf_wr_addr);
+        rf_a.wr_data(rf_wr_data);
+        rf_a.wr_en(rf_wr_en);
+        rf_a.rd_data(rf_a_data);
+        rf_b.clk(clk);
+        rf_b.rd_addr(rf_rd_addr_b);
+        rf_b.wr_addr(rf_wr_addr);
+        rf_b.wr_data(rf_wr_data);
+        rf_b.wr_en(rf_wr_en);
+        rf_b.rd_data(rf_b_data);
+
+        // 操作数B选择，X3未使用，接0
+        mux_lo.X0(x_lo[SRC_REG]);
+        mux_lo.X1(x_lo[SRC_IMM]);
+        mux_lo.X2(const_zero2);
+        mux_lo.X3(const_zero2);
+        mux_lo.Y(operand_select);
+        mux_lo.F(f_lo);
+        mux_hi.X0(x_hi[SRC_REG]);
+        mux_hi.X1(x_hi[SRC_IMM]);
+        mux_hi.X2(const_zero2);
+        mux_hi.X3(const_zero2);
+        mux_hi.Y(operand_select);
+        mux_hi.F(f_hi);
+
+        alu.A(alu_a);
+        alu.B(alu_b);
+        alu.op(alu_op);
+        alu.result(alu_result);
+        alu.zero(alu_zero);
+        alu.overflow(alu_overflow);
+        alu.carry(alu_carry);
+
+        dmem.clk(clk);
+        dmem.addr(dmem_addr);
+        dmem.wr_data(dmem_wr_data);
+        dmem.wr_en(dmem_wr_en);
+        dmem.rd_data(dmem_rd_data);
+
+        SC_METHOD(control_process);
+        sensitive << clk.pos();
+
+        SC_METHOD(operand_process);
+        sensitive << rf_a_data << rf_b_data << imm;
+
+        SC_METHOD(operand_b_process);
+        sensitive << f_lo << f_hi;
+    }
+
+private:
+    // 指令存储
+    sc_signal<sc_uint<4>> imem_addr;
+    sc_signal<sc_uint<8>> imem_hi_data;
+    sc_signal<sc_uint<8>> imem_lo_data;
+
+    // 寄存器堆
+    sc_signal<sc_uint<4>> rf_rd_addr_a;
+    sc_signal<sc_uint<4>> rf_rd_addr_b;
+    sc_signal<sc_uint<4>> rf_wr_addr;
+    sc_signal<sc_uint<8>> rf_wr_data;
+    sc_signal<bool> rf_wr_en;
+    sc_signal<sc_uint<8>> rf_a_data;
+    sc_signal<sc_uint<8>> rf_b_data;
+
+    // 操作数选择
+    sc_signal<sc_int<4>> imm;
+    sc_signal<sc_uint<2>> operand_select;
+    sc_signal<sc_uint<2>> x_lo[2];
+    sc_signal<sc_uint<2>> x_hi[2];
+    sc_signal<sc_uint<2>> f_lo;
+    sc_signal<sc_uint<2>> f_hi;
+
+    // ALU
+    sc_signal<sc_int<4>> alu_a;
+    sc_signal<sc_int<4>> alu_b;
+    sc_signal<sc_uint<3>> alu_op;
+    sc_signal<sc_int<4>> alu_result;
+    sc_signal<bool> alu_zero;
+    sc_signal<bool> alu_overflow;
+    sc_signal<bool> alu_carry;
+
+    // 数据存储
+    sc_signal<sc_uint<4>> dmem_addr;
+    sc_signal<sc_uint<8>> dmem_wr_data;
+    sc_signal<bool> dmem_wr_en;
+    sc_signal<sc_uint<8>> dmem_rd_data;
+
+    // 常量
+    sc_signal<sc_uint<8>> const_byte;
+    sc_signal<bool> const_false;
+    sc_signal<sc_uint<2>> const_zero2;
+
+    // 控制器状态
+    stage state;
+    unsigned int pc_reg;
+    unsigned int next_pc;
+    uint64_t retired;
+    uint64_t fast_retired;
+    uint64_t fast_remaining;
+    uint64_t cycle_count;
+    sc_uint<8> writeback;
+    isa::instruction current;
+
+    // 切换到快速模式执行，返回是否停机
+    bool run_fast() {
+        uint64_t n = fast_remaining;
+        if (max_instructions) n = std::min(n, max_instructions - retired);
+        bool halt = false;
+        uint64_t done = fast.run(pc_reg, n, halt);
+        retired += done;
+        fast_retired += done;
+        fast_remaining = 0;
+        return halt || (max_instructions && retired >= max_instructions);
+    }
+};
+
+#endif // MINI_CPU_H
@@ -0,0 +1,311 @@
+// File: mini_cpu_tb.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <string>
+#include "mini_cpu.h"
+#include "isa.h"
+#include "../common/telemetry_publisher.h"
+
+using namespace isa;
+
+// 一个测试程序及其运行结束后应有的寄存器和数据存储内容
+struct cpu_test {
+    program prog;
+    std::string data_file;                        // 数据存储初值，空表示全0
+    std::map<unsigned int, unsigned int> regs;    // 寄存器 -> 期望值
+    std::map<unsigned int, unsigned int> mem;     // 数据存储地址 -> 期望值
+    uint64_t instructions;                        // 期望执行的指令数
+};
+
+// 数组求和：dmem[0..3]求和，写到dmem[15]
+cpu_test sum_test() {
+    cpu_test t{program("sum"), "sum_data.txt", {}, {}, 0};
+    t.prog << addi(1, 0, 0)         // 0: r1 = 0       指针
+           << addi(2, 0, 4)         // 1: r2 = 4       计数
+           << addi(3, 0, 0)         // 2: r3 = 0       和
+           << ld(4, 1, 0)           // 3: r4 = mem[r1]
+           << alu(OP_ADD, 3, 3, 4)  // 4: r3 += r4
+           << addi(1, 1, 1)         // 5: r1++
+           << addi(2, 2, -1)        // 6: r2--
+           << bnz(2, 3)             // 7: 循环
+           << st(3, 0, -1)          // 8: mem[15] = r3
+           << halt();               // 9
+    std::ofstream data(t.data_file);
+    data << "# 数组求和的输入\n@0 01\n@1 02\n@2 ff\n@3 03\n";
+    t.regs = {{1, 0x04}, {2, 0x00}, {3, 0x05}, {4, 0x03}};
+    t.mem = {{15, 0x05}};
+    t.instructions = 3 + 4 * 5 + 2;
+    return t;
+}
+
+// 全部ALU操作、分支、跳转和访存
+cpu_test alu_test() {
+    cpu_test t{program("alu_ops"), "", {}, {}, 0};
+    t.prog << addi(1, 0, 5)             // 0: r1 = 5
+           << addi(2, 0, -3)            // 1: r2 = -3
+           << alu(OP_SUB, 3, 1, 2)      // 2: r3 = 5 - (-3) = 8，回绕为-8
+           << alu(OP_AND, 4, 1, 2)      // 3: r4 = 0101 & 1101 = 5
+           << alu(OP_OR, 5, 1, 2)       // 4: r5 = 1101 = -3
+           << alu(OP_XOR, 6, 1, 2)      // 5: r6 = 1000 = -8
+           << alu(OP_LESS, 7, 2, 1)     // 6: r7 = (-3 < 5) = 1
+           << alu(OP_EQ, 8, 1, 1)       // 7: r8 = 1
+           << alu(OP_NOT, 9, 1, 0)      // 8: r9 = ~5 = -6
+           << bz(0, 11)                 // 9: r0 == 0，跳转
+           << addi(10, 0, 7)            // 10: 跳过
+           << jmp(13)                   // 11
+           << addi(11, 0, 7)            // 12: 跳过
+           << st(9, 0, 2)               // 13: mem[2] = r9
+           << ld(12, 0, 2)              // 14: r12 = mem[2]
+           << halt();                   // 15
+    t.regs = {{1, 0x05}, {2, 0xFD}, {3, 0xF8}, {4, 0x05}, {5, 0xFD}, {6, 0xF8},
+              {7, 0x01}, {8, 0x01}, {9, 0xFA}, {10, 0x00}, {11, 0x00}, {12, 0xFA}};
+    t.mem = {{2, 0xFA}};
+    t.instructions = 14;
+    return t;
+}
+
+// 吞吐率基准：双重循环中不断读、加、写数据存储，永不停机，由指令数上限结束
+program bench_program() {
+    program p("bench");
+    p << addi(1, 0, 7)              // 0: 外层计数
+      << addi(2, 0, 7)              // 1: 内层计数
+      << ld(3, 2, 0)                // 2: r3 = mem[r2]
+      << alu(OP_ADD, 4, 4, 3)       // 3: r4 += r3
+      << st(4, 2, 0)                // 4: mem[r2] = r4
+      << addi(2, 2, -1)             // 5
+      << bnz(2, 2)                  // 6
+      << addi(1, 1, -1)             // 7
+      << bnz(1, 1)                  // 8
+      << jmp(0);                    // 9
+    return p;
+}
+
+// 运行方式
+enum run_mode {
+    RUN_CYCLE,      // 全程周期精确
+    RUN_FAST,       // 复位后立即切到快速模式，直到停机
+    RUN_MIXED       // 周期精确与快速模式交替
+};
+
+static const char* mode_name(run_mode m) {
+    return m == RUN_CYCLE ? "周期精确" : m == RUN_FAST ? "快速模式" : "交替运行";
+}
+
+SC_MODULE(mini_cpu_tb) {
+    sc_clock clk;
+    sc_signal<bool> rst_n;
+    sc_signal<bool> halted;
+
+    mini_cpu cpu;
+
+    uint64_t bench_instructions;
+    int errors;
+
+    // 交替运行时，每段周期精确执行的周期数和每段快速执行的指令数
+    uint64_t mixed_cycles;
+    uint64_t mixed_fast_instructions;
+
+    // 复位CPU，清空存储并装入程序，运行到停机；返回运行用时（秒）
+    double run(const program& prog, const std::string& data_file, uint64_t limit, run_mode mode) {
+        rst_n.write(false);
+        wait(clk.posedge_event());
+        wait(clk.posedge_event());
+
+        for (unsigned int a = 0; a < 16; a++) {
+            cpu.imem_hi.poke(a, OP_HALT << 4);     // 程序之外的单元填halt
+            cpu.imem_lo.poke(a, 0);
+            cpu.dmem.poke(a, 0);
+            cpu.poke_register(a, 0);
+        }
+        if (!prog.write()) {
+            std::cout << "错误: 无法写出程序文件 " << prog.name() << std::endl;
+            errors++;
+        }
+        cpu.load_program(prog.hi_path(), prog.lo_path());
+        if (!data_file.empty()) cpu.load_data(data_file);
+        cpu.max_instructions = limit;
+        cpu.fast_forward(mode == RUN_FAST ? UINT64_MAX : 0);
+
+        auto t0 = std::chrono::steady_clock::now();
+        rst_n.write(true);
+        if (mode == RUN_MIXED) {
+            const sc_time segment = clk.period() * double(mixed_cycles);
+            for (;;) {
+                wait(segment, halted.posedge_event());
+                if (halted.read()) break;
+                cpu.fast_forward(mixed_fast_instructions);
+            }
+        } else {
+            wait(halted.posedge_event());
+        }
+        wait(clk.posedge_event());      // 最后一条指令的写回
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    void check(const cpu_test& t) {
+        std::cout << "\n===== 程序 " << t.prog.name() << " =====\n";
+        for (size_t a = 0; a < t.prog.words().size(); a++) {
+            std::cout << "  " << std::setw(2) << a << ": " << disassemble(t.prog.words()[a]) << "\n";
+        }
+        run(t.prog, t.data_file, 0, RUN_CYCLE);
+
+        int before = errors;
+        for (const auto& r : t.regs) {
+            unsigned int v = cpu.peek_register(r.first).to_uint();
+            if (v != r.second) {
+                std::cout << "错误: r" << r.first << " = 0x" << std::hex << v
+                          << ", 期望 0x" << r.second << std::dec << std::endl;
+                errors++;
+            }
+        }
+        for (const auto& m : t.mem) {
+            unsigned int v = cpu.dmem.peek(m.first).to_uint();
+            if (v != m.second) {
+                std::cout << "错误: mem[" << m.first << "] = 0x" << std::hex << v
+                          << ", 期望 0x" << m.second << std::dec << std::endl;
+                errors++;
+            }
+        }
+        for (unsigned int r = 0; r < 16; r++) {
+            if (cpu.rf_a.peek(r) != cpu.rf_b.peek(r)) {
+                std::cout << "错误: 两份寄存器堆的r" << r << "不一致" << std::endl;
+                errors++;
+            }
+        }
+        if (cpu.instructions() != t.instructions) {
+            std::cout << "错误: 执行了 " << cpu.instructions() << " 条指令, 期望 " << t.instructions << std::endl;
+            errors++;
+        }
+        std::cout << "指令 " << cpu.instructions() << ", 周期 " << cpu.cycles()
+                  << (errors == before ? "  通过" : "  失败") << std::endl;
+
+        // 快速模式和交替运行的结果必须与周期精确模式完全相同
+        mini_cpu::architectural_state reference = cpu.snapshot();
+        compare_modes(t.prog, t.data_file, 0, reference);
+        compare_with_ecc(t.prog, t.data_file, reference);
+    }
+
+    // 全部存储打开ECC后交替运行：快速模式的写入同样要更新校验位，否则之后的端口读会把
+    // 正确的数据"纠正"成错误的值。结果必须与周期精确模式相同，并且没有任何纠错
+    void compare_with_ecc(const program& prog, const std::string& data_file,
+                          const mini_cpu::architectural_state& reference) {
+        set_ecc(true);
+        run(prog, data_file, 0, RUN_MIXED);
+        bool same = cpu.snapshot() == reference;
+        uint64_t events = 0;
+        for (const ecc_store<16>* e : {&cpu.imem_hi.ecc, &cpu.imem_lo.ecc, &cpu.dmem.ecc, &cpu.rf_a.ecc, &cpu.rf_b.ecc}) {
+            events += e->corrected + e->uncorrected;
+        }
+        set_ecc(false);
+        std::cout << "交替运行+ECC: 纠错 " << events
+                  << (same && events == 0 ? "  与周期精确模式一致" : "  与周期精确模式不一致") << std::endl;
+        if (!same || events) errors++;
+    }
+
+    void set_ecc(bool on) {
+        cpu.imem_hi.enable_ecc(on);
+        cpu.imem_lo.enable_ecc(on);
+        cpu.dmem.enable_ecc(on);
+        cpu.rf_a.enable_ecc(on);
+        cpu.rf_b.enable_ecc(on);
+    }
+
+    void compare_modes(const program& prog, const std::string& data_file, uint64_t limit,
+                       const mini_cpu::architectural_state& reference) {
+        for (run_mode mode : {RUN_FAST, RUN_MIXED}) {
+            run(prog, data_file, limit, mode);
+            bool same = cpu.snapshot() == reference;
+            std::cout << mode_name(mode) << ": 指令 " << cpu.instructions()
+                      << " (快速 " << cpu.fast_instructions() << "), 周期 " << cpu.cycles()
+                      << (same ? "  与周期精确模式一致" : "  与周期精确模式不一致") << std::endl;
+            if (!same) errors++;
+        }
+    }
+
+    void print_rate(run_mode mode, double seconds) {
+        std::cout << std::left << std::setw(12) << mode_name(mode) << std::right
+                  << "指令 " << cpu.instructions() << ", 周期 " << cpu.cycles()
+                  << std::fixed << std::setprecision(3) << ", 用时 " << seconds << " s, "
+                  << std::setprecision(0) << "每秒仿真指令数 " << (cpu.instructions() / seconds) << "\n";
+    }
+
+    void test_process() {
+        check(sum_test());
+        check(alu_test());
+
+        // 吞吐率基准：周期精确模式与快速模式
+        std::cout << "\n===== 吞吐率基准 =====\n";
+        double cycle_seconds = run(bench_program(), "", bench_instructions, RUN_CYCLE);
+        print_rate(RUN_CYCLE, cycle_seconds);
+        std::cout << std::setw(12) << "" << "每秒仿真周期数 " << (cpu.cycles() / cycle_seconds) << "\n";
+        mini_cpu::architectural_state reference = cpu.snapshot();
+
+        double fast_seconds = run(bench_program(), "", bench_instructions, RUN_FAST);
+        print_rate(RUN_FAST, fast_seconds);
+        if (!(cpu.snapshot() == reference)) {
+            std::cout << "错误: 快速模式的结果与周期精确模式不一致" << std::endl;
+            errors++;
+        }
+        std::cout << "快速模式加速比 " << std::setprecision(1) << (cycle_seconds / fast_seconds) << "x\n";
+
+        // 大段快速执行、小段周期精确执行交替，检查交接后状态仍然一致
+        mixed_cycles = 1000;
+        mixed_fast_instructions = 10000;
+        compare_modes(bench_program(), "", bench_instructions, reference);
+
+        if (errors) {
+            std::cout << "\n===== 迷你CPU测试失败 (" << errors << "处错误) =====\n";
+        } else {
+            std::cout << "\n===== 迷你CPU测试通过 =====\n";
+        }
+        sc_stop();
+    }
+
+    SC_CTOR(mini_cpu_tb)
+    : clk("clk", 10, SC_NS), cpu("cpu"), bench_instructions(200000), errors(0),
+      mixed_cycles(12), mixed_fast_instructions(2) {
+        cpu.clk(clk);
+        cpu.rst_n(rst_n);
+        cpu.halted(halted);
+
+        SC_THREAD(test_process);
+    }
+};
+
+// 用法: mini_cpu_tb [基准指令数]
+int sc_main(int argc, char* argv[]) {
+    mini_cpu_tb tb("mini_cpu_testbench");
+    if (argc > 1) tb.bench_instructions = std::stoull(argv[1]);
+
+    // 设置了TELEMETRY时把指令数和各存储的端口访问次数发布到共享内存，用common/telemetry_top查看。
+    // 快速模式不经过存储端口，也不推进仿真时间，这段时间里不发布
+    tele::publisher telemetry("telemetry", tb.clk.period());
+    mini_cpu& cpu = tb.cpu;
+    telemetry.add_counter("instructions", [&cpu]() { return cpu.instructions(); });
+    telemetry.add_counter("fast_instructions", [&cpu]() { return cpu.fast_instructions(); });
+    telemetry.add_counter("imem_reads", [&cpu]() { return cpu.imem_hi.reads + cpu.imem_lo.reads; });
+    telemetry.add_counter("dmem_reads", [&cpu]() { return cpu.dmem.reads; });
+    telemetry.add_counter("dmem_writes", [&cpu]() { return cpu.dmem.writes; });
+    telemetry.open_env("mini_cpu " + std::to_string(tb.bench_instructions) + " instructions");
+
+    sc_start();
+    return tb.errors ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+// File: models.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// 模型静态库：头文件中模型模板最常用的实例在这里集中编译一次。
+// 构建时定义了SC_MODELS_LIB，各模型头文件末尾用extern template声明同样的实例，
+// 包含它们的测试平台只引用这些实例，不再各自生成代码。
+// 不是模板的模块（如mux_4to1）成员函数都在类内定义，仍由使用它的测试平台编译
+#include "../register_ram/register_file.h"
+#include "../register_ram/ram.h"
+#include "../alu_4bit/alu_4bit.h"
+#include "../fifo_design/fifo.h"
+
+template struct register_file_t<sc_datatypes>;
+template struct register_file_t<native_datatypes>;
+template struct ram_t<sc_datatypes>;
+template struct ram_t<native_datatypes>;
+template struct alu_4bit_t<sc_datatypes>;
+template struct alu_4bit_t<native_datatypes>;
+
+template class fifo_ring<int, 8>;
+template struct fifo<int, 8>;
@@ -15,7 +15,11 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <systemc.h>
+#include <cstdlib>
 #include "mux_4to1.h"
+#include "mux_activity.h"
+#include "../common/scoreboard.h"
+#include "../common/txn_probe.h"
 
 SC_MODULE(mux_4to1_tb) {
     // 信号
@@ -32,6 +36,20 @@ SC_MODULE(mux_4to1_tb) {
     // 组件实例
     mux_4to1 mux_inst;
     
+    // 开关活动与能量估算：每1us一个窗口，写入mux_power.csv
+    pwr::power_report power;
+    mux_activity activity;
+    pwr::power_window power_win;
+    
+    // 记分板：按顺序比较期望输出和实际输出
+    scoreboard<unsigned int> sb;
+    
+    // 测试结果，仿真结束后由sc_main作为退出码返回
+    bool passed;
+    
+    // 事务日志：设置TXN_LOG时记录每组输入施加后的端口值，用于黄金输出比较
+    txn::probe txn_log;
+    
     // 测试进程
     void test_process() {
         // 初始化输入，每个输入赋予不同值便于观察
@@ -54,17 +72,38 @@ SC_MODULE(mux_4to1_tb) {
                  << F_sig.read() << endl;
             
             // 验证输出是否正确
-            sc_assert(F_sig.read() == i);
+            sb.expect(i);
+            sb.actual(F_sig.read().to_uint());
+            txn_log.sample();
         }
         
-        cout << "测试成功完成!" << endl;
+        // 穷举所有输入组合，只由记分板检查
+        for (int v = 0; v < 1024; v++) {
+            unsigned int x[4] = {v & 3u, (v >> 2) & 3u, (v >> 4) & 3u, (v >> 6) & 3u};
+            unsigned int y = v >> 8;
+            X0_sig.write(x[0]);
+            X1_sig.write(x[1]);
+            X2_sig.write(x[2]);
+            X3_sig.write(x[3]);
+            Y_sig.write(y);
+            wait(10, SC_NS);
+            sb.expect(x[y]);
+            sb.actual(F_sig.read().to_uint());
+            txn_log.sample();
+        }
+        
+        sb.report();
+        passed = sb.passed();
+        cout << (passed ? "测试成功完成!" : "测试失败!") << endl;
         cout << "波形已保存到 mux_4to1.vcd 文件" << endl;
         sc_stop();
     }
     
     // 构造函数
     SC_CTOR(mux_4to1_tb)
-    : mux_inst("mux_instance") {
+    : mux_inst("mux_instance"), activity("mux", power),
+      power_win("power_window", power, sc_time(1, SC_US)), sb("mux", 4),
+      passed(false), txn_log("txn_log") {
         // 连接信号到被测设备
         mux_inst.X0(X0_sig);
         mux_inst.X1(X1_sig);
@@ -73,6 +112,25 @@ SC_MODULE(mux_4to1_tb) {
         mux_inst.Y(Y_sig);
         mux_inst.F(F_sig);
         
+        activity.X0(X0_sig);
+        activity.X1(X1_sig);
+        activity.X2(X2_sig);
+        activity.X3(X3_sig);
+        activity.Y(Y_sig);
+        activity.F(F_sig);
+        
+        // 监视器已写入默认能量，ENERGY_TABLE指定的能量表文件覆盖其中的条目
+        if (const char* f = std::getenv("ENERGY_TABLE")) power.table().load(f);
+        power.open("mux_power.csv");
+        
+        txn_log.add("X0", X0_sig);
+        txn_log.add("X1", X1_sig);
+        txn_log.add("X2", X2_sig);
+        txn_log.add("X3", X3_sig);
+        txn_log.add("Y", Y_sig);
+        txn_log.add("F", F_sig);
+        txn_log.open_env();
+        
         // 注册进程
         SC_THREAD(test_process);
         
@@ -101,5 +159,5 @@ SC_MODULE(mux_4to1_tb) {
 int sc_main(int argc, char* argv[]) {
     mux_4to1_tb tb("testbench");
     sc_start();
-    return 0;
+    return tb.passed ? 0 : 1;
 }
@@ -0,0 +1,64 @@
+// File: mux_activity.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef MUX_ACTIVITY_H
+#define MUX_ACTIVITY_H
+
+#include <systemc.h>
+#include "../common/power_window.h"
+
+// 选择器开关活动监视器：与mux_4to1接在相同的信号上，任一端口改变时统计各端口的翻转位数
+SC_MODULE(mux_activity) {
+    sc_in<sc_uint<2>> X0;
+    sc_in<sc_uint<2>> X1;
+    sc_in<sc_uint<2>> X2;
+    sc_in<sc_uint<2>> X3;
+    sc_in<sc_uint<2>> Y;
+    sc_in<sc_uint<2>> F;
+
+    pwr::activity& act;
+    pwr::port_probe<sc_uint<2>> x0, x1, x2, x3, y, f;
+
+    SC_HAS_PROCESS(mux_activity);
+
+    void sample() {
+        x0.sample(act);
+        x1.sample(act);
+        x2.sample(act);
+        x3.sample(act);
+        y.sample(act);
+        f.sample(act);
+    }
+
+    mux_activity(sc_module_name name, pwr::power_report& report)
+    : sc_module(name), act(report.add_module("mux_4to1", basename())) {
+        x0.attach(act, X0, "X0");
+        x1.attach(act, X1, "X1");
+        x2.attach(act, X2, "X2");
+        x3.attach(act, X3, "X3");
+        y.attach(act, Y, "Y");
+        f.attach(act, F, "F");
+
+        // 每位翻转的默认能量（pJ），可以在之后用能量表文件覆盖
+        report.table().set("mux_4to1", "*", 0.005);
+        report.table().set("mux_4to1", "F", 0.01);
+
+        SC_METHOD(sample);
+        sensitive << X0 << X1 << X2 << X3 << Y << F;
+    }
+};
+
+#endif // MUX_ACTIVITY_H
@@ -0,0 +1,565 @@
+// File: components.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <systemc.h>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "net_types.h"
+#include "netlist.h"
+#include "object_pool.h"
+#include "../common/stimulus.h"
+#include "../mux_4to1/mux_4to1.h"
+#include "../alu_4bit/alu_4bit.h"
+#include "../register_ram/register_file.h"
+#include "../register_ram/ram.h"
+#include "../fifo_design/fifo.h"
+
+enum class port_dir : uint8_t { in, out };
+
+struct port_desc {
+    const char* name;
+    port_dir dir;
+    net_type type;          // none：任意类型，由连接的网络决定（随机源的输出）
+};
+
+// 一个实例对外的接口
+struct instance_desc {
+    std::vector<port_desc> ports;
+    double clock_period_ns = 0;     // 非0时，out端口连接的网络建成该周期的sc_clock
+};
+
+// 网表中的一个网络
+struct net_info {
+    std::string name;
+    net_type type = net_type::none;
+    int driver = -1;                // 驱动它的实例下标，-1为没有驱动（保持初值）
+    double clock_period_ns = 0;     // 非0为时钟网络
+    void* channel = nullptr;        // 例化后为sc_signal_inout_if<T>*，T由type决定
+};
+
+// ====== 参数 ======
+
+inline const std::string* find_param(const netlist_args& args, const char* key) {
+    for (const auto& a : args) {
+        if (a.first == key) return &a.second;
+    }
+    return nullptr;
+}
+
+// 无符号整数参数，没有给出时为def
+inline bool param_uint(const netlist_args& args, const char* key, unsigned long def,
+                       unsigned long& value, std::string& error) {
+    const std::string* s = find_param(args, key);
+    if (!s) {
+        value = def;
+        return true;
+    }
+    char* end = nullptr;
+    value = std::strtoul(s->c_str(), &end, 0);
+    if (s->empty() || *end != '\0') {
+        error = std::string("参数") + key + "应为整数: " + *s;
+        return false;
+    }
+    return true;
+}
+
+inline bool param_double(const netlist_args& args, const char* key, double def,
+                         double& value, std::string& error) {
+    const std::string* s = find_param(args, key);
+    if (!s) {
+        value = def;
+        return true;
+    }
+    char* end = nullptr;
+    value = std::strtod(s->c_str(), &end);
+    if (s->empty() || *end != '\0') {
+        error = std::string("参数") + key + "应为数值: " + *s;
+        return false;
+    }
+    return true;
+}
+
+// 参数只能取列出的值
+inline bool param_choice(const netlist_args& args, const char* key, unsigned long def,
+                         std::initializer_list<unsigned long> allowed, unsigned long& value, std::string& error) {
+    if (!param_uint(args, key, def, value, error)) return false;
+    for (unsigned long a : allowed) {
+        if (value == a) return true;
+    }
+    error = std::string("参数") + key + "=" + std::to_string(value) + "不支持，可选:";
+    for (unsigned long a : allowed) error += " " + std::to_string(a);
+    return false;
+}
+
+// ====== 例化时的端口绑定 ======
+
+// 例化一个实例时传给component::build的上下文：模块和信号的对象池，以及按端口名绑定网络
+class build_context {
+public:
+    build_context(object_pools& pools, std::vector<net_info>& nets) : pools_(pools), nets_(nets) {}
+
+    void begin(const netlist_instance& inst, const port_desc* ports, const int* port_nets, size_t count) {
+        inst_ = &inst;
+        ports_ = ports;
+        port_nets_ = port_nets;
+        count_ = count;
+    }
+
+    object_pools& pools() { return pools_; }
+    const netlist_instance& instance() const { return *inst_; }
+    const char* name() const { return inst_->name.c_str(); }
+
+    // 端口连接的网络的类型，未连接时为none
+    net_type port_type(const char* port) const {
+        int n = net_of(port);
+        return n < 0 ? net_type::none : nets_[n].type;
+    }
+
+    // 输入端口：未连接时接到该类型共用的常量信号（保持默认值）
+    template<typename T>
+    void bind(sc_in<T>& p, const char* port) {
+        int n = net_of(port);
+        p(n < 0 ? constant<T>() : channel<T>(n));
+    }
+
+    // 输出端口：未连接时接到单独的信号（每个信号只能有一个驱动）
+    template<typename T>
+    void bind(sc_inout<T>& p, const char* port) {
+        int n = net_of(port);
+        if (n < 0) {
+            p(*pools_.make<sc_signal<T>>());
+        } else {
+            p(channel<T>(n));
+        }
+    }
+
+private:
+    object_pools& pools_;
+    std::vector<net_info>& nets_;
+    std::map<net_type, void*> constants_;
+    const netlist_instance* inst_ = nullptr;
+    const port_desc* ports_ = nullptr;
+    const int* port_nets_ = nullptr;
+    size_t count_ = 0;
+
+    int net_of(const char* port) const {
+        for (size_t i = 0; i < count_; i++) {
+            if (std::strcmp(ports_[i].name, port) == 0) return port_nets_[i];
+        }
+        return -1;
+    }
+
+    template<typename T>
+    sc_signal_inout_if<T>& channel(int n) {
+        if (nets_[n].type != net_type_of<T>::value) {
+            SC_REPORT_ERROR("netlist", ("网络" + nets_[n].name + "的类型与" + inst_->name + "的端口不符").c_str());
+        }
+        return *static_cast<sc_signal_inout_if<T>*>(nets_[n].channel);
+    }
+
+    template<typename T>
+    sc_signal_inout_if<T>& constant() {
+        void*& c = constants_[net_type_of<T>::value];
+        if (!c) c = static_cast<sc_signal_inout_if<T>*>(pools_.make<sc_signal<T>>());
+        return *static_cast<sc_signal_inout_if<T>*>(c);
+    }
+};
+
+// ====== 元件 ======
+
+// 网表中的一种实例类型：检查参数、给出端口，以及例化
+class component {
+public:
+    explicit component(std::initializer_list<const char*> params) : params_(params) {}
+    virtual ~component() {}
+
+    // 实例的键是参数名时为参数，否则为端口
+    bool is_param(const std::string& key) const {
+        for (const char* p : params_) {
+            if (key == p) return true;
+        }
+        return false;
+    }
+
+    // 检查参数并给出端口；args中也包含端口连接，按参数名取值即可
+    virtual bool describe(const netlist_args& args, instance_desc& desc, std::string& error) const = 0;
+
+    // 例化并绑定全部端口，参数已经由describe检查过
+    virtual void build(build_context& ctx, const netlist_args& args) const = 0;
+
+private:
+    std::vector<const char*> params_;
+};
+
+// 时钟：period为周期（ns），out连接的网络建成sc_clock，本身不例化模块
+class clock_component : public component {
+public:
+    clock_component() : component({"period"}) {}
+
+    bool describe(const netlist_args& args, instance_desc& desc, std::string& error) const override {
+        double period;
+        if (!param_double(args, "period", 10.0, period, error)) return false;
+        if (period <= 0) {
+            error = "时钟周期必须大于0";
+            return false;
+        }
+        desc.ports = {{"out", port_dir::out, net_type::bit}};
+        desc.clock_period_ns = period;
+        return true;
+    }
+
+    void build(build_context&, const netlist_args&) const override {}
+};
+
+// 低电平有效复位：开始的cycles个时钟周期输出false，之后输出true
+SC_MODULE(reset_gen) {
+    sc_in<bool> clk;
+    sc_out<bool> out;
+
+    SC_HAS_PROCESS(reset_gen);
+
+    void tick() {
+        if (count < cycles && ++count == cycles) out.write(true);
+    }
+
+    reset_gen(sc_module_name name, unsigned int cycles) : sc_module(name), cycles(cycles), count(0) {
+        out.initialize(cycles == 0);
+        SC_METHOD(tick);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+
+private:
+    unsigned int cycles;
+    unsigned int count;
+};
+
+class reset_component : public component {
+public:
+    reset_component() : component({"cycles"}) {}
+
+    bool describe(const netlist_args& args, instance_desc& desc, std::string& error) const override {
+        unsigned long cycles;
+        if (!param_uint(args, "cycles", 2, cycles, error)) return false;
+        desc.ports = {{"clk", port_dir::in, net_type::bit},
+                      {"out", port_dir::out, net_type::bit}};
+        return true;
+    }
+
+    void build(build_context& ctx, const netlist_args& args) const override {
+        unsigned long cycles;
+        std::string error;
+        param_uint(args, "cycles", 2, cycles, error);
+        reset_gen* r = ctx.pools().make<reset_gen>(ctx.name(), unsigned(cycles));
+        ctx.bind(r->clk, "clk");
+        ctx.bind(r->out, "out");
+    }
+};
+
+// 随机源：每个时钟上升沿输出一个随机值，类型由out连接的网络决定。
+// bool以概率p为true，其他类型取随机数的低位。随机流由种子和实例名决定，
+// 同一网表在任何机器上、任何例化顺序下产生相同的激励
+template<typename T>
+struct random_value {
+    static T get(stim::philox_stream& rng, uint64_t) { return T(sc_dt::uint64(rng.next_u64())); }
+};
+
+template<>
+struct random_value<bool> {
+    static bool get(stim::philox_stream& rng, uint64_t thr) { return rng.bernoulli_threshold(thr); }
+};
+
+// 实例名到随机流编号（FNV-1a）
+inline uint64_t random_stream_of(const char* name) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const char* p = name; *p; p++) h = (h ^ uint8_t(*p)) * 0x100000001b3ULL;
+    return stim::STREAM_USER + (h >> 16);
+}
+
+template<typename T>
+SC_MODULE(random_source) {
+    sc_in<bool> clk;
+    sc_out<T> out;
+
+    SC_HAS_PROCESS(random_source);
+
+    void tick() { out.write(random_value<T>::get(rng, thr)); }
+
+    random_source(sc_module_name name, uint64_t seed, double p)
+    : sc_module(name), rng(seed, random_stream_of(name)), thr(stim::philox_stream::threshold(p)) {
+        SC_METHOD(tick);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+
+private:
+    stim::philox_stream rng;
+    uint64_t thr;
+};
+
+class random_component : public component {
+public:
+    random_component() : component({"seed", "p"}) {}
+
+    bool describe(const netlist_args& args, instance_desc& desc, std::string& error) const override {
+        unsigned long seed;
+        double p;
+        if (!param_uint(args, "seed", 1, seed, error) || !param_double(args, "p", 0.5, p, error)) return false;
+        desc.ports = {{"clk", port_dir::in, net_type::bit},
+                      {"out", port_dir::out, net_type::none}};
+        return true;
+    }
+
+    void build(build_context& ctx, const netlist_args& args) const override {
+        net_type t = ctx.port_type("out");
+        if (t != net_type::none) dispatch_net_type<make>(t, ctx, args);
+    }
+
+private:
+    template<typename T>
+    struct make {
+        static void apply(build_context& ctx, const netlist_args& args) {
+            unsigned long seed;
+            double p;
+            std::string error;
+            param_uint(args, "seed", 1, seed, error);
+            param_double(args, "p", 0.5, p, error);
+            random_source<T>* r = ctx.pools().make<random_source<T>>(ctx.name(), seed, p);
+            ctx.bind(r->clk, "clk");
+            ctx.bind(r->out, "out");
+        }
+    };
+};
+
+// fifo<T, DEPTH>：depth取2、4、8、16、32，width（数据位宽）取8、16、32、64
+class fifo_component : public component {
+public:
+    fifo_component() : component({"depth", "width"}) {}
+
+    bool describe(const netlist_args& args, instance_desc& desc, std::string& error) const override {
+        unsigned long depth, width;
+        if (!param_choice(args, "depth", 8, {2, 4, 8, 16, 32}, depth, error) ||
+            !param_choice(args, "width", 32, {8, 16, 32, 64}, width, error)) return false;
+        net_type data = data_type(width);
+        desc.ports = {{"clk", port_dir::in, net_type::bit},
+                      {"rst_n", port_dir::in, net_type::bit},
+                      {"write_en", port_dir::in, net_type::bit},
+                      {"data_in", port_dir::in, data},
+                      {"read_en", port_dir::in, net_type::bit},
+                      {"data_out", port_dir::out, data},
+                      {"full", port_dir::out, net_type::bit},
+                      {"empty", port_dir::out, net_type::bit},
+                      {"size", port_dir::out, net_type::word}};
+        return true;
+    }
+
+    void build(build_context& ctx, const netlist_args& args) const override {
+        unsigned long depth, width;
+        std::string error;
+        param_uint(args, "depth", 8, depth, error);
+        param_uint(args, "width", 32, width, error);
+        dispatch_net_type<by_depth>(data_type(width), ctx, unsigned(depth));
+    }
+
+private:
+    static net_type data_type(unsigned long width) {
+        switch (width) {
+            case 8:  return net_type::byte;
+            case 16: return net_type::half;
+            case 64: return net_type::dword;
+            default: return net_type::word;
+        }
+    }
+
+    template<typename T>
+    struct by_depth {
+        static void apply(build_context& ctx, unsigned int depth) {
+            switch (depth) {
+                case 2:  make<T, 2>(ctx); break;
+                case 4:  make<T, 4>(ctx); break;
+                case 16: make<T, 16>(ctx); break;
+                case 32: make<T, 32>(ctx); break;
+                default: make<T, 8>(ctx); break;
+            }
+        }
+    };
+
+    template<typename T, unsigned int DEPTH>
+    static void make(build_context& ctx) {
+        fifo<T, DEPTH>* f = ctx.pools().make<fifo<T, DEPTH>>(ctx.name());
+        f->debug_print = false;
+        ctx.bind(f->clk, "clk");
+        ctx.bind(f->rst_n, "rst_n");
+        ctx.bind(f->write_en, "write_en");
+        ctx.bind(f->data_in, "data_in");
+        ctx.bind(f->read_en, "read_en");
+        ctx.bind(f->data_out, "data_out");
+        ctx.bind(f->full, "full");
+        ctx.bind(f->empty, "empty");
+        ctx.bind(f->size, "size");
+    }
+};
+
+// 以下几种模型的位宽和容量在代码中是固定的（4位地址、4位ALU、4选1），
+// 参数只接受这些值，便于网表写明规格，也在以后模型参数化时保持网表格式不变
+
+// ram：16个8位存储单元，init可给出ram::initialize格式的初始化文件
+class ram_component : public component {
+public:
+    ram_component() : component({"size", "init"}) {}
+
+    bool describe(const netlist_args& args, instance_desc& desc, std::string& error) const override {
+        unsigned long size;
+        if (!param_choice(args, "size", 16, {16}, size, error)) return false;
+        desc.ports = {{"clk", port_dir::in, net_type::bit},
+                      {"addr", port_dir::in, net_type::u4},
+                      {"wr_data", port_dir::in, net_type::u8},
+                      {"wr_en", port_dir::in, net_type::bit},
+                      {"rd_data", port_dir::out, net_type::u8}};
+        return true;
+    }
+
+    void build(build_context& ctx, const netlist_args& args) const override {
+        ram* m = ctx.pools().make<ram>(ctx.name());
+        if (const std::string* init = find_param(args, "init")) m->initialize(*init);
+        ctx.bind(m->clk, "clk");
+        ctx.bind(m->addr, "addr");
+        ctx.bind(m->wr_data, "wr_data");
+        ctx.bind(m->wr_en, "wr_en");
+        ctx.bind(m->rd_data, "rd_data");
+    }
+};
+
+// register_file：16个8位寄存器
+class register_file_component : public component {
+public:
+    register_file_component() : component({"size"}) {}
+
+    bool describe(const netlist_args& args, instance_desc& desc, std::string& error) const override {
+        unsigned long size;
+        if (!param_choice(args, "size", 16, {16}, size, error)) return false;
+        desc.ports = {{"clk", port_dir::in, net_type::bit},
+                      {"rd_addr", port_dir::in, net_type::u4},
+                      {"wr_addr", port_dir::in, net_type::u4},
+                      {"wr_data", port_dir::in, net_type::u8},
+                      {"wr_en", port_dir::in, net_type::bit},
+                      {"rd_data", port_dir::out, net_type::u8}};
+        return true;
+    }
+
+    void build(build_context& ctx, const netlist_args&) const override {
+        register_file* r = ctx.pools().make<register_file>(ctx.name());
+        ctx.bind(r->clk, "clk");
+        ctx.bind(r->rd_addr, "rd_addr");
+        ctx.bind(r->wr_addr, "wr_addr");
+        ctx.bind(r->wr_data, "wr_data");
+        ctx.bind(r->wr_en, "wr_en");
+        ctx.bind(r->rd_data, "rd_data");
+    }
+};
+
+// alu：4位带符号补码ALU
+class alu_component : public component {
+public:
+    alu_component() : component({"width"}) {}
+
+    bool describe(const netlist_args& args, instance_desc& desc, std::string& error) const override {
+        unsigned long width;
+        if (!param_choice(args, "width", 4, {4}, width, error)) return false;
+        desc.ports = {{"A", port_dir::in, net_type::s4},
+                      {"B", port_dir::in, net_type::s4},
+                      {"op", port_dir::in, net_type::u3},
+                      {"result", port_dir::out, net_type::s4},
+                      {"zero", port_dir::out, net_type::bit},
+                      {"overflow", port_dir::out, net_type::bit},
+                      {"carry", port_dir::out, net_type::bit}};
+        return true;
+    }
+
+    void build(build_context& ctx, const netlist_args&) const override {
+        alu_4bit* a = ctx.pools().make<alu_4bit>(ctx.name());
+        ctx.bind(a->A, "A");
+        ctx.bind(a->B, "B");
+        ctx.bind(a->op, "op");
+        ctx.bind(a->result, "result");
+        ctx.bind(a->zero, "zero");
+        ctx.bind(a->overflow, "overflow");
+        ctx.bind(a->carry, "carry");
+    }
+};
+
+// mux：2位4选1选择器
+class mux_component : public component {
+public:
+    mux_component() : component({"fanin", "width"}) {}
+
+    bool describe(const netlist_args& args, instance_desc& desc, std::string& error) const override {
+        unsigned long fanin, width;
+        if (!param_choice(args, "fanin", 4, {4}, fanin, error) ||
+            !param_choice(args, "width", 2, {2}, width, error)) return false;
+        desc.ports = {{"X0", port_dir::in, net_type::u2},
+                      {"X1", port_dir::in, net_type::u2},
+                      {"X2", port_dir::in, net_type::u2},
+                      {"X3", port_dir::in, net_type::u2},
+                      {"Y", port_dir::in, net_type::u2},
+                      {"F", port_dir::out, net_type::u2}};
+        return true;
+    }
+
+    void build(build_context& ctx, const netlist_args&) const override {
+        mux_4to1* m = ctx.pools().make<mux_4to1>(ctx.name());
+        ctx.bind(m->X0, "X0");
+        ctx.bind(m->X1, "X1");
+        ctx.bind(m->X2, "X2");
+        ctx.bind(m->X3, "X3");
+        ctx.bind(m->Y, "Y");
+        ctx.bind(m->F, "F");
+    }
+};
+
+// 类型名到元件；可以用add()注册自己的元件
+class component_registry {
+public:
+    component_registry() {
+        add("clock", std::unique_ptr<component>(new clock_component));
+        add("reset", std::unique_ptr<component>(new reset_component));
+        add("random", std::unique_ptr<component>(new random_component));
+        add("fifo", std::unique_ptr<component>(new fifo_component));
+        add("ram", std::unique_ptr<component>(new ram_component));
+        add("register_file", std::unique_ptr<component>(new register_file_component));
+        add("alu", std::unique_ptr<component>(new alu_component));
+        add("mux", std::unique_ptr<component>(new mux_component));
+    }
+
+    void add(const std::string& type, std::unique_ptr<component> c) { components_[type] = std::move(c); }
+
+    const component* find(const std::string& type) const {
+        auto it = components_.find(type);
+        return it == components_.end() ? nullptr : it->second.get();
+    }
+
+private:
+    std::map<std::string, std::unique_ptr<component>> components_;
+};
+
+#endif // COMPONENTS_H
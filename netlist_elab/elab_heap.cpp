@@ -0,0 +1,123 @@
+// File: elab_heap.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "elab_heap.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "../common/arena.h"
+
+// 这里的状态都是常量初始化的，在任何静态构造函数调用operator new之前就可用。
+// arena第一次进入scope时在静态存储上构造，之后不再析构（进程结束前可能还有delete指向它）。
+// 只有打开了scope的线程从arena分配（depth是线程局部的），其他线程（能量报告的写日志线程、
+// 标准库的工作线程）照常使用普通堆；几个线程同时打开scope时，arena的切分由lock串行化
+namespace {
+
+alignas(arena) unsigned char heap_storage[sizeof(arena)];
+std::atomic<arena*> heap{nullptr};
+std::atomic_flag lock = ATOMIC_FLAG_INIT;
+thread_local int depth = 0;
+std::atomic<size_t> ignored_frees{0};
+
+struct spin_guard {
+    spin_guard() { while (lock.test_and_set(std::memory_order_acquire)) {} }
+    ~spin_guard() { lock.clear(std::memory_order_release); }
+};
+
+void* allocate(std::size_t n) {
+    if (n == 0) n = 1;
+    if (depth > 0) {
+        spin_guard g;
+        if (void* p = heap.load(std::memory_order_relaxed)->allocate(n)) return p;
+    }
+    for (;;) {
+        if (void* p = std::malloc(n)) return p;
+        std::new_handler h = std::get_new_handler();
+        if (!h) return nullptr;
+        h();
+    }
+}
+
+void release(void* p) {
+    if (!p) return;
+    arena* a = heap.load(std::memory_order_acquire);
+    if (a && a->owns(p)) {
+        ignored_frees.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::free(p);
+}
+
+} // namespace
+
+namespace elab_heap {
+
+scope::scope(bool enable) : enabled_(enable && available) {
+    if (!enabled_) return;
+    arena* a;
+    {
+        spin_guard g;
+        a = heap.load(std::memory_order_relaxed);
+        if (!a) {
+            a = new (heap_storage) arena;
+            heap.store(a, std::memory_order_release);
+        }
+    }
+    if (a->valid()) {
+        depth++;
+    } else {
+        enabled_ = false;
+    }
+}
+
+scope::~scope() {
+    if (enabled_) depth--;
+}
+
+bool active() { return depth > 0; }
+
+stats current() {
+    stats s = {0, 0, ignored_frees.load(std::memory_order_relaxed)};
+    spin_guard g;
+    if (arena* a = heap.load(std::memory_order_relaxed)) {
+        s.allocations = a->allocations();
+        s.bytes = a->used();
+    }
+    return s;
+}
+
+} // namespace elab_heap
+
+// 替换全局operator new/delete（带对齐参数的版本不替换，仍由标准库从普通堆分配）
+void* operator new(std::size_t n) {
+    if (void* p = allocate(n)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n) {
+    if (void* p = allocate(n)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return allocate(n); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return allocate(n); }
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
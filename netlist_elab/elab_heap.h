@@ -0,0 +1,93 @@
+// File: elab_heap.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ELAB_HEAP_H
+#define ELAB_HEAP_H
+
+#include <cstddef>
+#include <cstdio>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// 例化期间的全局内存分配
+//
+// 例化一个实例时，除了模块本身（由object_pools分配），SystemC内核还要为每个端口、
+// 信号、层次名、进程句柄、敏感表和对象表项做许多次小的堆分配。elab_heap::scope存在期间，
+// 当前线程的全局operator new改为从进程内共享的一个arena（见common/arena.h）顺序切分：
+// 十万个实例的这些对象落在一段连续的内存中，没有逐个malloc的开销和头部。
+//
+// 例化出的对象与仿真同生命期（SystemC每个进程只能例化一次），arena的内存直到进程结束
+// 都不归还：对arena中内存的delete什么也不做（只计数），scope结束后的分配回到普通堆。
+// 全局operator new的替换在elab_heap.cpp中，使用本头文件的程序需要链接它。
+//
+// scope只影响打开它的线程，可以在多个线程中同时使用。ASan（make asan）只检查经过malloc
+// 的内存，arena中的越界访问发现不了，所以ASan构建中available为false，scope不起作用
+namespace elab_heap {
+
+#if defined(__SANITIZE_ADDRESS__)
+constexpr bool available = false;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+constexpr bool available = false;
+#else
+constexpr bool available = true;
+#endif
+#else
+constexpr bool available = true;
+#endif
+
+struct stats {
+    size_t allocations;     // 从arena分配的次数
+    size_t bytes;           // 从arena分配的字节数（含对齐）
+    size_t ignored_frees;   // 对arena中内存的delete次数（内存不回收）
+};
+
+// 可以嵌套；enable为false（或available为false）时不起作用，便于对比
+class scope {
+public:
+    explicit scope(bool enable = true);
+    ~scope();
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+private:
+    bool enabled_;
+};
+
+bool active();
+stats current();
+
+// 进程当前的驻留内存（KiB），读/proc/self/statm
+inline long rss_kb() {
+    long pages = 0, resident = 0;
+    FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (std::fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    std::fclose(f);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// 进程驻留内存的峰值（KiB）
+inline long peak_rss_kb() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+} // namespace elab_heap
+
+#endif // ELAB_HEAP_H
@@ -0,0 +1,245 @@
+// File: elaborator.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ELABORATOR_H
+#define ELABORATOR_H
+
+#include <systemc.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "components.h"
+#include "elab_heap.h"
+
+class netlist_design;
+
+// 例化出的层次的顶层模块，全部网络和实例都是它的子对象（如design.f0、design.q0）
+SC_MODULE(netlist_top) {
+    netlist_top(sc_module_name name, netlist_design& design);
+};
+
+// 按网表在运行时例化设计，分两步：
+//   resolve：  查找元件、检查参数，确定每个网络的类型和驱动，有错误时不创建任何SystemC对象
+//   construct：在顶层模块的构造函数中创建全部网络（sc_signal/sc_clock）和实例并绑定端口
+// 模块和信号都从object_pools分配，同类对象连续存放；析构时按创建的逆序释放。
+// 默认在elab_heap::scope中例化，SystemC内核为端口、名字、进程等做的小分配也来自同一段arena
+class netlist_design {
+public:
+    explicit netlist_design(const component_registry& registry) : registry_(registry) {}
+
+    // 是否在elab_heap的arena中例化（默认是，ASan构建中总是否），在elaborate之前设置
+    void set_arena(bool on) { use_arena_ = on && elab_heap::available; }
+
+    bool elaborate(const netlist& nl, const char* top = "design") {
+        elab_heap::stats h0 = elab_heap::current();
+        elab_heap::scope heap(use_arena_);
+        auto t0 = std::chrono::steady_clock::now();
+        if (!resolve(nl)) return false;
+        auto t1 = std::chrono::steady_clock::now();
+        netlist_ = &nl;
+        pools_.make<netlist_top>(top, *this);
+        netlist_ = nullptr;
+        auto t2 = std::chrono::steady_clock::now();
+        resolve_seconds_ = std::chrono::duration<double>(t1 - t0).count();
+        construct_seconds_ = std::chrono::duration<double>(t2 - t1).count();
+        elab_heap::stats h1 = elab_heap::current();
+        arena_allocations_ = h1.allocations - h0.allocations;
+        arena_bytes_ = h1.bytes - h0.bytes;
+        return true;
+    }
+
+    const std::string& last_error() const { return error_; }
+
+    size_t instances() const { return inst_.size(); }
+    const std::vector<net_info>& nets() const { return nets_; }
+    const object_pools& pools() const { return pools_; }
+    double resolve_seconds() const { return resolve_seconds_; }
+    double construct_seconds() const { return construct_seconds_; }
+    size_t arena_allocations() const { return arena_allocations_; }
+    size_t arena_bytes() const { return arena_bytes_; }
+
+    int find_net(const std::string& name) const {
+        auto it = net_index_.find(name);
+        return it == net_index_.end() ? -1 : it->second;
+    }
+
+    // 网络当前的值（按位宽截断的无符号数）
+    uint64_t value(int net) const {
+        return dispatch_net_type<read_bits>(nets_[net].type, nets_[net].channel);
+    }
+
+    // 全部网络按名字排序的当前值
+    std::map<std::string, uint64_t> values() const {
+        std::map<std::string, uint64_t> v;
+        for (size_t n = 0; n < nets_.size(); n++) v[nets_[n].name] = value(int(n));
+        return v;
+    }
+
+private:
+    friend struct netlist_top;
+
+    // 一个实例解析后的结果；端口和连接的网络存放在ports_/port_nets_的[first, first+count)中
+    struct resolved_instance {
+        const component* comp;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    const component_registry& registry_;
+    const netlist* netlist_ = nullptr;
+    object_pools pools_;
+    std::vector<net_info> nets_;
+    std::unordered_map<std::string, int> net_index_;
+    std::vector<resolved_instance> inst_;
+    std::vector<port_desc> ports_;
+    std::vector<int> port_nets_;
+    std::string error_;
+    double resolve_seconds_ = 0;
+    double construct_seconds_ = 0;
+    bool use_arena_ = elab_heap::available;
+    size_t arena_allocations_ = 0;
+    size_t arena_bytes_ = 0;
+
+    bool fail(const netlist& nl, const netlist_instance& inst, const std::string& msg) {
+        error_ = nl.source() + ":" + std::to_string(inst.line) + ": " + inst.name + ": " + msg;
+        return false;
+    }
+
+    bool resolve(const netlist& nl) {
+        nets_.clear();
+        net_index_.clear();
+        inst_.clear();
+        ports_.clear();
+        port_nets_.clear();
+        inst_.reserve(nl.instances().size());
+
+        instance_desc desc;
+        std::string msg;
+        for (size_t i = 0; i < nl.instances().size(); i++) {
+            const netlist_instance& inst = nl.instances()[i];
+            const component* comp = registry_.find(inst.type);
+            if (!comp) return fail(nl, inst, "未知的类型 " + inst.type);
+            desc.ports.clear();
+            desc.clock_period_ns = 0;
+            if (!comp->describe(inst.args, desc, msg)) return fail(nl, inst, msg);
+
+            resolved_instance r = {comp, uint32_t(ports_.size()), uint32_t(desc.ports.size())};
+            ports_.insert(ports_.end(), desc.ports.begin(), desc.ports.end());
+            port_nets_.insert(port_nets_.end(), desc.ports.size(), -1);
+
+            for (const auto& a : inst.args) {
+                if (comp->is_param(a.first)) continue;
+                uint32_t k = 0;
+                while (k < r.count && a.first != ports_[r.first + k].name) k++;
+                if (k == r.count) return fail(nl, inst, inst.type + "没有端口或参数 " + a.first);
+                if (!netlist::valid_name(a.second)) return fail(nl, inst, "非法的网络名: " + a.second);
+
+                const port_desc& p = ports_[r.first + k];
+                int n = net(a.second);
+                net_info& ni = nets_[n];
+                port_nets_[r.first + k] = n;
+                if (p.type != net_type::none) {
+                    if (ni.type == net_type::none) {
+                        ni.type = p.type;
+                    } else if (ni.type != p.type) {
+                        return fail(nl, inst, std::string("端口") + p.name + "是" + net_type_name(p.type) +
+                                    "，网络" + ni.name + "已经是" + net_type_name(ni.type));
+                    }
+                }
+                if (p.dir == port_dir::out) {
+                    if (ni.driver >= 0) {
+                        return fail(nl, inst, "网络" + ni.name + "已经由" +
+                                    nl.instances()[ni.driver].name + "驱动");
+                    }
+                    ni.driver = int(i);
+                    ni.clock_period_ns = desc.clock_period_ns;
+                }
+            }
+            inst_.push_back(r);
+        }
+
+        // 网络和实例都是顶层模块的子对象，SystemC中同级对象不能重名
+        for (const netlist_instance& inst : nl.instances()) {
+            if (net_index_.count(inst.name)) return fail(nl, inst, "实例名与网络名相同");
+        }
+        for (const net_info& ni : nets_) {
+            if (ni.type == net_type::none) {
+                error_ = nl.source() + ": 网络" + ni.name + "只连接了任意类型的端口，无法确定类型";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int net(const std::string& name) {
+        auto it = net_index_.emplace(name, int(nets_.size()));
+        if (it.second) {
+            nets_.emplace_back();
+            nets_.back().name = name;
+        }
+        return it.first->second;
+    }
+
+    // 在netlist_top的构造函数中调用
+    void construct() {
+        for (net_info& ni : nets_) {
+            if (ni.clock_period_ns > 0) {
+                sc_clock* c = pools_.make<sc_clock>(ni.name.c_str(), sc_time(ni.clock_period_ns, SC_NS));
+                ni.channel = static_cast<sc_signal_inout_if<bool>*>(c);
+            } else {
+                ni.channel = dispatch_net_type<make_signal>(ni.type, pools_, ni.name.c_str());
+            }
+        }
+        build_context ctx(pools_, nets_);
+        for (size_t i = 0; i < inst_.size(); i++) {
+            const netlist_instance& inst = netlist_->instances()[i];
+            ctx.begin(inst, &ports_[inst_[i].first], &port_nets_[inst_[i].first], inst_[i].count);
+            inst_[i].comp->build(ctx, inst.args);
+        }
+    }
+
+    template<typename T>
+    struct make_signal {
+        static void* apply(object_pools& pools, const char* name) {
+            return static_cast<sc_signal_inout_if<T>*>(pools.make<sc_signal<T>>(name));
+        }
+    };
+
+    template<typename T>
+    struct read_bits {
+        static uint64_t apply(void* channel) {
+            return net_value_bits(static_cast<sc_signal_inout_if<T>*>(channel)->read());
+        }
+    };
+};
+
+// 按名字顺序对网络的值做校验和，用于比较两次运行（或与手写的等价设计）的结果
+inline uint64_t net_checksum(const std::map<std::string, uint64_t>& values) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const auto& v : values) {
+        for (char c : v.first) h = (h ^ uint8_t(c)) * 0x100000001b3ULL;
+        h = (h ^ v.second) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+inline netlist_top::netlist_top(sc_module_name name, netlist_design& design) : sc_module(name) {
+    design.construct();
+}
+
+#endif // ELABORATOR_H
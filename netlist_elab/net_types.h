@@ -0,0 +1,96 @@
+// File: net_types.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NET_TYPES_H
+#define NET_TYPES_H
+
+#include <systemc.h>
+#include <cstdint>
+#include <utility>
+
+// 网表中网络（信号）的值类型。模型端口的类型是固定的，网络的类型由连接到它的端口决定
+enum class net_type : uint8_t {
+    none,       // 尚未确定：只连接了随机源这类任意类型的端口
+    bit,        // bool
+    u2,         // sc_uint<2>
+    u3,         // sc_uint<3>
+    u4,         // sc_uint<4>
+    u8,         // sc_uint<8>
+    s4,         // sc_int<4>
+    byte,       // uint8_t，8位宽fifo的数据
+    half,       // uint16_t，16位宽fifo的数据
+    word,       // unsigned int，32位宽fifo的数据和fifo的size
+    dword       // uint64_t，64位宽fifo的数据
+};
+
+inline const char* net_type_name(net_type t) {
+    switch (t) {
+        case net_type::bit:   return "bool";
+        case net_type::u2:    return "sc_uint<2>";
+        case net_type::u3:    return "sc_uint<3>";
+        case net_type::u4:    return "sc_uint<4>";
+        case net_type::u8:    return "sc_uint<8>";
+        case net_type::s4:    return "sc_int<4>";
+        case net_type::byte:  return "uint8_t";
+        case net_type::half:  return "uint16_t";
+        case net_type::word:  return "unsigned int";
+        case net_type::dword: return "uint64_t";
+        default:              return "未定";
+    }
+}
+
+// C++类型到net_type
+template<typename T> struct net_type_of;
+template<> struct net_type_of<bool>         { static constexpr net_type value = net_type::bit; };
+template<> struct net_type_of<sc_uint<2>>   { static constexpr net_type value = net_type::u2; };
+template<> struct net_type_of<sc_uint<3>>   { static constexpr net_type value = net_type::u3; };
+template<> struct net_type_of<sc_uint<4>>   { static constexpr net_type value = net_type::u4; };
+template<> struct net_type_of<sc_uint<8>>   { static constexpr net_type value = net_type::u8; };
+template<> struct net_type_of<sc_int<4>>    { static constexpr net_type value = net_type::s4; };
+template<> struct net_type_of<uint8_t>      { static constexpr net_type value = net_type::byte; };
+template<> struct net_type_of<uint16_t>     { static constexpr net_type value = net_type::half; };
+template<> struct net_type_of<unsigned int> { static constexpr net_type value = net_type::word; };
+template<> struct net_type_of<uint64_t>     { static constexpr net_type value = net_type::dword; };
+
+// 按运行时的类型调用F<T>::apply(args...)，t不能是none
+template<template<typename> class F, typename... Args>
+auto dispatch_net_type(net_type t, Args&&... args) -> decltype(F<bool>::apply(std::forward<Args>(args)...)) {
+    switch (t) {
+        case net_type::u2:    return F<sc_uint<2>>::apply(std::forward<Args>(args)...);
+        case net_type::u3:    return F<sc_uint<3>>::apply(std::forward<Args>(args)...);
+        case net_type::u4:    return F<sc_uint<4>>::apply(std::forward<Args>(args)...);
+        case net_type::u8:    return F<sc_uint<8>>::apply(std::forward<Args>(args)...);
+        case net_type::s4:    return F<sc_int<4>>::apply(std::forward<Args>(args)...);
+        case net_type::byte:  return F<uint8_t>::apply(std::forward<Args>(args)...);
+        case net_type::half:  return F<uint16_t>::apply(std::forward<Args>(args)...);
+        case net_type::word:  return F<unsigned int>::apply(std::forward<Args>(args)...);
+        case net_type::dword: return F<uint64_t>::apply(std::forward<Args>(args)...);
+        default:              return F<bool>::apply(std::forward<Args>(args)...);
+    }
+}
+
+// 网络的值折算成64位整数，用于比较和校验和；带符号数按位宽截断
+inline uint64_t net_value_bits(bool v) { return v; }
+inline uint64_t net_value_bits(uint8_t v) { return v; }
+inline uint64_t net_value_bits(uint16_t v) { return v; }
+inline uint64_t net_value_bits(unsigned int v) { return v; }
+inline uint64_t net_value_bits(uint64_t v) { return v; }
+template<int W> uint64_t net_value_bits(const sc_uint<W>& v) { return v.to_uint64(); }
+template<int W> uint64_t net_value_bits(const sc_int<W>& v) {
+    return uint64_t(v.to_int64()) & ((uint64_t(1) << W) - 1);
+}
+
+#endif // NET_TYPES_H
@@ -0,0 +1,151 @@
+// File: netlist.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NETLIST_H
+#define NETLIST_H
+
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// 文本网表：每行一个实例
+//
+//   类型 实例名 键=值 键=值 ...
+//
+// 键是该类型的参数名时为参数（如fifo的depth），否则是端口名，值为连接的网络名。
+// 网络不需要声明，同名的端口连在一起；#到行尾是注释，空行忽略。例如
+//
+//   clock  clk   period=10 out=clk
+//   fifo   f0    depth=8 width=32 clk=clk rst_n=rst_n write_en=we data_in=d0 data_out=q0
+//
+// 这里只做词法和名字的检查，端口、参数和网络类型的检查见elaborator.h
+
+typedef std::vector<std::pair<std::string, std::string>> netlist_args;
+
+struct netlist_instance {
+    std::string type;
+    std::string name;
+    netlist_args args;      // 按出现顺序
+    unsigned int line;      // 在源文件中的行号，用于报错
+};
+
+class netlist {
+public:
+    bool load(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            error_ = "无法打开网表文件: " + path;
+            return false;
+        }
+        return parse(in, path);
+    }
+
+    bool parse(std::istream& in, const std::string& source = "<输入>") {
+        source_ = source;
+        std::string line;
+        unsigned int line_no = 0;
+        std::vector<std::string> tokens;
+        while (std::getline(in, line)) {
+            line_no++;
+            size_t hash = line.find('#');
+            if (hash != std::string::npos) line.resize(hash);
+            split(line, tokens);
+            if (tokens.empty()) continue;
+            if (tokens.size() < 2) return fail(line_no, "缺少实例名");
+
+            netlist_instance inst;
+            inst.type = tokens[0];
+            inst.name = tokens[1];
+            inst.line = line_no;
+            if (!valid_name(inst.type)) return fail(line_no, "非法的类型名: " + inst.type);
+            if (!valid_name(inst.name)) return fail(line_no, "非法的实例名: " + inst.name);
+            if (!names_.insert(inst.name).second) return fail(line_no, "实例名重复: " + inst.name);
+
+            inst.args.reserve(tokens.size() - 2);
+            for (size_t i = 2; i < tokens.size(); i++) {
+                const std::string& t = tokens[i];
+                size_t eq = t.find('=');
+                if (eq == std::string::npos || eq == 0 || eq + 1 == t.size()) {
+                    return fail(line_no, "应为 键=值: " + t);
+                }
+                std::string key = t.substr(0, eq);
+                for (const auto& a : inst.args) {
+                    if (a.first == key) return fail(line_no, inst.name + " 的 " + key + " 重复");
+                }
+                inst.args.emplace_back(std::move(key), t.substr(eq + 1));
+            }
+            instances_.push_back(std::move(inst));
+        }
+        return true;
+    }
+
+    // 在程序里构造网表（基准的生成器使用）；行号记为实例序号
+    void add(const std::string& type, const std::string& name, netlist_args args) {
+        instances_.push_back(netlist_instance{type, name, std::move(args), unsigned(instances_.size() + 1)});
+        names_.insert(name);
+    }
+
+    void write(std::ostream& os) const {
+        for (const netlist_instance& inst : instances_) {
+            os << inst.type << " " << inst.name;
+            for (const auto& a : inst.args) os << " " << a.first << "=" << a.second;
+            os << "\n";
+        }
+    }
+
+    const std::vector<netlist_instance>& instances() const { return instances_; }
+    const std::string& source() const { return source_; }
+    const std::string& last_error() const { return error_; }
+
+    // 网络名和实例名：字母或下划线开头，其后为字母、数字、下划线
+    static bool valid_name(const std::string& s) {
+        if (s.empty() || !(isalpha_(s[0]) || s[0] == '_')) return false;
+        for (char c : s) {
+            if (!(isalpha_(c) || (c >= '0' && c <= '9') || c == '_')) return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<netlist_instance> instances_;
+    std::unordered_set<std::string> names_;
+    std::string source_;
+    std::string error_;
+
+    static bool isalpha_(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+    static void split(const std::string& line, std::vector<std::string>& tokens) {
+        tokens.clear();
+        size_t i = 0, n = line.size();
+        while (i < n) {
+            while (i < n && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) i++;
+            size_t start = i;
+            while (i < n && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') i++;
+            if (i > start) tokens.emplace_back(line, start, i - start);
+        }
+    }
+
+    bool fail(unsigned int line, const std::string& msg) {
+        error_ = source_ + ":" + std::to_string(line) + ": " + msg;
+        return false;
+    }
+};
+
+#endif // NETLIST_H
@@ -0,0 +1,479 @@
+// File: netlist_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "elaborator.h"
+#include "../common/child_process.h"
+
+// ====== 基准设计 ======
+// 全局的时钟、复位和17个激励源，加上cells个单元。每个单元5个实例：
+//   fifo<i>：32位、深度8，数据来自上一个单元的fifo（fifo0来自随机源），形成一条fifo链
+//   ram<i>、rf<i>：ram的读数据写入寄存器堆
+//   alu<i>、mux<i>：共用全局的随机操作数
+static const unsigned int STIM_INSTANCES = 17;
+
+static unsigned int cells_for(unsigned int instances) {
+    return instances > STIM_INSTANCES + 5 ? (instances - STIM_INSTANCES) / 5 : 1;
+}
+
+static netlist make_cells(unsigned int cells) {
+    netlist nl;
+    nl.add("clock", "clkgen", {{"period", "10"}, {"out", "clk"}});
+    nl.add("reset", "rstgen", {{"cycles", "2"}, {"clk", "clk"}, {"out", "rst_n"}});
+    const char* sources[] = {"we", "re", "wen", "din", "a", "b", "op", "x0", "x1", "x2", "x3", "sel",
+                             "addr", "waddr", "wdata"};
+    for (const char* s : sources) {
+        netlist_args args = {{"clk", "clk"}, {"out", s}};
+        if (std::string(s) == "wen") args.push_back({"p", "0.3"});
+        nl.add("random", std::string("src_") + s, args);
+    }
+    for (unsigned int i = 0; i < cells; i++) {
+        std::string n = std::to_string(i);
+        std::string prev = i ? "q" + std::to_string(i - 1) : "din";
+        nl.add("fifo", "fifo" + n, {{"depth", "8"}, {"width", "32"}, {"clk", "clk"}, {"rst_n", "rst_n"},
+                                    {"write_en", "we"}, {"data_in", prev}, {"read_en", "re"}, {"data_out", "q" + n}});
+        nl.add("ram", "ram" + n, {{"clk", "clk"}, {"addr", "addr"}, {"wr_data", "wdata"}, {"wr_en", "wen"},
+                                  {"rd_data", "rd" + n}});
+        nl.add("register_file", "rf" + n, {{"clk", "clk"}, {"rd_addr", "addr"}, {"wr_addr", "waddr"},
+                                           {"wr_data", "rd" + n}, {"wr_en", "wen"}, {"rd_data", "rfd" + n}});
+        nl.add("alu", "alu" + n, {{"A", "a"}, {"B", "b"}, {"op", "op"}, {"result", "res" + n}, {"zero", "z" + n}});
+        nl.add("mux", "mux" + n, {{"X0", "x0"}, {"X1", "x1"}, {"X2", "x2"}, {"X3", "x3"}, {"Y", "sel"},
+                                  {"F", "mo" + n}});
+    }
+    return nl;
+}
+
+// 与make_cells相同的设计，按测试平台的惯常写法在C++中直接例化（逐个new），
+// 用于对比例化时间，并检查网表例化的行为与之完全一致
+SC_MODULE(direct_cells) {
+    sc_clock clk;
+    sc_signal<bool> rst_n, we, re, wen;
+    sc_signal<unsigned int> din;
+    sc_signal<sc_int<4>> a, b;
+    sc_signal<sc_uint<3>> op;
+    sc_signal<sc_uint<2>> x0, x1, x2, x3, sel;
+    sc_signal<sc_uint<4>> addr, waddr;
+    sc_signal<sc_uint<8>> wdata;
+
+    reset_gen rstgen;
+    random_source<bool> src_we, src_re, src_wen;
+    random_source<unsigned int> src_din;
+    random_source<sc_int<4>> src_a, src_b;
+    random_source<sc_uint<3>> src_op;
+    random_source<sc_uint<2>> src_x0, src_x1, src_x2, src_x3, src_sel;
+    random_source<sc_uint<4>> src_addr, src_waddr;
+    random_source<sc_uint<8>> src_wdata;
+
+    struct cell {
+        fifo<unsigned int, 8>* f;
+        ram* m;
+        register_file* r;
+        alu_4bit* u;
+        mux_4to1* x;
+        sc_signal<unsigned int>* q;
+        sc_signal<sc_uint<8>>* rd;
+        sc_signal<sc_uint<8>>* rfd;
+        sc_signal<sc_int<4>>* res;
+        sc_signal<bool>* z;
+        sc_signal<sc_uint<2>>* mo;
+        sc_signal<bool>* full;          // 网表中没有连接的输出
+        sc_signal<bool>* empty;
+        sc_signal<unsigned int>* size;
+        sc_signal<bool>* overflow;
+        sc_signal<bool>* carry;
+    };
+    std::vector<cell> cells;
+
+    direct_cells(sc_module_name name, unsigned int n)
+    : sc_module(name), clk("clk", 10, SC_NS), rst_n("rst_n"), we("we"), re("re"), wen("wen"), din("din"),
+      a("a"), b("b"), op("op"), x0("x0"), x1("x1"), x2("x2"), x3("x3"), sel("sel"),
+      addr("addr"), waddr("waddr"), wdata("wdata"),
+      rstgen("rstgen", 2),
+      src_we("src_we", 1, 0.5), src_re("src_re", 1, 0.5), src_wen("src_wen", 1, 0.3), src_din("src_din", 1, 0.5),
+      src_a("src_a", 1, 0.5), src_b("src_b", 1, 0.5), src_op("src_op", 1, 0.5),
+      src_x0("src_x0", 1, 0.5), src_x1("src_x1", 1, 0.5), src_x2("src_x2", 1, 0.5), src_x3("src_x3", 1, 0.5),
+      src_sel("src_sel", 1, 0.5), src_addr("src_addr", 1, 0.5), src_waddr("src_waddr", 1, 0.5),
+      src_wdata("src_wdata", 1, 0.5) {
+        rstgen.clk(clk);
+        rstgen.out(rst_n);
+        bind_source(src_we, we);
+        bind_source(src_re, re);
+        bind_source(src_wen, wen);
+        bind_source(src_din, din);
+        bind_source(src_a, a);
+        bind_source(src_b, b);
+        bind_source(src_op, op);
+        bind_source(src_x0, x0);
+        bind_source(src_x1, x1);
+        bind_source(src_x2, x2);
+        bind_source(src_x3, x3);
+        bind_source(src_sel, sel);
+        bind_source(src_addr, addr);
+        bind_source(src_waddr, waddr);
+        bind_source(src_wdata, wdata);
+
+        cells.resize(n);
+        for (unsigned int i = 0; i < n; i++) {
+            std::string s = std::to_string(i);
+            cell& c = cells[i];
+            c.q = new sc_signal<unsigned int>(("q" + s).c_str());
+            c.rd = new sc_signal<sc_uint<8>>(("rd" + s).c_str());
+            c.rfd = new sc_signal<sc_uint<8>>(("rfd" + s).c_str());
+            c.res = new sc_signal<sc_int<4>>(("res" + s).c_str());
+            c.z = new sc_signal<bool>(("z" + s).c_str());
+            c.mo = new sc_signal<sc_uint<2>>(("mo" + s).c_str());
+            c.full = new sc_signal<bool>;
+            c.empty = new sc_signal<bool>;
+            c.size = new sc_signal<unsigned int>;
+            c.overflow = new sc_signal<bool>;
+            c.carry = new sc_signal<bool>;
+
+            c.f = new fifo<unsigned int, 8>(("fifo" + s).c_str());
+            c.f->debug_print = false;
+            c.f->clk(clk);
+            c.f->rst_n(rst_n);
+            c.f->write_en(we);
+            c.f->data_in(i ? *cells[i - 1].q : din);
+            c.f->read_en(re);
+            c.f->data_out(*c.q);
+            c.f->full(*c.full);
+            c.f->empty(*c.empty);
+            c.f->size(*c.size);
+
+            c.m = new ram(("ram" + s).c_str());
+            c.m->clk(clk);
+            c.m->addr(addr);
+            c.m->wr_data(wdata);
+            c.m->wr_en(wen);
+            c.m->rd_data(*c.rd);
+
+            c.r = new register_file(("rf" + s).c_str());
+            c.r->clk(clk);
+            c.r->rd_addr(addr);
+            c.r->wr_addr(waddr);
+            c.r->wr_data(*c.rd);
+            c.r->wr_en(wen);
+            c.r->rd_data(*c.rfd);
+
+            c.u = new alu_4bit(("alu" + s).c_str());
+            c.u->A(a);
+            c.u->B(b);
+            c.u->op(op);
+            c.u->result(*c.res);
+            c.u->zero(*c.z);
+            c.u->overflow(*c.overflow);
+            c.u->carry(*c.carry);
+
+            c.x = new mux_4to1(("mux" + s).c_str());
+            c.x->X0(x0);
+            c.x->X1(x1);
+            c.x->X2(x2);
+            c.x->X3(x3);
+            c.x->Y(sel);
+            c.x->F(*c.mo);
+        }
+    }
+
+    ~direct_cells() {
+        for (cell& c : cells) {
+            delete c.f; delete c.m; delete c.r; delete c.u; delete c.x;
+            delete c.q; delete c.rd; delete c.rfd; delete c.res; delete c.z; delete c.mo;
+            delete c.full; delete c.empty; delete c.size; delete c.overflow; delete c.carry;
+        }
+    }
+
+    // 与netlist_design::values()相同：全部具名网络按名字排序的值
+    std::map<std::string, uint64_t> values() const {
+        std::map<std::string, uint64_t> v;
+        v["clk"] = clk.read();
+        v["rst_n"] = rst_n.read();
+        v["we"] = we.read();
+        v["re"] = re.read();
+        v["wen"] = wen.read();
+        v["din"] = din.read();
+        v["a"] = net_value_bits(a.read());
+        v["b"] = net_value_bits(b.read());
+        v["op"] = net_value_bits(op.read());
+        v["x0"] = net_value_bits(x0.read());
+        v["x1"] = net_value_bits(x1.read());
+        v["x2"] = net_value_bits(x2.read());
+        v["x3"] = net_value_bits(x3.read());
+        v["sel"] = net_value_bits(sel.read());
+        v["addr"] = net_value_bits(addr.read());
+        v["waddr"] = net_value_bits(waddr.read());
+        v["wdata"] = net_value_bits(wdata.read());
+        for (size_t i = 0; i < cells.size(); i++) {
+            std::string s = std::to_string(i);
+            const cell& c = cells[i];
+            v["q" + s] = c.q->read();
+            v["rd" + s] = net_value_bits(c.rd->read());
+            v["rfd" + s] = net_value_bits(c.rfd->read());
+            v["res" + s] = net_value_bits(c.res->read());
+            v["z" + s] = c.z->read();
+            v["mo" + s] = net_value_bits(c.mo->read());
+        }
+        return v;
+    }
+
+private:
+    template<typename T>
+    void bind_source(random_source<T>& src, sc_signal<T>& sig) {
+        src.clk(clk);
+        src.out(sig);
+    }
+};
+
+// ====== 在子进程中例化并运行 ======
+
+// 一次例化的结果，由子进程经管道传回
+struct elab_result {
+    unsigned int instances;
+    unsigned int nets;
+    double parse_ms;            // 网表文本解析（直接例化为0）
+    double resolve_ms;          // 检查端口、参数和网络类型
+    double construct_ms;        // 创建模块和信号、绑定端口
+    double init_ms;             // sc_start(SC_ZERO_TIME)：完成例化和初始化
+    double run_ms;
+    long elab_rss_kb;           // 从例化前到初始化完成，驻留内存峰值的增量
+    long peak_rss_kb;           // 子进程整个运行期间的驻留内存峰值
+    size_t arena_allocations;   // 例化期间从elab_heap分配的次数和字节数
+    size_t arena_bytes;
+    uint64_t checksum;
+    bool ok;
+};
+
+// 例化方式
+enum class elab_mode { netlist_arena, netlist_heap, direct };
+
+static const char* mode_name(elab_mode m) {
+    switch (m) {
+        case elab_mode::netlist_arena: return "网表+arena";
+        case elab_mode::netlist_heap:  return "网表";
+        default:                       return "直接";
+    }
+}
+
+static const uint64_t RUN_CYCLES_DEFAULT = 100;
+
+static double ms_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static elab_result run_netlist(unsigned int cells, uint64_t cycles, bool use_arena) {
+    elab_result r = {};
+    std::string text;
+    {
+        std::ostringstream os;
+        make_cells(cells).write(os);
+        text = os.str();
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    netlist nl;
+    std::istringstream in(text);
+    if (!nl.parse(in, "cells")) {
+        std::cout << "错误: " << nl.last_error() << std::endl;
+        return r;
+    }
+    r.parse_ms = ms_since(t0);
+
+    long rss0 = elab_heap::rss_kb();
+    component_registry registry;
+    netlist_design design(registry);
+    design.set_arena(use_arena);
+    if (!design.elaborate(nl)) {
+        std::cout << "错误: " << design.last_error() << std::endl;
+        return r;
+    }
+    r.resolve_ms = design.resolve_seconds() * 1e3;
+    r.construct_ms = design.construct_seconds() * 1e3;
+    r.arena_allocations = design.arena_allocations();
+    r.arena_bytes = design.arena_bytes();
+
+    auto t1 = std::chrono::steady_clock::now();
+    sc_start(SC_ZERO_TIME);
+    r.init_ms = ms_since(t1);
+    r.elab_rss_kb = elab_heap::peak_rss_kb() - rss0;
+    auto t2 = std::chrono::steady_clock::now();
+    sc_start(sc_time(10.0 * double(cycles), SC_NS));
+    r.run_ms = ms_since(t2);
+
+    r.peak_rss_kb = elab_heap::peak_rss_kb();
+    r.instances = unsigned(design.instances());
+    r.nets = unsigned(design.nets().size());
+    r.checksum = net_checksum(design.values());
+    r.ok = true;
+    return r;
+}
+
+static elab_result run_direct(unsigned int cells, uint64_t cycles) {
+    elab_result r = {};
+    long rss0 = elab_heap::rss_kb();
+    auto t0 = std::chrono::steady_clock::now();
+    direct_cells design("design", cells);
+    r.construct_ms = ms_since(t0);
+
+    auto t1 = std::chrono::steady_clock::now();
+    sc_start(SC_ZERO_TIME);
+    r.init_ms = ms_since(t1);
+    r.elab_rss_kb = elab_heap::peak_rss_kb() - rss0;
+    auto t2 = std::chrono::steady_clock::now();
+    sc_start(sc_time(10.0 * double(cycles), SC_NS));
+    r.run_ms = ms_since(t2);
+
+    r.peak_rss_kb = elab_heap::peak_rss_kb();
+    r.instances = STIM_INSTANCES + 5 * cells;
+    r.nets = STIM_INSTANCES + 6 * cells;
+    r.checksum = net_checksum(design.values());
+    r.ok = true;
+    return r;
+}
+
+// 每次例化在一个子进程中进行（见common/child_process.h）
+static bool run_in_child(elab_mode mode, unsigned int cells, uint64_t cycles, elab_result& result) {
+    return child::run_in_child([&]() {
+        return mode == elab_mode::direct ? run_direct(cells, cycles)
+                                         : run_netlist(cells, cycles, mode == elab_mode::netlist_arena);
+    }, result) && result.ok;
+}
+
+// ====== 网表检查 ======
+
+// 有错误的网表必须在创建任何SystemC对象之前被拒绝，错误信息包含行号
+static int check_errors() {
+    struct bad_case {
+        const char* what;
+        const char* text;
+        const char* expect;     // 错误信息中应包含的内容
+    };
+    const bad_case cases[] = {
+        {"未知类型", "adder u0 a=x\n", ":1: u0: 未知的类型"},
+        {"未知端口", "mux m0 X0=a Z=b\n", "没有端口或参数 Z"},
+        {"参数取值", "fifo f0 depth=7\n", "depth=7不支持"},
+        {"参数格式", "clock c0 period=fast out=clk\n", "应为数值"},
+        {"类型冲突", "alu u0 result=n\nmux m0 X0=n\n", ":2: m0: 端口X0是sc_uint<2>，网络n已经是sc_int<4>"},
+        {"多个驱动", "mux m0 F=n\nmux m1 F=n\n", "网络n已经由m0驱动"},
+        {"无法定型", "clock c0 out=clk\nrandom r0 clk=clk out=n\n", "网络n只连接了任意类型的端口"},
+        {"名字冲突", "mux m0 F=m0\n", "实例名与网络名相同"},
+        {"实例重名", "mux m0\nmux m0\n", ":2: 实例名重复"},
+        {"语法错误", "mux m0 X0\n", "应为 键=值"},
+    };
+
+    component_registry registry;
+    int failures = 0;
+    std::cout << "===== 网表检查 =====\n";
+    for (const bad_case& c : cases) {
+        netlist nl;
+        std::istringstream in(c.text);
+        std::string error;
+        if (!nl.parse(in, "bad")) {
+            error = nl.last_error();
+        } else {
+            netlist_design design(registry);
+            if (!design.elaborate(nl)) error = design.last_error();
+        }
+        bool ok = !error.empty() && error.find(c.expect) != std::string::npos;
+        std::cout << "  " << (ok ? "通过" : "失败") << ": " << c.what << " -> " << error << "\n";
+        if (!ok) failures++;
+    }
+    return failures;
+}
+
+// 用法: netlist_bench [实例数列表] [运行周期数] [md]
+//       给出md时计时表另外按Markdown表格打印一遍，可以直接贴进README
+//       netlist_bench gen <实例数>      把基准网表打印到标准输出，可供netlist_run使用
+int sc_main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "gen") {
+        unsigned int instances = argc > 2 ? std::stoul(argv[2]) : 1000;
+        make_cells(cells_for(instances)).write(std::cout);
+        return 0;
+    }
+
+    std::vector<unsigned int> sizes = {1000, 10000, 100000};
+    if (argc > 1) {
+        sizes.clear();
+        std::stringstream ss(argv[1]);
+        std::string item;
+        while (std::getline(ss, item, ',')) sizes.push_back(std::stoul(item));
+    }
+    uint64_t cycles = argc > 2 ? std::stoull(argv[2]) : RUN_CYCLES_DEFAULT;
+    bool markdown = argc > 3 && std::string(argv[3]) == "md";
+
+    int failures = check_errors();
+
+    // 小规模设计运行较多周期，三种方式例化的全部网络的值必须一致
+    const elab_mode modes[] = {elab_mode::netlist_arena, elab_mode::netlist_heap, elab_mode::direct};
+    std::cout << "\n===== 网表例化与直接例化的一致性 (50个单元, 500周期) =====\n";
+    elab_result ref = {};
+    for (elab_mode m : modes) {
+        elab_result r;
+        if (!run_in_child(m, 50, 500, r)) {
+            std::cout << "  失败: " << mode_name(m) << "的子进程运行失败\n";
+            failures++;
+            continue;
+        }
+        if (m == elab_mode::netlist_arena) ref = r;
+        bool same = r.checksum == ref.checksum;
+        std::cout << "  " << (same ? "通过" : "失败") << ": " << mode_name(m) << " 0x" << std::hex
+                  << r.checksum << std::dec << "\n";
+        if (!same) failures++;
+    }
+
+    std::cout << "\n===== 例化时间 (ms) 和内存 (MiB)，运行" << cycles << "周期 =====\n";
+    std::cout << std::right << std::setw(8) << "实例数" << std::setw(12) << "方式" << std::setw(10) << "解析"
+              << std::setw(10) << "检查" << std::setw(10) << "例化" << std::setw(10) << "初始化"
+              << std::setw(10) << "合计" << std::setw(12) << "运行" << std::setw(10) << "例化内存"
+              << std::setw(10) << "峰值RSS" << std::setw(12) << "arena分配" << "\n";
+    std::ostringstream md;
+    md << std::fixed << std::setprecision(1)
+       << "| 实例数 | 方式 | 解析+检查 (ms) | 例化 (ms) | 初始化 (ms) | 合计 (ms) | 例化内存 (MiB) | 峰值RSS (MiB) |\n"
+       << "|-------:|------|------:|------:|------:|------:|------:|------:|\n";
+    for (unsigned int n : sizes) {
+        unsigned int cells = cells_for(n);
+        for (elab_mode m : modes) {
+            elab_result r;
+            if (!run_in_child(m, cells, cycles, r)) {
+                std::cout << "错误: " << n << "个实例的" << mode_name(m) << "例化失败\n";
+                failures++;
+                continue;
+            }
+            double total = r.parse_ms + r.resolve_ms + r.construct_ms + r.init_ms;
+            std::cout << std::fixed << std::setprecision(1) << std::setw(8) << r.instances
+                      << std::setw(12) << mode_name(m)
+                      << std::setw(10) << r.parse_ms << std::setw(10) << r.resolve_ms
+                      << std::setw(10) << r.construct_ms << std::setw(10) << r.init_ms
+                      << std::setw(10) << total << std::setw(12) << r.run_ms
+                      << std::setw(10) << r.elab_rss_kb / 1024.0 << std::setw(10) << r.peak_rss_kb / 1024.0
+                      << std::setw(12) << r.arena_allocations << "\n";
+            md << "| " << r.instances << " | " << mode_name(m) << " | " << r.parse_ms + r.resolve_ms
+               << " | " << r.construct_ms << " | " << r.init_ms << " | " << total
+               << " | " << r.elab_rss_kb / 1024.0 << " | " << r.peak_rss_kb / 1024.0 << " |\n";
+        }
+    }
+    if (markdown) std::cout << "\n" << md.str();
+
+    if (failures) {
+        std::cout << "\n===== 网表例化测试失败 (" << failures << "处错误) =====" << std::endl;
+        return 1;
+    }
+    std::cout << "\n===== 网表例化测试通过 =====" << std::endl;
+    return 0;
+}
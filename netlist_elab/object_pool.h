@@ -0,0 +1,118 @@
+// File: object_pool.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 按类型分块的对象池，网表例化时的模块和信号都从这里分配。
+// 同一类型的对象连续存放在每块BLOCK_OBJECTS个的定长块中，用placement new构造，
+// 例化十万个实例只需要几百次块分配；块不移动，对象地址在池的生命期内不变。
+// clear()（以及析构）按创建的逆序析构全部对象，再释放所有块
+class object_pools {
+public:
+    static const size_t BLOCK_OBJECTS = 256;
+
+    object_pools() : blocks_(0), bytes_(0) {}
+    ~object_pools() { clear(); }
+
+    object_pools(const object_pools&) = delete;
+    object_pools& operator=(const object_pools&) = delete;
+
+    // 先登记再构造：构造函数中创建的子对象（例如模块的子模块）登记在后，逆序析构时先于父对象。
+    // 构造函数抛出异常时该对象不再析构，它的槽位在clear()时随块一起释放
+    template<typename T, typename... Args>
+    T* make(Args&&... args) {
+        void* slot = pool<T>().allocate(*this);
+        size_t k = objects_.size();
+        objects_.push_back({slot, nullptr});
+        T* obj;
+        try {
+            obj = new (slot) T(std::forward<Args>(args)...);
+        } catch (...) {
+            objects_[k].destroy = nullptr;
+            throw;
+        }
+        objects_[k].destroy = &destroy<T>;
+        return obj;
+    }
+
+    void clear() {
+        for (size_t i = objects_.size(); i > 0; i--) {
+            if (objects_[i - 1].destroy) objects_[i - 1].destroy(objects_[i - 1].obj);
+        }
+        objects_.clear();
+        pools_.clear();
+        blocks_ = 0;
+        bytes_ = 0;
+    }
+
+    size_t objects() const { return objects_.size(); }
+    size_t blocks() const { return blocks_; }
+    size_t bytes() const { return bytes_; }
+
+private:
+    struct pool_base {
+        virtual ~pool_base() {}
+    };
+
+    template<typename T>
+    struct typed_pool : pool_base {
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot;
+        std::vector<std::unique_ptr<slot[]>> blocks;
+        size_t used = BLOCK_OBJECTS;        // 最后一块已用的槽数
+
+        void* allocate(object_pools& owner) {
+            if (used == BLOCK_OBJECTS) {
+                blocks.emplace_back(new slot[BLOCK_OBJECTS]);
+                used = 0;
+                owner.blocks_++;
+                owner.bytes_ += sizeof(slot) * BLOCK_OBJECTS;
+            }
+            return &blocks.back()[used++];
+        }
+    };
+
+    struct live_object {
+        void* obj;
+        void (*destroy)(void*);
+    };
+
+    template<typename T>
+    static void destroy(void* p) { static_cast<T*>(p)->~T(); }
+
+    template<typename T>
+    typed_pool<T>& pool() {
+        std::unique_ptr<pool_base>& p = pools_[std::type_index(typeid(T))];
+        if (!p) p.reset(new typed_pool<T>);
+        return static_cast<typed_pool<T>&>(*p);
+    }
+
+    std::unordered_map<std::type_index, std::unique_ptr<pool_base>> pools_;
+    std::vector<live_object> objects_;
+    size_t blocks_;
+    size_t bytes_;
+};
+
+#endif // OBJECT_POOL_H
@@ -0,0 +1,64 @@
+// File: flit.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FLIT_H
+#define FLIT_H
+
+#include <systemc.h>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+// 片上网络中传输的单元。每个包只有一个flit，路由信息和统计信息都在其中
+struct flit {
+    uint32_t id;              // 源节点内的序号
+    uint16_t src;             // 源节点编号 y*宽度+x
+    uint16_t dst;             // 目的节点编号
+    uint64_t inject_cycle;    // 产生时的周期，用于统计延迟
+
+    flit() : id(0), src(0), dst(0), inject_cycle(0) {}
+
+    bool operator==(const flit& o) const {
+        return id == o.id && src == o.src && dst == o.dst && inject_cycle == o.inject_cycle;
+    }
+};
+
+// sc_signal<flit>和fifo<flit>需要的输出运算符与波形追踪
+inline std::ostream& operator<<(std::ostream& os, const flit& f) {
+    return os << "{" << f.src << "->" << f.dst << " #" << f.id << "}";
+}
+
+inline void sc_trace(sc_trace_file* tf, const flit& f, const std::string& name) {
+    sc_trace(tf, f.id, name + ".id");
+    sc_trace(tf, f.src, name + ".src");
+    sc_trace(tf, f.dst, name + ".dst");
+}
+
+// 路由器的5个端口
+enum noc_port {
+    PORT_LOCAL = 0,
+    PORT_NORTH = 1,     // y-1
+    PORT_EAST  = 2,     // x+1
+    PORT_SOUTH = 3,     // y+1
+    PORT_WEST  = 4,     // x-1
+    NUM_PORTS  = 5
+};
+
+inline unsigned int opposite(unsigned int p) {
+    return p == PORT_LOCAL ? PORT_LOCAL : (p + 1) % 4 + 1;
+}
+
+#endif // FLIT_H
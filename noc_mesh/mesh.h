@@ -0,0 +1,138 @@
+// File: mesh.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef MESH_H
+#define MESH_H
+
+#include <systemc.h>
+#include <string>
+#include <vector>
+#include "flit.h"
+#include "router.h"
+#include "noc_terminal.h"
+
+// 一条单向链路：flit方向的valid/data，以及反方向的credit
+struct noc_link {
+    sc_signal<bool> valid;
+    sc_signal<flit> data;
+    sc_signal<bool> credit;
+};
+
+// width x height的二维网格：每个节点一个路由器和一个终端（网络接口）
+// 节点编号为 y*width+x；边界上没有邻居的端口接在空链路上，XY路由不会使用它们
+template<unsigned int DEPTH = 4>
+SC_MODULE(mesh) {
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+
+    unsigned int width, height;
+    std::vector<router<DEPTH>*> routers;
+    std::vector<noc_terminal*> terminals;
+
+    mesh(sc_module_name name, unsigned int width, unsigned int height,
+         const noc_traffic& traffic, noc_stats& stats)
+    : sc_module(name), width(width), height(height) {
+        unsigned int n = width * height;
+
+        // in_links[node*NUM_PORTS + p]：进入节点node的端口p的链路；
+        // eject_links[node]：路由器本地输出到终端
+        for (unsigned int i = 0; i < n * NUM_PORTS; i++) in_links.push_back(new noc_link);
+        for (unsigned int i = 0; i < n; i++) eject_links.push_back(new noc_link);
+
+        for (unsigned int node = 0; node < n; node++) {
+            unsigned int x = node % width, y = node / width;
+            std::string rn = "router_" + std::to_string(x) + "_" + std::to_string(y);
+            router<DEPTH>* r = new router<DEPTH>(rn.c_str(), x, y, width);
+            routers.push_back(r);
+            r->clk(clk);
+            r->rst_n(rst_n);
+
+            for (unsigned int p = 0; p < NUM_PORTS; p++) {
+                noc_link* in = in_links[node * NUM_PORTS + p];
+                r->in_valid[p](in->valid);
+                r->in_flit[p](in->data);
+                r->credit_out[p](in->credit);
+
+                // 输出端口接邻居对应输入端口的链路；本地端口接终端；边界接空链路
+                noc_link* out;
+                int nb = neighbor(x, y, p);
+                if (p == PORT_LOCAL) {
+                    out = eject_links[node];
+                } else if (nb >= 0) {
+                    out = in_links[nb * NUM_PORTS + opposite(p)];
+                } else {
+                    out = new noc_link;
+                    unused_links.push_back(out);
+                }
+                r->out_valid[p](out->valid);
+                r->out_flit[p](out->data);
+                r->credit_in[p](out->credit);
+            }
+
+            std::string tn = "terminal_" + std::to_string(x) + "_" + std::to_string(y);
+            noc_terminal* t = new noc_terminal(tn.c_str(), node, n, DEPTH, traffic, stats);
+            terminals.push_back(t);
+            t->clk(clk);
+            t->rst_n(rst_n);
+            noc_link* inj = in_links[node * NUM_PORTS + PORT_LOCAL];
+            t->inj_valid(inj->valid);
+            t->inj_flit(inj->data);
+            t->inj_credit(inj->credit);
+            t->ej_valid(eject_links[node]->valid);
+            t->ej_flit(eject_links[node]->data);
+            t->ej_credit(eject_links[node]->credit);
+        }
+    }
+
+    ~mesh() {
+        for (router<DEPTH>* r : routers) delete r;
+        for (noc_terminal* t : terminals) delete t;
+        for (noc_link* l : in_links) delete l;
+        for (noc_link* l : eject_links) delete l;
+        for (noc_link* l : unused_links) delete l;
+    }
+
+    // 全部路由器转发的flit数（每一跳计一次，含最后送往本地端口）
+    uint64_t hops() const {
+        uint64_t h = 0;
+        for (const router<DEPTH>* r : routers) h += r->forwarded;
+        return h;
+    }
+
+    // 全部终端源队列中尚未注入的包
+    uint64_t backlog() const {
+        uint64_t b = 0;
+        for (const noc_terminal* t : terminals) b += t->backlog();
+        return b;
+    }
+
+private:
+    std::vector<noc_link*> in_links;
+    std::vector<noc_link*> eject_links;
+    std::vector<noc_link*> unused_links;
+
+    int neighbor(unsigned int x, unsigned int y, unsigned int p) const {
+        switch (p) {
+            case PORT_NORTH: return y > 0 ? int((y - 1) * width + x) : -1;
+            case PORT_SOUTH: return y + 1 < height ? int((y + 1) * width + x) : -1;
+            case PORT_EAST:  return x + 1 < width ? int(y * width + x + 1) : -1;
+            case PORT_WEST:  return x > 0 ? int(y * width + x - 1) : -1;
+            default:         return -1;
+        }
+    }
+};
+
+#endif // MESH_H
@@ -0,0 +1,212 @@
+// File: noc_bench.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "mesh.h"
+#include "../common/child_process.h"
+#include "../common/telemetry_publisher.h"
+
+struct bench_config {
+    unsigned int width;
+    unsigned int height;
+    unsigned int depth;
+    uint64_t warmup;
+    uint64_t measure;
+    uint64_t seed;
+    double hot_fraction;
+};
+
+// 一个注入率下的结果，由子进程经管道传回
+struct point_result {
+    double accepted;          // 统计窗口内每节点每周期收到的包数
+    double avg_latency;       // 统计窗口内产生的包的平均延迟（周期）
+    uint64_t max_latency;
+    uint64_t measured;        // 统计窗口内产生的包数
+    uint64_t hops;            // 全部路由器的转发次数
+    uint64_t cycles;          // 仿真的总周期数（含预热和排空）
+    double sim_seconds;
+    bool drained;             // 排空阶段结束时所有包都已送达
+    bool ok;                  // 已排空，没有送错节点，产生与收到的包一致
+};
+
+static const uint64_t RESET_CYCLES = 2;
+
+template<unsigned int DEPTH>
+static point_result run_point(const bench_config& cfg, traffic_pattern pattern, double rate) {
+    noc_traffic traffic;
+    traffic.pattern = pattern;
+    traffic.rate = rate;
+    traffic.hotspot = (cfg.height / 2) * cfg.width + cfg.width / 2;
+    traffic.hot_fraction = cfg.hot_fraction;
+    traffic.warmup = cfg.warmup;
+    traffic.measure = cfg.measure;
+    traffic.generate = true;
+    traffic.seed = cfg.seed;
+    noc_stats stats;
+
+    sc_clock clk("clk", 10, SC_NS);
+    sc_signal<bool> rst_n("rst_n");
+    mesh<DEPTH> net("mesh", cfg.width, cfg.height, traffic, stats);
+    net.clk(clk);
+    net.rst_n(rst_n);
+
+    // 设置了TELEMETRY时把运行状态发布到共享内存，用common/telemetry_top查看；
+    // 每100个周期把全部输入FIFO的占用计入直方图
+    tele::publisher telemetry("telemetry", clk.period(), 100);
+    telemetry.add_counter("injected", [&stats]() { return stats.injected; });
+    telemetry.add_counter("received", [&stats]() { return stats.received; });
+    telemetry.add_counter("hops", [&net]() { return net.hops(); });
+    telemetry.add_gauge("backlog", [&net]() { return net.backlog(); });
+    unsigned int occupancy = telemetry.add_histogram("fifo_occupancy", DEPTH + 1);
+    for (router<DEPTH>* r : net.routers) {
+        for (unsigned int p = 0; p < NUM_PORTS; p++) telemetry.add_sample(occupancy, r->occupancy(p));
+    }
+    std::ostringstream label;
+    label << "noc " << (pattern == traffic_pattern::hotspot ? "hotspot " : "uniform ")
+          << cfg.width << "x" << cfg.height << " depth " << DEPTH << " rate " << rate;
+    telemetry.open_env(label.str());
+
+    // 复位两个周期，之后预热并统计，再停止产生新包、排空网络
+    auto t0 = std::chrono::steady_clock::now();
+    sc_start(clk.period() * double(RESET_CYCLES));
+    rst_n.write(true);
+    sc_start(clk.period() * double(cfg.warmup + cfg.measure));
+    traffic.generate = false;
+    // 全网每周期至少送达一个包（热点节点的接收带宽），产生的包数不超过节点数乘以周期数，
+    // 超过这个上限仍未排空说明包丢失或网络死锁
+    unsigned int nodes = cfg.width * cfg.height;
+    uint64_t cycles = cfg.warmup + cfg.measure;
+    uint64_t limit = std::max<uint64_t>(20, nodes + 1) * (cfg.warmup + cfg.measure);
+    while (stats.received < stats.injected && cycles < limit) {
+        sc_start(clk.period() * 100.0);
+        cycles += 100;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    point_result r;
+    r.accepted = double(stats.window_received) / (double(nodes) * cfg.measure);
+    r.avg_latency = stats.measured_received ? double(stats.latency_sum) / stats.measured_received : 0.0;
+    r.max_latency = stats.latency_max;
+    r.measured = stats.measured_injected;
+    r.hops = net.hops();
+    r.cycles = cycles;
+    r.sim_seconds = seconds;
+    r.drained = stats.received == stats.injected;
+    r.ok = r.drained && stats.misrouted == 0 && stats.receive_checksum == stats.inject_checksum;
+    return r;
+}
+
+// 在子进程中例化并运行一个注入率（见common/child_process.h）
+static bool run_in_child(const bench_config& cfg, traffic_pattern pattern, double rate, point_result& result) {
+    return child::run_in_child([&]() {
+        switch (cfg.depth) {
+            case 2:  return run_point<2>(cfg, pattern, rate);
+            case 8:  return run_point<8>(cfg, pattern, rate);
+            default: return run_point<4>(cfg, pattern, rate);
+        }
+    }, result);
+}
+
+// 扫描注入率，打印延迟和吞吐量曲线；返回出错的点数
+static int sweep(const bench_config& cfg, traffic_pattern pattern, const std::vector<double>& rates) {
+    bool hot = pattern == traffic_pattern::hotspot;
+    std::cout << "\n===== " << (hot ? "热点" : "均匀随机") << "流量 ("
+              << cfg.width << "x" << cfg.height << "网格, 输入缓冲深度 " << cfg.depth;
+    if (hot) std::cout << ", " << cfg.hot_fraction * 100 << "%发往热点";
+    std::cout << ") =====\n";
+    std::cout << std::right << std::setw(8) << "注入率" << std::setw(10) << "吞吐量"
+              << std::setw(10) << "平均延迟" << std::setw(10) << "最大延迟"
+              << std::setw(10) << "统计包数" << std::setw(12) << "周期/s" << std::setw(14) << "flit跳数/s" << "\n";
+
+    int failures = 0;
+    for (double rate : rates) {
+        point_result r;
+        if (!run_in_child(cfg, pattern, rate, r)) {
+            std::cout << "错误: 注入率 " << rate << " 的子进程运行失败\n";
+            failures++;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(3) << std::setw(8) << rate
+                  << std::setw(10) << r.accepted
+                  << std::setprecision(1) << std::setw(10) << r.avg_latency
+                  << std::setw(10) << r.max_latency
+                  << std::setw(10) << r.measured
+                  << std::setprecision(0) << std::setw(12) << (r.cycles / r.sim_seconds)
+                  << std::setw(14) << (r.hops / r.sim_seconds);
+        if (r.accepted < 0.95 * rate) std::cout << "  饱和";
+        if (!r.drained) {
+            std::cout << "  错误: 未排空";
+            failures++;
+        } else if (!r.ok) {
+            std::cout << "  错误: 包丢失、重复或送错节点";
+            failures++;
+        }
+        std::cout << "\n";
+    }
+    return failures;
+}
+
+// 用法: noc_bench [uniform|hotspot|both] [宽] [高] [缓冲深度2|4|8] [统计周期数] [种子] [注入率列表]
+//   注入率列表用逗号分隔，例如 0.05,0.1,0.2
+int sc_main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "both";
+    bench_config cfg;
+    cfg.width = argc > 2 ? std::stoul(argv[2]) : 4;
+    cfg.height = argc > 3 ? std::stoul(argv[3]) : 4;
+    cfg.depth = argc > 4 ? std::stoul(argv[4]) : 4;
+    cfg.measure = argc > 5 ? std::stoull(argv[5]) : 2000;
+    cfg.seed = argc > 6 ? std::stoull(argv[6]) : 1;
+    cfg.warmup = cfg.measure / 2;
+    cfg.hot_fraction = 0.2;
+
+    std::vector<double> rates = {0.02, 0.05, 0.1, 0.15, 0.2, 0.25, 0.3, 0.35, 0.4, 0.5};
+    if (argc > 7) {
+        rates.clear();
+        std::stringstream ss(argv[7]);
+        std::string item;
+        while (std::getline(ss, item, ',')) rates.push_back(std::stod(item));
+    }
+
+    if (mode != "uniform" && mode != "hotspot" && mode != "both") {
+        std::cout << "未知模式: " << mode << std::endl;
+        return 1;
+    }
+    if (cfg.depth != 2 && cfg.depth != 4 && cfg.depth != 8) {
+        std::cout << "缓冲深度只支持2、4、8" << std::endl;
+        return 1;
+    }
+    if (cfg.width * cfg.height < 2 || cfg.width * cfg.height > 65536) {
+        std::cout << "网格节点数应在2~65536之间" << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    if (mode != "hotspot") failures += sweep(cfg, traffic_pattern::uniform, rates);
+    if (mode != "uniform") failures += sweep(cfg, traffic_pattern::hotspot, rates);
+
+    if (failures) {
+        std::cout << "\n===== NoC测试失败 (" << failures << "处错误) =====" << std::endl;
+        return 1;
+    }
+    std::cout << "\n===== NoC测试通过 =====" << std::endl;
+    return 0;
+}
@@ -0,0 +1,172 @@
+// File: noc_terminal.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NOC_TERMINAL_H
+#define NOC_TERMINAL_H
+
+#include <systemc.h>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include "flit.h"
+#include "../common/stimulus.h"
+
+// 流量模式
+enum class traffic_pattern { uniform, hotspot };
+
+// 全部终端共用的流量配置
+struct noc_traffic {
+    traffic_pattern pattern;
+    double rate;                  // 每个节点每周期产生一个包的概率
+    unsigned int hotspot;         // 热点节点
+    double hot_fraction;          // hotspot模式下发往热点的比例
+    uint64_t warmup;              // 预热周期数，之后开始统计
+    uint64_t measure;             // 统计窗口的周期数
+    bool generate;                // 为false时停止产生新包（排空阶段）
+    uint64_t seed;
+};
+
+// 全部终端共用的统计
+struct noc_stats {
+    uint64_t injected;            // 产生的包数
+    uint64_t received;            // 收到的包数
+    uint64_t measured_injected;   // 统计窗口内产生的包数
+    uint64_t measured_received;   // 其中已经收到的包数
+    uint64_t window_received;     // 统计窗口内收到的包数（吞吐量）
+    uint64_t latency_sum;         // 统计窗口内产生的包的延迟之和
+    uint64_t latency_max;
+    uint64_t misrouted;           // 送错节点的包
+    uint64_t inject_checksum;     // 产生和收到的包的(src, id)之和，排空后应相等
+    uint64_t receive_checksum;
+
+    noc_stats()
+    : injected(0), received(0), measured_injected(0), measured_received(0), window_received(0),
+      latency_sum(0), latency_max(0), misrouted(0), inject_checksum(0), receive_checksum(0) {}
+
+    static uint64_t tag(const flit& f) {
+        return (uint64_t(f.src) << 32 | f.id) * 0x9E3779B97F4A7C15ULL;
+    }
+};
+
+// 网络接口：按流量配置产生包，经本地端口注入路由器，并接收送达本节点的包
+// 产生的包先进入不限长度的源队列，延迟从产生时算起（包含源队列中的排队时间）。
+// 注入方向同样按信用发送；接收方向每个周期都能收下，收到后立即回送credit
+SC_MODULE(noc_terminal) {
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+
+    sc_out<bool> inj_valid;       // 接路由器本地输入端口
+    sc_out<flit> inj_flit;
+    sc_in<bool> inj_credit;
+
+    sc_in<bool> ej_valid;         // 接路由器本地输出端口
+    sc_in<flit> ej_flit;
+    sc_out<bool> ej_credit;
+
+    SC_HAS_PROCESS(noc_terminal);
+
+    void terminal_process() {
+        if (!rst_n.read()) {
+            credits = depth;
+            inj_valid.write(false);
+            ej_credit.write(false);
+            return;
+        }
+        cycle++;
+        bool in_window = cycle > traffic.warmup && cycle <= traffic.warmup + traffic.measure;
+
+        // 接收：路由器上个下降沿发出的flit
+        bool got = ej_valid.read();
+        if (got) {
+            const flit& f = ej_flit.read();
+            stats.received++;
+            stats.receive_checksum += noc_stats::tag(f);
+            if (f.dst != node) stats.misrouted++;
+            if (in_window) stats.window_received++;
+            if (f.inject_cycle > traffic.warmup && f.inject_cycle <= traffic.warmup + traffic.measure) {
+                uint64_t latency = cycle - f.inject_cycle;
+                stats.measured_received++;
+                stats.latency_sum += latency;
+                stats.latency_max = std::max(stats.latency_max, latency);
+            }
+        }
+        ej_credit.write(got);
+
+        // 产生新包
+        if (traffic.generate && rng.bernoulli_threshold(rate_thr)) {
+            flit f;
+            f.id = seq++;
+            f.src = node;
+            f.dst = pick_destination();
+            f.inject_cycle = cycle;
+            source.push_back(f);
+            stats.injected++;
+            stats.inject_checksum += noc_stats::tag(f);
+            if (in_window) stats.measured_injected++;
+        }
+
+        // 注入：有信用时发出源队列队首
+        if (inj_credit.read()) credits++;
+        if (credits > 0 && !source.empty()) {
+            inj_flit.write(source.front());
+            inj_valid.write(true);
+            source.pop_front();
+            credits--;
+        } else {
+            inj_valid.write(false);
+        }
+    }
+
+    size_t backlog() const { return source.size(); }
+
+    noc_terminal(sc_module_name name, unsigned int node, unsigned int nodes, unsigned int depth,
+                 const noc_traffic& traffic, noc_stats& stats)
+    : sc_module(name), traffic(traffic), stats(stats), node(node), nodes(nodes), depth(depth),
+      rng(traffic.seed, stim::STREAM_USER + 1 + node),
+      rate_thr(stim::philox_stream::threshold(traffic.rate)),
+      hot_thr(stim::philox_stream::threshold(traffic.hot_fraction)),
+      credits(depth), cycle(0), seq(0) {
+        SC_METHOD(terminal_process);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+
+private:
+    const noc_traffic& traffic;
+    noc_stats& stats;
+    unsigned int node;
+    unsigned int nodes;
+    unsigned int depth;
+    stim::philox_stream rng;
+    uint64_t rate_thr;
+    uint64_t hot_thr;
+    unsigned int credits;
+    uint64_t cycle;
+    uint32_t seq;
+    std::deque<flit> source;      // 源队列
+
+    // 均匀随机：除自己以外的节点等概率；热点：以hot_fraction的概率发往热点，否则均匀随机
+    unsigned int pick_destination() {
+        if (traffic.pattern == traffic_pattern::hotspot && node != traffic.hotspot &&
+            rng.bernoulli_threshold(hot_thr)) {
+            return traffic.hotspot;
+        }
+        unsigned int d = rng.uniform(0, nodes - 2);
+        return d >= node ? d + 1 : d;
+    }
+};
+
+#endif // NOC_TERMINAL_H
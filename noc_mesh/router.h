@@ -0,0 +1,183 @@
+// File: router.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ROUTER_H
+#define ROUTER_H
+
+#include <systemc.h>
+#include <string>
+#include "flit.h"
+#include "../fifo_design/fifo.h"
+
+// 输入缓冲的二维网格路由器
+// - 每个输入端口一个fifo<flit, DEPTH>，上游直接写入（write_en/data_in）
+// - 基于信用的流控：每个输出端口一个信用计数器，初值为下游输入缓冲的深度，
+//   发出一个flit减一，下游从缓冲中取出一个flit时回送一个周期的credit脉冲加一，
+//   所以上游只在下游有空位时发送，不需要查看full
+// - XY维序路由，每个输出端口独立做轮询仲裁
+//
+// fifo在时钟上升沿读写，路由器的逻辑在下降沿执行，此时fifo的输出已经稳定：
+//   下降沿k：  取回上升沿k读出的flit作为该输入的队首；路由、仲裁并发出flit；
+//             队首空出来的输入置read_en并回送credit
+//   上升沿k+1：fifo出队；下游fifo写入本路由器发出的flit
+// 每一跳2个周期，每个输入端口每周期可以转发一个flit
+template<unsigned int DEPTH = 4>
+SC_MODULE(router) {
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+
+    // 输入端口：上游的flit和回送给上游的credit
+    sc_in<bool> in_valid[NUM_PORTS];
+    sc_in<flit> in_flit[NUM_PORTS];
+    sc_out<bool> credit_out[NUM_PORTS];
+
+    // 输出端口：发给下游的flit和下游回送的credit
+    sc_out<bool> out_valid[NUM_PORTS];
+    sc_out<flit> out_flit[NUM_PORTS];
+    sc_in<bool> credit_in[NUM_PORTS];
+
+    unsigned int x, y;          // 本路由器在网格中的坐标
+    unsigned int width;         // 网格宽度，用于把节点编号换算成坐标
+    uint64_t forwarded;         // 转发的flit数（含送往本地端口）
+
+    SC_HAS_PROCESS(router);
+
+    // XY路由：先沿x方向走到目的列，再沿y方向
+    unsigned int route(unsigned int dst) const {
+        unsigned int dx = dst % width, dy = dst / width;
+        if (dx > x) return PORT_EAST;
+        if (dx < x) return PORT_WEST;
+        if (dy > y) return PORT_SOUTH;
+        if (dy < y) return PORT_NORTH;
+        return PORT_LOCAL;
+    }
+
+    void router_process() {
+        if (!rst_n.read()) {
+            for (unsigned int p = 0; p < NUM_PORTS; p++) {
+                credits[p] = DEPTH;
+                head_valid[p] = false;
+                pending_pop[p] = false;
+                rr[p] = p;
+                out_valid[p].write(false);
+                credit_out[p].write(false);
+                rd_en[p].write(false);
+            }
+            return;
+        }
+
+        // 下游回送的信用
+        for (unsigned int o = 0; o < NUM_PORTS; o++) {
+            if (credit_in[o].read()) credits[o]++;
+        }
+
+        // 取回上升沿出队的flit；计算各输入队首要去的输出端口
+        unsigned int want[NUM_PORTS];
+        for (unsigned int i = 0; i < NUM_PORTS; i++) {
+            if (pending_pop[i]) {
+                head[i] = buf_out[i].read();
+                head_valid[i] = true;
+                pending_pop[i] = false;
+            }
+            want[i] = head_valid[i] ? route(head[i].dst) : NUM_PORTS;
+        }
+
+        // 每个输出端口从上次获胜者的下一个输入开始轮询，有信用时发出一个flit
+        for (unsigned int o = 0; o < NUM_PORTS; o++) {
+            unsigned int grant = NUM_PORTS;
+            if (credits[o] > 0) {
+                for (unsigned int k = 1; k <= NUM_PORTS; k++) {
+                    unsigned int i = (rr[o] + k) % NUM_PORTS;
+                    if (want[i] == o) {
+                        grant = i;
+                        break;
+                    }
+                }
+            }
+            if (grant < NUM_PORTS) {
+                out_flit[o].write(head[grant]);
+                out_valid[o].write(true);
+                credits[o]--;
+                head_valid[grant] = false;
+                rr[o] = grant;
+                forwarded++;
+            } else {
+                out_valid[o].write(false);
+            }
+        }
+
+        // 队首空出的输入从fifo取下一个flit，同时把这个空位作为信用回送上游
+        for (unsigned int i = 0; i < NUM_PORTS; i++) {
+            bool pop = !head_valid[i] && !buf_empty[i].read();
+            rd_en[i].write(pop);
+            credit_out[i].write(pop);
+            pending_pop[i] = pop;
+        }
+    }
+
+    // 输入端口p的FIFO中的flit数（不含已取出等待仲裁的队首）
+    const sc_signal<unsigned int>& occupancy(unsigned int p) const { return buf_size[p]; }
+
+    router(sc_module_name name, unsigned int x, unsigned int y, unsigned int width)
+    : sc_module(name), x(x), y(y), width(width), forwarded(0) {
+        for (unsigned int p = 0; p < NUM_PORTS; p++) {
+            std::string n = "in_buf_" + std::to_string(p);
+            buf[p] = new fifo<flit, DEPTH>(n.c_str());
+            buf[p]->debug_print = false;
+            buf[p]->clk(clk);
+            buf[p]->rst_n(rst_n);
+            buf[p]->write_en(in_valid[p]);
+            buf[p]->data_in(in_flit[p]);
+            buf[p]->read_en(rd_en[p]);
+            buf[p]->data_out(buf_out[p]);
+            buf[p]->full(buf_full[p]);
+            buf[p]->empty(buf_empty[p]);
+            buf[p]->size(buf_size[p]);
+
+            credits[p] = DEPTH;
+            head_valid[p] = false;
+            pending_pop[p] = false;
+            rr[p] = p;
+        }
+
+        SC_METHOD(router_process);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+
+    ~router() {
+        for (unsigned int p = 0; p < NUM_PORTS; p++) delete buf[p];
+    }
+
+private:
+    // 输入缓冲及其内部连线
+    fifo<flit, DEPTH>* buf[NUM_PORTS];
+    sc_signal<bool> rd_en[NUM_PORTS];
+    sc_signal<flit> buf_out[NUM_PORTS];
+    sc_signal<bool> buf_full[NUM_PORTS];
+    sc_signal<bool> buf_empty[NUM_PORTS];
+    sc_signal<unsigned int> buf_size[NUM_PORTS];
+
+    // 每个输入的队首（已从fifo取出、等待仲裁的flit）
+    flit head[NUM_PORTS];
+    bool head_valid[NUM_PORTS];
+    bool pending_pop[NUM_PORTS];    // 本周期置了read_en，下个下降沿取回
+
+    unsigned int credits[NUM_PORTS];    // 各输出端口下游的空位数
+    unsigned int rr[NUM_PORTS];         // 各输出端口上次获胜的输入
+};
+
+#endif // ROUTER_H
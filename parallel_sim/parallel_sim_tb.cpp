@@ -0,0 +1,180 @@
+// File: parallel_sim_tb.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "partition.h"
+#include "slice.h"
+
+// 一次分区运行的配置
+struct run_config {
+    unsigned int partitions;       // 分区（进程）数量
+    unsigned int slices;           // 切片总数，首尾相连成环
+    unsigned int cycles;           // 仿真时钟周期数
+    unsigned int lookahead_cycles; // 边界通道延迟，同时作为同步量子
+};
+
+// 运行结果保存在共享内存中，由父进程汇总
+struct run_shared {
+    partition_shared* sync;
+    boundary_channel<int>* links;  // links[i]: 切片i -> 切片(i+1)%slices
+    uint64_t* checksums;           // 每个切片的摘要
+    void* links_mem;
+    size_t links_bytes;
+};
+
+// 单个分区的顶层：本分区的时钟、切片和同步模块
+SC_MODULE(partition_top) {
+    sc_clock clk;
+    std::vector<slice*> slices;
+    partition_sync* sync;
+
+    partition_top(sc_module_name name, const run_config& cfg, run_shared& rs,
+                  unsigned int self, unsigned int first, unsigned int last)
+    : sc_module(name), clk("clk", 10, SC_NS), sync(nullptr) {
+        uint64_t lookahead = sc_time(10.0 * cfg.lookahead_cycles, SC_NS).value();
+
+        for (unsigned int i = first; i < last; i++) {
+            unsigned int prev = (i + cfg.slices - 1) % cfg.slices;
+            std::string n = "slice_" + std::to_string(i);
+            slice* s = new slice(n.c_str(), &rs.links[prev], &rs.links[i], lookahead, i + 1);
+            s->clk(clk);
+            slices.push_back(s);
+        }
+
+        // 环形拓扑：本分区唯一的上游是前一个分区
+        if (cfg.partitions > 1) {
+            std::vector<unsigned int> upstream;
+            upstream.push_back((self + cfg.partitions - 1) % cfg.partitions);
+            sync = new partition_sync("sync", rs.sync, self, upstream,
+                                      sc_time(10.0 * cfg.lookahead_cycles, SC_NS));
+        }
+    }
+};
+
+// 以给定分区数运行一次，返回所有切片摘要之和与墙钟时间
+bool run_once(const run_config& cfg, uint64_t& checksum, double& seconds) {
+    run_shared rs;
+    rs.sync = partition_shared::create(cfg.partitions);
+    rs.links_bytes = cfg.slices * (sizeof(boundary_channel<int>) + sizeof(uint64_t));
+    rs.links_mem = partition_shared::shared_alloc(rs.links_bytes);
+    rs.links = static_cast<boundary_channel<int>*>(rs.links_mem);
+    rs.checksums = reinterpret_cast<uint64_t*>(rs.links + cfg.slices);
+    for (unsigned int i = 0; i < cfg.slices; i++) {
+        rs.links[i].reset(&rs.sync->aborted);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = run_partitions(rs.sync, [&](unsigned int p) {
+        unsigned int first = p * cfg.slices / cfg.partitions;
+        unsigned int last = (p + 1) * cfg.slices / cfg.partitions;
+        partition_top top("top", cfg, rs, p, first, last);
+        sc_start(10.0 * cfg.cycles, SC_NS);
+        for (unsigned int i = first; i < last; i++) {
+            rs.checksums[i] = top.slices[i - first]->checksum;
+        }
+    });
+    auto end = std::chrono::steady_clock::now();
+    seconds = std::chrono::duration<double>(end - start).count();
+
+    checksum = 0;
+    for (unsigned int i = 0; i < cfg.slices; i++) {
+        checksum += rs.checksums[i];
+    }
+
+    partition_shared::shared_free(rs.links_mem, rs.links_bytes);
+    partition_shared::destroy(rs.sync);
+    return ok;
+}
+
+// 扩展性基准：切片总数固定，分区数从1增加到32
+int run_bench(unsigned int slices, unsigned int cycles, unsigned int lookahead) {
+    std::cout << "\n===== 分区并行仿真扩展性测试 =====\n";
+    std::cout << "切片数: " << slices << ", 周期数: " << cycles
+              << ", lookahead: " << lookahead << " 周期\n\n";
+    std::cout << std::setw(8) << "分区数" << std::setw(12) << "时间(s)"
+              << std::setw(16) << "切片周期/s" << std::setw(10) << "加速比"
+              << std::setw(10) << "效率" << "  摘要\n";
+
+    uint64_t reference = 0;
+    double base_time = 0;
+    bool all_match = true;
+    const unsigned int counts[] = {1, 2, 4, 8, 16, 32};
+
+    for (unsigned int p : counts) {
+        if (p > slices) break;
+        run_config cfg = {p, slices, cycles, lookahead};
+        uint64_t checksum = 0;
+        double seconds = 0;
+        if (!run_once(cfg, checksum, seconds)) {
+            std::cout << "错误: 分区进程异常退出 (分区数 " << p << ")\n";
+            return 1;
+        }
+        if (p == 1) {
+            reference = checksum;
+            base_time = seconds;
+        }
+        bool match = (checksum == reference);
+        all_match = all_match && match;
+        double speedup = base_time / seconds;
+        std::cout << std::setw(8) << p
+                  << std::setw(12) << std::fixed << std::setprecision(3) << seconds
+                  << std::setw(16) << std::setprecision(0) << (double(slices) * cycles / seconds)
+                  << std::setw(10) << std::setprecision(2) << speedup
+                  << std::setw(9) << std::setprecision(0) << (100.0 * speedup / p) << "%"
+                  << "  0x" << std::hex << checksum << std::dec
+                  << (match ? "" : "  (不一致!)") << std::endl;
+    }
+
+    std::cout << (all_match ? "\n所有分区配置的结果一致\n" : "\n错误: 分区结果与单分区不一致\n");
+    return all_match ? 0 : 1;
+}
+
+int sc_main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        unsigned int slices = argc > 2 ? std::stoul(argv[2]) : 256;
+        unsigned int cycles = argc > 3 ? std::stoul(argv[3]) : 20000;
+        unsigned int lookahead = argc > 4 ? std::stoul(argv[4]) : 10;
+        return run_bench(slices, cycles, lookahead);
+    }
+
+    // 默认测试：单分区与4分区结果必须完全一致
+    std::cout << "\n===== 分区并行仿真测试 =====\n";
+    run_config single = {1, 16, 2000, 10};
+    run_config multi = {4, 16, 2000, 10};
+    uint64_t sum_single = 0, sum_multi = 0;
+    double t_single = 0, t_multi = 0;
+
+    if (!run_once(single, sum_single, t_single) || !run_once(multi, sum_multi, t_multi)) {
+        std::cout << "错误: 分区进程异常退出\n";
+        return 1;
+    }
+
+    std::cout << "单分区摘要: 0x" << std::hex << sum_single << std::dec
+              << " (" << t_single << " s)\n";
+    std::cout << "4分区摘要:  0x" << std::hex << sum_multi << std::dec
+              << " (" << t_multi << " s)\n";
+
+    if (sum_single != sum_multi) {
+        std::cout << "\n===== 分区并行仿真测试失败 =====\n";
+        return 1;
+    }
+    std::cout << "\n===== 分区并行仿真测试通过 =====\n";
+    return 0;
+}
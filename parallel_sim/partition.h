@@ -0,0 +1,259 @@
+// File: partition.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <systemc.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../common/child_process.h"
+
+// 同一进程中无法并行运行多个SystemC内核（见common/child_process.h），
+// 因此分区执行采用"每个分区一个进程"的方式：父进程在
+// 任何SystemC对象构造之前fork出N个子进程，每个子进程只例化自己负责的
+// 子系统并独立调用sc_start()。分区之间的通信与时间同步全部经过一块
+// 匿名共享内存完成。
+
+// 避免伪共享，每个原子计数器独占一个缓存行
+struct alignas(64) padded_counter {
+    std::atomic<uint64_t> value;
+};
+
+// 中止标志：有分区异常退出时由父进程置位。其余分区在自旋等待（上游进度、边界通道
+// 空位）中检查它，不再等待永远不会到来的进度，直接以PARTITION_ABORTED退出
+struct alignas(64) abort_flag {
+    static constexpr int PARTITION_ABORTED = 3;
+
+    std::atomic<uint32_t> value;
+
+    void raise() { value.store(1, std::memory_order_release); }
+    bool raised() const { return value.load(std::memory_order_acquire) != 0; }
+
+    // 自旋等待的每一轮调用；父进程已经判定本次运行失败，子进程不需要清理
+    void exit_if_raised() const {
+        if (raised()) _exit(PARTITION_ABORTED);
+    }
+};
+
+// 跨分区边界通道：单生产者单消费者环形队列，每个元素携带投递时间戳
+// 发送方在时刻t发送的数据，其时间戳为t+lookahead，接收方只在本地时间
+// 到达该时间戳后才能取出，这样结果与分区数量无关
+template<typename T, unsigned int CAPACITY = 512>
+struct boundary_channel {
+    struct entry {
+        uint64_t timestamp;    // 投递时间（内核时间单位，默认1ps）
+        T        value;
+    };
+
+    padded_counter head;       // 消费者位置
+    padded_counter tail;       // 生产者位置
+    const abort_flag* abort;   // 队列满时等待中检查的中止标志（可以为空）
+    entry slots[CAPACITY];
+
+    void reset(const abort_flag* a = nullptr) {
+        head.value.store(0, std::memory_order_relaxed);
+        tail.value.store(0, std::memory_order_relaxed);
+        abort = a;
+    }
+
+    // 发送方：队列满时让出CPU等待接收方消费；接收方所在的分区异常退出时随中止标志退出
+    void push(uint64_t timestamp, const T& value) {
+        uint64_t t = tail.value.load(std::memory_order_relaxed);
+        while (t - head.value.load(std::memory_order_acquire) >= CAPACITY) {
+            if (abort) abort->exit_if_raised();
+            std::this_thread::yield();
+        }
+        slots[t % CAPACITY].timestamp = timestamp;
+        slots[t % CAPACITY].value = value;
+        tail.value.store(t + 1, std::memory_order_release);
+    }
+
+    // 接收方：只取出时间戳不晚于now的数据
+    bool pop_ready(uint64_t now, T& value) {
+        uint64_t h = head.value.load(std::memory_order_relaxed);
+        if (h == tail.value.load(std::memory_order_acquire)) {
+            return false;
+        }
+        const entry& e = slots[h % CAPACITY];
+        if (e.timestamp > now) {
+            return false;
+        }
+        value = e.value;
+        head.value.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// 分区间共享的同步状态
+// progress[p] = T 表示分区p已经完成了所有早于T的活动
+struct partition_shared {
+    static constexpr uint64_t FINISHED = ~uint64_t(0);
+
+    unsigned int num_partitions;
+    padded_counter* progress;
+    abort_flag aborted;
+
+    // 在共享内存中为n个分区分配同步状态
+    static partition_shared* create(unsigned int n) {
+        void* mem = shared_alloc(bytes_for(n));
+        partition_shared* s = new (mem) partition_shared();
+        s->num_partitions = n;
+        s->aborted.value.store(0, std::memory_order_relaxed);
+        uintptr_t p = reinterpret_cast<uintptr_t>(s + 1);
+        p = (p + 63) & ~uintptr_t(63);
+        s->progress = reinterpret_cast<padded_counter*>(p);
+        for (unsigned int i = 0; i < n; i++) {
+            new (&s->progress[i]) padded_counter();
+            s->progress[i].value.store(0, std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    // 释放create分配的同步状态
+    static void destroy(partition_shared* s) {
+        shared_free(s, bytes_for(s->num_partitions));
+    }
+
+    static size_t bytes_for(unsigned int n) {
+        return sizeof(partition_shared) + 64 + n * sizeof(padded_counter);
+    }
+
+    // 分配一块fork后父子进程都可见的共享内存（清零）
+    static void* shared_alloc(size_t bytes) {
+        void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            std::cerr << "Error: 共享内存分配失败 (" << bytes << " 字节)" << std::endl;
+            std::exit(1);
+        }
+        return mem;
+    }
+
+    static void shared_free(void* mem, size_t bytes) {
+        munmap(mem, bytes);
+    }
+
+    void publish(unsigned int p, uint64_t t) {
+        progress[p].value.store(t, std::memory_order_release);
+    }
+
+    // 自旋等待上游分区推进到时刻t；上游异常退出时随中止标志退出
+    void wait_for(unsigned int p, uint64_t t) const {
+        while (progress[p].value.load(std::memory_order_acquire) < t) {
+            aborted.exit_if_raised();
+            std::this_thread::yield();
+        }
+    }
+};
+
+// 保守同步模块：每经过一个量子（quantum）发布本分区进度，
+// 然后阻塞内核线程直到所有上游分区都推进到同一时刻。
+// 要求量子不大于边界通道的lookahead，并且同步点不与边界通道的
+// 收发时刻重合（边界收发在时钟下降沿进行，同步点位于上升沿）。
+SC_MODULE(partition_sync) {
+    partition_shared* shared;
+    unsigned int self;
+    std::vector<unsigned int> upstream;
+    sc_time quantum;
+
+    SC_HAS_PROCESS(partition_sync);
+
+    void sync_process() {
+        while (true) {
+            wait(quantum);
+            uint64_t now = sc_time_stamp().value();
+            shared->publish(self, now);
+            for (unsigned int u : upstream) {
+                shared->wait_for(u, now);
+            }
+        }
+    }
+
+    partition_sync(sc_module_name name, partition_shared* s, unsigned int id,
+                   const std::vector<unsigned int>& up, const sc_time& q)
+    : sc_module(name), shared(s), self(id), upstream(up), quantum(q) {
+        SC_THREAD(sync_process);
+    }
+};
+
+// 以N个子进程运行N个分区（见common/child_process.h），body(p)在子进程p中完成例化与sc_start()
+// 子进程结束前将进度置为FINISHED，防止下游在最后一个量子上等待。
+// 父进程以非阻塞的waitpid轮询各分区：一个分区崩溃、被杀死或没有正常结束时，
+// 它的下游永远等不到它的进度，于是置位中止标志并杀死其余分区，本次运行失败而不是挂起
+inline bool run_partitions(partition_shared* shared,
+                           const std::function<void(unsigned int)>& body) {
+    std::vector<child::handle> children;
+    for (unsigned int p = 0; p < shared->num_partitions; p++) {
+        child::handle h;
+        bool started = child::start<char>([shared, &body, p]() {
+            body(p);
+            shared->publish(p, partition_shared::FINISHED);
+            return char(1);
+        }, h);
+        if (!started) {
+            // 已经启动的分区会在同步点上等待缺失的分区，先杀死再回收
+            std::cerr << "Error: fork失败" << std::endl;
+            shared->aborted.raise();
+            for (child::handle& c : children) child::stop(c);
+            return false;
+        }
+        children.push_back(h);
+    }
+
+    bool ok = true;
+    size_t running = children.size();
+    while (running > 0) {
+        bool reaped = false;
+        for (unsigned int p = 0; p < children.size(); p++) {
+            child::handle& c = children[p];
+            if (c.pid < 0) continue;
+            int status = 0;
+            pid_t r = waitpid(c.pid, &status, WNOHANG);
+            if (r == 0 || (r < 0 && errno == EINTR)) continue;
+            char done = 0;
+            bool finished = r == c.pid && child::collect(c, status, done);
+            if (r != c.pid) {
+                close(c.fd);
+                c = child::handle();
+            }
+            running--;
+            reaped = true;
+            if (!finished && ok) {
+                std::cerr << "Error: 分区" << p << "异常退出，中止其余分区" << std::endl;
+                ok = false;
+                shared->aborted.raise();
+                for (child::handle& other : children) {
+                    if (other.pid >= 0) {
+                        child::stop(other);
+                        running--;
+                    }
+                }
+            }
+        }
+        if (!reaped) usleep(100);
+    }
+    return ok;
+}
+
+#endif // PARTITION_H
@@ -0,0 +1,194 @@
+// File: slice.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef SLICE_H
+#define SLICE_H
+
+#include <systemc.h>
+#include "../fifo_design/fifo.h"
+#include "../alu_4bit/alu_4bit.h"
+#include "../register_ram/ram.h"
+#include "partition.h"
+
+// 一个计算切片：fifo -> alu_4bit -> ram
+// 令牌来源于上一个切片的边界通道或本地LFSR，经过fifo缓冲后送入ALU，
+// ALU结果写入RAM，部分令牌通过边界通道转发给下一个切片
+SC_MODULE(slice) {
+    sc_in<bool> clk;
+
+    // fifo连接信号
+    sc_signal<bool> rst_n;
+    sc_signal<bool> write_en;
+    sc_signal<int> data_in;
+    sc_signal<bool> read_en;
+    sc_signal<int> data_out;
+    sc_signal<bool> full;
+    sc_signal<bool> empty;
+    sc_signal<unsigned int> size;
+
+    // ALU连接信号
+    sc_signal<sc_int<4>> alu_a;
+    sc_signal<sc_int<4>> alu_b;
+    sc_signal<sc_uint<3>> alu_op;
+    sc_signal<sc_int<4>> alu_result;
+    sc_signal<bool> alu_zero;
+    sc_signal<bool> alu_overflow;
+    sc_signal<bool> alu_carry;
+
+    // RAM连接信号
+    sc_signal<sc_uint<4>> ram_addr;
+    sc_signal<sc_uint<8>> ram_wr_data;
+    sc_signal<bool> ram_wr_en;
+    sc_signal<sc_uint<8>> ram_rd_data;
+
+    // 子模块
+    fifo<int, 8> queue;
+    alu_4bit alu;
+    ram memory;
+
+    // 边界通道（可能跨分区，也可能在同一分区内）
+    boundary_channel<int>* in_link;
+    boundary_channel<int>* out_link;
+    uint64_t lookahead;            // 边界通道延迟（内核时间单位）
+
+    uint32_t lfsr;                 // 本地令牌生成器
+    uint64_t checksum;             // 所有RAM写入与转发令牌的摘要
+
+    SC_HAS_PROCESS(slice);
+
+    uint32_t next_token() {
+        // 16位Galois LFSR
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+        return lfsr;
+    }
+
+    void mix(uint64_t v) {
+        checksum = (checksum ^ v) * 1099511628211ULL;
+    }
+
+    // 驱动进程：在时钟下降沿采样上一拍结果并准备下一个上升沿的输入
+    void drive_process() {
+        rst_n.write(false);
+        wait(clk.negedge_event());
+        rst_n.write(true);
+
+        bool reading = false;      // 上一个上升沿是否读出了fifo
+        bool alu_busy = false;     // ALU输入上是否有待收集的令牌
+        int alu_token = 0;
+        bool has_pending = false;  // 尚未写入fifo的令牌
+        int pending = 0;
+        uint64_t cycle = 0;
+
+        while (true) {
+            wait(clk.negedge_event());
+            uint64_t now = sc_time_stamp().value();
+            cycle++;
+
+            // 收集ALU结果，写入RAM并按条件转发
+            if (alu_busy) {
+                int r = alu_result.read().to_int() & 0xF;
+                int flags = (alu_zero.read() ? 1 : 0) | (alu_overflow.read() ? 2 : 0)
+                          | (alu_carry.read() ? 4 : 0);
+                unsigned int addr = alu_token & 0xF;
+                unsigned int data = r | (flags << 4);
+                ram_addr.write(addr);
+                ram_wr_data.write(data);
+                ram_wr_en.write(true);
+                mix((addr << 8) | data);
+
+                if ((alu_token & 3) == 0) {
+                    int forward = (alu_token * 31 + r) & 0xFFFF;
+                    out_link->push(now + lookahead, forward);
+                    mix(0x10000u | forward);
+                }
+                alu_busy = false;
+            } else {
+                ram_wr_en.write(false);
+            }
+
+            // 上一拍读出的令牌送入ALU
+            if (reading) {
+                alu_token = data_out.read();
+                alu_a.write(sc_int<4>(alu_token & 0xF));
+                alu_b.write(sc_int<4>((alu_token >> 4) & 0xF));
+                alu_op.write((alu_token >> 8) & 0x7);
+                alu_busy = true;
+            }
+
+            // 选择写入fifo的令牌：优先取边界输入，否则每两拍本地生成一个
+            if (!has_pending) {
+                if (in_link->pop_ready(now, pending)) {
+                    has_pending = true;
+                } else if ((cycle & 1) == 0) {
+                    pending = next_token();
+                    has_pending = true;
+                }
+            }
+
+            bool do_write = has_pending && !full.read();
+            write_en.write(do_write);
+            data_in.write(pending);
+            if (do_write) {
+                has_pending = false;
+            }
+
+            reading = !empty.read();
+            read_en.write(reading);
+        }
+    }
+
+    slice(sc_module_name name, boundary_channel<int>* in, boundary_channel<int>* out,
+          uint64_t link_delay, uint32_t seed)
+    : sc_module(name),
+      queue("queue"),
+      alu("alu"),
+      memory("memory"),
+      in_link(in),
+      out_link(out),
+      lookahead(link_delay),
+      lfsr(seed ? seed : 1),
+      checksum(14695981039346656037ULL) {
+
+        queue.debug_print = false;
+        queue.clk(clk);
+        queue.rst_n(rst_n);
+        queue.write_en(write_en);
+        queue.data_in(data_in);
+        queue.read_en(read_en);
+        queue.data_out(data_out);
+        queue.full(full);
+        queue.empty(empty);
+        queue.size(size);
+
+        alu.A(alu_a);
+        alu.B(alu_b);
+        alu.op(alu_op);
+        alu.result(alu_result);
+        alu.zero(alu_zero);
+        alu.overflow(alu_overflow);
+        alu.carry(alu_carry);
+
+        memory.clk(clk);
+        memory.addr(ram_addr);
+        memory.wr_data(ram_wr_data);
+        memory.wr_en(ram_wr_en);
+        memory.rd_data(ram_rd_data);
+
+        SC_THREAD(drive_process);
+    }
+};
+
+#endif // SLICE_H
@@ -0,0 +1,120 @@
+// File: ecc.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ECC_H
+#define ECC_H
+
+#include <cstdint>
+
+// 一次读出的纠错结果
+enum class ecc_result { ok, corrected, uncorrectable };
+
+// 纠正表的一项：按(总体奇偶是否不符, 汉明校验子)查出要翻转的位
+struct secded8_fix {
+    uint8_t data;
+    uint8_t check;
+    ecc_result result;
+};
+
+// secded8的编码表和纠正表，编译期生成
+struct secded8_tables {
+    uint8_t check[256] = {};
+    secded8_fix fixes[32] = {};
+
+    constexpr secded8_tables() {
+        const uint8_t pos[8] = {3, 5, 6, 7, 9, 10, 11, 12};
+        for (unsigned int d = 0; d < 256; d++) {
+            unsigned int h = 0, ones = 0;
+            for (unsigned int k = 0; k < 8; k++) {
+                if (d >> k & 1) {
+                    h ^= pos[k];
+                    ones++;
+                }
+            }
+            for (unsigned int k = 0; k < 4; k++) ones += h >> k & 1;
+            check[d] = uint8_t(h | (ones & 1) << 4);
+        }
+        for (unsigned int s = 0; s < 16; s++) {
+            // 总体奇偶相符：校验子为0没有错误，否则是两位错误
+            fixes[s] = {0, 0, s ? ecc_result::uncorrectable : ecc_result::ok};
+            // 总体奇偶不符：奇数位错误，校验子指出出错的位置；超出12说明至少三位出错
+            secded8_fix& f = fixes[16 | s];
+            f = {0, 0, ecc_result::corrected};
+            if (s == 0) {
+                f.check = 0x10;
+            } else if ((s & (s - 1)) == 0) {
+                f.check = uint8_t(s);
+            } else if (s > 12) {
+                f.result = ecc_result::uncorrectable;
+            } else {
+                for (unsigned int k = 0; k < 8; k++) {
+                    if (pos[k] == s) f.data = uint8_t(1u << k);
+                }
+            }
+        }
+    }
+};
+
+// SECDED(13,8)：8位数据加5位校验，纠正一位错误、检测两位错误。
+// 码字位置1~12按汉明码排列，校验位在1、2、4、8，数据位0~7依次在3、5、6、7、9、10、11、12；
+// 第13位是整个码字的总体奇偶位。check的bit0~3是汉明校验位，bit4是总体奇偶位。
+//
+// 编码和译码都查表：数据的汉明校验位就是所有为1的数据位所在位置的异或，预先算成256项的表；
+// 译码时 校验子=表[数据]^存储的校验位，总体奇偶用popcount求出，再查32项的纠正表
+class secded8 {
+public:
+    static const unsigned int CODE_BITS = 13;     // 码字位编号：0~7数据位，8~12校验位
+
+    static uint8_t encode(uint8_t data) { return tables_.check[data]; }
+
+    // 就地纠正data和check，返回结果；uncorrectable时两者保持原样
+    static ecc_result decode(uint8_t& data, uint8_t& check) {
+        unsigned int s = (tables_.check[data] ^ check) & 0xF;
+        unsigned int p = unsigned(__builtin_popcount(data) + __builtin_popcount(check)) & 1;
+        const secded8_fix& f = tables_.fixes[p << 4 | s];
+        data ^= f.data;
+        check ^= f.check;
+        return f.result;
+    }
+
+private:
+    static constexpr secded8_tables tables_ = secded8_tables();
+};
+
+// 附加在存储模型上的每字校验位和纠错计数，默认关闭。
+// 打开后每次写入同时写校验位，每次读出先译码：一位错误纠正后写回存储（读时擦洗），
+// 两位错误只计数，读出的仍是存储中的值
+template<unsigned int WORDS>
+struct ecc_store {
+    bool enabled;
+    uint8_t check[WORDS];
+    uint64_t corrected;             // 纠正的一位错误
+    uint64_t uncorrected;           // 检测到但不能纠正的错误
+
+    ecc_store() : enabled(false), check(), corrected(0), uncorrected(0) {}
+
+    void write(unsigned int a, uint8_t data) { check[a] = secded8::encode(data); }
+
+    // data是从存储中读出的值，返回后是纠正过的值
+    ecc_result read(unsigned int a, uint8_t& data) {
+        ecc_result r = secded8::decode(data, check[a]);
+        if (r == ecc_result::corrected) corrected++;
+        else if (r == ecc_result::uncorrectable) uncorrected++;
+        return r;
+    }
+};
+
+#endif // ECC_H
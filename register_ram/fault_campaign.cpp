@@ -0,0 +1,328 @@
+// File: fault_campaign.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+#include "register_file.h"
+#include "ram.h"
+#include "ecc.h"
+#include "fault_injector.h"
+#include "../common/stimulus.h"
+#include "../common/child_process.h"
+
+// 一个模型在一次运行中的统计
+struct model_result {
+    uint64_t injected;          // 注入的故障数
+    uint64_t reads;             // 检查过的读访问
+    uint64_t detected;          // 读出时报告了不可纠正错误
+    uint64_t silent;            // 读出的值错误而没有报告（静默数据损坏）
+    uint64_t corrected;         // 模型纠正的一位错误
+    uint64_t uncorrected;       // 模型检测到的不可纠正错误
+
+    void add(const model_result& o) {
+        injected += o.injected;
+        reads += o.reads;
+        detected += o.detected;
+        silent += o.silent;
+        corrected += o.corrected;
+        uncorrected += o.uncorrected;
+    }
+};
+
+struct run_result {
+    model_result ram;
+    model_result regs;
+};
+
+struct campaign_config {
+    uint64_t cycles;            // 每次运行的周期数
+    bool ecc;
+    fault_config fault;
+    uint64_t seed;
+};
+
+// 一次运行：ram和register_file接在同一组地址/数据信号上，驱动线程每个周期随机读或写
+// （地址每周期都变，两个模型的读进程每次都重新读出），影子存储给出期望值；
+// 两个故障注入器各自按故障率翻转存储中的位
+SC_MODULE(campaign_top) {
+    sc_clock clk;
+    sc_signal<sc_uint<4>> addr;
+    sc_signal<sc_uint<8>> wr_data;
+    sc_signal<bool> wr_en;
+    sc_signal<sc_uint<8>> ram_rd_data;
+    sc_signal<sc_uint<8>> reg_rd_data;
+
+    ram mem;
+    register_file regs;
+    fault_injector<ram> ram_faults;
+    fault_injector<register_file> reg_faults;
+
+    model_result ram_res;
+    model_result reg_res;
+
+    SC_HAS_PROCESS(campaign_top);
+
+    // 检查上一周期的读：读出值与影子存储比较，期间模型报告的不可纠正错误记为检出。
+    // 发现错误后把影子值写回（相当于上层的恢复），同一次损坏只计一次
+    template<typename MODEL>
+    void check_read(MODEL& m, const sc_signal<sc_uint<8>>& rd, model_result& res, uint64_t& due_seen,
+                    unsigned int a) {
+        res.reads++;
+        bool due = m.ecc.uncorrected != due_seen;
+        due_seen = m.ecc.uncorrected;
+        if (due) {
+            res.detected++;
+        } else if (rd.read().to_uint() != shadow[a]) {
+            res.silent++;
+        } else {
+            return;
+        }
+        m.poke(a, shadow[a]);
+    }
+
+    void drive_thread() {
+        unsigned int a = 0;
+        bool was_read = false;
+        for (;;) {
+            wait(clk.negedge_event());
+            if (was_read) {
+                check_read(mem, ram_rd_data, ram_res, ram_due, a);
+                check_read(regs, reg_rd_data, reg_res, reg_due, a);
+            } else {
+                // 写周期中模型也会读出，期间的不可纠正错误不属于任何一次被检查的读
+                ram_due = mem.ecc.uncorrected;
+                reg_due = regs.ecc.uncorrected;
+            }
+
+            uint32_t r = rng.next_u32();
+            unsigned int next = (a + 1 + (r & 0xF) % 15) & 0xF;   // 与上一周期不同的地址
+            a = next;
+            bool write = ((r >> 4) & 3) == 0;                      // 1/4写，3/4读
+            unsigned int data = (r >> 8) & 0xFF;
+            addr.write(a);
+            wr_data.write(data);
+            wr_en.write(write);
+            if (write) shadow[a] = data;
+            was_read = !write;
+        }
+    }
+
+    campaign_top(sc_module_name name, const campaign_config& cfg, uint64_t run)
+    : sc_module(name), clk("clk", 10, SC_NS), mem("mem"), regs("regs"),
+      ram_faults("ram_faults", mem, cfg.fault, cfg.seed, stim::STREAM_USER + 3 * run + 1),
+      reg_faults("reg_faults", regs, cfg.fault, cfg.seed, stim::STREAM_USER + 3 * run + 2),
+      ram_res(), reg_res(), rng(cfg.seed, stim::STREAM_USER + 3 * run), ram_due(0), reg_due(0) {
+        mem.clk(clk);
+        mem.addr(addr);
+        mem.wr_data(wr_data);
+        mem.wr_en(wr_en);
+        mem.rd_data(ram_rd_data);
+
+        regs.clk(clk);
+        regs.rd_addr(addr);
+        regs.wr_addr(addr);
+        regs.wr_data(wr_data);
+        regs.wr_en(wr_en);
+        regs.rd_data(reg_rd_data);
+
+        ram_faults.clk(clk);
+        reg_faults.clk(clk);
+
+        for (unsigned int i = 0; i < 16; i++) shadow[i] = 0;
+        mem.enable_ecc(cfg.ecc);
+        regs.enable_ecc(cfg.ecc);
+
+        SC_THREAD(drive_thread);
+    }
+
+    run_result result() const {
+        run_result r = {ram_res, reg_res};
+        r.ram.injected = ram_faults.injected;
+        r.ram.corrected = mem.ecc.corrected;
+        r.ram.uncorrected = mem.ecc.uncorrected;
+        r.regs.injected = reg_faults.injected;
+        r.regs.corrected = regs.ecc.corrected;
+        r.regs.uncorrected = regs.ecc.uncorrected;
+        return r;
+    }
+
+private:
+    unsigned int shadow[16];
+    stim::philox_stream rng;
+    uint64_t ram_due;
+    uint64_t reg_due;
+};
+
+// ====== 并行运行 ======
+
+// 运行结果由子进程经管道传回
+struct run_message {
+    run_result result;
+    bool ok;
+};
+
+// 每次运行在一个子进程中进行（见common/child_process.h），最多jobs个同时运行。
+// 运行之间相互独立，第i次运行的激励和故障只由(种子, i)决定，汇总结果与并行数无关
+static bool run_campaign(const campaign_config& cfg, unsigned int runs, unsigned int jobs, run_result& total) {
+    total = run_result();
+    bool ok = true;
+    bool started = child::run_parallel<run_message>(runs, jobs,
+        [&cfg](unsigned int i) {
+            run_message msg;
+            campaign_top top("top", cfg, i);
+            sc_start(sc_time(10.0 * double(cfg.cycles), SC_NS));
+            msg.result = top.result();
+            msg.ok = true;
+            return msg;
+        },
+        [&total, &ok](unsigned int, const run_message& msg) {
+            if (!msg.ok) {
+                ok = false;
+                return;
+            }
+            total.ram.add(msg.result.ram);
+            total.regs.add(msg.result.regs);
+        });
+    return started && ok;
+}
+
+// ====== 自检 ======
+
+// SECDED穷举：全部256个数据，每个码字的13个一位错误都要纠正回原值，78种两位错误都要报告不可纠正
+static int check_secded() {
+    uint64_t single = 0, dual = 0;
+    int failures = 0;
+    for (unsigned int d = 0; d < 256; d++) {
+        uint8_t c = secded8::encode(uint8_t(d));
+        for (unsigned int i = 0; i < secded8::CODE_BITS; i++) {
+            for (unsigned int j = i; j < secded8::CODE_BITS; j++) {
+                unsigned int mask = 1u << i | 1u << j;
+                uint8_t x = uint8_t(d ^ (mask & 0xFF)), y = uint8_t(c ^ (mask >> 8));
+                ecc_result r = secded8::decode(x, y);
+                if (i == j) {
+                    single++;
+                    if (r != ecc_result::corrected || x != d || y != c) failures++;
+                } else {
+                    dual++;
+                    if (r != ecc_result::uncorrectable) failures++;
+                }
+            }
+        }
+        uint8_t x = uint8_t(d), y = c;
+        if (secded8::decode(x, y) != ecc_result::ok) failures++;
+    }
+    std::cout << "  " << (failures ? "失败" : "通过") << ": SECDED穷举 " << single << " 个一位错误, "
+              << dual << " 个两位错误" << std::endl;
+    return failures;
+}
+
+static void print_row(const char* ecc, const campaign_config& cfg, const char* model, const model_result& r,
+                      double seconds) {
+    double per_m = r.injected ? 1e6 / double(r.injected) : 0.0;
+    std::cout << std::left << std::setw(6) << ecc << std::setw(10) << fault_pattern_name(cfg.fault.pattern)
+              << std::setw(15) << model << std::right << std::setw(10) << r.injected
+              << std::setw(11) << r.reads << std::setw(10) << r.corrected << std::setw(10) << r.detected
+              << std::setw(10) << r.silent << std::fixed << std::setprecision(1)
+              << std::setw(14) << r.silent * per_m;
+    if (seconds > 0) std::cout << std::setprecision(0) << std::setw(12) << 2 * r.injected / seconds;
+    std::cout << "\n";
+}
+
+// 用法: fault_campaign [运行数] [每次周期数] [并行数] [故障率] [模式|all] [ECC 0|1] [种子] [burst位数]
+//   模式: single adjacent double burst（burst翻转连续的若干位，默认3）；
+//   all依次运行ECC关闭的single和ECC打开的全部模式
+int sc_main(int argc, char* argv[]) {
+    unsigned int runs = argc > 1 ? std::stoul(argv[1]) : 32;
+    campaign_config cfg;
+    cfg.cycles = argc > 2 ? std::stoull(argv[2]) : 200000;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int jobs = argc > 3 ? std::stoul(argv[3]) : unsigned(cpus > 0 ? cpus : 1);
+    cfg.fault.rate = argc > 4 ? std::stod(argv[4]) : 0.05;
+    std::string mode = argc > 5 ? argv[5] : "all";
+    cfg.ecc = argc > 6 ? std::stoul(argv[6]) != 0 : true;
+    cfg.seed = argc > 7 ? std::stoull(argv[7]) : 1;
+    cfg.fault.burst = argc > 8 ? std::stoul(argv[8]) : 3;
+    cfg.fault.check_bits = true;
+    if (jobs == 0) jobs = 1;
+    if (runs == 0 || cfg.cycles == 0) {
+        std::cout << "运行数和周期数必须大于0" << std::endl;
+        return 1;
+    }
+    if (!(cfg.fault.rate >= 0.0 && cfg.fault.rate <= 1.0)) {
+        std::cout << "故障率应在0~1之间: " << cfg.fault.rate << std::endl;
+        return 1;
+    }
+    // 码字至少有8个数据位
+    if (cfg.fault.burst == 0 || cfg.fault.burst > 8) {
+        std::cout << "burst位数应在1~8之间: " << cfg.fault.burst << std::endl;
+        return 1;
+    }
+
+    std::vector<std::pair<bool, fault_pattern>> rows;
+    if (mode == "all") {
+        rows = {{false, fault_pattern::single}, {true, fault_pattern::single}, {true, fault_pattern::adjacent},
+                {true, fault_pattern::double_random}, {true, fault_pattern::burst}};
+    } else {
+        fault_pattern p;
+        if (!parse_fault_pattern(mode, p)) {
+            std::cout << "未知的故障模式: " << mode << std::endl;
+            return 1;
+        }
+        rows = {{cfg.ecc, p}};
+    }
+
+    std::cout << "===== 自检 =====" << std::endl;
+    int failures = check_secded();
+
+    std::cout << "\n===== 故障注入 (" << runs << "次运行 x " << cfg.cycles << "周期, " << jobs
+              << "个并行, 每个模型每周期故障率 " << cfg.fault.rate << ") =====\n";
+    std::cout << std::left << std::setw(6) << "ECC" << std::setw(10) << "模式" << std::setw(15) << "模型"
+              << std::right << std::setw(10) << "注入" << std::setw(11) << "检查的读" << std::setw(10) << "纠正"
+              << std::setw(10) << "检出" << std::setw(10) << "静默" << std::setw(14) << "静默/百万注入"
+              << std::setw(12) << "注入/s" << "\n";
+    for (const auto& row : rows) {
+        cfg.ecc = row.first;
+        cfg.fault.pattern = row.second;
+        run_result total;
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = run_campaign(cfg, runs, jobs, total);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (!ok) {
+            std::cout << "错误: 有运行失败\n";
+            failures++;
+            continue;
+        }
+        const char* ecc = cfg.ecc ? "on" : "off";
+        print_row(ecc, cfg, "ram", total.ram, 0);
+        print_row(ecc, cfg, "register_file", total.regs, seconds);
+        // ECC关闭时模型不会纠正或检出任何错误
+        if (!cfg.ecc && (total.ram.corrected || total.ram.detected || total.regs.corrected || total.regs.detected)) {
+            std::cout << "错误: ECC关闭时出现了纠正或检出\n";
+            failures++;
+        }
+    }
+
+    if (failures) {
+        std::cout << "\n===== 故障注入测试失败 (" << failures << "处错误) =====" << std::endl;
+        return 1;
+    }
+    std::cout << "\n===== 故障注入测试通过 =====" << std::endl;
+    return 0;
+}
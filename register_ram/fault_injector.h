@@ -0,0 +1,141 @@
+// File: fault_injector.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FAULT_INJECTOR_H
+#define FAULT_INJECTOR_H
+
+#include <systemc.h>
+#include <cstdint>
+#include <string>
+#include "ecc.h"
+#include "../common/stimulus.h"
+
+// 一次故障翻转的位型
+enum class fault_pattern {
+    single,         // 一位
+    adjacent,       // 相邻两位
+    double_random,  // 任意两位
+    burst           // 连续burst位
+};
+
+inline const char* fault_pattern_name(fault_pattern p) {
+    switch (p) {
+        case fault_pattern::single:        return "single";
+        case fault_pattern::adjacent:      return "adjacent";
+        case fault_pattern::double_random: return "double";
+        default:                           return "burst";
+    }
+}
+
+inline bool parse_fault_pattern(const std::string& s, fault_pattern& p) {
+    const fault_pattern all[] = {fault_pattern::single, fault_pattern::adjacent,
+                                 fault_pattern::double_random, fault_pattern::burst};
+    for (fault_pattern a : all) {
+        if (s == fault_pattern_name(a)) {
+            p = a;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct fault_config {
+    double rate;                // 每个周期发生一次故障的概率
+    fault_pattern pattern;
+    unsigned int burst;         // burst模式翻转的位数
+    bool check_bits;            // ECC打开时，故障也可能落在校验位上
+};
+
+// 一次故障：地址和码字翻转掩码（bit0~7数据位，bit8~12校验位）
+struct fault {
+    unsigned int addr;
+    unsigned int mask;
+};
+
+// 故障发生器：由(种子, 流编号)决定全部故障序列，与仿真内核无关
+class fault_generator {
+public:
+    fault_generator(uint64_t seed, uint64_t stream, unsigned int words, const fault_config& cfg)
+    : rng(seed, stream), words(words), cfg(cfg), thr(stim::philox_stream::threshold(cfg.rate)) {}
+
+    // 本周期是否发生故障
+    bool tick() { return rng.bernoulli_threshold(thr); }
+
+    // code_bits：码字中可能出错的位数（ECC关闭时8，打开时13或8）
+    fault next(unsigned int code_bits) {
+        fault f;
+        f.addr = unsigned(rng.uniform(0, words - 1));
+        f.mask = 0;
+        switch (cfg.pattern) {
+            case fault_pattern::single:
+                f.mask = 1u << rng.uniform(0, code_bits - 1);
+                break;
+            case fault_pattern::adjacent:
+                f.mask = 3u << rng.uniform(0, code_bits - 2);
+                break;
+            case fault_pattern::double_random: {
+                unsigned int a = unsigned(rng.uniform(0, code_bits - 1));
+                unsigned int b = unsigned(rng.uniform(0, code_bits - 2));
+                f.mask = 1u << a | 1u << (b >= a ? b + 1 : b);
+                break;
+            }
+            default: {
+                unsigned int n = cfg.burst < code_bits ? cfg.burst : code_bits;
+                f.mask = ((1u << n) - 1) << rng.uniform(0, code_bits - n);
+                break;
+            }
+        }
+        return f;
+    }
+
+private:
+    stim::philox_stream rng;
+    unsigned int words;
+    fault_config cfg;
+    uint64_t thr;
+};
+
+// 故障注入器：每个时钟下降沿以cfg.rate的概率向模型注入一次故障。
+// MODEL需要提供inject(addr, mask)和ecc（register_file和ram均已提供）
+template<typename MODEL>
+SC_MODULE(fault_injector) {
+    sc_in<bool> clk;
+
+    MODEL& model;
+    uint64_t injected;
+
+    SC_HAS_PROCESS(fault_injector);
+
+    void inject_process() {
+        if (!gen.tick()) return;
+        fault f = gen.next(model.ecc.enabled && cfg.check_bits ? secded8::CODE_BITS : 8);
+        model.inject(f.addr, f.mask);
+        injected++;
+    }
+
+    fault_injector(sc_module_name name, MODEL& m, const fault_config& cfg, uint64_t seed, uint64_t stream)
+    : sc_module(name), model(m), injected(0), cfg(cfg), gen(seed, stream, 16, cfg) {
+        SC_METHOD(inject_process);
+        sensitive << clk.neg();
+        dont_initialize();
+    }
+
+private:
+    fault_config cfg;
+    fault_generator gen;
+};
+
+#endif // FAULT_INJECTOR_H
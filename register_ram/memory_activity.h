@@ -0,0 +1,193 @@
+// File: memory_activity.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef MEMORY_ACTIVITY_H
+#define MEMORY_ACTIVITY_H
+
+#include <systemc.h>
+#include <functional>
+#include <string>
+#include "../common/power_window.h"
+
+// 16个8位存储单元的翻转计数
+// 监视器在时钟上升沿按端口上的写使能、地址和数据重放写操作，与影子副本异或得到翻转位数，
+// 不需要每周期扫描存储；仿真开始时通过peek取得初始内容（例如从文件初始化的值）。
+// 经poke的后门写入不会被计入。
+struct storage_probe {
+    unsigned int counter[16];
+    uint64_t shadow[16];
+    std::function<uint64_t(unsigned int)> peek;
+
+    void attach(pwr::activity& a, const std::string& name) {
+        for (unsigned int i = 0; i < 16; i++) {
+            counter[i] = a.add(name + "[" + std::to_string(i) + "]");
+            shadow[i] = 0;
+        }
+    }
+
+    void sync() {
+        if (!peek) return;
+        for (unsigned int i = 0; i < 16; i++) shadow[i] = peek(i);
+    }
+
+    void write(pwr::activity& a, unsigned int addr, uint64_t data) {
+        a.toggle(counter[addr], shadow[addr], data);
+        shadow[addr] = data;
+    }
+};
+
+// 寄存器堆开关活动监视器：端口翻转、每个寄存器的翻转、写次数和时钟周期
+SC_MODULE(register_file_activity) {
+    sc_in<bool> clk;
+    sc_in<sc_uint<4>> rd_addr;
+    sc_in<sc_uint<4>> wr_addr;
+    sc_in<sc_uint<8>> wr_data;
+    sc_in<bool> wr_en;
+    sc_in<sc_uint<8>> rd_data;
+
+    pwr::activity& act;
+    pwr::port_probe<sc_uint<4>> rd_addr_p, wr_addr_p;
+    pwr::port_probe<sc_uint<8>> wr_data_p, rd_data_p;
+    pwr::port_probe<bool> wr_en_p;
+    storage_probe regs;
+    unsigned int cycles;
+    unsigned int writes;
+
+    SC_HAS_PROCESS(register_file_activity);
+
+    void sample_ports() {
+        rd_addr_p.sample(act);
+        wr_addr_p.sample(act);
+        wr_data_p.sample(act);
+        wr_en_p.sample(act);
+        rd_data_p.sample(act);
+    }
+
+    // 上升沿读到的是本次时钟沿之前的值，正好是write_process写入时看到的值
+    void sample_clock() {
+        act.count(cycles);
+        if (wr_en.read()) {
+            act.count(writes);
+            regs.write(act, wr_addr.read().to_uint(), wr_data.read().to_uint64());
+        }
+    }
+
+    // 接上被监视的寄存器堆，仿真开始时用它的peek取得初始内容
+    template<typename M>
+    void attach(const M& m) {
+        regs.peek = [&m](unsigned int a) { return m.peek(a).to_uint64(); };
+    }
+
+    void start_of_simulation() override {
+        regs.sync();
+    }
+
+    register_file_activity(sc_module_name name, pwr::power_report& report)
+    : sc_module(name), act(report.add_module("register_file", basename())) {
+        rd_addr_p.attach(act, rd_addr, "rd_addr");
+        wr_addr_p.attach(act, wr_addr, "wr_addr");
+        wr_data_p.attach(act, wr_data, "wr_data");
+        wr_en_p.attach(act, wr_en, "wr_en");
+        rd_data_p.attach(act, rd_data, "rd_data");
+        regs.attach(act, "reg");
+        cycles = act.add("clk");
+        writes = act.add("write");
+
+        // 默认能量（pJ）：端口和存储按每位翻转，clk按每个周期，write按每次写入
+        pwr::energy_table& t = report.table();
+        t.set("register_file", "*", 0.01);
+        t.set("register_file", "reg", 0.05);
+        t.set("register_file", "clk", 0.2);
+        t.set("register_file", "write", 0.3);
+
+        SC_METHOD(sample_ports);
+        sensitive << rd_addr << wr_addr << wr_data << wr_en << rd_data;
+
+        SC_METHOD(sample_clock);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+};
+
+// RAM开关活动监视器：读写共用一个地址，其余与寄存器堆相同
+SC_MODULE(ram_activity) {
+    sc_in<bool> clk;
+    sc_in<sc_uint<4>> addr;
+    sc_in<sc_uint<8>> wr_data;
+    sc_in<bool> wr_en;
+    sc_in<sc_uint<8>> rd_data;
+
+    pwr::activity& act;
+    pwr::port_probe<sc_uint<4>> addr_p;
+    pwr::port_probe<sc_uint<8>> wr_data_p, rd_data_p;
+    pwr::port_probe<bool> wr_en_p;
+    storage_probe mem;
+    unsigned int cycles;
+    unsigned int writes;
+
+    SC_HAS_PROCESS(ram_activity);
+
+    void sample_ports() {
+        addr_p.sample(act);
+        wr_data_p.sample(act);
+        wr_en_p.sample(act);
+        rd_data_p.sample(act);
+    }
+
+    void sample_clock() {
+        act.count(cycles);
+        if (wr_en.read()) {
+            act.count(writes);
+            mem.write(act, addr.read().to_uint(), wr_data.read().to_uint64());
+        }
+    }
+
+    // 接上被监视的RAM，仿真开始时用它的peek取得初始内容
+    template<typename M>
+    void attach(const M& m) {
+        mem.peek = [&m](unsigned int a) { return m.peek(a).to_uint64(); };
+    }
+
+    void start_of_simulation() override {
+        mem.sync();
+    }
+
+    ram_activity(sc_module_name name, pwr::power_report& report)
+    : sc_module(name), act(report.add_module("ram", basename())) {
+        addr_p.attach(act, addr, "addr");
+        wr_data_p.attach(act, wr_data, "wr_data");
+        wr_en_p.attach(act, wr_en, "wr_en");
+        rd_data_p.attach(act, rd_data, "rd_data");
+        mem.attach(act, "mem");
+        cycles = act.add("clk");
+        writes = act.add("write");
+
+        pwr::energy_table& t = report.table();
+        t.set("ram", "*", 0.01);
+        t.set("ram", "mem", 0.08);
+        t.set("ram", "clk", 0.3);
+        t.set("ram", "write", 0.5);
+
+        SC_METHOD(sample_ports);
+        sensitive << addr << wr_data << wr_en << rd_data;
+
+        SC_METHOD(sample_clock);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+};
+
+#endif // MEMORY_ACTIVITY_H
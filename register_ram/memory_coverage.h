@@ -0,0 +1,84 @@
+// File: memory_coverage.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef MEMORY_COVERAGE_H
+#define MEMORY_COVERAGE_H
+
+#include <systemc.h>
+#include "../common/coverage.h"
+
+// 寄存器堆覆盖率监视器：每个地址是否被读过、写过
+// 读是组合逻辑，随rd_addr变化采样；写在时钟上升沿采样
+SC_MODULE(register_file_coverage) {
+    sc_in<bool> clk;
+    sc_in<sc_uint<4>> rd_addr;
+    sc_in<sc_uint<4>> wr_addr;
+    sc_in<bool> wr_en;
+
+    cov::covergroup group;
+    cov::coverpoint& read_cp;
+    cov::coverpoint& write_cp;
+
+    void sample_read() {
+        read_cp.sample(rd_addr.read().to_uint());
+    }
+
+    void sample_write() {
+        if (wr_en.read()) write_cp.sample(wr_addr.read().to_uint());
+    }
+
+    SC_CTOR(register_file_coverage)
+    : group("register_file"),
+      read_cp(group.add("read addr", 16)),
+      write_cp(group.add("write addr", 16)) {
+        SC_METHOD(sample_read);
+        sensitive << rd_addr;
+
+        SC_METHOD(sample_write);
+        sensitive << clk.pos();
+        dont_initialize();
+    }
+};
+
+// RAM覆盖率监视器：读写共用一个地址，写使能无效时的地址计为读
+SC_MODULE(ram_coverage) {
+    sc_in<bool> clk;
+    sc_in<sc_uint<4>> addr;
+    sc_in<bool> wr_en;
+
+    cov::covergroup group;
+    cov::coverpoint& read_cp;
+    cov::coverpoint& write_cp;
+
+    void sample() {
+        unsigned int a = addr.read().to_uint();
+        if (!wr_en.read()) {
+            read_cp.sample(a);
+        } else if (clk.posedge()) {
+            write_cp.sample(a);
+        }
+    }
+
+    SC_CTOR(ram_coverage)
+    : group("ram"),
+      read_cp(group.add("read addr", 16)),
+      write_cp(group.add("write addr", 16)) {
+        SC_METHOD(sample);
+        sensitive << clk.pos() << addr;
+    }
+};
+
+#endif // MEMORY_COVERAGE_H
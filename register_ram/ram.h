@@ -23,9 +23,14 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include "../common/datatypes.h"
+#include "watchpoint.h"
+#include "ecc.h"
 
 // 16个8位存储单元的RAM
-SC_MODULE(ram) {
+// P是内部存储的数据类型策略（见common/datatypes.h），端口类型与策略无关
+template<typename P>
+struct ram_t : sc_module {
     // 端口声明
     sc_in<bool> clk;               // 时钟
     sc_in<sc_uint<4>> addr;        // 地址（4位，可寻址16个存储单元）
@@ -34,19 +39,81 @@ SC_MODULE(ram) {
     sc_out<sc_uint<8>> rd_data;    // 读数据（8位）
 
     // 内部存储
-    sc_uint<8> memory[16];         // 16个8位存储单元
+    typename P::byte_type memory[16];      // 16个8位存储单元
+
+    // 观察点（见watchpoint.h）：端口读写和TLM访问触发，后门peek/poke不触发
+    watch_unit<4> watch;
+
+    // 可选的每字SECDED校验和纠错计数（见ecc.h），默认关闭，用enable_ecc()打开
+    ecc_store<16> ecc;
+
+    // 端口访问计数：地址变化时读出一次，时钟上升沿写使能有效时写入一次；后门访问不计
+    uint64_t reads;
+    uint64_t writes;
+
+    SC_HAS_PROCESS(ram_t);
 
     // 读写操作过程
     void process() {
-        // 读操作（组合逻辑，不需要时钟）
-        rd_data.write(memory[addr.read()]);
+        unsigned int a = addr.read().to_uint();
+
+        // 读操作（组合逻辑，不需要时钟）；只有地址变化才是一次读访问，
+        // 时钟上升沿只是按保持的地址刷新rd_data，不计数也不触发读观察点
+        bool read_access = addr.event();
+        if (read_access) reads++;
+        if (ecc.enabled) ecc_read(a);
+        if (read_access && watch.armed(a, WATCH_READ)) watch_access_hit(a, WATCH_READ, memory[a]);
+        rd_data.write(P::from_byte(memory[a]));
         
         // 写操作（时序逻辑，在时钟上升沿写入）
         if (clk.posedge() && wr_en.read()) {
-            memory[addr.read()] = wr_data.read();
+            typename P::byte_type v = P::to_byte(wr_data.read());
+            if (watch.armed(a, WATCH_WRITE)) watch_access_hit(a, WATCH_WRITE, v);
+            memory[a] = v;
+            writes++;
+            if (ecc.enabled) ecc.write(a, byte_value(v));
         }
     }
 
+    // 观察点的慢路径：v是读出或将要写入的值
+    void watch_access_hit(unsigned int a, watch_access access, typename P::byte_type v) {
+        watch.check(name(), a, access, P::from_byte(memory[a]).to_uint(), P::from_byte(v).to_uint());
+    }
+
+    // ECC读出：一位错误纠正后写回存储（读时擦洗）
+    void ecc_read(unsigned int a) {
+        uint8_t d = byte_value(memory[a]);
+        if (ecc.read(a, d) == ecc_result::corrected) memory[a] = P::to_byte(d);
+    }
+
+    static uint8_t byte_value(typename P::byte_type v) { return uint8_t(P::from_byte(v).to_uint()); }
+
+    // 后门访问：不经过端口、不消耗仿真时间，直接读写存储
+    // 注意poke不会刷新rd_data端口，下一次地址变化或时钟上升沿后才可见
+    sc_uint<8> peek(unsigned int a) const {
+        return P::from_byte(memory[a & 0xF]);
+    }
+
+    void poke(unsigned int a, sc_uint<8> data) {
+        memory[a & 0xF] = P::to_byte(data);
+        if (ecc.enabled) ecc.write(a & 0xF, uint8_t(data.to_uint()));
+    }
+
+    // 打开或关闭ECC；打开时按当前内容重新计算全部校验位，纠错计数清零
+    void enable_ecc(bool on) {
+        ecc.enabled = on;
+        ecc.corrected = 0;
+        ecc.uncorrected = 0;
+        for (unsigned int i = 0; i < 16; i++) ecc.write(i, byte_value(memory[i]));
+    }
+
+    // 故障注入：翻转地址a处码字中mask指定的位，bit0~7是数据位，bit8~12是校验位（ECC关闭时忽略）
+    void inject(unsigned int a, unsigned int mask) {
+        a &= 0xF;
+        memory[a] = P::to_byte(sc_uint<8>(byte_value(memory[a]) ^ (mask & 0xFF)));
+        if (ecc.enabled) ecc.check[a] ^= uint8_t((mask >> 8) & 0x1F);
+    }
+
     // 初始化RAM
     void initialize(const std::string& filename) {
         std::ifstream file(filename);
@@ -76,7 +143,7 @@ SC_MODULE(ram) {
                 ss_data >> data;
                 
                 if (addr >= 0 && addr < 16) {
-                    memory[addr] = data;
+                    poke(addr, data);
                     std::cout << "初始化RAM[" << addr << "] = 0x" 
                               << std::hex << std::setw(2) << std::setfill('0') 
                               << data << std::dec << std::endl;
@@ -88,7 +155,7 @@ SC_MODULE(ram) {
     }
 
     // 构造函数
-    SC_CTOR(ram) {
+    ram_t(sc_module_name name) : sc_module(name), reads(0), writes(0) {
         for (int i = 0; i < 16; i++) {
             memory[i] = 0;  // 默认初始化为0
         }
@@ -101,4 +168,12 @@ SC_MODULE(ram) {
     }
 };
 
+typedef ram_t<default_datatypes> ram;
+
+#ifdef SC_MODELS_LIB
+// 这些实例已在models/libscmodels.a中编译（见build.mk）
+extern template struct ram_t<sc_datatypes>;
+extern template struct ram_t<native_datatypes>;
+#endif
+
 #endif // RAM_H
@@ -23,9 +23,14 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include "../common/datatypes.h"
+#include "watchpoint.h"
+#include "ecc.h"
 
 // 16个8位寄存器的寄存器堆
-SC_MODULE(register_file) {
+// P是内部存储的数据类型策略（见common/datatypes.h），端口类型与策略无关
+template<typename P>
+struct register_file_t : sc_module {
     // 端口声明
     sc_in<bool> clk;               // 时钟
     sc_in<sc_uint<4>> rd_addr;     // 读地址（4位，可寻址16个寄存器）
@@ -35,20 +40,74 @@ SC_MODULE(register_file) {
     sc_out<sc_uint<8>> rd_data;    // 读数据（8位）
 
     // 内部存储
-    sc_uint<8> registers[16];      // 16个8位寄存器
+    typename P::byte_type registers[16];   // 16个8位寄存器
+
+    // 观察点（见watchpoint.h）：端口读写和TLM访问触发，后门peek/poke不触发
+    watch_unit<4> watch;
+
+    // 可选的每字SECDED校验和纠错计数（见ecc.h），默认关闭，用enable_ecc()打开
+    ecc_store<16> ecc;
+
+    SC_HAS_PROCESS(register_file_t);
 
     // 读操作过程（组合逻辑，不需要时钟）
     void read_process() {
-        rd_data.write(registers[rd_addr.read()]);
+        unsigned int a = rd_addr.read().to_uint();
+        if (ecc.enabled) ecc_read(a);
+        if (watch.armed(a, WATCH_READ)) watch_access_hit(a, WATCH_READ, registers[a]);
+        rd_data.write(P::from_byte(registers[a]));
     }
 
     // 写操作过程（时序逻辑，在时钟上升沿写入）
     void write_process() {
         if (clk.posedge() && wr_en.read()) {
-            registers[wr_addr.read()] = wr_data.read();
+            unsigned int a = wr_addr.read().to_uint();
+            typename P::byte_type v = P::to_byte(wr_data.read());
+            if (watch.armed(a, WATCH_WRITE)) watch_access_hit(a, WATCH_WRITE, v);
+            registers[a] = v;
+            if (ecc.enabled) ecc.write(a, byte_value(v));
         }
     }
 
+    // 观察点的慢路径：v是读出或将要写入的值
+    void watch_access_hit(unsigned int a, watch_access access, typename P::byte_type v) {
+        watch.check(name(), a, access, P::from_byte(registers[a]).to_uint(), P::from_byte(v).to_uint());
+    }
+
+    // ECC读出：一位错误纠正后写回存储（读时擦洗）
+    void ecc_read(unsigned int a) {
+        uint8_t d = byte_value(registers[a]);
+        if (ecc.read(a, d) == ecc_result::corrected) registers[a] = P::to_byte(d);
+    }
+
+    static uint8_t byte_value(typename P::byte_type v) { return uint8_t(P::from_byte(v).to_uint()); }
+
+    // 后门访问：不经过端口、不消耗仿真时间，直接读写寄存器
+    // 注意poke不会刷新rd_data端口，下一次读地址变化后才可见
+    sc_uint<8> peek(unsigned int a) const {
+        return P::from_byte(registers[a & 0xF]);
+    }
+
+    void poke(unsigned int a, sc_uint<8> data) {
+        registers[a & 0xF] = P::to_byte(data);
+        if (ecc.enabled) ecc.write(a & 0xF, uint8_t(data.to_uint()));
+    }
+
+    // 打开或关闭ECC；打开时按当前内容重新计算全部校验位，纠错计数清零
+    void enable_ecc(bool on) {
+        ecc.enabled = on;
+        ecc.corrected = 0;
+        ecc.uncorrected = 0;
+        for (unsigned int i = 0; i < 16; i++) ecc.write(i, byte_value(registers[i]));
+    }
+
+    // 故障注入：翻转地址a处码字中mask指定的位，bit0~7是数据位，bit8~12是校验位（ECC关闭时忽略）
+    void inject(unsigned int a, unsigned int mask) {
+        a &= 0xF;
+        registers[a] = P::to_byte(sc_uint<8>(byte_value(registers[a]) ^ (mask & 0xFF)));
+        if (ecc.enabled) ecc.check[a] ^= uint8_t((mask >> 8) & 0x1F);
+    }
+
     // 初始化寄存器
     void initialize(const std::string& filename) {
         std::ifstream file(filename);
@@ -78,7 +137,7 @@ SC_MODULE(register_file) {
                 ss_data >> data;
                 
                 if (addr >= 0 && addr < 16) {
-                    registers[addr] = data;
+                    poke(addr, data);
                     std::cout << "初始化寄存器[" << addr << "] = 0x" 
                               << std::hex << std::setw(2) << std::setfill('0') 
                               << data << std::dec << std::endl;
@@ -90,7 +149,7 @@ SC_MODULE(register_file) {
     }
 
     // 构造函数
-    SC_CTOR(register_file) {
+    register_file_t(sc_module_name name) : sc_module(name) {
         for (int i = 0; i < 16; i++) {
             registers[i] = 0;  // 默认初始化为0
         }
@@ -106,4 +165,12 @@ SC_MODULE(register_file) {
     }
 };
 
+typedef register_file_t<default_datatypes> register_file;
+
+#ifdef SC_MODELS_LIB
+// 这些实例已在models/libscmodels.a中编译（见build.mk）
+extern template struct register_file_t<sc_datatypes>;
+extern template struct register_file_t<native_datatypes>;
+#endif
+
 #endif // REGISTER_FILE_H
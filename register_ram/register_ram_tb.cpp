@@ -16,8 +16,13 @@
 
 #include <systemc.h>
 #include <iomanip>
+#include <cstdlib>
 #include "register_file.h"
 #include "ram.h"
+#include "memory_coverage.h"
+#include "memory_activity.h"
+#include "../common/scoreboard.h"
+#include "../common/txn_probe.h"
 
 SC_MODULE(register_ram_tb) {
     // 信号
@@ -40,6 +45,38 @@ SC_MODULE(register_ram_tb) {
     register_file reg_file;
     ram memory;
     
+    // 覆盖率监视器
+    register_file_coverage reg_cov;
+    ram_coverage ram_cov;
+    
+    // 开关活动与能量估算：每100ns一个窗口，写入register_ram_power.csv
+    pwr::power_report power;
+    register_file_activity reg_act;
+    ram_activity ram_act;
+    pwr::power_window power_win;
+    
+    // 参考模型：两块存储的影子副本，读出的数据交给记分板与其比较
+    unsigned int reg_shadow[16];
+    unsigned int ram_shadow[16];
+    scoreboard<unsigned int> reg_sb;
+    scoreboard<unsigned int> ram_sb;
+    
+    // 测试结果，仿真结束后由sc_main作为退出码返回
+    bool passed;
+    
+    // 事务日志：设置TXN_LOG时在每个时钟下降沿记录全部端口值，用于黄金输出比较
+    txn::probe txn_log;
+    
+    void check_reg(int i) {
+        reg_sb.expect(reg_shadow[i]);
+        reg_sb.actual(reg_rd_data.read().to_uint());
+    }
+    
+    void check_ram(int i) {
+        ram_sb.expect(ram_shadow[i]);
+        ram_sb.actual(ram_rd_data.read().to_uint());
+    }
+    
     // 辅助方法：十六进制显示
     void print_hex(const char* name, int value) {
         std::cout << name << ": 0x" << std::hex << std::setw(2) 
@@ -52,10 +89,17 @@ SC_MODULE(register_ram_tb) {
         wait(10, SC_NS);
         std::cout << "\n===== 初始状态 =====\n";
         
+        // 初值由mem1.txt加载，以加载后的存储内容作为参考模型的起点
+        for (int i = 0; i < 16; i++) {
+            reg_shadow[i] = reg_file.peek(i).to_uint();
+            ram_shadow[i] = memory.peek(i).to_uint();
+        }
+        
         // 读取寄存器初始值
         for (int i = 0; i < 16; i++) {
             reg_rd_addr.write(i);
             wait(5, SC_NS);
+            check_reg(i);
             std::cout << "寄存器[" << i << "]: 0x" << std::hex << std::setw(2) 
                       << std::setfill('0') << reg_rd_data.read().to_uint() << std::dec << std::endl;
         }
@@ -65,6 +109,7 @@ SC_MODULE(register_ram_tb) {
         for (int i = 0; i < 16; i++) {
             ram_addr.write(i);
             wait(5, SC_NS);
+            check_ram(i);
             std::cout << "RAM[" << i << "]: 0x" << std::hex << std::setw(2) 
                       << std::setfill('0') << ram_rd_data.read().to_uint() << std::dec << std::endl;
         }
@@ -75,6 +120,7 @@ SC_MODULE(register_ram_tb) {
         for (int i = 0; i < 16; i++) {
             reg_wr_addr.write(i);
             reg_wr_data.write(0xA0 + i);  // 写入新数据
+            reg_shadow[i] = 0xA0 + i;
             wait(10, SC_NS);  // 等待写入完成
         }
         reg_wr_en.write(false);
@@ -85,6 +131,7 @@ SC_MODULE(register_ram_tb) {
         for (int i = 0; i < 16; i++) {
             reg_rd_addr.write(i);
             wait(5, SC_NS);
+            check_reg(i);
             print_hex(("寄存器[" + std::to_string(i) + "]").c_str(), reg_rd_data.read().to_uint());
         }
         
@@ -94,6 +141,7 @@ SC_MODULE(register_ram_tb) {
         for (int i = 0; i < 16; i++) {
             ram_addr.write(i);
             ram_wr_data.write(0x50 + i);  // 写入新数据
+            ram_shadow[i] = 0x50 + i;
             wait(10, SC_NS);  // 等待写入完成
         }
         ram_wr_en.write(false);
@@ -104,6 +152,7 @@ SC_MODULE(register_ram_tb) {
         for (int i = 0; i < 16; i++) {
             ram_addr.write(i);
             wait(5, SC_NS);
+            check_ram(i);
             print_hex(("RAM[" + std::to_string(i) + "]").c_str(), ram_rd_data.read().to_uint());
         }
         
@@ -114,6 +163,8 @@ SC_MODULE(register_ram_tb) {
             reg_rd_addr.write(i);
             wait(5, SC_NS);
             sc_uint<8> data = reg_rd_data.read();
+            check_reg(i);
+            ram_shadow[15 - i] = reg_shadow[i];
             
             // 写RAM
             ram_wr_en.write(true);
@@ -133,10 +184,19 @@ SC_MODULE(register_ram_tb) {
         for (int i = 8; i < 16; i++) {
             ram_addr.write(i);
             wait(5, SC_NS);
+            check_ram(i);
             print_hex(("RAM[" + std::to_string(i) + "]").c_str(), ram_rd_data.read().to_uint());
         }
         
-        std::cout << "\n===== 测试完成 =====\n";
+        std::cout << "\n";
+        reg_sb.report();
+        ram_sb.report();
+        reg_cov.group.report();
+        ram_cov.group.report();
+        reg_cov.group.save("register_file.cov");
+        ram_cov.group.save("ram.cov");
+        passed = reg_sb.passed() && ram_sb.passed();
+        std::cout << "\n===== 测试" << (passed ? "通过" : "失败") << " =====\n";
         sc_stop();
     }
     
@@ -144,7 +204,16 @@ SC_MODULE(register_ram_tb) {
     SC_CTOR(register_ram_tb) 
     : clk("clk", 10, SC_NS),  // 10ns周期的时钟
       reg_file("register_file_inst"),
-      memory("ram_inst") {
+      memory("ram_inst"),
+      reg_cov("reg_cov"),
+      ram_cov("ram_cov"),
+      reg_act("reg_act", power),
+      ram_act("ram_act", power),
+      power_win("power_window", power, sc_time(100, SC_NS)),
+      reg_sb("register_file", 4),
+      ram_sb("ram", 4),
+      passed(false),
+      txn_log("txn_log", clk.negedge_event()) {
         
         // 连接寄存器堆
         reg_file.clk(clk);
@@ -161,6 +230,45 @@ SC_MODULE(register_ram_tb) {
         memory.wr_en(ram_wr_en);
         memory.rd_data(ram_rd_data);
         
+        // 覆盖率监视器接在相同的信号上
+        reg_cov.clk(clk);
+        reg_cov.rd_addr(reg_rd_addr);
+        reg_cov.wr_addr(reg_wr_addr);
+        reg_cov.wr_en(reg_wr_en);
+        ram_cov.clk(clk);
+        ram_cov.addr(ram_addr);
+        ram_cov.wr_en(ram_wr_en);
+        
+        // 开关活动监视器接在相同的信号上，存储的初始内容在仿真开始时通过peek取得
+        reg_act.clk(clk);
+        reg_act.rd_addr(reg_rd_addr);
+        reg_act.wr_addr(reg_wr_addr);
+        reg_act.wr_data(reg_wr_data);
+        reg_act.wr_en(reg_wr_en);
+        reg_act.rd_data(reg_rd_data);
+        reg_act.attach(reg_file);
+        ram_act.clk(clk);
+        ram_act.addr(ram_addr);
+        ram_act.wr_data(ram_wr_data);
+        ram_act.wr_en(ram_wr_en);
+        ram_act.rd_data(ram_rd_data);
+        ram_act.attach(memory);
+        
+        // 监视器已写入默认能量，ENERGY_TABLE指定的能量表文件覆盖其中的条目
+        if (const char* f = std::getenv("ENERGY_TABLE")) power.table().load(f);
+        power.open("register_ram_power.csv", pwr::format::csv, true);
+        
+        txn_log.add("reg_rd_addr", reg_rd_addr);
+        txn_log.add("reg_wr_addr", reg_wr_addr);
+        txn_log.add("reg_wr_data", reg_wr_data);
+        txn_log.add("reg_wr_en", reg_wr_en);
+        txn_log.add("reg_rd_data", reg_rd_data);
+        txn_log.add("ram_addr", ram_addr);
+        txn_log.add("ram_wr_data", ram_wr_data);
+        txn_log.add("ram_wr_en", ram_wr_en);
+        txn_log.add("ram_rd_data", ram_rd_data);
+        txn_log.open_env();
+        
         // 注册测试进程
         SC_THREAD(test_process);
         sensitive << clk.posedge_event();  
@@ -200,5 +308,5 @@ int sc_main(int argc, char* argv[]) {
     // 开始仿真
     sc_start();
     
-    return 0;
+    return tb.passed ? 0 : 1;
 }
@@ -0,0 +1,323 @@
+// File: register_ram_td.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <tlm_utils/tlm_quantumkeeper.h>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include "register_file.h"
+#include "ram.h"
+#include "tlm_target.h"
+
+// 时间解耦发起方：重复register_ram_tb中的访问序列
+// 同步模式下每次访问后都wait(delay)；解耦模式下由tlm_quantumkeeper累积本地时间，
+// 只在本地时间超过全局量子时才与内核同步。
+// 参考模式不经过TLM和模型，在两个影子数组上执行同一序列，给出期望的摘要和结束时的存储内容
+SC_MODULE(td_initiator) {
+    tlm_utils::simple_initiator_socket<td_initiator> reg_socket;
+    tlm_utils::simple_initiator_socket<td_initiator> ram_socket;
+
+    tlm_utils::tlm_quantumkeeper qk;
+    bool decoupled;                // 当前是否处于时间解耦模式
+    bool reference;                // 当前是否在影子数组上运行参考序列
+    uint64_t accesses;             // 已完成的访问次数
+    uint64_t checksum;             // 所有读出数据的摘要
+
+    tlm::tlm_generic_payload trans;
+    unsigned char data;
+
+    // 运行结果
+    struct result {
+        double seconds;
+        uint64_t accesses;
+        uint64_t checksum;
+        sc_time sim_time;
+        unsigned char reg_final[16];   // 序列结束时寄存器堆和RAM的内容
+        unsigned char ram_final[16];
+    };
+    result lockstep_result;
+    result decoupled_result;
+    result reference_result;
+    uint64_t target_accesses;
+
+    // 被访问的模型：每种模式开始前经后门恢复仿真开始时的内容，两次运行从相同的状态出发
+    register_file* reg_model;
+    ram* ram_model;
+    sc_uint<8> reg_image[16];
+    sc_uint<8> ram_image[16];
+    unsigned char reg_shadow[16];
+    unsigned char ram_shadow[16];
+
+    SC_HAS_PROCESS(td_initiator);
+
+    // 发起一次单字节访问
+    unsigned char access(tlm_utils::simple_initiator_socket<td_initiator>& socket,
+                         tlm::tlm_command cmd, unsigned int addr, unsigned char value) {
+        data = value;
+        trans.set_command(cmd);
+        trans.set_address(addr);
+        trans.set_data_ptr(&data);
+        trans.set_data_length(1);
+        trans.set_streaming_width(1);
+        trans.set_byte_enable_ptr(nullptr);
+        trans.set_dmi_allowed(false);
+        trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+
+        if (decoupled) {
+            sc_time delay = qk.get_local_time();
+            socket->b_transport(trans, delay);
+            qk.set(delay);
+            if (qk.need_sync()) {
+                qk.sync();
+            }
+        } else {
+            sc_time delay = SC_ZERO_TIME;
+            socket->b_transport(trans, delay);
+            wait(delay);
+        }
+
+        if (trans.is_response_error()) {
+            SC_REPORT_ERROR("td_initiator", trans.get_response_string().c_str());
+        }
+        accesses++;
+        return data;
+    }
+
+    // 参考模式下的一次访问：直接读写影子数组
+    unsigned char shadow_access(unsigned char* mem, tlm::tlm_command cmd, unsigned int addr,
+                                unsigned char value) {
+        if (cmd == tlm::TLM_WRITE_COMMAND) mem[addr] = value;
+        accesses++;
+        return mem[addr];
+    }
+
+    unsigned char read_reg(unsigned int a) {
+        return reference ? shadow_access(reg_shadow, tlm::TLM_READ_COMMAND, a, 0)
+                         : access(reg_socket, tlm::TLM_READ_COMMAND, a, 0);
+    }
+    void write_reg(unsigned int a, unsigned char v) {
+        if (reference) shadow_access(reg_shadow, tlm::TLM_WRITE_COMMAND, a, v);
+        else access(reg_socket, tlm::TLM_WRITE_COMMAND, a, v);
+    }
+    unsigned char read_ram(unsigned int a) {
+        return reference ? shadow_access(ram_shadow, tlm::TLM_READ_COMMAND, a, 0)
+                         : access(ram_socket, tlm::TLM_READ_COMMAND, a, 0);
+    }
+    void write_ram(unsigned int a, unsigned char v) {
+        if (reference) shadow_access(ram_shadow, tlm::TLM_WRITE_COMMAND, a, v);
+        else access(ram_socket, tlm::TLM_WRITE_COMMAND, a, v);
+    }
+
+    void mix(unsigned char v) {
+        checksum = (checksum ^ v) * 1099511628211ULL;
+    }
+
+    // register_ram_tb中的一轮序列：读初值、写寄存器、写RAM、寄存器到RAM传输
+    void run_round(unsigned int round) {
+        for (int i = 0; i < 16; i++) mix(read_reg(i));
+        for (int i = 0; i < 16; i++) mix(read_ram(i));
+
+        for (int i = 0; i < 16; i++) write_reg(i, 0xA0 + i + round);
+        for (int i = 0; i < 16; i++) mix(read_reg(i));
+
+        for (int i = 0; i < 16; i++) write_ram(i, 0x50 + i + round);
+        for (int i = 0; i < 16; i++) mix(read_ram(i));
+
+        for (int i = 0; i < 8; i++) {
+            unsigned char v = read_reg(i);
+            write_ram(15 - i, v);
+        }
+        for (int i = 8; i < 16; i++) mix(read_ram(i));
+    }
+
+    // 以当前模式运行序列直到达到目标访问次数
+    result run_sequence() {
+        accesses = 0;
+        checksum = 14695981039346656037ULL;
+        sc_time start_time = sc_time_stamp();
+        auto start = std::chrono::steady_clock::now();
+
+        qk.reset();
+        for (unsigned int round = 0; accesses < target_accesses; round++) {
+            run_round(round);
+        }
+        if (decoupled) {
+            qk.sync();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        result r;
+        r.seconds = std::chrono::duration<double>(end - start).count();
+        r.accesses = accesses;
+        r.checksum = checksum;
+        r.sim_time = sc_time_stamp() - start_time;
+        for (unsigned int i = 0; i < 16; i++) {
+            r.reg_final[i] = reference ? reg_shadow[i] : reg_model->peek(i).to_uint();
+            r.ram_final[i] = reference ? ram_shadow[i] : ram_model->peek(i).to_uint();
+        }
+        return r;
+    }
+
+    void restore() {
+        for (unsigned int i = 0; i < 16; i++) {
+            reg_model->poke(i, reg_image[i]);
+            ram_model->poke(i, ram_image[i]);
+        }
+    }
+
+    void test_process() {
+        for (unsigned int i = 0; i < 16; i++) {
+            reg_image[i] = reg_model->peek(i);
+            ram_image[i] = ram_model->peek(i);
+        }
+
+        decoupled = false;
+        lockstep_result = run_sequence();
+
+        restore();
+        decoupled = true;
+        decoupled_result = run_sequence();
+
+        for (unsigned int i = 0; i < 16; i++) {
+            reg_shadow[i] = reg_image[i].to_uint();
+            ram_shadow[i] = ram_image[i].to_uint();
+        }
+        decoupled = false;
+        reference = true;
+        reference_result = run_sequence();
+
+        sc_stop();
+    }
+
+    td_initiator(sc_module_name name, uint64_t target)
+    : sc_module(name), reg_socket("reg_socket"), ram_socket("ram_socket"),
+      decoupled(false), reference(false), accesses(0), checksum(0), data(0), target_accesses(target),
+      reg_model(nullptr), ram_model(nullptr) {
+        SC_THREAD(test_process);
+    }
+};
+
+// 测试顶层：模型端口接在静止的信号上，所有访问都经过TLM后门适配器
+SC_MODULE(register_ram_td) {
+    sc_signal<bool> clk;
+    sc_signal<sc_uint<4>> reg_rd_addr;
+    sc_signal<sc_uint<4>> reg_wr_addr;
+    sc_signal<sc_uint<8>> reg_wr_data;
+    sc_signal<bool> reg_wr_en;
+    sc_signal<sc_uint<8>> reg_rd_data;
+
+    sc_signal<sc_uint<4>> ram_addr;
+    sc_signal<sc_uint<8>> ram_wr_data;
+    sc_signal<bool> ram_wr_en;
+    sc_signal<sc_uint<8>> ram_rd_data;
+
+    register_file reg_file;
+    ram memory;
+    memory_tlm_target<register_file> reg_target;
+    memory_tlm_target<ram> ram_target;
+    td_initiator initiator;
+
+    register_ram_td(sc_module_name name, uint64_t target_accesses)
+    : sc_module(name),
+      reg_file("register_file_inst"),
+      memory("ram_inst"),
+      // 延迟与register_ram_tb中的等待时间一致：读5ns，写10ns
+      reg_target("reg_target", reg_file, sc_time(5, SC_NS), sc_time(10, SC_NS)),
+      ram_target("ram_target", memory, sc_time(5, SC_NS), sc_time(10, SC_NS)),
+      initiator("initiator", target_accesses) {
+
+        reg_file.clk(clk);
+        reg_file.rd_addr(reg_rd_addr);
+        reg_file.wr_addr(reg_wr_addr);
+        reg_file.wr_data(reg_wr_data);
+        reg_file.wr_en(reg_wr_en);
+        reg_file.rd_data(reg_rd_data);
+
+        memory.clk(clk);
+        memory.addr(ram_addr);
+        memory.wr_data(ram_wr_data);
+        memory.wr_en(ram_wr_en);
+        memory.rd_data(ram_rd_data);
+
+        initiator.reg_socket.bind(reg_target.socket);
+        initiator.ram_socket.bind(ram_target.socket);
+        initiator.reg_model = &reg_file;
+        initiator.ram_model = &memory;
+    }
+};
+
+void print_result(const char* name, const td_initiator::result& r) {
+    std::cout << std::left << std::setw(12) << name << std::right
+              << std::setw(10) << r.accesses
+              << std::setw(12) << std::fixed << std::setprecision(3) << r.seconds
+              << std::setw(14) << std::setprecision(0) << (r.accesses / r.seconds)
+              << "  " << r.sim_time
+              << "  0x" << std::hex << r.checksum << std::dec << std::endl;
+}
+
+// 读数据摘要、访问次数和结束时的存储内容都与参考序列相同
+bool matches(const td_initiator::result& r, const td_initiator::result& ref) {
+    if (r.checksum != ref.checksum || r.accesses != ref.accesses) return false;
+    for (unsigned int i = 0; i < 16; i++) {
+        if (r.reg_final[i] != ref.reg_final[i] || r.ram_final[i] != ref.ram_final[i]) return false;
+    }
+    return true;
+}
+
+// 用法: register_ram_td [量子ns] [访问次数]
+int sc_main(int argc, char* argv[]) {
+    double quantum_ns = argc > 1 ? std::stod(argv[1]) : 1000.0;
+    uint64_t target = argc > 2 ? std::stoull(argv[2]) : 1000000;
+
+    tlm_utils::tlm_quantumkeeper::set_global_quantum(sc_time(quantum_ns, SC_NS));
+
+    register_ram_td top("top", target);
+    top.reg_file.initialize("./mem1.txt");
+    top.memory.initialize("./mem1.txt");
+
+    sc_start();
+
+    const td_initiator::result& lock = top.initiator.lockstep_result;
+    const td_initiator::result& td = top.initiator.decoupled_result;
+
+    std::cout << "\n===== 时间解耦测试（量子 " << quantum_ns << " ns）=====\n";
+    std::cout << std::left << std::setw(12) << "模式" << std::right
+              << std::setw(10) << "访问次数" << std::setw(12) << "时间(s)"
+              << std::setw(14) << "访问/s" << "  仿真时间  摘要\n";
+    print_result("逐次同步", lock);
+    print_result("时间解耦", td);
+    std::cout << "加速比: " << std::setprecision(2) << (lock.seconds / td.seconds) << "x\n";
+
+    const td_initiator::result& ref = top.initiator.reference_result;
+    std::cout << "参考序列摘要: 0x" << std::hex << ref.checksum << std::dec << std::endl;
+
+    // 两种模式都经过同一个后门适配器，彼此比较只能发现时序上的差别；
+    // 读数据摘要和结束时的存储内容还要与不经过模型的参考序列比较
+    bool same_time = lock.sim_time == td.sim_time;
+    bool lock_ok = matches(lock, ref);
+    bool td_ok = matches(td, ref);
+    std::cout << "仿真时间" << (same_time ? "一致" : "不一致")
+              << ", 逐次同步与参考序列" << (lock_ok ? "一致" : "不一致")
+              << ", 时间解耦与参考序列" << (td_ok ? "一致" : "不一致") << std::endl;
+
+    bool ok = same_time && lock_ok && td_ok;
+    std::cout << (ok ? "\n===== 两种模式结果一致 =====\n"
+                     : "\n===== 错误: 两种模式结果不一致 =====\n");
+    return ok ? 0 : 1;
+}
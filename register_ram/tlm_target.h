@@ -0,0 +1,75 @@
+// File: tlm_target.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TLM_TARGET_H
+#define TLM_TARGET_H
+
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_target_socket.h>
+
+// 存储模型的TLM-2.0松散定时（LT）适配器
+// MODEL需要提供peek(addr)/poke(addr, data)后门接口、watch观察点和ecc校验（register_file和ram均已提供）
+// b_transport不等待，只在delay上累加访问延迟，由发起方决定何时与内核同步
+template<typename MODEL>
+SC_MODULE(memory_tlm_target) {
+    tlm_utils::simple_target_socket<memory_tlm_target> socket;
+
+    MODEL& model;
+    sc_time read_latency;          // 读访问延迟
+    sc_time write_latency;         // 写访问延迟
+
+    SC_HAS_PROCESS(memory_tlm_target);
+
+    // 阻塞传输：每次访问一个字节，地址范围0~15
+    void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+        sc_dt::uint64 addr = trans.get_address();
+        unsigned char* ptr = trans.get_data_ptr();
+
+        if (addr >= 16) {
+            trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+            return;
+        }
+        if (trans.get_data_length() != 1 || trans.get_byte_enable_ptr() != nullptr) {
+            trans.set_response_status(tlm::TLM_BURST_ERROR_RESPONSE);
+            return;
+        }
+
+        unsigned int a = unsigned(addr);
+        if (trans.get_command() == tlm::TLM_READ_COMMAND) {
+            if (model.ecc.enabled) model.ecc_read(a);
+            *ptr = model.peek(a).to_uint();
+            if (model.watch.armed(a, WATCH_READ)) model.watch.check(model.name(), a, WATCH_READ, *ptr, *ptr);
+            delay += read_latency;
+        } else if (trans.get_command() == tlm::TLM_WRITE_COMMAND) {
+            if (model.watch.armed(a, WATCH_WRITE)) {
+                model.watch.check(model.name(), a, WATCH_WRITE, model.peek(a).to_uint(), *ptr);
+            }
+            model.poke(a, *ptr);
+            delay += write_latency;
+        }
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    }
+
+    memory_tlm_target(sc_module_name name, MODEL& m,
+                      const sc_time& rd_lat, const sc_time& wr_lat)
+    : sc_module(name), socket("socket"), model(m),
+      read_latency(rd_lat), write_latency(wr_lat) {
+        socket.register_b_transport(this, &memory_tlm_target::b_transport);
+    }
+};
+
+#endif // TLM_TARGET_H
@@ -0,0 +1,221 @@
+// File: trace_reader.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TRACE_READER_H
+#define TRACE_READER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 存储访问轨迹的二进制格式（小端）
+// 文件头之后是定长记录，每条记录16字节，可以直接映射成数组使用，无需解析
+struct trace_record {
+    uint64_t timestamp;    // 访问发生的时钟周期
+    uint32_t addr;         // 地址（回放时按模型地址宽度截断）
+    uint16_t data;         // 写数据，或读访问时观测到的读数据
+    uint8_t  flags;        // bit0: 1写 0读
+    uint8_t  reserved;
+
+    bool is_write() const { return flags & TRACE_WRITE; }
+
+    static constexpr uint8_t TRACE_WRITE = 1;
+};
+
+static_assert(sizeof(trace_record) == 16, "trace_record必须是16字节");
+
+struct trace_header {
+    char     magic[8];     // "SCTRACE1"
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t count;        // 记录条数
+
+    static constexpr uint32_t VERSION = 1;
+};
+
+static_assert(sizeof(trace_header) == 24, "trace_header必须是24字节");
+
+// 轨迹写入：带缓冲的顺序写，关闭时回填记录条数
+class trace_writer {
+public:
+    trace_writer() : file(nullptr), count(0) {}
+    ~trace_writer() { close(); }
+
+    bool open(const std::string& path) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        buffer.reserve(BUFFER_RECORDS);
+        count = 0;
+        trace_header h = make_header(0);
+        return std::fwrite(&h, sizeof(h), 1, file) == 1;
+    }
+
+    void write(const trace_record& r) {
+        buffer.push_back(r);
+        if (buffer.size() == BUFFER_RECORDS) flush();
+    }
+
+    void close() {
+        if (!file) return;
+        flush();
+        trace_header h = make_header(count);
+        std::fseek(file, 0, SEEK_SET);
+        std::fwrite(&h, sizeof(h), 1, file);
+        std::fclose(file);
+        file = nullptr;
+    }
+
+private:
+    static constexpr size_t BUFFER_RECORDS = 65536;
+
+    std::FILE* file;
+    uint64_t count;
+    std::vector<trace_record> buffer;
+
+    static trace_header make_header(uint64_t n) {
+        trace_header h;
+        std::memcpy(h.magic, "SCTRACE1", 8);
+        h.version = trace_header::VERSION;
+        h.record_size = sizeof(trace_record);
+        h.count = n;
+        return h;
+    }
+
+    void flush() {
+        if (buffer.empty()) return;
+        count += std::fwrite(buffer.data(), sizeof(trace_record), buffer.size(), file);
+        buffer.clear();
+    }
+};
+
+// 轨迹读取：把整个文件只读映射进地址空间，按窗口顺序消费
+// 进入一个新窗口时，通知内核预读下一个窗口（MADV_WILLNEED），并释放已经
+// 消费完的上一个窗口（MADV_DONTNEED），因此驻留内存只有约两个窗口，
+// 消费当前窗口与读入下一个窗口重叠进行，相当于双缓冲
+class trace_reader {
+public:
+    static constexpr size_t WINDOW_RECORDS = 262144;   // 每个窗口4MB
+
+    trace_reader() : fd(-1), base(nullptr), map_size(0), records(nullptr),
+                     total(0), pos(0), window_end(0) {}
+    ~trace_reader() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "无法打开轨迹文件: " + path;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(trace_header)) {
+            error = "轨迹文件过短: " + path;
+            close();
+            return false;
+        }
+        map_size = st.st_size;
+        base = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            base = nullptr;
+            error = "mmap失败: " + path;
+            close();
+            return false;
+        }
+        madvise(base, map_size, MADV_SEQUENTIAL);
+
+        const trace_header* h = static_cast<const trace_header*>(base);
+        if (std::memcmp(h->magic, "SCTRACE1", 8) != 0 ||
+            h->version != trace_header::VERSION ||
+            h->record_size != sizeof(trace_record)) {
+            error = "轨迹文件格式错误: " + path;
+            close();
+            return false;
+        }
+        // 以文件实际长度为准，防止写入中断导致的记录条数不符
+        total = std::min<uint64_t>(h->count, (map_size - sizeof(trace_header)) / sizeof(trace_record));
+        records = reinterpret_cast<const trace_record*>(static_cast<const char*>(base) + sizeof(trace_header));
+        pos = 0;
+        window_end = 0;
+        return true;
+    }
+
+    void close() {
+        if (base) munmap(base, map_size);
+        if (fd >= 0) ::close(fd);
+        base = nullptr;
+        fd = -1;
+        records = nullptr;
+        total = pos = window_end = 0;
+    }
+
+    uint64_t size() const { return total; }
+    uint64_t position() const { return pos; }
+    const std::string& last_error() const { return error; }
+
+    // 取出下一段连续记录（不超过当前窗口的末尾），返回条数，0表示结束
+    size_t next_block(const trace_record*& block) {
+        if (pos >= total) return 0;
+        if (pos == window_end) advance_window();
+        block = records + pos;
+        size_t n = window_end - pos;
+        pos = window_end;
+        return n;
+    }
+
+    // 逐条读取，内部按块推进
+    bool next(trace_record& r) {
+        if (pos >= total) return false;
+        if (pos == window_end) advance_window();
+        r = records[pos++];
+        return true;
+    }
+
+private:
+    int fd;
+    void* base;
+    size_t map_size;
+    const trace_record* records;
+    uint64_t total;
+    uint64_t pos;
+    uint64_t window_end;
+    std::string error;
+
+    // 对记录区间[first, last)执行madvise，地址按页对齐
+    void advise(uint64_t first, uint64_t last, int advice) {
+        static const uintptr_t page = sysconf(_SC_PAGESIZE);
+        uintptr_t lo = reinterpret_cast<uintptr_t>(records + first) & ~(page - 1);
+        uintptr_t hi = reinterpret_cast<uintptr_t>(records + last);
+        if (hi > lo) madvise(reinterpret_cast<void*>(lo), hi - lo, advice);
+    }
+
+    void advance_window() {
+        uint64_t start = window_end;
+        window_end = std::min<uint64_t>(start + WINDOW_RECORDS, total);
+        uint64_t ahead = std::min<uint64_t>(window_end + WINDOW_RECORDS, total);
+        if (ahead > window_end) advise(window_end, ahead, MADV_WILLNEED);
+        // 释放上一个窗口；映射是只读的，即使误释放了边界页，再次访问时也会从文件重新读入
+        if (start >= WINDOW_RECORDS) advise(start - WINDOW_RECORDS, start, MADV_DONTNEED);
+    }
+};
+
+#endif // TRACE_READER_H
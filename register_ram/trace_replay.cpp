@@ -0,0 +1,304 @@
+// File: trace_replay.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include "register_file.h"
+#include "ram.h"
+#include "trace_reader.h"
+#include "../common/stimulus.h"
+
+// 回放统计
+struct replay_stats {
+    uint64_t records;
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t mismatches;
+
+    replay_stats() : records(0), reads(0), writes(0), mismatches(0) {}
+
+    // 读数据与轨迹中观测值不一致，只打印前几条
+    void mismatch(const trace_record& r, unsigned int actual) {
+        if (mismatches++ < 5) {
+            std::cout << "不一致: 周期 " << r.timestamp << " 地址 " << (r.addr & 0xF)
+                      << " 轨迹读数 0x" << std::hex << (r.data & 0xFF)
+                      << " 模型读数 0x" << actual << std::dec << std::endl;
+        }
+    }
+};
+
+// 端口模式：按轨迹时间戳在时钟下降沿驱动模型端口，下一个下降沿检查读数据
+// 模型看作单端口存储，每个周期最多一次访问；时间戳相同或倒退的记录顺延到下一个周期
+// register_file的rd_data只在读地址变化时刷新，读记录的地址与上一条相同时先切到相邻地址
+// 再切回，让读进程在写入之后重新求值（ram每个周期都刷新，不需要这样做）
+SC_MODULE(trace_driver) {
+    sc_in<bool> clk;
+    sc_out<sc_uint<4>> addr;
+    sc_out<sc_uint<8>> wr_data;
+    sc_out<bool> wr_en;
+    sc_in<sc_uint<8>> rd_data;
+
+    trace_reader& reader;
+    bool refresh_read;    // 读地址不变时强制刷新rd_data（register_file）
+    replay_stats stats;
+
+    SC_HAS_PROCESS(trace_driver);
+
+    void drive_thread() {
+        const sc_time period(10, SC_NS);
+        bool started = false;
+        bool pending_read = false;
+        trace_record pending;
+        uint64_t cycle = 0;
+
+        wait(clk.negedge_event());
+
+        const trace_record* block;
+        size_t n;
+        while ((n = reader.next_block(block)) != 0) {
+            for (size_t i = 0; i < n; i++) {
+                const trace_record& r = block[i];
+                if (started) {
+                    // 上一条记录所在周期的上升沿已经过去
+                    wait(period);
+                    cycle++;
+                    if (pending_read && rd_data.read() != (pending.data & 0xFF)) {
+                        stats.mismatch(pending, rd_data.read().to_uint());
+                    }
+                    // 空闲周期：撤销写使能，一次等待跳过整段空闲
+                    if (r.timestamp > cycle) {
+                        wr_en.write(false);
+                        wait(period * double(r.timestamp - cycle));
+                        cycle = r.timestamp;
+                    }
+                } else {
+                    started = true;
+                    cycle = r.timestamp;
+                }
+
+                const unsigned int a = r.addr & 0xF;
+                if (refresh_read && !r.is_write() && addr.read() == a) {
+                    addr.write(a ^ 1);
+                    wait(SC_ZERO_TIME);
+                }
+                addr.write(a);
+                wr_data.write(r.data & 0xFF);
+                wr_en.write(r.is_write());
+                pending_read = !r.is_write();
+                pending = r;
+                stats.records++;
+                (r.is_write() ? stats.writes : stats.reads)++;
+            }
+        }
+
+        if (started) {
+            wait(period);
+            if (pending_read && rd_data.read() != (pending.data & 0xFF)) {
+                stats.mismatch(pending, rd_data.read().to_uint());
+            }
+        }
+        sc_stop();
+    }
+
+    trace_driver(sc_module_name name, trace_reader& r, bool refresh = false)
+    : sc_module(name), reader(r), refresh_read(refresh) {
+        SC_THREAD(drive_thread);
+    }
+};
+
+// 端口模式的顶层：只例化被回放的那个模型
+SC_MODULE(replay_top) {
+    sc_clock clk;
+    sc_signal<sc_uint<4>> addr;
+    sc_signal<sc_uint<8>> wr_data;
+    sc_signal<bool> wr_en;
+    sc_signal<sc_uint<8>> rd_data;
+
+    std::unique_ptr<ram> ram_inst;
+    std::unique_ptr<register_file> reg_inst;
+    trace_driver driver;
+
+    replay_top(sc_module_name name, bool use_ram, trace_reader& reader)
+    : sc_module(name), clk("clk", 10, SC_NS), driver("driver", reader, !use_ram) {
+        if (use_ram) {
+            ram_inst.reset(new ram("ram_inst"));
+            ram_inst->clk(clk);
+            ram_inst->addr(addr);
+            ram_inst->wr_data(wr_data);
+            ram_inst->wr_en(wr_en);
+            ram_inst->rd_data(rd_data);
+        } else {
+            reg_inst.reset(new register_file("reg_inst"));
+            reg_inst->clk(clk);
+            reg_inst->rd_addr(addr);
+            reg_inst->wr_addr(addr);
+            reg_inst->wr_data(wr_data);
+            reg_inst->wr_en(wr_en);
+            reg_inst->rd_data(rd_data);
+        }
+        driver.clk(clk);
+        driver.addr(addr);
+        driver.wr_data(wr_data);
+        driver.wr_en(wr_en);
+        driver.rd_data(rd_data);
+    }
+};
+
+// 后门模式：不经过仿真内核，直接用peek/poke按顺序回放
+template<typename MODEL>
+replay_stats replay_backdoor(MODEL& model, trace_reader& reader) {
+    replay_stats stats;
+    const trace_record* block;
+    size_t n;
+    while ((n = reader.next_block(block)) != 0) {
+        for (size_t i = 0; i < n; i++) {
+            const trace_record& r = block[i];
+            if (r.is_write()) {
+                model.poke(r.addr, r.data & 0xFF);
+                stats.writes++;
+            } else {
+                unsigned int actual = model.peek(r.addr).to_uint();
+                if (actual != (r.data & 0xFFu)) stats.mismatch(r, actual);
+                stats.reads++;
+            }
+        }
+        stats.records += n;
+    }
+    return stats;
+}
+
+// 生成合成轨迹：随机读写，读记录的数据取自影子存储，约1/8的访问之后有一段空闲
+bool generate_trace(const std::string& path, uint64_t count, uint64_t seed) {
+    trace_writer writer;
+    if (!writer.open(path)) return false;
+
+    stim::memory_stimulus gen(seed, 0.5);
+    stim::philox_stream& rng = gen.stream();
+    uint8_t shadow[16] = {0};
+    uint64_t cycle = 1;
+
+    for (uint64_t i = 0; i < count; i++) {
+        stim::memory_op op = gen.next();
+        trace_record r;
+        r.timestamp = cycle;
+        r.addr = op.addr;
+        r.flags = op.write ? trace_record::TRACE_WRITE : 0;
+        r.reserved = 0;
+        if (op.write) {
+            shadow[op.addr] = op.data;
+            r.data = op.data;
+        } else {
+            r.data = shadow[op.addr];
+        }
+        writer.write(r);
+        cycle += (rng.next_u32() & 7) == 0 ? 1 + rng.uniform(1, 16) : 1;
+    }
+    writer.close();
+    return true;
+}
+
+// 只读取轨迹、不驱动模型，测量读取本身的速率
+double scan_trace(trace_reader& reader, uint64_t& checksum) {
+    auto t0 = std::chrono::steady_clock::now();
+    const trace_record* block;
+    size_t n;
+    checksum = 0;
+    while ((n = reader.next_block(block)) != 0) {
+        for (size_t i = 0; i < n; i++) {
+            checksum += block[i].timestamp ^ block[i].addr ^ block[i].data;
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void print_stats(const char* name, const replay_stats& s, double seconds) {
+    std::cout << std::left << std::setw(20) << name << std::right
+              << "记录 " << s.records << " (读 " << s.reads << ", 写 " << s.writes << ")"
+              << std::fixed << std::setprecision(3) << ", 用时 " << seconds << " s, "
+              << std::setprecision(1) << (s.records / seconds / 1e6) << " M条/s"
+              << ", 不一致 " << s.mismatches << std::endl;
+}
+
+// 用法:
+//   trace_replay gen <文件> [记录数] [种子]           生成合成轨迹
+//   trace_replay <文件> <ram|regfile> <port|backdoor>  回放轨迹
+int sc_main(int argc, char* argv[]) {
+    if (argc >= 3 && std::string(argv[1]) == "gen") {
+        uint64_t count = argc > 3 ? std::stoull(argv[3]) : 10000000;
+        uint64_t seed = argc > 4 ? std::stoull(argv[4]) : 1;
+        if (!generate_trace(argv[2], count, seed)) {
+            std::cout << "错误: 无法写入 " << argv[2] << std::endl;
+            return 1;
+        }
+        std::cout << "已生成 " << count << " 条记录: " << argv[2] << std::endl;
+        return 0;
+    }
+    if (argc < 4) {
+        std::cout << "用法: " << argv[0] << " gen <文件> [记录数] [种子]\n"
+                  << "      " << argv[0] << " <文件> <ram|regfile> <port|backdoor>\n";
+        return 1;
+    }
+
+    const std::string path = argv[1];
+    const bool use_ram = std::string(argv[2]) == "ram";
+    const bool port_mode = std::string(argv[3]) == "port";
+
+    trace_reader reader;
+    if (!reader.open(path)) {
+        std::cout << "错误: " << reader.last_error() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n===== 轨迹回放: " << path << " (" << reader.size() << "条) =====\n";
+    uint64_t checksum;
+    double scan_seconds = scan_trace(reader, checksum);
+    std::cout << std::left << std::setw(20) << "仅读取轨迹" << std::right << std::fixed
+              << std::setprecision(1) << (reader.size() / scan_seconds / 1e6) << " M条/s, "
+              << (reader.size() * sizeof(trace_record) / scan_seconds / 1e9) << " GB/s"
+              << "  (摘要 0x" << std::hex << checksum << std::dec << ")\n";
+    if (!reader.open(path)) {
+        std::cout << "错误: " << reader.last_error() << std::endl;
+        return 1;
+    }
+
+    replay_stats stats;
+    auto t0 = std::chrono::steady_clock::now();
+    if (port_mode) {
+        replay_top top("top", use_ram, reader);
+        sc_start();
+        stats = top.driver.stats;
+    } else if (use_ram) {
+        ram model("ram_inst");
+        stats = replay_backdoor(model, reader);
+    } else {
+        register_file model("reg_inst");
+        stats = replay_backdoor(model, reader);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::string name = std::string(use_ram ? "ram" : "register_file") + (port_mode ? "/端口" : "/后门");
+    print_stats(name.c_str(), stats, seconds);
+
+    if (stats.mismatches) {
+        std::cout << "\n===== 回放发现 " << stats.mismatches << " 处读数据不一致 =====\n";
+        return 1;
+    }
+    std::cout << "\n===== 回放完成，读数据全部一致 =====\n";
+    return 0;
+}
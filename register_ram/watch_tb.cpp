@@ -0,0 +1,277 @@
+// File: watch_tb.cpp
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <systemc.h>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "register_file.h"
+#include "ram.h"
+#include "../common/stimulus.h"
+
+// 一个周期的访问：同一个地址同时送给ram和register_file的读写端口
+struct mem_op {
+    unsigned int addr;
+    unsigned int data;
+    bool write;
+};
+
+SC_MODULE(watch_top) {
+    sc_clock clk;
+    sc_signal<sc_uint<4>> addr;
+    sc_signal<sc_uint<8>> wr_data;
+    sc_signal<bool> wr_en;
+    sc_signal<sc_uint<8>> ram_rd_data;
+    sc_signal<sc_uint<8>> reg_rd_data;
+
+    ram mem;
+    register_file regs;
+
+    // 驱动：每个下降沿取脚本中的下一条访问；脚本放完后在随机模式下产生随机访问，否则保持空闲
+    std::vector<mem_op> script;
+    size_t next;
+    uint64_t random_cycles;          // 剩余的随机访问周期数
+    unsigned int random_addr_max;    // 随机地址范围0~random_addr_max
+    stim::philox_stream rng;
+
+    SC_HAS_PROCESS(watch_top);
+
+    void drive_thread() {
+        for (;;) {
+            wait(clk.negedge_event());
+            mem_op op = {0, 0, false};
+            if (next < script.size()) {
+                op = script[next++];
+            } else if (random_cycles > 0) {
+                random_cycles--;
+                uint32_t r = rng.next_u32();
+                op.addr = (r & 0xF) % (random_addr_max + 1);
+                op.data = (r >> 8) & 0xFF;
+                op.write = (r >> 16) & 1;
+            } else {
+                wr_en.write(false);
+                continue;
+            }
+            addr.write(op.addr);
+            wr_data.write(op.data);
+            wr_en.write(op.write);
+        }
+    }
+
+    void play(const std::vector<mem_op>& ops) {
+        script = ops;
+        next = 0;
+    }
+
+    watch_top(sc_module_name name)
+    : sc_module(name), clk("clk", 10, SC_NS), mem("mem"), regs("regs"),
+      next(0), random_cycles(0), random_addr_max(15), rng(1, stim::STREAM_USER) {
+        mem.clk(clk);
+        mem.addr(addr);
+        mem.wr_data(wr_data);
+        mem.wr_en(wr_en);
+        mem.rd_data(ram_rd_data);
+
+        regs.clk(clk);
+        regs.rd_addr(addr);
+        regs.wr_addr(addr);
+        regs.wr_data(wr_data);
+        regs.wr_en(wr_en);
+        regs.rd_data(reg_rd_data);
+
+        SC_THREAD(drive_thread);
+    }
+};
+
+static int failures = 0;
+
+static void check(bool ok, const std::string& what) {
+    std::cout << "  " << (ok ? "通过" : "失败") << ": " << what << std::endl;
+    if (!ok) failures++;
+}
+
+static const sc_time PERIOD(10, SC_NS);
+
+// 运行脚本的全部访问，再多走两个周期让最后一次写入完成
+static void run_script(watch_top& top, const std::vector<mem_op>& ops) {
+    top.play(ops);
+    sc_start(PERIOD * double(ops.size() + 2));
+}
+
+// 页位图：大地址空间、每页64个字时，只有观察点所在的页置位
+static void check_pages() {
+    std::cout << "\n===== 页位图 =====" << std::endl;
+    watch_unit<20, 6> w;
+    check(!w.armed(1000, WATCH_WRITE) && !w.armed(1000, WATCH_READ), "没有观察点时全部未置位");
+    int id = w.add(watchpoint(1000, 1003, WATCH_WRITE));
+    check(id > 0 && w.armed(960, WATCH_WRITE) && w.armed(1023, WATCH_WRITE), "观察点所在的页(960~1023)置位");
+    check(!w.armed(959, WATCH_WRITE) && !w.armed(1024, WATCH_WRITE), "相邻的页未置位");
+    check(!w.armed(1000, WATCH_READ), "写观察点不置读位图");
+    int id2 = w.add(watchpoint(2000, 70000, WATCH_READ));
+    check(w.armed(2000, WATCH_READ) && w.armed(40000, WATCH_READ) && w.armed(70000, WATCH_READ) &&
+          !w.armed(70080, WATCH_READ), "跨多页的范围");
+    w.enable(id, false);
+    check(!w.armed(1000, WATCH_WRITE), "禁用后清除");
+    w.remove(id2);
+    check(!w.armed(2000, WATCH_READ) && w.size() == 1, "删除后清除");
+    check(w.add(watchpoint(5, 4)) < 0 && w.add(watchpoint(1u << 20, 1u << 21)) < 0, "拒绝空范围和越界范围");
+}
+
+// 回调修改观察点集合：一次性观察点删除自己，另一个回调加入新观察点并删除后面的观察点
+static void check_callback_edits() {
+    std::cout << "\n===== 回调中增删观察点 =====" << std::endl;
+    watch_unit<8> w;
+    int once = 0, later = 0, added = 0;
+    int once_id = 0, later_id = 0, added_id = 0;
+    once_id = w.add(watchpoint(0, 15).then_call([&](const watch_hit&) {
+        once++;
+        w.remove(once_id);
+    }));
+    w.add(watchpoint(0, 15).then_call([&](const watch_hit&) {
+        if (added_id) return;
+        added_id = w.add(watchpoint(0, 15).then_call([&](const watch_hit&) { added++; }));
+        w.remove(later_id);
+    }));
+    later_id = w.add(watchpoint(0, 15).then_call([&](const watch_hit&) { later++; }));
+
+    w.check("unit", 3, WATCH_WRITE, 0, 1);
+    check(once == 1 && later == 0 && added == 0 && w.size() == 2, "删除自己和后面的观察点，新观察点本次不检查");
+    w.check("unit", 3, WATCH_WRITE, 1, 2);
+    check(once == 1 && added == 1 && w.hits(added_id) == 1, "新观察点从下一次访问开始生效");
+    w.clear();
+}
+
+static void check_triggers(watch_top& top) {
+    std::cout << "\n===== 触发条件 =====" << std::endl;
+    ram& mem = top.mem;
+
+    // 没有观察点时不进入慢路径
+    run_script(top, {{1, 0x10, true}, {5, 0x20, true}, {5, 0, false}, {9, 0x30, true}});
+    check(mem.watch.slow_checks() == 0 && top.regs.watch.slow_checks() == 0, "没有观察点时不进入慢路径");
+
+    // 地址范围写观察点，回调得到完整的上下文
+    std::vector<watch_hit> hits;
+    int id = mem.watch.add(watchpoint(4, 7, WATCH_WRITE).then_call([&](const watch_hit& h) { hits.push_back(h); }));
+    run_script(top, {{2, 0x11, true}, {5, 0x22, true}, {9, 0x33, true}, {6, 0x44, false}, {7, 0x55, true}});
+    check(hits.size() == 2 && mem.watch.hits(id) == 2, "范围[4,7]内的两次写命中，范围外和读不命中");
+    if (hits.size() == 2) {
+        check(hits[0].addr == 5 && hits[0].old_value == 0x20 && hits[0].value == 0x22 &&
+              hits[0].access == WATCH_WRITE && std::string(hits[0].model) == "top.mem",
+              "命中上下文：模型、地址、旧值和新值");
+        check(hits[0].time < hits[1].time && hits[1].addr == 7 && hits[1].value == 0x55, "命中时间和顺序");
+    }
+    check(mem.peek(5) == 0x22 && mem.peek(7) == 0x55, "命中的写照常完成");
+    mem.watch.remove(id);
+
+    // 值匹配：只在写入0x2a时命中（只比较低4位的观察点对0x1a也命中）
+    hits.clear();
+    int exact = mem.watch.add(watchpoint(3, 3).when_value(0x2a).then_call([&](const watch_hit& h) { hits.push_back(h); }));
+    int low = mem.watch.add(watchpoint(3, 3).when_value(0xa, 0xf));
+    run_script(top, {{3, 0x11, true}, {3, 0x2a, true}, {3, 0x1a, true}, {3, 0x2a, false}});
+    check(hits.size() == 1 && hits[0].value == 0x2a && mem.watch.hits(low) == 2, "值匹配与掩码");
+    mem.watch.remove(exact);
+    mem.watch.remove(low);
+
+    // register_file的读观察点（tracepoint）：读地址变为9时打印
+    std::ostringstream trace;
+    top.regs.watch.set_trace_stream(trace);
+    int rd = top.regs.watch.add(watchpoint(9, 9, WATCH_READ).then_trace());
+    run_script(top, {{8, 0, false}, {9, 0, false}, {10, 0, false}});
+    check(top.regs.watch.hits(rd) == 1 && trace.str().find("top.regs 读 [9] 0x33") != std::string::npos,
+          "读观察点打印上下文: " + trace.str().substr(0, trace.str().find('\n')));
+    top.regs.watch.remove(rd);
+
+    // ram的读观察点：地址在9上保持三个周期（三个时钟上升沿），只在地址变为9时命中一次；
+    // 读计数同样只计地址变化（10->8->9->10）
+    int ram_rd = mem.watch.add(watchpoint(9, 9, WATCH_READ));
+    uint64_t reads = mem.reads;
+    run_script(top, {{8, 0, false}, {9, 0, false}, {9, 0, false}, {9, 0, false}, {10, 0, false}});
+    check(mem.watch.hits(ram_rd) == 1, "地址保持时时钟沿不触发ram的读观察点");
+    check(mem.reads - reads == 3, "读计数只计地址变化");
+    mem.watch.remove(ram_rd);
+
+    // 暂停：第8次访问写地址10，sc_start在那个周期返回，resume后继续执行剩下的脚本
+    std::vector<mem_op> ops;
+    for (unsigned int i = 0; i < 20; i++) ops.push_back({i == 7 ? 10u : 12u, i, true});
+    int brk = mem.watch.add(watchpoint(10, 10).then_stop());
+    sc_time t0 = sc_time_stamp();
+    top.play(ops);
+    sc_start(PERIOD * 40.0);
+    sc_time paused = sc_time_stamp();
+    check(mem.watch.stopped() && paused < t0 + PERIOD * 10.0 && top.next == 8, "命中后暂停仿真");
+    std::cout << "    " << mem.watch.stop_hit() << std::endl;
+    mem.watch.resume();
+    sc_start(t0 + PERIOD * 40.0 - paused);
+    check(!mem.watch.stopped() && top.next == ops.size() && mem.peek(12) == 19, "resume后继续运行");
+    mem.watch.remove(brk);
+}
+
+// 访问路径的代价：随机读写n个周期，地址只在0~14
+//   无观察点：位图全为0
+//   其他页：观察地址15，访问时位测试不命中
+//   全部页：观察全部地址，但值永远不匹配，每次访问都进入慢路径
+static void measure(watch_top& top, uint64_t n) {
+    std::cout << "\n===== 访问路径的代价 (" << n << "个随机读写周期) =====" << std::endl;
+    struct phase {
+        const char* name;
+        unsigned int lo, hi;
+        bool armed;
+    };
+    const phase phases[] = {{"无观察点", 0, 0, false}, {"其他页", 15, 15, true}, {"全部页", 0, 15, true}};
+    top.random_addr_max = 14;
+    for (const phase& p : phases) {
+        int ids[2] = {0, 0};
+        if (p.armed) {
+            ids[0] = top.mem.watch.add(watchpoint(p.lo, p.hi, WATCH_ACCESS).when_value(0x100));
+            ids[1] = top.regs.watch.add(watchpoint(p.lo, p.hi, WATCH_ACCESS).when_value(0x100));
+        }
+        uint64_t slow0 = top.mem.watch.slow_checks() + top.regs.watch.slow_checks();
+        top.random_cycles = n;
+        auto t0 = std::chrono::steady_clock::now();
+        sc_start(PERIOD * double(n));
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        uint64_t slow = top.mem.watch.slow_checks() + top.regs.watch.slow_checks() - slow0;
+        std::cout << "  " << std::left << std::setw(12) << p.name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(8) << s * 1e9 / n << " ns/周期, 慢路径 " << slow
+                  << " 次" << std::endl;
+        if (p.armed) {
+            top.mem.watch.remove(ids[0]);
+            top.regs.watch.remove(ids[1]);
+        }
+    }
+}
+
+// 用法: watch_tb [随机周期数]
+int sc_main(int argc, char* argv[]) {
+    uint64_t n = argc > 1 ? std::stoull(argv[1]) : 1000000;
+
+    check_pages();
+    check_callback_edits();
+
+    watch_top top("top");
+    sc_start(PERIOD * 0.5);
+    check_triggers(top);
+    measure(top, n);
+
+    if (failures) {
+        std::cout << "\n===== 观察点测试失败 (" << failures << "处错误) =====" << std::endl;
+        return 1;
+    }
+    std::cout << "\n===== 观察点测试通过 =====" << std::endl;
+    return 0;
+}
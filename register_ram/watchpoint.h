@@ -0,0 +1,251 @@
+// File: watchpoint.h
+// Copyright (C) 2025  ZhaoCake
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef WATCHPOINT_H
+#define WATCHPOINT_H
+
+#include <systemc.h>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// 访问类型，可以按位组合
+enum watch_access : unsigned int {
+    WATCH_READ = 1,
+    WATCH_WRITE = 2,
+    WATCH_ACCESS = WATCH_READ | WATCH_WRITE
+};
+
+// 一次命中的上下文
+struct watch_hit {
+    int id;                         // 观察点编号
+    const char* model;              // 模型的层次名
+    unsigned int addr;
+    watch_access access;            // WATCH_READ或WATCH_WRITE
+    unsigned int old_value;         // 访问前存储中的值（读时与value相同）
+    unsigned int value;             // 读出或写入的值
+    sc_time time;
+    uint64_t delta;                 // 命中时的sc_delta_count()
+};
+
+inline std::ostream& operator<<(std::ostream& os, const watch_hit& h) {
+    std::ios::fmtflags flags = os.flags();
+    char fill = os.fill();
+    os << "[" << h.time << " delta " << h.delta << "] 观察点#" << h.id << " " << h.model
+       << (h.access == WATCH_WRITE ? " 写" : " 读") << " [" << h.addr << "] " << std::hex << std::setfill('0');
+    if (h.access == WATCH_WRITE) os << "0x" << std::setw(2) << h.old_value << " -> ";
+    os << "0x" << std::setw(2) << h.value;
+    os.flags(flags);
+    os.fill(fill);
+    return os;
+}
+
+// 观察点：地址范围[lo, hi]上的读和/或写，可选值匹配（(value & mask) == (match & mask)）。
+// 命中时依次：调用回调、打印上下文（tracepoint）、暂停仿真（sc_pause，sc_start随后返回）。
+// 回调里可以增删、启用或禁用观察点（例如一次性的观察点删除自己），见watch_unit::check()
+//
+//   ram0.watch.add(watchpoint(4, 7, WATCH_WRITE).when_value(0x2a).then_stop());
+struct watchpoint {
+    unsigned int lo;
+    unsigned int hi;
+    unsigned int access;
+    bool match_value;
+    unsigned int match;
+    unsigned int mask;
+    bool trace;
+    bool stop;
+    std::function<void(const watch_hit&)> callback;
+
+    watchpoint(unsigned int lo, unsigned int hi, unsigned int access = WATCH_WRITE)
+    : lo(lo), hi(hi), access(access), match_value(false), match(0), mask(~0u), trace(false), stop(false) {}
+
+    watchpoint& when_value(unsigned int v, unsigned int m = ~0u) {
+        match_value = true;
+        match = v;
+        mask = m;
+        return *this;
+    }
+    watchpoint& then_call(std::function<void(const watch_hit&)> f) {
+        callback = std::move(f);
+        return *this;
+    }
+    watchpoint& then_trace() {
+        trace = true;
+        return *this;
+    }
+    watchpoint& then_stop() {
+        stop = true;
+        return *this;
+    }
+};
+
+// 一个存储模型的观察点集合，地址空间为2^ADDR_BITS个字，每页2^PAGE_BITS个字。
+// 读、写各有一张按页的标志位图：观察点覆盖的页置位。模型的每次访问先做一次位测试（armed），
+// 只有落在被观察的页上才进入check()逐个比较观察点；没有观察点时位图全为0，访问路径上只多一次位测试。
+// 观察点的增删不在访问路径上，每次增删都重建位图
+template<unsigned int ADDR_BITS, unsigned int PAGE_BITS = 0>
+class watch_unit {
+public:
+    static const unsigned int PAGES = 1u << (ADDR_BITS - PAGE_BITS);
+    static const unsigned int WORDS = (PAGES + 63) / 64;
+
+    watch_unit() : next_id_(1), slow_checks_(0), stopped_(false), stop_hit_(), trace_os_(&std::cout) {
+        rebuild();
+    }
+
+    // access为WATCH_READ或WATCH_WRITE（调用处是常量）
+    bool armed(unsigned int addr, watch_access access) const {
+        unsigned int p = (addr >> PAGE_BITS) & (PAGES - 1);
+        return (pages_[access == WATCH_WRITE][p >> 6] >> (p & 63)) & 1;
+    }
+
+    // 返回观察点编号；地址范围超出地址空间的部分被截掉，范围为空时返回-1
+    int add(const watchpoint& w) {
+        if (w.lo > w.hi || w.lo >= (1u << ADDR_BITS) || !(w.access & WATCH_ACCESS)) return -1;
+        entries_.push_back({next_id_, w, true, 0});
+        if (entries_.back().w.hi >= (1u << ADDR_BITS)) entries_.back().w.hi = (1u << ADDR_BITS) - 1;
+        rebuild();
+        return next_id_++;
+    }
+
+    bool remove(int id) {
+        for (size_t i = 0; i < entries_.size(); i++) {
+            if (entries_[i].id == id) {
+                entries_.erase(entries_.begin() + i);
+                rebuild();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool enable(int id, bool on) {
+        entry* e = find(id);
+        if (!e) return false;
+        e->enabled = on;
+        rebuild();
+        return true;
+    }
+
+    void clear() {
+        entries_.clear();
+        rebuild();
+    }
+
+    size_t size() const { return entries_.size(); }
+
+    uint64_t hits(int id) const {
+        for (const entry& e : entries_) {
+            if (e.id == id) return e.hits;
+        }
+        return 0;
+    }
+
+    // 进入check()的次数：访问落在被观察的页上，但不一定命中观察点
+    uint64_t slow_checks() const { return slow_checks_; }
+
+    // 最近一次由then_stop()的观察点暂停仿真的上下文；resume()清除暂停标志
+    bool stopped() const { return stopped_; }
+    const watch_hit& stop_hit() const { return stop_hit_; }
+    void resume() { stopped_ = false; }
+
+    void set_trace_stream(std::ostream& os) { trace_os_ = &os; }
+
+    // 慢路径：由模型在armed()为真时调用。访问照常完成，then_stop()在当前delta周期结束后生效。
+    // 回调可以修改观察点集合，entries_可能因此移动或重新分配：调用回调之前先取出trace/stop
+    // 并复制回调本身，之后不再使用指向entries_的引用，而是按编号找到下一个要检查的观察点。
+    // 回调中新加的观察点从下一次访问开始生效，删除的观察点（包括自己）本次不再检查
+    void check(const char* model, unsigned int addr, watch_access access,
+               unsigned int old_value, unsigned int value) {
+        slow_checks_++;
+        const int end_id = next_id_;
+        size_t i = 0;
+        while (i < entries_.size() && entries_[i].id < end_id) {
+            entry& e = entries_[i];
+            const watchpoint& w = e.w;
+            if (!e.enabled || !(w.access & access) || addr < w.lo || addr > w.hi ||
+                (w.match_value && ((value ^ w.match) & w.mask))) {
+                i++;
+                continue;
+            }
+
+            watch_hit h = {e.id, model, addr, access, old_value, value, sc_time_stamp(), sc_delta_count()};
+            e.hits++;
+            const bool trace = w.trace;
+            const bool stop = w.stop;
+            if (w.callback) {
+                std::function<void(const watch_hit&)> f = w.callback;
+                f(h);
+                i = position_after(h.id);
+            } else {
+                i++;
+            }
+            if (trace) *trace_os_ << h << std::endl;
+            if (stop && !stopped_) {
+                stopped_ = true;
+                stop_hit_ = h;
+                if (sc_is_running()) sc_pause();
+            }
+        }
+    }
+
+private:
+    struct entry {
+        int id;
+        watchpoint w;
+        bool enabled;
+        uint64_t hits;
+    };
+
+    entry* find(int id) {
+        for (entry& e : entries_) {
+            if (e.id == id) return &e;
+        }
+        return nullptr;
+    }
+
+    // 编号大于id的第一个观察点的位置（entries_按编号递增排列）
+    size_t position_after(int id) const {
+        size_t i = 0;
+        while (i < entries_.size() && entries_[i].id <= id) i++;
+        return i;
+    }
+
+    void rebuild() {
+        for (unsigned int k = 0; k < 2; k++) {
+            for (unsigned int i = 0; i < WORDS; i++) pages_[k][i] = 0;
+        }
+        for (const entry& e : entries_) {
+            if (!e.enabled) continue;
+            for (unsigned int p = e.w.lo >> PAGE_BITS; p <= e.w.hi >> PAGE_BITS; p++) {
+                if (e.w.access & WATCH_READ) pages_[0][p >> 6] |= uint64_t(1) << (p & 63);
+                if (e.w.access & WATCH_WRITE) pages_[1][p >> 6] |= uint64_t(1) << (p & 63);
+            }
+        }
+    }
+
+    uint64_t pages_[2][WORDS];          // [0]读、[1]写的页标志位图
+    std::vector<entry> entries_;
+    int next_id_;
+    uint64_t slow_checks_;
+    bool stopped_;
+    watch_hit stop_hit_;
+    std::ostream* trace_os_;
+};
+
+#endif // WATCHPOINT_H